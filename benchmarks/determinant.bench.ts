@@ -2,7 +2,12 @@
 import { performance } from "perf_hooks";
 // Importa tanto la clase MatrixUtils como la función JS específica si la tienes separada
 import { MatrixUtils } from "../src/core/matrix/MatrixUtils"; // Ajusta ruta
-import { determinantWasm, cleanupWasm } from "../src/core/wasm/wasm-loader"; // Ajusta ruta
+import {
+  determinantWasm,
+  determinantWasmSync,
+  initWasm,
+  cleanupWasm,
+} from "../src/core/wasm/wasm-loader"; // Ajusta ruta
 import type { Matrix3x3 } from "../src/types/core.types"; // Ajusta ruta
 
 // --- Configuración ---
@@ -131,10 +136,22 @@ async function main() {
     true,
   );
 
+  // Versión WASM síncrona (export C directo, sin Embind ni await)
+  await initWasm();
+  const wasmSyncTime = await runDeterminantBenchmark(
+    determinantWasmSync,
+    "WASM Determinant (sync)",
+    false,
+  );
+
   // --- Resultados ---
   console.log("\n--- Benchmark Summary ---");
   console.log(`JS Time:   ${jsTime.toFixed(2)} ms`);
   console.log(`WASM Time: ${wasmTime.toFixed(2)} ms`);
+  console.log(`WASM Sync Time: ${wasmSyncTime.toFixed(2)} ms`);
+  console.log(
+    `Per-call overhead removed by sync API: ${(((wasmTime - wasmSyncTime) / NUM_ITERATIONS) * 1e6).toFixed(0)} ns`,
+  );
 
   if (jsTime > 0 && wasmTime > 0) {
     const diff = jsTime - wasmTime;
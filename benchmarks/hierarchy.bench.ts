@@ -0,0 +1,109 @@
+// benchmarks/hierarchy.bench.ts
+import { performance } from "perf_hooks";
+import { MatrixUtils } from "../src/core/matrix/MatrixUtils";
+import { WasmBufferManager } from "../src/core/wasm/WasmBufferManager";
+import { HIERARCHY_ROOT } from "../src/core/wasm/WasmTransformHierarchy";
+import { cleanupWasm } from "../src/core/wasm/wasm-loader";
+import type { Matrix3x3 } from "../src/types/core.types";
+
+// --- Configuración ---
+// Escena de grupos de grupos: ROOTS raíces, cada nodo con FANOUT hijos por nivel
+const ROOTS = 16;
+const FANOUT = 8;
+const LEVELS = 4; // 16 * (1 + 8 + 64 + 512) = 9360 nodos
+const NUM_FRAMES = 200;
+const WARMUP_FRAMES = 20;
+// Fracción de raíces que se mueven en cada frame (el resto de la escena quieta)
+const MOVING_ROOTS = [1, 0.25, 1 / ROOTS];
+
+/** Padres en orden de anchura (topológico): cada nivel después del anterior. */
+function buildParents(): number[] {
+  const parents: number[] = [];
+  let level: number[] = [];
+  for (let r = 0; r < ROOTS; r++) {
+    level.push(parents.length);
+    parents.push(HIERARCHY_ROOT);
+  }
+  for (let depth = 1; depth < LEVELS; depth++) {
+    const next: number[] = [];
+    for (const parent of level) {
+      for (let c = 0; c < FANOUT; c++) {
+        next.push(parents.length);
+        parents.push(parent);
+      }
+    }
+    level = next;
+  }
+  return parents;
+}
+
+function localAt(i: number, frame: number): Matrix3x3 {
+  return MatrixUtils.multiply(
+    MatrixUtils.translation((i % 13) + frame * 0.1, i % 7),
+    MatrixUtils.rotation(i * 0.01 + frame * 0.001)
+  );
+}
+
+async function main() {
+  const manager = new WasmBufferManager();
+  await manager.initialize();
+  const parents = buildParents();
+  const numNodes = parents.length;
+  const locals = parents.map((_, i) => localAt(i, 0));
+  const hierarchy = manager.createTransformHierarchy(numNodes);
+  parents.forEach((parent, i) => hierarchy.addNode(parent, locals[i]));
+  hierarchy.update();
+
+  const rows: Record<string, Record<string, string>> = {};
+  for (const fraction of MOVING_ROOTS) {
+    const moving = Math.max(1, Math.round(ROOTS * fraction));
+    let sink = 0;
+
+    // JS: recomponer todo con MatrixUtils.multiply (una alocación por nodo)
+    const worlds: Matrix3x3[] = new Array(numNodes);
+    let start = 0;
+    for (let frame = -WARMUP_FRAMES; frame < NUM_FRAMES; frame++) {
+      if (frame === 0) start = performance.now();
+      for (let r = 0; r < moving; r++) locals[r] = localAt(r, frame);
+      for (let i = 0; i < numNodes; i++) {
+        const parent = parents[i];
+        worlds[i] =
+          parent === HIERARCHY_ROOT
+            ? locals[i]
+            : MatrixUtils.multiply(worlds[parent], locals[i]);
+      }
+      sink += worlds[numNodes - 1][6];
+    }
+    const jsMs = (performance.now() - start) / NUM_FRAMES;
+
+    // WASM: marcar las raíces movidas y propagar solo sus subárboles
+    let updated = 0;
+    for (let frame = -WARMUP_FRAMES; frame < NUM_FRAMES; frame++) {
+      if (frame === 0) {
+        start = performance.now();
+        updated = 0;
+      }
+      for (let r = 0; r < moving; r++) hierarchy.setLocal(r, localAt(r, frame));
+      updated += hierarchy.update();
+    }
+    const wasmMs = (performance.now() - start) / NUM_FRAMES;
+    sink += hierarchy.getWorld(numNodes - 1)[6];
+
+    rows[`${moving}/${ROOTS} roots moving`] = {
+      "Nodes updated/frame": (updated / NUM_FRAMES).toFixed(0),
+      "JS compose (ms)": jsMs.toFixed(3),
+      "WASM update (ms)": wasmMs.toFixed(3),
+      Speedup: `${(jsMs / wasmMs).toFixed(1)}x`,
+    };
+    console.log(`(checksum: ${sink.toExponential(2)})`);
+  }
+  console.log(
+    `\n=== World-matrix propagation, ${numNodes} nodes (${NUM_FRAMES} frames) ===`
+  );
+  console.table(rows);
+
+  await manager.cleanup();
+  await cleanupWasm();
+}
+
+main().catch(console.error);
@@ -0,0 +1,87 @@
+// benchmarks/incremental.bench.ts
+import { performance } from "perf_hooks";
+import { MatrixUtils } from "../src/core/matrix/MatrixUtils";
+import { WasmBufferManager } from "../src/core/wasm/WasmBufferManager";
+import { cleanupWasm } from "../src/core/wasm/wasm-loader";
+
+// --- Configuración ---
+// Nube estática con unos pocos puntos editados por frame y la cámara quieta.
+const NUM_POINTS = 500000;
+const NUM_FRAMES = 200;
+const WARMUP_FRAMES = 20;
+const EDITS_PER_FRAME = [0, 10, 100, 1000, 10000, 100000];
+
+const MATRIX = MatrixUtils.multiply(
+  MatrixUtils.translation(120, -40),
+  MatrixUtils.rotation(0.3)
+);
+
+let seed = 12345;
+function random(): number {
+  seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+  return seed / 0x7fffffff;
+}
+
+/** Edita `edits` puntos al azar; con `mark` los registra como sucios. */
+function editPoints(
+  manager: WasmBufferManager,
+  input: Float32Array,
+  edits: number,
+  mark: boolean
+): void {
+  for (let k = 0; k < edits; k++) {
+    const i = Math.floor(random() * NUM_POINTS);
+    input[i * 2] = random() * 1000;
+    input[i * 2 + 1] = random() * 1000;
+    if (mark) manager.markInputDirty(i);
+  }
+}
+
+async function timeFrames(
+  manager: WasmBufferManager,
+  input: Float32Array,
+  edits: number,
+  incremental: boolean
+): Promise<number> {
+  let elapsed = 0;
+  for (let frame = -WARMUP_FRAMES; frame < NUM_FRAMES; frame++) {
+    editPoints(manager, input, edits, incremental);
+    const t0 = performance.now();
+    if (incremental) {
+      await manager.transformPointsIncrementalManaged(MATRIX, NUM_POINTS);
+    } else {
+      await manager.transformPointsBatchManaged(MATRIX, NUM_POINTS);
+    }
+    if (frame >= 0) elapsed += performance.now() - t0;
+  }
+  return elapsed / NUM_FRAMES;
+}
+
+async function main() {
+  const manager = new WasmBufferManager();
+  await manager.initialize();
+  const input = (await manager.getInputBuffer(NUM_POINTS)).view;
+  await manager.getOutputBuffer(NUM_POINTS);
+  for (let i = 0; i < input.length; i++) input[i] = random() * 1000;
+
+  const rows: Record<string, Record<string, string>> = {};
+  for (const edits of EDITS_PER_FRAME) {
+    const full = await timeFrames(manager, input, edits, false);
+    manager.markInputDirtyAll();
+    const incremental = await timeFrames(manager, input, edits, true);
+    rows[edits.toLocaleString()] = {
+      "Full batch (ms)": full.toFixed(4),
+      "Incremental (ms)": incremental.toFixed(4),
+      Speedup: `${(full / incremental).toFixed(1)}x`,
+    };
+  }
+  console.log(
+    `\n=== ${NUM_POINTS.toLocaleString()} static points, edits per frame (${NUM_FRAMES} frames) ===`
+  );
+  console.table(rows);
+
+  await manager.cleanup();
+  await cleanupWasm();
+}
+
+main().catch(console.error);
@@ -0,0 +1,119 @@
+// benchmarks/keyframes.bench.ts
+import { performance } from "perf_hooks";
+import { MatrixUtils } from "../src/core/matrix/MatrixUtils";
+import { WasmBufferManager } from "../src/core/wasm/WasmBufferManager";
+import type { Keyframe } from "../src/core/wasm/WasmKeyframeAnimation";
+import { cleanupWasm } from "../src/core/wasm/wasm-loader";
+import type { Matrix3x3 } from "../src/types/core.types";
+
+// --- Configuración ---
+// Muchos objetos animados con pistas TRS, evaluados una vez por frame
+const TRACK_COUNTS = [1000, 10000, 50000];
+const KEYS_PER_TRACK = 8;
+const NUM_FRAMES = 50;
+const WARMUP_FRAMES = 5;
+const DURATION = 10;
+
+interface Trs {
+  tx: number;
+  ty: number;
+  angle: number;
+  scale: number;
+}
+
+function keyParams(track: number, key: number): Trs {
+  return {
+    tx: (track % 97) + key * 3,
+    ty: (track % 89) - key * 2,
+    angle: (track * 0.01 + key * 0.7) % (2 * Math.PI),
+    scale: 1 + 0.1 * ((track + key) % 5),
+  };
+}
+
+function compose(p: Trs): Matrix3x3 {
+  return MatrixUtils.multiply(
+    MatrixUtils.multiply(
+      MatrixUtils.translation(p.tx, p.ty),
+      MatrixUtils.rotation(p.angle)
+    ),
+    MatrixUtils.scaling(p.scale, p.scale)
+  );
+}
+
+const keyTime = (key: number) => (key * DURATION) / (KEYS_PER_TRACK - 1);
+
+/** JS: busca el tramo, interpola TRS lineal y compone con MatrixUtils. */
+function evaluateJs(tracks: Trs[][], t: number, out: Matrix3x3[]): void {
+  const segment = Math.min(
+    KEYS_PER_TRACK - 2,
+    Math.floor((t / DURATION) * (KEYS_PER_TRACK - 1))
+  );
+  const u = (t - keyTime(segment)) / (keyTime(segment + 1) - keyTime(segment));
+  for (let i = 0; i < tracks.length; i++) {
+    const a = tracks[i][segment];
+    const b = tracks[i][segment + 1];
+    out[i] = compose({
+      tx: a.tx + (b.tx - a.tx) * u,
+      ty: a.ty + (b.ty - a.ty) * u,
+      angle: a.angle + (b.angle - a.angle) * u,
+      scale: a.scale + (b.scale - a.scale) * u,
+    });
+  }
+}
+
+async function main() {
+  const manager = new WasmBufferManager();
+  await manager.initialize();
+
+  const rows: Record<string, Record<string, string>> = {};
+  for (const count of TRACK_COUNTS) {
+    const tracks = Array.from({ length: count }, (_, i) =>
+      Array.from({ length: KEYS_PER_TRACK }, (_, k) => keyParams(i, k))
+    );
+    const setupStart = performance.now();
+    const animation = manager.createKeyframeAnimation();
+    for (const params of tracks) {
+      const keys: Keyframe[] = params.map((p, k) => ({
+        time: keyTime(k),
+        matrix: compose(p),
+      }));
+      animation.addTrack(keys);
+    }
+    const setupMs = performance.now() - setupStart;
+
+    let sink = 0;
+    const worlds: Matrix3x3[] = new Array(count);
+    const run = (frame: (t: number) => void) => {
+      for (let f = 0; f < WARMUP_FRAMES; f++) frame(f * 0.01);
+      const start = performance.now();
+      for (let f = 0; f < NUM_FRAMES; f++) frame((f * DURATION) / NUM_FRAMES);
+      return (performance.now() - start) / NUM_FRAMES;
+    };
+    const jsMs = run((t) => {
+      evaluateJs(tracks, t, worlds);
+      sink += worlds[count - 1][6];
+    });
+    const wasmMs = run((t) => {
+      const out = manager.evaluateKeyframeAnimationManaged(animation, t);
+      sink += out.view[count * 9 - 3];
+    });
+    animation.dispose();
+
+    rows[count.toLocaleString()] = {
+      "Setup + decompose (ms)": setupMs.toFixed(1),
+      "JS evaluate (ms/frame)": jsMs.toFixed(3),
+      "WASM evaluate (ms/frame)": wasmMs.toFixed(3),
+      Speedup: `${(jsMs / wasmMs).toFixed(1)}x`,
+    };
+    console.log(`(checksum ${count}: ${sink.toExponential(2)})`);
+  }
+  console.log(
+    `\n=== Keyframe evaluation, ${KEYS_PER_TRACK} keys per track (${NUM_FRAMES} frames) ===`
+  );
+  console.table(rows);
+
+  await manager.cleanup();
+  await cleanupWasm();
+}
+
+main().catch(console.error);
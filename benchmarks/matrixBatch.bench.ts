@@ -0,0 +1,150 @@
+// benchmarks/matrixBatch.bench.ts
+import { performance } from "perf_hooks";
+import { MatrixUtils } from "../src/core/matrix/MatrixUtils";
+import { WasmBufferManager } from "../src/core/wasm/WasmBufferManager";
+import type { MatrixBatchOptions } from "../src/core/wasm/WasmBufferManager";
+import {
+  cleanupWasm,
+  initWasm,
+  inverseWasmSync,
+  multiplyWasmSync,
+} from "../src/core/wasm/wasm-loader";
+import type { Matrix3x3 } from "../src/types/core.types";
+
+// --- Configuración ---
+// Composición local * padre de muchos objetos por frame, como en un scene graph.
+const BATCH_SIZES = [1000, 10000, 50000];
+const NUM_FRAMES = 50;
+const WARMUP_FRAMES = 5;
+
+let seed = 4242;
+function random(): number {
+  seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+  return seed / 0x7fffffff - 0.5;
+}
+
+function randomMatrices(count: number): Matrix3x3[] {
+  return Array.from({ length: count }, () =>
+    MatrixUtils.fromValues(
+      1 + random(),
+      random(),
+      0,
+      random(),
+      1 + random(),
+      0,
+      random() * 100,
+      random() * 100,
+      1
+    )
+  );
+}
+
+/** Matrices por segundo de `frame` repetido NUM_FRAMES veces. */
+async function measure(
+  count: number,
+  frame: () => unknown | Promise<unknown>
+): Promise<number> {
+  for (let i = 0; i < WARMUP_FRAMES; i++) await frame();
+  const start = performance.now();
+  for (let i = 0; i < NUM_FRAMES; i++) await frame();
+  const seconds = (performance.now() - start) / 1000;
+  return (count * NUM_FRAMES) / seconds;
+}
+
+async function main() {
+  await initWasm();
+  const manager = new WasmBufferManager();
+  await manager.initialize();
+
+  const rows: Record<string, Record<string, string>> = {};
+  const inverseRows: Record<string, Record<string, string>> = {};
+  for (const count of BATCH_SIZES) {
+    const parents = randomMatrices(count);
+    const locals = randomMatrices(count);
+    const worlds = Array.from({ length: count }, () => new Float32Array(9));
+    let sink = 0;
+
+    // Bucle de llamadas sueltas: una copia de entrada/salida por par
+    const singleRate = await measure(count, () => {
+      for (let i = 0; i < count; i++) {
+        multiplyWasmSync(parents[i], locals[i], worlds[i]);
+      }
+      sink += worlds[count - 1][0];
+    });
+
+    const batchRate = async (options: MatrixBatchOptions) => {
+      const buffers = await manager.getMatrixBatchBuffers(count, options);
+      const a = buffers.a.view;
+      const b = buffers.b.view;
+      const soa = options.layout === "soa";
+      for (let i = 0; i < count; i++) {
+        for (let k = 0; k < 9; k++) {
+          if (!options.sharedA) {
+            a[soa ? k * count + i : i * 9 + k] = parents[i][k];
+          }
+          b[soa ? k * count + i : i * 9 + k] = locals[i][k];
+        }
+      }
+      if (options.sharedA) a.set(parents[0]);
+      return measure(count, async () => {
+        const out = await manager.multiplyMatricesBatchManaged(count, options);
+        sink += out.view[0];
+      });
+    };
+    const aosRate = await batchRate({ layout: "aos" });
+    const soaRate = await batchRate({ layout: "soa" });
+    const sharedRate = await batchRate({ layout: "soa", sharedA: true });
+
+    rows[count.toLocaleString()] = {
+      "Single calls (M/s)": (singleRate / 1e6).toFixed(2),
+      "Batch AoS (M/s)": (aosRate / 1e6).toFixed(2),
+      "Batch SoA (M/s)": (soaRate / 1e6).toFixed(2),
+      "Shared A SoA (M/s)": (sharedRate / 1e6).toFixed(2),
+      "AoS speedup": `${(aosRate / singleRate).toFixed(1)}x`,
+      "SoA speedup": `${(soaRate / singleRate).toFixed(1)}x`,
+    };
+
+    // Inversas para hit testing: mapear de pantalla a local por objeto
+    const singleInverseRate = await measure(count, () => {
+      for (let i = 0; i < count; i++) inverseWasmSync(parents[i], worlds[i]);
+      sink += worlds[count - 1][0];
+    });
+    const batchInverseRate = async (layout: "aos" | "soa") => {
+      const a = (await manager.getMatrixBatchBuffers(count, { layout })).a.view;
+      for (let i = 0; i < count; i++) {
+        for (let k = 0; k < 9; k++) {
+          a[layout === "soa" ? k * count + i : i * 9 + k] = parents[i][k];
+        }
+      }
+      return measure(count, async () => {
+        const result = await manager.invertMatricesBatchManaged(count, {
+          layout,
+        });
+        sink += result.inverted;
+      });
+    };
+    const inverseAosRate = await batchInverseRate("aos");
+    const inverseSoaRate = await batchInverseRate("soa");
+    inverseRows[count.toLocaleString()] = {
+      "Single calls (M/s)": (singleInverseRate / 1e6).toFixed(2),
+      "Batch AoS (M/s)": (inverseAosRate / 1e6).toFixed(2),
+      "Batch SoA (M/s)": (inverseSoaRate / 1e6).toFixed(2),
+      "AoS speedup": `${(inverseAosRate / singleInverseRate).toFixed(1)}x`,
+      "SoA speedup": `${(inverseSoaRate / singleInverseRate).toFixed(1)}x`,
+    };
+    console.log(`(checksum ${count}: ${sink.toExponential(2)})`);
+  }
+  console.log(
+    `\n=== Batched 3x3 multiply vs single-call loop (${NUM_FRAMES} frames, millions of matrices/s) ===`
+  );
+  console.table(rows);
+  console.log(
+    `\n=== Batched 3x3 inverse vs single-call loop (${NUM_FRAMES} frames, millions of matrices/s) ===`
+  );
+  console.table(inverseRows);
+
+  await manager.cleanup();
+  await cleanupWasm();
+}
+
+main().catch(console.error);
@@ -1,7 +1,7 @@
 // benchmarks/multiply.bench.ts
 import { performance } from 'perf_hooks';
 import { MatrixUtils } from '../src/core/matrix/MatrixUtils'; // Ajusta ruta
-import { multiplyWasm, cleanupWasm, loadWasmModule } from '../src/core/wasm/wasm-loader'; // Ajusta ruta
+import { multiplyWasm, multiplyWasmSync, initWasm, cleanupWasm, loadWasmModule } from '../src/core/wasm/wasm-loader'; // Ajusta ruta
 import type { Matrix3x3 } from '../src/types/core.types'; // Ajusta ruta
 import { isValidNumber } from '../src/utils/utils'; // Importar si es necesario
 
@@ -175,10 +175,26 @@ async function main() {
         )
     ).duration;
 
+    // Versión WASM síncrona (export C directo, sin Embind ni await por llamada)
+    await initWasm();
+    const wasmSyncTime = (
+        await runBenchmark(
+            multiplyWasmSync,
+            'WASM Multiply (sync)',
+            NUM_ITERATIONS,
+            getMatrixPair,
+            false,
+        )
+    ).duration;
+
     // --- Resumen ---
     console.log('\n--- Benchmark Summary (Multiply) ---');
     console.log(`JS Time:   ${jsTime.toFixed(2)} ms`);
     console.log(`WASM Time: ${wasmTime.toFixed(2)} ms`);
+    console.log(`WASM Sync Time: ${wasmSyncTime.toFixed(2)} ms`);
+    console.log(
+        `Per-call overhead removed by sync API: ${(((wasmTime - wasmSyncTime) / NUM_ITERATIONS) * 1e6).toFixed(0)} ns`,
+    );
     if (jsTime > 0 && wasmTime > 0) {
         const diff = jsTime - wasmTime;
         const perc = (diff / jsTime) * 100;
@@ -0,0 +1,98 @@
+// benchmarks/pointCodec.bench.ts
+import { performance } from "perf_hooks";
+import { gzipSync } from "zlib";
+import { MatrixUtils } from "../src/core/matrix/MatrixUtils";
+import { WasmBufferManager } from "../src/core/wasm/WasmBufferManager";
+import { cleanupWasm } from "../src/core/wasm/wasm-loader";
+
+// --- Configuración ---
+const NUM_POINTS = 1_000_000;
+const WORLD_SIZE = 10000;
+const ITERATIONS = 20;
+const CHUNK_BYTES = 64 * 1024; // Chunks de red simulados para el decode en streaming
+const STEPS = [0, 0.01, 0.001]; // 0 = 2^16 celdas dentro del AABB
+
+let seed = 12345;
+function random(): number {
+  seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+  return seed / 0x7fffffff;
+}
+
+/** Nube uniforme; con `coherent` se reordena en Hilbert antes de codificar. */
+async function loadPoints(
+  manager: WasmBufferManager,
+  coherent: boolean
+): Promise<void> {
+  const input = (await manager.getInputBuffer(NUM_POINTS)).view;
+  seed = 12345;
+  for (let i = 0; i < NUM_POINTS * 2; i++) input[i] = random() * WORLD_SIZE;
+  if (coherent) await manager.reorderPointsSpatiallyManaged(NUM_POINTS);
+}
+
+function* chunksOf(bytes: Uint8Array): Generator<Uint8Array> {
+  for (let offset = 0; offset < bytes.length; offset += CHUNK_BYTES) {
+    yield bytes.subarray(offset, offset + CHUNK_BYTES);
+  }
+}
+
+async function main() {
+  const manager = new WasmBufferManager();
+  await manager.initialize();
+  await manager.getOutputBuffer(NUM_POINTS);
+  const matrix = MatrixUtils.rotation(0.5);
+  const rawBytes = NUM_POINTS * 8;
+
+  const rows: Record<string, Record<string, string>> = {};
+  for (const coherent of [false, true]) {
+    await loadPoints(manager, coherent);
+    const raw = (await manager.getInputBuffer(NUM_POINTS)).view.slice();
+    const gzipBytes = gzipSync(new Uint8Array(raw.buffer)).length;
+    for (const step of STEPS) {
+      (await manager.getInputBuffer(NUM_POINTS)).view.set(raw);
+      let encoded = await manager.encodePointsManaged(NUM_POINTS, {
+        source: "input",
+        step,
+      });
+      let t0 = performance.now();
+      for (let k = 0; k < ITERATIONS; k++) {
+        encoded = await manager.encodePointsManaged(NUM_POINTS, {
+          source: "input",
+          step,
+        });
+      }
+      const encodeMs = (performance.now() - t0) / ITERATIONS;
+
+      await manager.decodePointsManaged(encoded);
+      t0 = performance.now();
+      for (let k = 0; k < ITERATIONS; k++) {
+        await manager.decodePointsManaged(chunksOf(encoded));
+      }
+      const decodeMs = (performance.now() - t0) / ITERATIONS;
+      t0 = performance.now();
+      for (let k = 0; k < ITERATIONS; k++) {
+        await manager.decodePointsManaged(chunksOf(encoded));
+        await manager.transformPointsBatchManaged(matrix, NUM_POINTS);
+      }
+      const pipelineMs = (performance.now() - t0) / ITERATIONS;
+
+      const label = `${coherent ? "hilbert" : "random"} step=${step || "auto"}`;
+      rows[label] = {
+        "Bytes/pt": (encoded.length / NUM_POINTS).toFixed(2),
+        Ratio: `${(rawBytes / encoded.length).toFixed(2)}x`,
+        "gzip(f32) ratio": `${(rawBytes / gzipBytes).toFixed(2)}x`,
+        "Encode (ms)": encodeMs.toFixed(2),
+        "Decode Mpts/s": (NUM_POINTS / decodeMs / 1000).toFixed(1),
+        "Decode+transform (ms)": pipelineMs.toFixed(2),
+      };
+    }
+  }
+  console.log(
+    `\n=== Point codec: ${NUM_POINTS.toLocaleString()} points, ${CHUNK_BYTES / 1024} KiB chunks ===`
+  );
+  console.table(rows);
+
+  await manager.cleanup();
+  await cleanupWasm();
+}
+
+main().catch(console.error);
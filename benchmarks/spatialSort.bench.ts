@@ -0,0 +1,131 @@
+// benchmarks/spatialSort.bench.ts
+import { performance } from "perf_hooks";
+import { WasmBufferManager } from "../src/core/wasm/WasmBufferManager";
+import type { SpatialCurve } from "../src/core/wasm/WasmBufferManager";
+import { cleanupWasm } from "../src/core/wasm/wasm-loader";
+
+// --- Configuración ---
+// Consultas de radio sobre un índice de rejilla (CSR): los candidatos de cada
+// celda se leen del buffer de puntos por índice, como en hit testing o vecinos.
+const NUM_POINTS = 2_000_000;
+const WORLD_SIZE = 10000;
+const GRID_CELLS = 512; // Por eje
+const NUM_QUERIES = 50000;
+const QUERY_RADIUS = 40;
+
+let seed = 12345;
+function random(): number {
+  seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+  return seed / 0x7fffffff;
+}
+
+interface GridIndex {
+  cellStart: Uint32Array; // GRID_CELLS^2 + 1
+  indices: Uint32Array; // Índices de punto agrupados por celda
+}
+
+function cellOf(v: number): number {
+  const c = Math.floor((v / WORLD_SIZE) * GRID_CELLS);
+  return c < 0 ? 0 : c >= GRID_CELLS ? GRID_CELLS - 1 : c;
+}
+
+function buildGrid(points: Float32Array, numPoints: number): GridIndex {
+  const cellStart = new Uint32Array(GRID_CELLS * GRID_CELLS + 1);
+  const cells = new Uint32Array(numPoints);
+  for (let i = 0; i < numPoints; i++) {
+    cells[i] = cellOf(points[i * 2 + 1]) * GRID_CELLS + cellOf(points[i * 2]);
+    cellStart[cells[i] + 1]++;
+  }
+  for (let c = 0; c < GRID_CELLS * GRID_CELLS; c++) {
+    cellStart[c + 1] += cellStart[c];
+  }
+  const fill = cellStart.slice(0, -1);
+  const indices = new Uint32Array(numPoints);
+  for (let i = 0; i < numPoints; i++) indices[fill[cells[i]]++] = i;
+  return { cellStart, indices };
+}
+
+function runQueries(
+  points: Float32Array,
+  grid: GridIndex,
+  queries: Float32Array
+): number {
+  let hits = 0;
+  const r2 = QUERY_RADIUS * QUERY_RADIUS;
+  for (let q = 0; q < NUM_QUERIES; q++) {
+    const qx = queries[q * 2];
+    const qy = queries[q * 2 + 1];
+    const x0 = cellOf(qx - QUERY_RADIUS);
+    const x1 = cellOf(qx + QUERY_RADIUS);
+    const y0 = cellOf(qy - QUERY_RADIUS);
+    const y1 = cellOf(qy + QUERY_RADIUS);
+    for (let cy = y0; cy <= y1; cy++) {
+      for (let cx = x0; cx <= x1; cx++) {
+        const cell = cy * GRID_CELLS + cx;
+        const end = grid.cellStart[cell + 1];
+        for (let k = grid.cellStart[cell]; k < end; k++) {
+          const i = grid.indices[k];
+          const dx = points[i * 2] - qx;
+          const dy = points[i * 2 + 1] - qy;
+          if (dx * dx + dy * dy <= r2) hits++;
+        }
+      }
+    }
+  }
+  return hits;
+}
+
+async function main() {
+  const manager = new WasmBufferManager();
+  await manager.initialize();
+  const original = new Float32Array(NUM_POINTS * 2);
+  for (let i = 0; i < original.length; i++) original[i] = random() * WORLD_SIZE;
+  const queries = new Float32Array(NUM_QUERIES * 2);
+  for (let i = 0; i < queries.length; i++) queries[i] = random() * WORLD_SIZE;
+  const ids = Uint32Array.from({ length: NUM_POINTS }, (_, i) => i);
+
+  const rows: Record<string, Record<string, string>> = {};
+  const orders: (SpatialCurve | "original")[] = [
+    "original",
+    "morton",
+    "hilbert",
+  ];
+  for (const order of orders) {
+    (await manager.getInputBuffer(NUM_POINTS)).view.set(original);
+    await manager.getOutputBuffer(NUM_POINTS);
+    let sortMs = 0;
+    if (order !== "original") {
+      const t0 = performance.now();
+      await manager.reorderPointsSpatiallyManaged(NUM_POINTS, {
+        curve: order,
+        attributes: [ids.slice()],
+      });
+      sortMs = performance.now() - t0;
+    }
+    const points = (await manager.getInputBuffer(NUM_POINTS)).view.slice();
+    const grid = buildGrid(points, NUM_POINTS);
+    runQueries(points, grid, queries); // Calentamiento
+    const t0 = performance.now();
+    const hits = runQueries(points, grid, queries);
+    const queryMs = performance.now() - t0;
+    rows[order] = {
+      "Reorder (ms)": order === "original" ? "-" : sortMs.toFixed(1),
+      "Queries (ms)": queryMs.toFixed(1),
+      "us/query": ((queryMs * 1000) / NUM_QUERIES).toFixed(2),
+      Hits: hits.toLocaleString(),
+    };
+  }
+  const base = parseFloat(rows.original["Queries (ms)"]);
+  for (const row of Object.values(rows)) {
+    row.Speedup = `${(base / parseFloat(row["Queries (ms)"])).toFixed(2)}x`;
+  }
+  console.log(
+    `\n=== ${NUM_QUERIES.toLocaleString()} radius queries over ${NUM_POINTS.toLocaleString()} points (grid ${GRID_CELLS}^2) ===`
+  );
+  console.table(rows);
+
+  await manager.cleanup();
+  await cleanupWasm();
+}
+
+main().catch(console.error);
@@ -0,0 +1,130 @@
+// benchmarks/startup.bench.ts
+import { performance } from "perf_hooks";
+import { existsSync, readFileSync } from "fs";
+import { gzipSync } from "zlib";
+import { fileURLToPath } from "url";
+import {
+  cleanupWasm,
+  getCompiledWasmModule,
+  initWasm,
+  initWasmSync,
+} from "../src/core/wasm/wasm-loader";
+import type { WasmModuleVariant } from "../src/core/wasm/wasm-loader";
+
+// --- Configuración ---
+const NUM_ITERATIONS = 20;
+const GENERATED_DIR = new URL("../src/core/wasm/generated/", import.meta.url);
+const VARIANT_FILES: Record<WasmModuleVariant, string> = {
+  baseline: "matrix_ops.baseline",
+  simd: "matrix_ops",
+  relaxed: "matrix_ops.relaxed",
+  threads: "matrix_ops.threads",
+  size: "matrix_ops.size",
+};
+
+function generatedPath(file: string): string {
+  return fileURLToPath(new URL(file, GENERATED_DIR));
+}
+
+function kb(bytes: number): string {
+  return (bytes / 1024).toFixed(1);
+}
+
+function median(values: number[]): number {
+  const sorted = [...values].sort((a, b) => a - b);
+  return sorted[Math.floor(sorted.length / 2)];
+}
+
+// --- Tamaño de los Binarios ---
+function reportSizes(): WasmModuleVariant[] {
+  console.log("\n--- Binary Size (KiB) ---");
+  const rows: Record<string, Record<string, string>> = {};
+  const present: WasmModuleVariant[] = [];
+  for (const [variant, base] of Object.entries(VARIANT_FILES)) {
+    const wasmPath = generatedPath(`${base}.wasm`);
+    const jsPath = generatedPath(`${base}.js`);
+    if (!existsSync(wasmPath) || !existsSync(jsPath)) continue;
+    present.push(variant as WasmModuleVariant);
+    const wasm = readFileSync(wasmPath);
+    const js = readFileSync(jsPath);
+    rows[variant] = {
+      ".wasm": kb(wasm.length),
+      ".wasm gzip": kb(gzipSync(wasm).length),
+      ".js": kb(js.length),
+      ".js gzip": kb(gzipSync(js).length),
+    };
+  }
+  console.table(rows);
+  return present;
+}
+
+// --- Compilación ---
+async function reportCompileTimes(variants: WasmModuleVariant[]) {
+  console.log(`\n--- WebAssembly.compile (${NUM_ITERATIONS} runs) ---`);
+  const rows: Record<string, Record<string, string>> = {};
+  for (const variant of variants) {
+    const bytes = readFileSync(generatedPath(`${VARIANT_FILES[variant]}.wasm`));
+    const times: number[] = [];
+    for (let i = 0; i < NUM_ITERATIONS; i++) {
+      const start = performance.now();
+      await WebAssembly.compile(bytes);
+      times.push(performance.now() - start);
+    }
+    // V8 cachea en memoria los binarios ya compilados: la primera es la relevante
+    rows[variant] = {
+      "First (ms)": times[0].toFixed(2),
+      "Median (ms)": median(times).toFixed(2),
+    };
+  }
+  console.table(rows);
+}
+
+// --- Arranque ---
+async function main() {
+  const variants = reportSizes();
+
+  // La primera inicialización del proceso es el arranque en frío real: importa
+  // el JS generado, compila el binario e instancia
+  console.log("\n--- Startup ---");
+  let start = performance.now();
+  await initWasm();
+  const coldTime = performance.now() - start;
+
+  // Recargas tras cleanupWasm(): reutilizan el WebAssembly.Module cacheado
+  const warmTimes: number[] = [];
+  for (let i = 0; i < NUM_ITERATIONS; i++) {
+    await cleanupWasm();
+    start = performance.now();
+    await initWasm();
+    warmTimes.push(performance.now() - start);
+  }
+  console.log(`Cold start (initWasm):        ${coldTime.toFixed(2)} ms`);
+  console.log(
+    `Reload with cached module:    ${median(warmTimes).toFixed(2)} ms`
+  );
+
+  if (variants.includes("size")) {
+    await cleanupWasm();
+    const glue = await import(
+      /* @vite-ignore */ new URL("matrix_ops.size.js", GENERATED_DIR).href
+    );
+    const compiled = await getCompiledWasmModule("size");
+    const syncTimes: number[] = [];
+    for (let i = 0; i < NUM_ITERATIONS; i++) {
+      await cleanupWasm();
+      start = performance.now();
+      initWasmSync(glue.default, compiled);
+      syncTimes.push(performance.now() - start);
+    }
+    console.log(
+      `initWasmSync (size build):    ${median(syncTimes).toFixed(2)} ms`
+    );
+  } else {
+    console.log("initWasmSync: skipped (run `pnpm build:wasm:size`).");
+  }
+  await cleanupWasm();
+
+  await reportCompileTimes(variants);
+}
+
+main().catch(console.error);
@@ -1,18 +1,37 @@
 // benchmarks/transformPoints.bench.ts
 import { performance } from "perf_hooks";
+import os from "os";
 import { MatrixUtils } from "../src/core/matrix/MatrixUtils"; // Ajusta ruta
 import {
   WasmBufferManager,
   ManagedWasmBuffer,
 } from "../src/core/wasm/WasmBufferManager"; // Ajusta ruta
-import { cleanupWasm } from "../src/core/wasm/wasm-loader"; // Ajusta ruta (solo cleanup)
+import {
+  cleanupWasm,
+  loadWasmModule,
+} from "../src/core/wasm/wasm-loader"; // Ajusta ruta
+import type { WasmTransformPlan } from "../src/core/wasm/WasmTransformPlan";
 import type { Matrix3x3, Point } from "../src/types/core.types"; // Ajusta ruta
 import { isValidNumber } from "../src/utils/utils";
 
 // --- Configuración ---
 const NUM_ITERATIONS = 500;
 const WARMUP_ITERATIONS_DIV = 10;
-const BATCH_SIZES = [1, 10, 100, 1000, 10000, 50000, 100000, 250000, 500000];
+const BATCH_SIZES = [
+  1, 10, 100, 1000, 10000, 50000, 100000, 250000, 500000, 1000000,
+];
+// Workers para la build con pthreads (el hilo principal también procesa chunks)
+const MT_WORKERS = Math.max(
+  1,
+  Math.min(8, (os.availableParallelism?.() ?? os.cpus().length) - 1)
+);
+// Igual que PARALLEL_MIN_POINTS en core_cpp: por debajo el kernel es serie
+const PARALLEL_MIN_POINTS = 65536;
+// Escalado: mismos lotes con 0 (serie), 1, 2, 4... workers en la build threads
+const SCALING_SIZES = BATCH_SIZES.filter((size) => size >= PARALLEL_MIN_POINTS);
+const SCALING_WORKERS = [...new Set([0, 1, 2, 4, MT_WORKERS])]
+  .filter((workers) => workers <= MT_WORKERS)
+  .sort((a, b) => a - b);
 
 // --- Función JS (Referencia - Sin Cambios) ---
 const transformPointsBatchJS = (
@@ -221,10 +240,35 @@ async function main() {
     process.exit(1);
   }
 
+  // Gestor sobre la build con pthreads (opcional: requiere `pnpm build:wasm:threads`)
+  let mtManager: WasmBufferManager | null = new WasmBufferManager();
+  try {
+    await mtManager.initialize({ threads: MT_WORKERS });
+    // Sin SharedArrayBuffer initialize carga la build por defecto sin hilos
+    if (mtManager.getThreadCount() === 0) {
+      throw new Error("threads build loaded without workers");
+    }
+    console.log(
+      `WASM MT Buffer Manager initialized (${mtManager.getThreadCount()} workers).`
+    );
+  } catch (e) {
+    console.warn("WASM MT build not available, skipping MT benchmarks.", e);
+    await mtManager.cleanup();
+    mtManager = null;
+  }
+  const mtThreads = mtManager ? mtManager.getThreadCount() + 1 : 0;
+
   console.log(
     `\nStarting Transform Points Batch Benchmarks (${NUM_ITERATIONS} iterations per size)...`
   );
-  const results: { [key: number]: { js: number; wasm: number } } = {};
+  const results: {
+    [key: number]: {
+      js: number;
+      wasm: number;
+      plan: number;
+      wasmMt: number;
+    };
+  } = {};
 
   // Bucle de Benchmarks
   for (const size of BATCH_SIZES) {
@@ -247,20 +291,27 @@ async function main() {
       undefined,
       jsCalculateResult
     );
-    results[size] = { js: jsResult.duration, wasm: -1 };
+    results[size] = {
+      js: jsResult.duration,
+      wasm: -1,
+      plan: -1,
+      wasmMt: -1,
+    };
 
     // --- Benchmark WASM usando WasmBufferManager ---
     type WasmExecArgs = [WasmBufferManager, Matrix3x3, number];
-    const wasmSetup = async (): Promise<WasmExecArgs | { error: string }> => {
-      try {
-        const inputBuffer = await bufferManager.getInputBuffer(numPoints);
-        await bufferManager.getOutputBuffer(numPoints);
-        inputBuffer.view.set(points);
-        return [bufferManager, matrix_combined, numPoints];
-      } catch (e) {
-        return { error: e instanceof Error ? e.message : String(e) };
-      }
-    };
+    const makeWasmSetup =
+      (manager: WasmBufferManager) =>
+      async (): Promise<WasmExecArgs | { error: string }> => {
+        try {
+          const inputBuffer = await manager.getInputBuffer(numPoints);
+          await manager.getOutputBuffer(numPoints);
+          inputBuffer.view.set(points);
+          return [manager, matrix_combined, numPoints];
+        } catch (e) {
+          return { error: e instanceof Error ? e.message : String(e) };
+        }
+      };
 
     const wasmExecutionFn = async (
       manager: WasmBufferManager,
@@ -291,37 +342,154 @@ async function main() {
       wasmExecutionFn,
       `WASM Managed Batch (${size})`,
       NUM_ITERATIONS,
-      wasmSetup,
+      makeWasmSetup(bufferManager),
       undefined,
       wasmCalculateResult // Usar la función actualizada
     );
     results[size].wasm = wasmResult.duration;
+
+    // --- Benchmark WASM con plan precompilado (updateMatrix + execute) ---
+    type PlanExecArgs = [WasmTransformPlan, Matrix3x3, WasmBufferManager];
+    const planSetup = async (): Promise<PlanExecArgs | { error: string }> => {
+      try {
+        const inputBuffer = await bufferManager.getInputBuffer(numPoints);
+        await bufferManager.getOutputBuffer(numPoints);
+        inputBuffer.view.set(points);
+        const plan = bufferManager.createTransformPlan(
+          matrix_combined,
+          numPoints
+        );
+        return [plan, matrix_combined, bufferManager];
+      } catch (e) {
+        return { error: e instanceof Error ? e.message : String(e) };
+      }
+    };
+    const planResult = await runBenchmark<PlanExecArgs, void>(
+      (plan: WasmTransformPlan, matrix: Matrix3x3) => {
+        plan.updateMatrix(matrix);
+        plan.execute();
+      },
+      `WASM Plan Batch (${size})`,
+      NUM_ITERATIONS,
+      planSetup,
+      ([plan]) => plan.dispose(),
+      (_res, [, , manager]) => {
+        const outputView = manager.getOutputView(numPoints);
+        return outputView && isValidNumber(outputView[0])
+          ? outputView[0]
+          : "InvalidResultPlan";
+      }
+    );
+    results[size].plan = planResult.duration;
+
+    // --- Benchmark WASM multihilo (mismo kernel repartido en chunks) ---
+    if (mtManager) {
+      const mtResult = await runBenchmark<WasmExecArgs, void>(
+        wasmExecutionFn,
+        `WASM MT Managed Batch (${size})`,
+        NUM_ITERATIONS,
+        makeWasmSetup(mtManager),
+        undefined,
+        wasmCalculateResult
+      );
+      results[size].wasmMt = mtResult.duration;
+    }
   } // Fin bucle BATCH_SIZES
 
+  // --- Escalado por hilos: mismo binario, solo cambia el pool de workers ---
+  const scaling: { size: number; threads: number; duration: number }[] = [];
+  if (mtManager) {
+    const manager = mtManager;
+    const mtModule = await loadWasmModule("threads");
+    for (const size of SCALING_SIZES) {
+      for (const workers of SCALING_WORKERS) {
+        mtModule.setTransformThreads(workers);
+        const result = await runBenchmark<[WasmBufferManager, number], void>(
+          async (m: WasmBufferManager, n: number) => {
+            await m.transformPointsBatchManaged(matrix_combined, n);
+          },
+          `WASM Thread Scaling (${size} points, ${workers + 1} threads)`,
+          NUM_ITERATIONS,
+          async () => {
+            const inputBuffer = await manager.getInputBuffer(size);
+            await manager.getOutputBuffer(size);
+            inputBuffer.view.set(pointsData[size]);
+            return [manager, size];
+          }
+        );
+        scaling.push({ size, threads: workers + 1, duration: result.duration });
+      }
+    }
+    mtModule.setTransformThreads(mtThreads - 1);
+  }
+
   // Liberar buffers gestionados
   console.log("\nCleaning up managed WASM buffers...");
   await bufferManager.cleanup();
+  if (mtManager) await mtManager.cleanup();
 
   // Resumen
   console.log(
     "\n--- Benchmark Summary (Transform Points Batch - Managed Buffers) ---"
   );
-  console.log("Batch Size | JS Time (ms) | WASM Time (ms) | WASM Speedup");
-  console.log("-----------|--------------|----------------|-------------");
+  console.log(
+    `Batch Size | JS Time (ms) | WASM Time (ms) | WASM Speedup | Plan Time (ms) | MT Time (ms) | WASM/MT time (${mtThreads || "no"} threads)`
+  );
+  console.log(
+    "-----------|--------------|----------------|--------------|----------------|--------------|-----------"
+  );
   for (const size of BATCH_SIZES) {
     const jsT = results[size].js;
     const wasmT = results[size].wasm;
+    const mtT = results[size].wasmMt;
+    const planT = results[size].plan;
     let speedup = "N/A";
     if (jsT > 0 && wasmT > 0) {
       const factor = jsT / wasmT;
       speedup = `${factor.toFixed(1)}x`;
     } else if (wasmT <= 0) speedup = "FAILED/Inf";
+    const mtTime = mtT > 0 ? mtT.toFixed(2) : "N/A";
+    const planTime = planT > 0 ? planT.toFixed(2) : "N/A";
+    const mtRatio = mtT > 0 && wasmT > 0 ? (wasmT / mtT).toFixed(2) : "N/A";
+    console.log(
+      `${size.toString().padStart(10)} | ${jsT.toFixed(2).padStart(12)} | ${wasmT.toFixed(2).padStart(14)} | ${speedup.padStart(12)} | ${planTime.padStart(14)} | ${mtTime.padStart(12)} | ${mtRatio.padStart(9)}`
+    );
+  }
+
+  // Speedup medido frente a 1 hilo de la misma build (no frente a la simd)
+  console.log(
+    `\n--- Thread Scaling (threads build, ${NUM_ITERATIONS} iterations, ${os.cpus().length} CPUs) ---`
+  );
+  if (!scaling.length) {
+    console.log("Not run: build with `pnpm build:wasm:threads` first.");
+  } else {
     console.log(
-      `${size.toString().padStart(10)} | ${jsT.toFixed(2).padStart(12)} | ${wasmT.toFixed(2).padStart(14)} | ${speedup.padStart(11)}`
+      "    Points | Threads | Time/op (ms) | Mpoints/s | vs 1 thread"
     );
+    console.log(
+      "-----------|---------|--------------|-----------|------------"
+    );
+    for (const row of scaling) {
+      const serial = scaling.find(
+        (other) => other.size === row.size && other.threads === 1
+      )!;
+      const msPerOp = row.duration / NUM_ITERATIONS;
+      const ok = row.duration > 0;
+      const time = ok ? msPerOp.toFixed(4) : "FAILED";
+      const mpts = ok ? (row.size / msPerOp / 1000).toFixed(1) : "N/A";
+      const vsSerial =
+        ok && serial.duration > 0
+          ? `${(serial.duration / row.duration).toFixed(2)}x`
+          : "N/A";
+      console.log(
+        `${row.size.toString().padStart(10)} | ${row.threads.toString().padStart(7)} | ${time.padStart(12)} | ${mpts.padStart(9)} | ${vsSerial.padStart(11)}`
+      );
+    }
   }
 
   await cleanupWasm(); // Limpieza final estática del loader
+  // Los workers de pthreads (worker_threads en Node) mantienen vivo el proceso
+  process.exit(0);
 }
 
 main().catch((error) => {
@@ -0,0 +1,118 @@
+// benchmarks/transformProgram.bench.ts
+import { performance } from "perf_hooks";
+import {
+  PerspectiveCommand,
+  RotateCommand,
+  ScaleCommand,
+  SkewCommand,
+  TranslateCommand,
+} from "../src/core/commands";
+import type { TransformCommand } from "../src/core/commands";
+import { MatrixUtils } from "../src/core/matrix/MatrixUtils";
+import { WasmBufferManager } from "../src/core/wasm/WasmBufferManager";
+import { cleanupWasm } from "../src/core/wasm/wasm-loader";
+
+// --- Configuración ---
+// Muchos documentos, cada uno con su historial de comandos, recompuestos a la vez
+const DOCUMENT_COUNTS = [1000, 10000, 50000];
+const COMMANDS_PER_DOCUMENT = 8;
+const NUM_FRAMES = 20;
+const WARMUP_FRAMES = 3;
+
+function buildHistory(
+  doc: number,
+  perspective: PerspectiveCommand
+): TransformCommand[] {
+  const commands: TransformCommand[] = [];
+  for (let i = 0; i < COMMANDS_PER_DOCUMENT; i++) {
+    switch ((doc + i) % 4) {
+      case 0:
+        commands.push(new TranslateCommand(doc % 50, i * 2));
+        break;
+      case 1:
+        commands.push(new RotateCommand(0.1 * i, { x: 50, y: 50 }));
+        break;
+      case 2:
+        commands.push(new ScaleCommand(1 + 0.01 * i, 0.9));
+        break;
+      default:
+        commands.push(new SkewCommand(0.05, -0.02));
+    }
+  }
+  // Uno de cada cuatro documentos termina con una corrección de perspectiva
+  if (doc % 4 === 0) commands.push(perspective);
+  return commands;
+}
+
+/** Milisegundos por frame de `frame` repetido NUM_FRAMES veces. */
+function measure(frame: () => void): number {
+  for (let i = 0; i < WARMUP_FRAMES; i++) frame();
+  const start = performance.now();
+  for (let i = 0; i < NUM_FRAMES; i++) frame();
+  return (performance.now() - start) / NUM_FRAMES;
+}
+
+async function main() {
+  const manager = new WasmBufferManager();
+  await manager.initialize();
+  const perspective = await PerspectiveCommand.create(
+    [
+      { x: 0, y: 0 },
+      { x: 100, y: 0 },
+      { x: 100, y: 100 },
+      { x: 0, y: 100 },
+    ],
+    [
+      { x: 5, y: 3 },
+      { x: 96, y: 1 },
+      { x: 104, y: 97 },
+      { x: 2, y: 103 },
+    ]
+  );
+
+  const rows: Record<string, Record<string, string>> = {};
+  for (const count of DOCUMENT_COUNTS) {
+    const histories = Array.from({ length: count }, (_, doc) =>
+      buildHistory(doc, perspective)
+    );
+    const program = manager.createTransformProgram({
+      maxWords: count * (COMMANDS_PER_DOCUMENT + 1) * 10,
+    });
+    let sink = 0;
+
+    // JS: MatrixUtils.combine por documento (una matriz nueva por comando)
+    const jsMs = measure(() => {
+      for (const commands of histories) {
+        sink += MatrixUtils.combine(commands)[6];
+      }
+    });
+    // WASM: codificar todos los historiales y plegarlos en una llamada
+    const encodeEvalMs = measure(() => {
+      program.reset();
+      for (const commands of histories) program.addSequence(commands);
+      sink += manager.evaluateTransformProgramManaged(program).view[6];
+    });
+    // Solo evaluar (historiales sin cambios, p. ej. tras cambiar de origen)
+    const evalMs = measure(() => {
+      sink += manager.evaluateTransformProgramManaged(program).view[6];
+    });
+    program.dispose();
+
+    rows[count.toLocaleString()] = {
+      "JS combine (ms)": jsMs.toFixed(2),
+      "WASM encode + eval (ms)": encodeEvalMs.toFixed(2),
+      "WASM eval only (ms)": evalMs.toFixed(3),
+      "Encode + eval speedup": `${(jsMs / encodeEvalMs).toFixed(1)}x`,
+    };
+    console.log(`(checksum ${count}: ${sink.toExponential(2)})`);
+  }
+  console.log(
+    `\n=== Command sequences folded to matrices, ${COMMANDS_PER_DOCUMENT} commands per document (${NUM_FRAMES} frames) ===`
+  );
+  console.table(rows);
+
+  await manager.cleanup();
+  await cleanupWasm();
+}
+
+main().catch(console.error);
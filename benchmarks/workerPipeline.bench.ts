@@ -0,0 +1,141 @@
+// benchmarks/workerPipeline.bench.ts
+import { performance } from "perf_hooks";
+import { MatrixUtils } from "../src/core/matrix/MatrixUtils";
+import { WasmBufferManager } from "../src/core/wasm/WasmBufferManager";
+import { WasmWorkerPipeline } from "../src/core/wasm/WasmWorkerPipeline";
+import { cleanupWasm } from "../src/core/wasm/wasm-loader";
+
+// --- Configuración ---
+// Bucle por frames como el de las demos: actualizar puntos, transformar, dibujar.
+// "Dibujar" se simula recorriendo la salida DRAW_PASSES veces.
+const NUM_FRAMES = 200;
+const WARMUP_FRAMES = 20;
+const BATCH_SIZES = [10000, 100000, 250000, 500000];
+const DRAW_PASSES = 4;
+
+interface FrameResult {
+  frameMs: number; // Tiempo medio por frame
+  latencyMs: number; // Desde que el frame tiene entrada hasta que hay salida
+  pointsPerSec: number;
+}
+
+function updatePoints(points: Float32Array, frame: number): void {
+  for (let i = 0; i < points.length; i++) points[i] = (i % 1000) + frame;
+}
+
+let drawSink = 0;
+function draw(points: Float32Array): void {
+  let acc = 0;
+  for (let pass = 0; pass < DRAW_PASSES; pass++) {
+    for (let i = 0; i < points.length; i++) acc += points[i];
+  }
+  drawSink += acc;
+}
+
+function matrixFor(frame: number) {
+  return MatrixUtils.multiply(
+    MatrixUtils.translation(frame, -frame),
+    MatrixUtils.rotation(frame * 0.01)
+  );
+}
+
+/** Camino síncrono: el frame espera la transformación en el hilo principal. */
+async function runSync(
+  manager: WasmBufferManager,
+  numPoints: number
+): Promise<FrameResult> {
+  const input = await manager.getInputBuffer(numPoints);
+  await manager.getOutputBuffer(numPoints);
+  let latency = 0;
+  let start = 0;
+  for (let frame = -WARMUP_FRAMES; frame < NUM_FRAMES; frame++) {
+    if (frame === 0) {
+      start = performance.now();
+      latency = 0;
+    }
+    updatePoints(input.view, frame);
+    const t0 = performance.now();
+    await manager.transformPointsBatchManaged(matrixFor(frame), numPoints);
+    const output = manager.getOutputView(numPoints)!;
+    latency += performance.now() - t0;
+    draw(output);
+  }
+  const total = performance.now() - start;
+  return {
+    frameMs: total / NUM_FRAMES,
+    latencyMs: latency / NUM_FRAMES,
+    pointsPerSec: (numPoints * NUM_FRAMES) / (total / 1000),
+  };
+}
+
+/** Worker con doble buffer: el frame N+1 se transforma mientras se dibuja el N. */
+async function runPipelined(
+  pipeline: WasmWorkerPipeline,
+  numPoints: number
+): Promise<FrameResult> {
+  const submittedAt = new Map<number, number>();
+  let latency = 0;
+  let start = 0;
+  let previous = 0;
+  const finish = async (job: number) => {
+    const output = await pipeline.result(job);
+    latency += performance.now() - submittedAt.get(job)!;
+    submittedAt.delete(job);
+    draw(output);
+  };
+  for (let frame = -WARMUP_FRAMES; frame < NUM_FRAMES; frame++) {
+    if (frame === 0) {
+      if (previous) await finish(previous);
+      previous = 0;
+      start = performance.now();
+      latency = 0;
+    }
+    updatePoints(pipeline.nextInput(numPoints), frame);
+    const job = pipeline.submit(matrixFor(frame), numPoints);
+    submittedAt.set(job, performance.now());
+    if (previous) await finish(previous);
+    previous = job;
+  }
+  await finish(previous);
+  const total = performance.now() - start;
+  return {
+    frameMs: total / NUM_FRAMES,
+    latencyMs: latency / NUM_FRAMES,
+    pointsPerSec: (numPoints * NUM_FRAMES) / (total / 1000),
+  };
+}
+
+async function main() {
+  const manager = new WasmBufferManager();
+  await manager.initialize();
+  const pipeline = await WasmWorkerPipeline.create({
+    maxPoints: Math.max(...BATCH_SIZES),
+  });
+
+  const rows: Record<string, Record<string, string>> = {};
+  for (const numPoints of BATCH_SIZES) {
+    console.log(`\n--- ${numPoints.toLocaleString()} points ---`);
+    const sync = await runSync(manager, numPoints);
+    const piped = await runPipelined(pipeline, numPoints);
+    rows[numPoints.toLocaleString()] = {
+      "Sync frame (ms)": sync.frameMs.toFixed(3),
+      "Worker frame (ms)": piped.frameMs.toFixed(3),
+      "Sync latency (ms)": sync.latencyMs.toFixed(3),
+      "Worker latency (ms)": piped.latencyMs.toFixed(3),
+      "Sync Mpts/s": (sync.pointsPerSec / 1e6).toFixed(1),
+      "Worker Mpts/s": (piped.pointsPerSec / 1e6).toFixed(1),
+      Speedup: `${(sync.frameMs / piped.frameMs).toFixed(2)}x`,
+    };
+  }
+  console.log(
+    `\n=== Frame loop: sync await vs worker pipeline (${NUM_FRAMES} frames, draw = ${DRAW_PASSES} passes) ===`
+  );
+  console.table(rows);
+  console.log(`(draw checksum: ${drawSink.toExponential(2)})`);
+
+  pipeline.dispose();
+  await manager.cleanup();
+  await cleanupWasm();
+}
+
+main().catch(console.error);
@@ -0,0 +1,344 @@
+// core_cpp/src/buffer_pool.h
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// --- Pool de Buffers con Handles ---
+// Dos asignadores detrás de handles enteros para que JS no guarde punteros crudos:
+// - Pool por clases de tamaño (potencias de 2): los bloques liberados vuelven a una
+//   lista libre de su clase y se reutilizan sin pasar por malloc. Redondear a la
+//   siguiente potencia da el crecimiento geométrico al redimensionar.
+// - Arena por frame (bump): alocaciones temporales que se liberan todas juntas con
+//   reset_arena(). Si un frame desborda el chunk, se añade otro del doble de tamaño y en el
+//   reset se funden en uno, así que en régimen estable no hay malloc por frame.
+// No es thread-safe: se usa solo desde el hilo de JS.
+
+const int POOL_MIN_CLASS_SHIFT = 6;  // 64 bytes
+const int POOL_MAX_CLASS_SHIFT = 30; // 1 GiB
+const size_t POOL_ALIGNMENT = 16;    // v128 y Float64Array
+const size_t ARENA_MIN_CHUNK_BYTES = 64 * 1024;
+
+// handle = (generación << POOL_HANDLE_INDEX_BITS) | (índice + 1); 0 = inválido.
+// La generación detecta handles liberados (o de un frame anterior).
+const int POOL_HANDLE_INDEX_BITS = 20;
+const uint32_t POOL_HANDLE_INDEX_MASK = (1u << POOL_HANDLE_INDEX_BITS) - 1;
+const uint32_t POOL_HANDLE_GENERATION_MASK = (1u << (31 - POOL_HANDLE_INDEX_BITS)) - 1;
+
+/** Contadores para medir churn y fragmentación (ver `pool_stats`). */
+struct BufferPoolStats
+{
+    uint32_t live_handles;      // Handles vivos (pool + arena)
+    uint32_t pooled_bytes;      // Bytes en uso por handles del pool
+    uint32_t cached_bytes;      // Bytes en listas libres, listos para reutilizar
+    uint32_t arena_capacity;    // Bytes reservados por la arena
+    uint32_t arena_used;        // Bytes usados por la arena en el frame actual
+    uint32_t system_allocs;     // Llamadas acumuladas a malloc del sistema
+    uint32_t system_frees;      // Llamadas acumuladas a free del sistema
+    uint32_t reuse_hits;        // Alocaciones servidas desde una lista libre
+};
+
+class BufferPool
+{
+public:
+    static BufferPool &instance()
+    {
+        static BufferPool pool;
+        return pool;
+    }
+
+    /** Aloca al menos `bytes` del pool. Devuelve el handle o 0 si falla. */
+    int32_t alloc(size_t bytes)
+    {
+        const int cls = size_class(bytes);
+        if (cls < 0)
+            return 0;
+        void *ptr = take_block(cls);
+        if (!ptr)
+            return 0;
+        const int32_t handle = make_handle(ptr, class_bytes(cls), cls, Kind::Pool);
+        if (!handle)
+        {
+            // Sin entradas libres: el bloque vuelve a su lista
+            free_lists_[cls].push_back(ptr);
+            cached_bytes_ += class_bytes(cls);
+            pooled_bytes_ -= class_bytes(cls);
+        }
+        return handle;
+    }
+
+    /**
+     * Garantiza `bytes` de capacidad para el handle, que no cambia. Si la clase
+     * actual no basta se mueve a un bloque mayor (copiando el contenido si
+     * `preserve`). Devuelve false si el handle no es válido o no hay memoria.
+     */
+    bool realloc(int32_t handle, size_t bytes, bool preserve)
+    {
+        Entry *e = lookup(handle);
+        if (!e || e->kind != Kind::Pool)
+            return false;
+        if (bytes <= e->capacity)
+            return true;
+        const int cls = size_class(bytes);
+        if (cls < 0)
+            return false;
+        void *ptr = take_block(cls);
+        if (!ptr)
+            return false;
+        if (preserve)
+            std::memcpy(ptr, e->ptr, e->capacity);
+        free_lists_[e->size_class].push_back(e->ptr);
+        cached_bytes_ += e->capacity;
+        pooled_bytes_ -= e->capacity;
+        e->ptr = ptr;
+        e->capacity = (uint32_t)class_bytes(cls);
+        e->size_class = (uint8_t)cls;
+        return true;
+    }
+
+    /** Devuelve el bloque a la lista libre de su clase. Ignora handles inválidos. */
+    void free(int32_t handle)
+    {
+        Entry *e = lookup(handle);
+        if (!e || e->kind != Kind::Pool)
+            return;
+        free_lists_[e->size_class].push_back(e->ptr);
+        cached_bytes_ += e->capacity;
+        pooled_bytes_ -= e->capacity;
+        release_entry(index_of(handle));
+    }
+
+    /** Alocación temporal en la arena; el handle caduca en el siguiente `reset_arena`. */
+    int32_t arena_alloc(size_t bytes)
+    {
+        const size_t aligned = align_up(std::max<size_t>(bytes, 1));
+        if (chunks_.empty() || chunks_.back().used + aligned > chunks_.back().capacity)
+        {
+            const size_t last = chunks_.empty() ? 0 : chunks_.back().capacity;
+            if (!add_chunk(std::max({aligned, last * 2, ARENA_MIN_CHUNK_BYTES})))
+                return 0;
+        }
+        Chunk &chunk = chunks_.back();
+        const int32_t handle = make_handle(chunk.base + chunk.used, aligned, 0, Kind::Arena);
+        if (!handle)
+            return 0;
+        // Solo se consume la arena cuando el handle existe
+        chunk.used += aligned;
+        arena_handles_.push_back(handle);
+        return handle;
+    }
+
+    /** Invalida todos los handles de la arena y funde sus chunks en uno. */
+    void reset_arena()
+    {
+        for (int32_t handle : arena_handles_)
+            release_entry(index_of(handle));
+        arena_handles_.clear();
+        if (chunks_.size() > 1)
+        {
+            size_t total = 0;
+            for (Chunk &chunk : chunks_)
+            {
+                total += chunk.capacity;
+                system_free(chunk.base);
+            }
+            chunks_.clear();
+            add_chunk(total);
+        }
+        for (Chunk &chunk : chunks_)
+            chunk.used = 0;
+    }
+
+    /** Libera al sistema los bloques cacheados en las listas libres. */
+    void trim()
+    {
+        for (std::vector<void *> &list : free_lists_)
+        {
+            for (void *ptr : list)
+                system_free(ptr);
+            list.clear();
+        }
+        cached_bytes_ = 0;
+    }
+
+    void *ptr(int32_t handle)
+    {
+        Entry *e = lookup(handle);
+        return e ? e->ptr : nullptr;
+    }
+
+    uint32_t capacity(int32_t handle)
+    {
+        Entry *e = lookup(handle);
+        return e ? e->capacity : 0;
+    }
+
+    void stats(BufferPoolStats &out) const
+    {
+        out.live_handles = (uint32_t)(entries_.size() - free_entries_.size());
+        out.pooled_bytes = (uint32_t)pooled_bytes_;
+        out.cached_bytes = (uint32_t)cached_bytes_;
+        out.arena_capacity = 0;
+        out.arena_used = 0;
+        for (const Chunk &chunk : chunks_)
+        {
+            out.arena_capacity += (uint32_t)chunk.capacity;
+            out.arena_used += (uint32_t)chunk.used;
+        }
+        out.system_allocs = system_allocs_;
+        out.system_frees = system_frees_;
+        out.reuse_hits = reuse_hits_;
+    }
+
+private:
+    enum class Kind : uint8_t
+    {
+        Free = 0,
+        Pool = 1,
+        Arena = 2
+    };
+
+    struct Entry
+    {
+        void *ptr;
+        uint32_t capacity;
+        uint32_t generation;
+        uint8_t size_class;
+        Kind kind;
+    };
+
+    struct Chunk
+    {
+        char *base;
+        size_t capacity;
+        size_t used;
+    };
+
+    static size_t align_up(size_t bytes)
+    {
+        return (bytes + POOL_ALIGNMENT - 1) & ~(POOL_ALIGNMENT - 1);
+    }
+
+    static size_t class_bytes(int cls)
+    {
+        return (size_t)1 << (cls + POOL_MIN_CLASS_SHIFT);
+    }
+
+    // Clase cuya potencia de 2 cubre `bytes`, o -1 si excede la mayor
+    static int size_class(size_t bytes)
+    {
+        int shift = POOL_MIN_CLASS_SHIFT;
+        while (((size_t)1 << shift) < bytes)
+        {
+            if (++shift > POOL_MAX_CLASS_SHIFT)
+                return -1;
+        }
+        return shift - POOL_MIN_CLASS_SHIFT;
+    }
+
+    static uint32_t index_of(int32_t handle)
+    {
+        return ((uint32_t)handle & POOL_HANDLE_INDEX_MASK) - 1;
+    }
+
+    void *system_alloc(size_t bytes)
+    {
+        void *ptr = std::aligned_alloc(POOL_ALIGNMENT, align_up(bytes));
+        if (ptr)
+            ++system_allocs_;
+        return ptr;
+    }
+
+    void system_free(void *ptr)
+    {
+        std::free(ptr);
+        ++system_frees_;
+    }
+
+    void *take_block(int cls)
+    {
+        std::vector<void *> &list = free_lists_[cls];
+        if (!list.empty())
+        {
+            void *ptr = list.back();
+            list.pop_back();
+            cached_bytes_ -= class_bytes(cls);
+            pooled_bytes_ += class_bytes(cls);
+            ++reuse_hits_;
+            return ptr;
+        }
+        void *ptr = system_alloc(class_bytes(cls));
+        if (ptr)
+            pooled_bytes_ += class_bytes(cls);
+        return ptr;
+    }
+
+    bool add_chunk(size_t bytes)
+    {
+        char *base = (char *)system_alloc(bytes);
+        if (!base)
+            return false;
+        chunks_.push_back({base, align_up(bytes), 0});
+        return true;
+    }
+
+    int32_t make_handle(void *ptr, size_t capacity, int cls, Kind kind)
+    {
+        uint32_t index;
+        if (!free_entries_.empty())
+        {
+            index = free_entries_.back();
+            free_entries_.pop_back();
+        }
+        else
+        {
+            if (entries_.size() >= POOL_HANDLE_INDEX_MASK)
+                return 0;
+            index = (uint32_t)entries_.size();
+            entries_.push_back({nullptr, 0, 1, 0, Kind::Free});
+        }
+        Entry &e = entries_[index];
+        e.ptr = ptr;
+        e.capacity = (uint32_t)capacity;
+        e.size_class = (uint8_t)cls;
+        e.kind = kind;
+        return (int32_t)((e.generation << POOL_HANDLE_INDEX_BITS) | (index + 1));
+    }
+
+    void release_entry(uint32_t index)
+    {
+        Entry &e = entries_[index];
+        e.ptr = nullptr;
+        e.capacity = 0;
+        e.kind = Kind::Free;
+        // Nunca 0, para que ningún handle válido valga 0
+        e.generation = e.generation >= POOL_HANDLE_GENERATION_MASK ? 1 : e.generation + 1;
+        free_entries_.push_back(index);
+    }
+
+    Entry *lookup(int32_t handle)
+    {
+        if (handle <= 0)
+            return nullptr;
+        const uint32_t index = index_of(handle);
+        if (index >= entries_.size())
+            return nullptr;
+        Entry &e = entries_[index];
+        const uint32_t generation = (uint32_t)handle >> POOL_HANDLE_INDEX_BITS;
+        return e.kind != Kind::Free && e.generation == generation ? &e : nullptr;
+    }
+
+    std::vector<Entry> entries_;
+    std::vector<uint32_t> free_entries_;
+    std::vector<void *> free_lists_[POOL_MAX_CLASS_SHIFT - POOL_MIN_CLASS_SHIFT + 1];
+    std::vector<Chunk> chunks_;
+    std::vector<int32_t> arena_handles_;
+    size_t pooled_bytes_ = 0;
+    size_t cached_bytes_ = 0;
+    uint32_t system_allocs_ = 0;
+    uint32_t system_frees_ = 0;
+    uint32_t reuse_hits_ = 0;
+};
@@ -0,0 +1,48 @@
+// core_cpp/src/id_registry.h
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * Registro de objetos expuestos a JS por id entero (planes, jerarquías, animaciones).
+ * id = índice + 1, 0 = inválido. Los huecos de los objetos destruidos se reutilizan,
+ * así que un id liberado puede volver a asignarse a un objeto nuevo.
+ */
+template <typename T>
+class IdRegistry
+{
+public:
+    /** Registra el objeto. @returns Su id (> 0). */
+    int32_t add(std::unique_ptr<T> object)
+    {
+        for (size_t i = 0; i < objects_.size(); ++i)
+        {
+            if (!objects_[i])
+            {
+                objects_[i] = std::move(object);
+                return (int32_t)i + 1;
+            }
+        }
+        objects_.push_back(std::move(object));
+        return (int32_t)objects_.size();
+    }
+
+    /** @returns El objeto del id, o nullptr si no es válido o ya se destruyó. */
+    T *find(int32_t id) const
+    {
+        return id > 0 && id <= (int32_t)objects_.size() ? objects_[id - 1].get() : nullptr;
+    }
+
+    /** Destruye el objeto del id (ids no válidos se ignoran). */
+    void destroy(int32_t id)
+    {
+        if (find(id))
+            objects_[id - 1].reset();
+    }
+
+private:
+    std::vector<std::unique_ptr<T>> objects_;
+};
@@ -0,0 +1,236 @@
+// core_cpp/src/keyframe_animation.h
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "matrix_batch.h"
+#include "matrix_types.h"
+
+// --- Animación por Keyframes ---
+// Cada keyframe es una matriz afín descompuesta al añadirla en traslación, rotación y
+// estiramiento simétrico (descomposición polar A = R * S de la parte lineal, vía SVD
+// de Eigen: R = U V^T, S = V Σ V^T). S = [[sx, k], [k, sy]] recoge escala y skew.
+// Interpolar (t, θ, S) componente a componente evita el "colapso" de interpolar los
+// coeficientes de la matriz (una rotación de 180° no pasa por la matriz nula).
+// Las pistas se guardan en SoA compacto: un array por parámetro con los keyframes de
+// todas las pistas seguidos y, por pista, [primer keyframe, número de keyframes].
+// Los ángulos se desenrollan al añadir la pista, así que θ interpola por el arco corto.
+// evaluate_animation evalúa todas las pistas para un tiempo en una llamada y escribe
+// una matriz por pista en un array AoS o SoA (MatrixBatchLayout), directamente usable
+// por transformPointsInstanced o por las operaciones por lotes de matrix_batch.h.
+
+// Curva de la transición desde un keyframe al siguiente (la guarda el keyframe inicial)
+enum class KeyframeEasing : uint8_t
+{
+    Linear = 0,
+    Step = 1,     // Mantiene el keyframe inicial hasta el siguiente
+    EaseIn = 2,   // u^2
+    EaseOut = 3,  // 1 - (1 - u)^2
+    EaseInOut = 4 // smoothstep: 3u^2 - 2u^3
+};
+
+const uint8_t KEYFRAME_EASING_COUNT = 5;
+
+// Parámetros de una matriz afín: M = T(tx, ty) * R(angle) * [[sx, skew], [skew, sy]]
+struct TransformParams
+{
+    float tx, ty, angle, sx, sy, skew;
+};
+
+struct KeyframeAnimation
+{
+    // Un elemento por keyframe (todas las pistas seguidas)
+    std::vector<float> time, tx, ty, angle, sx, sy, skew;
+    std::vector<uint8_t> easing;
+    // Un elemento por pista
+    std::vector<int32_t> track_start, track_count;
+
+    int num_tracks() const { return (int)track_start.size(); }
+};
+
+/**
+ * Descompone una matriz afín column-major (polar de la parte lineal). Con reflexión
+ * (det < 0) el signo va al valor singular menor de S, así que R es siempre una rotación.
+ * @returns false si la matriz tiene perspectiva o coeficientes no finitos.
+ */
+inline bool decompose_transform(const float *m, TransformParams &out)
+{
+    for (int k = 0; k < 9; ++k)
+    {
+        if (!std::isfinite(m[k]))
+            return false;
+    }
+    if (std::abs(m[2]) >= MATRIX_CLASSIFY_EPSILON || std::abs(m[5]) >= MATRIX_CLASSIFY_EPSILON ||
+        std::abs(m[8] - 1.0f) >= MATRIX_CLASSIFY_EPSILON)
+        return false;
+
+    Eigen::Matrix2f a;
+    a << m[0], m[3], m[1], m[4];
+    Eigen::JacobiSVD<Eigen::Matrix2f> svd(a, Eigen::ComputeFullU | Eigen::ComputeFullV);
+    Eigen::Matrix2f u = svd.matrixU();
+    Eigen::Vector2f sigma = svd.singularValues();
+    const Eigen::Matrix2f &v = svd.matrixV();
+    if ((u * v.transpose()).determinant() < 0.0f)
+    {
+        u.col(1) *= -1.0f;
+        sigma(1) = -sigma(1);
+    }
+    const Eigen::Matrix2f r = u * v.transpose();
+    const Eigen::Matrix2f s = v * sigma.asDiagonal() * v.transpose();
+
+    out.tx = m[6];
+    out.ty = m[7];
+    out.angle = std::atan2(r(1, 0), r(0, 0));
+    out.sx = s(0, 0);
+    out.sy = s(1, 1);
+    out.skew = 0.5f * (s(0, 1) + s(1, 0));
+    return true;
+}
+
+/** Matriz column-major de los parámetros (inversa de decompose_transform). */
+inline void compose_transform(const TransformParams &p, float *m)
+{
+    const float c = std::cos(p.angle);
+    const float s = std::sin(p.angle);
+    m[0] = c * p.sx - s * p.skew;
+    m[1] = s * p.sx + c * p.skew;
+    m[2] = 0.0f;
+    m[3] = c * p.skew - s * p.sy;
+    m[4] = s * p.skew + c * p.sy;
+    m[5] = 0.0f;
+    m[6] = p.tx;
+    m[7] = p.ty;
+    m[8] = 1.0f;
+}
+
+inline float apply_easing(KeyframeEasing easing, float u)
+{
+    switch (easing)
+    {
+    case KeyframeEasing::Step:
+        return 0.0f;
+    case KeyframeEasing::EaseIn:
+        return u * u;
+    case KeyframeEasing::EaseOut:
+        return 1.0f - (1.0f - u) * (1.0f - u);
+    case KeyframeEasing::EaseInOut:
+        return u * u * (3.0f - 2.0f * u);
+    case KeyframeEasing::Linear:
+    default:
+        return u;
+    }
+}
+
+/**
+ * Añade una pista con num_keys keyframes (matrices AoS column-major, tiempos
+ * estrictamente crecientes y una curva por keyframe; la del último no se usa).
+ * @returns Índice de la pista, -1 si num_keys, los tiempos o las curvas no son
+ *          válidos, o -2 si alguna matriz no es afín. En error no cambia nada.
+ */
+inline int add_animation_track(KeyframeAnimation &anim, const float *matrices, const float *times,
+                               const uint8_t *easings, int num_keys)
+{
+    if (num_keys <= 0)
+        return -1;
+    for (int i = 0; i < num_keys; ++i)
+    {
+        if (!std::isfinite(times[i]) || (i > 0 && !(times[i] > times[i - 1])) || easings[i] >= KEYFRAME_EASING_COUNT)
+            return -1;
+    }
+    std::vector<TransformParams> params((size_t)num_keys);
+    for (int i = 0; i < num_keys; ++i)
+    {
+        if (!decompose_transform(matrices + (size_t)i * 9, params[i]))
+            return -2;
+        // Desenrolla θ respecto al keyframe anterior: la diferencia queda en [-π, π]
+        if (i > 0)
+        {
+            const float prev = params[i - 1].angle;
+            const float two_pi = 6.28318530717958647692f;
+            params[i].angle = prev + std::remainder(params[i].angle - prev, two_pi);
+        }
+    }
+
+    anim.track_start.push_back((int32_t)anim.time.size());
+    anim.track_count.push_back(num_keys);
+    for (int i = 0; i < num_keys; ++i)
+    {
+        anim.time.push_back(times[i]);
+        anim.tx.push_back(params[i].tx);
+        anim.ty.push_back(params[i].ty);
+        anim.angle.push_back(params[i].angle);
+        anim.sx.push_back(params[i].sx);
+        anim.sy.push_back(params[i].sy);
+        anim.skew.push_back(params[i].skew);
+        anim.easing.push_back(easings[i]);
+    }
+    return anim.num_tracks() - 1;
+}
+
+// Parámetros de la pista en el tiempo t (fuera del rango se fija el extremo)
+inline void evaluate_animation_track(const KeyframeAnimation &anim, int track, float t, TransformParams &out)
+{
+    const int32_t start = anim.track_start[track];
+    const int32_t count = anim.track_count[track];
+    const float *time = anim.time.data() + start;
+
+    // Último keyframe con time <= t (búsqueda binaria); antes del primero, el primero
+    int32_t k = 0;
+    if (t >= time[count - 1])
+        k = count - 1;
+    else if (t > time[0])
+    {
+        int32_t lo = 0, hi = count - 1; // time[lo] <= t < time[hi]
+        while (hi - lo > 1)
+        {
+            const int32_t mid = (lo + hi) / 2;
+            if (time[mid] <= t)
+                lo = mid;
+            else
+                hi = mid;
+        }
+        k = lo;
+    }
+
+    const size_t i = (size_t)start + k;
+    float w = 0.0f;
+    if (k < count - 1 && t > time[k])
+    {
+        const float u = (t - time[k]) / (time[k + 1] - time[k]);
+        w = apply_easing((KeyframeEasing)anim.easing[i], u);
+    }
+    const size_t j = w > 0.0f ? i + 1 : i;
+    out.tx = anim.tx[i] + (anim.tx[j] - anim.tx[i]) * w;
+    out.ty = anim.ty[i] + (anim.ty[j] - anim.ty[i]) * w;
+    out.angle = anim.angle[i] + (anim.angle[j] - anim.angle[i]) * w;
+    out.sx = anim.sx[i] + (anim.sx[j] - anim.sx[i]) * w;
+    out.sy = anim.sy[i] + (anim.sy[j] - anim.sy[i]) * w;
+    out.skew = anim.skew[i] + (anim.skew[j] - anim.skew[i]) * w;
+}
+
+/**
+ * Evalúa todas las pistas en el tiempo t y escribe la matriz de la pista i en la
+ * posición i de out (num_tracks matrices en el layout dado).
+ * @returns Número de pistas evaluadas.
+ */
+inline int evaluate_animation(const KeyframeAnimation &anim, float t, float *out, MatrixBatchLayout layout)
+{
+    const int n = anim.num_tracks();
+    TransformParams params;
+    float m[9];
+    for (int track = 0; track < n; ++track)
+    {
+        evaluate_animation_track(anim, track, t, params);
+        if (layout == MatrixBatchLayout::AoS)
+        {
+            compose_transform(params, out + (size_t)track * 9);
+            continue;
+        }
+        compose_transform(params, m);
+        for (int k = 0; k < 9; ++k)
+            out[(size_t)k * n + track] = m[k];
+    }
+    return n;
+}
@@ -0,0 +1,381 @@
+// core_cpp/src/matrix_batch.h
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include "simd_compat.h"
+
+#include "matrix_types.h"
+
+// --- Operaciones 3x3 por Lotes ---
+// Producto, inversa y determinante de arrays de matrices 3x3.
+
+// --- Producto por Lotes ---
+// out[i] = a[i] * b[i] (o a[0] * b[i] con una sola A) para arrays de matrices
+// column-major. Cada v128 lleva el mismo coeficiente de 4 matrices distintas, así
+// que el producto de 4 pares son 27 mul + 18 add vectoriales sin shuffles.
+// Layouts:
+// - AoS: 9 floats contiguos por matriz (Matrix3x3 de JS). Cada bloque de 4 matrices
+//        se traspone a lanes con shuffles al cargar y se deshace al guardar.
+// - SoA: 9 planos de `count` floats; el plano k tiene el coeficiente k de todas las
+//        matrices. Carga y guarda directa.
+// Con una sola A sus coeficientes se replican una vez fuera del bucle.
+// out puede coincidir exactamente con a o b (cada bloque se lee antes de escribirse),
+// pero no solaparse parcialmente.
+
+enum class MatrixBatchLayout : int
+{
+    AoS = 0,
+    SoA = 1
+};
+
+// Los 9 coeficientes de 4 matrices: c[k] = coeficiente k de las matrices 0..3
+struct MatrixLanes
+{
+    v128_t c[9];
+};
+
+// out = a * b por lanes; o(c, r) = sum_k a(k, r) * b(c, k) en column-major
+inline void multiply_matrix_lanes(const MatrixLanes &a, const MatrixLanes &b, MatrixLanes &out)
+{
+    for (int col = 0; col < 3; ++col)
+    {
+        const v128_t b0 = b.c[col * 3], b1 = b.c[col * 3 + 1], b2 = b.c[col * 3 + 2];
+        for (int row = 0; row < 3; ++row)
+        {
+            v128_t sum = wasm_f32x4_mul(a.c[row], b0);
+            sum = wasm_f32x4_add(sum, wasm_f32x4_mul(a.c[3 + row], b1));
+            sum = wasm_f32x4_add(sum, wasm_f32x4_mul(a.c[6 + row], b2));
+            out.c[col * 3 + row] = sum;
+        }
+    }
+}
+
+// Misma suma que multiply_matrix_lanes para una matriz (residuo escalar)
+inline void multiply_matrix_scalar(const float *a, const float *b, float *out)
+{
+    float r[9];
+    for (int col = 0; col < 3; ++col)
+        for (int row = 0; row < 3; ++row)
+            r[col * 3 + row] = a[row] * b[col * 3] + a[3 + row] * b[col * 3 + 1] + a[6 + row] * b[col * 3 + 2];
+    for (int k = 0; k < 9; ++k)
+        out[k] = r[k];
+}
+
+// Traspuesta 4x4: las filas r0..r3 pasan a ser columnas
+inline void transpose4(v128_t &r0, v128_t &r1, v128_t &r2, v128_t &r3)
+{
+    const v128_t t0 = wasm_i32x4_shuffle(r0, r1, 0, 4, 1, 5);
+    const v128_t t1 = wasm_i32x4_shuffle(r2, r3, 0, 4, 1, 5);
+    const v128_t t2 = wasm_i32x4_shuffle(r0, r1, 2, 6, 3, 7);
+    const v128_t t3 = wasm_i32x4_shuffle(r2, r3, 2, 6, 3, 7);
+    r0 = wasm_i64x2_shuffle(t0, t1, 0, 2);
+    r1 = wasm_i64x2_shuffle(t0, t1, 1, 3);
+    r2 = wasm_i64x2_shuffle(t2, t3, 0, 2);
+    r3 = wasm_i64x2_shuffle(t2, t3, 1, 3);
+}
+
+// 4 matrices AoS consecutivas (36 floats) a lanes: coeficientes 0-3 y 4-7 con dos
+// trasposiciones 4x4, el 8 con un make
+inline void load_matrix_lanes_aos(const float *m, MatrixLanes &out)
+{
+    for (int half = 0; half < 8; half += 4)
+    {
+        v128_t r0 = wasm_v128_load(m + half);
+        v128_t r1 = wasm_v128_load(m + 9 + half);
+        v128_t r2 = wasm_v128_load(m + 18 + half);
+        v128_t r3 = wasm_v128_load(m + 27 + half);
+        transpose4(r0, r1, r2, r3);
+        out.c[half] = r0;
+        out.c[half + 1] = r1;
+        out.c[half + 2] = r2;
+        out.c[half + 3] = r3;
+    }
+    out.c[8] = wasm_f32x4_make(m[8], m[17], m[26], m[35]);
+}
+
+inline void store_matrix_lanes_aos(const MatrixLanes &lanes, float *m)
+{
+    for (int half = 0; half < 8; half += 4)
+    {
+        v128_t r0 = lanes.c[half], r1 = lanes.c[half + 1];
+        v128_t r2 = lanes.c[half + 2], r3 = lanes.c[half + 3];
+        transpose4(r0, r1, r2, r3);
+        wasm_v128_store(m + half, r0);
+        wasm_v128_store(m + 9 + half, r1);
+        wasm_v128_store(m + 18 + half, r2);
+        wasm_v128_store(m + 27 + half, r3);
+    }
+    m[8] = wasm_f32x4_extract_lane(lanes.c[8], 0);
+    m[17] = wasm_f32x4_extract_lane(lanes.c[8], 1);
+    m[26] = wasm_f32x4_extract_lane(lanes.c[8], 2);
+    m[35] = wasm_f32x4_extract_lane(lanes.c[8], 3);
+}
+
+inline void load_matrix_lanes_soa(const float *planes, int count, int i, MatrixLanes &out)
+{
+    for (int k = 0; k < 9; ++k)
+        out.c[k] = wasm_v128_load(planes + (size_t)k * count + i);
+}
+
+inline void store_matrix_lanes_soa(const MatrixLanes &lanes, float *planes, int count, int i)
+{
+    for (int k = 0; k < 9; ++k)
+        wasm_v128_store(planes + (size_t)k * count + i, lanes.c[k]);
+}
+
+inline void splat_matrix_lanes(const float *m, MatrixLanes &out)
+{
+    for (int k = 0; k < 9; ++k)
+        out.c[k] = wasm_f32x4_splat(m[k]);
+}
+
+/**
+ * out[i] = a[i] * b[i] para count matrices (a[0] * b[i] si shared_a).
+ * Con SoA y shared_a, `a` son los 9 floats de una sola matriz column-major.
+ */
+inline void multiply_matrices_batch_kernel(const float *a, bool shared_a, const float *b, float *out,
+                                           int count, MatrixBatchLayout layout)
+{
+    MatrixLanes la, lb, lo;
+    if (shared_a)
+        splat_matrix_lanes(a, la);
+
+    int i = 0;
+    if (layout == MatrixBatchLayout::AoS)
+    {
+        for (; i + 4 <= count; i += 4)
+        {
+            if (!shared_a)
+                load_matrix_lanes_aos(a + (size_t)i * 9, la);
+            load_matrix_lanes_aos(b + (size_t)i * 9, lb);
+            multiply_matrix_lanes(la, lb, lo);
+            store_matrix_lanes_aos(lo, out + (size_t)i * 9);
+        }
+        for (; i < count; ++i)
+            multiply_matrix_scalar(shared_a ? a : a + (size_t)i * 9, b + (size_t)i * 9, out + (size_t)i * 9);
+        return;
+    }
+
+    for (; i + 4 <= count; i += 4)
+    {
+        if (!shared_a)
+            load_matrix_lanes_soa(a, count, i, la);
+        load_matrix_lanes_soa(b, count, i, lb);
+        multiply_matrix_lanes(la, lb, lo);
+        store_matrix_lanes_soa(lo, out, count, i);
+    }
+    // Residuo: recoger la matriz i de los planos, multiplicar y repartir
+    for (; i < count; ++i)
+    {
+        float ma[9], mb[9], mo[9];
+        for (int k = 0; k < 9; ++k)
+        {
+            ma[k] = shared_a ? a[k] : a[(size_t)k * count + i];
+            mb[k] = b[(size_t)k * count + i];
+        }
+        multiply_matrix_scalar(ma, mb, mo);
+        for (int k = 0; k < 9; ++k)
+            out[(size_t)k * count + i] = mo[k];
+    }
+}
+
+// --- Inversa y Determinante por Lotes ---
+// Forma cerrada por cofactores, sin LU: con m en column-major y
+// (a b c / d e f / g h i) sus filas, la inversa es adj(m) / det y, en column-major,
+// adj(m) son los 9 cofactores en orden. Mismo criterio de fallo que la antigua
+// inversa con FullPivLU: |det| < MATRIX_INVERSE_EPSILON deja la salida a NaN y da 0
+// (un det NaN no cuenta como fallo; su inversa ya es NaN).
+// Especialización afín: si las 4 matrices del bloque tienen la fila de perspectiva
+// (0, 0, 1) (misma prueba que classify_matrix) se invierte el bloque 2x2 y la
+// traslación: solo 3 de los 9 cofactores llevan productos y la última fila es exacta.
+
+// Desarrollo por la primera fila, con el mismo orden de operaciones que las lanes
+inline float determinant_scalar(const float *m)
+{
+    const float a = m[0], b = m[3], c = m[6];
+    const float d = m[1], e = m[4], f = m[7];
+    const float g = m[2], h = m[5], i = m[8];
+    return a * (e * i - f * h) + b * (f * g - d * i) + c * (d * h - e * g);
+}
+
+/** Inversa de una matriz. @returns 1 si |det| >= MATRIX_INVERSE_EPSILON; si no, out a NaN y 0. */
+inline int invert_matrix_scalar(const float *m, float *out)
+{
+    const float a = m[0], b = m[3], c = m[6];
+    const float d = m[1], e = m[4], f = m[7];
+    const float g = m[2], h = m[5], i = m[8];
+    const float cof[9] = {
+        e * i - f * h, f * g - d * i, d * h - e * g,
+        c * h - b * i, a * i - c * g, b * g - a * h,
+        b * f - c * e, c * d - a * f, a * e - b * d};
+    const float det = a * cof[0] + b * cof[1] + c * cof[2];
+    if (std::abs(det) < MATRIX_INVERSE_EPSILON)
+    {
+        for (int k = 0; k < 9; ++k)
+            out[k] = std::numeric_limits<float>::quiet_NaN();
+        return 0;
+    }
+    const float inv_det = 1.0f / det;
+    for (int k = 0; k < 9; ++k)
+        out[k] = cof[k] * inv_det;
+    return 1;
+}
+
+inline v128_t f32x4_diff_of_products(v128_t a, v128_t b, v128_t c, v128_t d)
+{
+    return wasm_f32x4_sub(wasm_f32x4_mul(a, b), wasm_f32x4_mul(c, d));
+}
+
+// Todas las lanes con fila de perspectiva (0, 0, 1)
+inline bool matrix_lanes_affine(const MatrixLanes &m)
+{
+    const v128_t eps = wasm_f32x4_splat(MATRIX_CLASSIFY_EPSILON);
+    const v128_t near = wasm_v128_and(
+        wasm_v128_and(wasm_f32x4_lt(wasm_f32x4_abs(m.c[2]), eps), wasm_f32x4_lt(wasm_f32x4_abs(m.c[5]), eps)),
+        wasm_f32x4_lt(wasm_f32x4_abs(wasm_f32x4_sub(m.c[8], wasm_f32x4_splat(1.0f))), eps));
+    return wasm_i32x4_bitmask(near) == 0xf;
+}
+
+// Cofactores de 4 matrices; devuelve el determinante
+inline v128_t matrix_lanes_cofactors(const MatrixLanes &m, bool affine, MatrixLanes &cof)
+{
+    const v128_t a = m.c[0], b = m.c[3], c = m.c[6];
+    const v128_t d = m.c[1], e = m.c[4], f = m.c[7];
+    if (affine)
+    {
+        const v128_t zero = wasm_f32x4_splat(0.0f);
+        cof.c[0] = e;
+        cof.c[1] = wasm_f32x4_sub(zero, d);
+        cof.c[2] = zero;
+        cof.c[3] = wasm_f32x4_sub(zero, b);
+        cof.c[4] = a;
+        cof.c[5] = zero;
+        cof.c[6] = f32x4_diff_of_products(b, f, c, e);
+        cof.c[7] = f32x4_diff_of_products(c, d, a, f);
+        cof.c[8] = f32x4_diff_of_products(a, e, b, d);
+        return cof.c[8];
+    }
+    const v128_t g = m.c[2], h = m.c[5], i = m.c[8];
+    cof.c[0] = f32x4_diff_of_products(e, i, f, h);
+    cof.c[1] = f32x4_diff_of_products(f, g, d, i);
+    cof.c[2] = f32x4_diff_of_products(d, h, e, g);
+    cof.c[3] = f32x4_diff_of_products(c, h, b, i);
+    cof.c[4] = f32x4_diff_of_products(a, i, c, g);
+    cof.c[5] = f32x4_diff_of_products(b, g, a, h);
+    cof.c[6] = f32x4_diff_of_products(b, f, c, e);
+    cof.c[7] = f32x4_diff_of_products(c, d, a, f);
+    cof.c[8] = f32x4_diff_of_products(a, e, b, d);
+    return wasm_f32x4_add(wasm_f32x4_add(wasm_f32x4_mul(a, cof.c[0]), wasm_f32x4_mul(b, cof.c[1])),
+                          wasm_f32x4_mul(c, cof.c[2]));
+}
+
+/**
+ * Inversa de 4 matrices. Las lanes singulares quedan a NaN.
+ * @returns Bitmask de 4 bits con las lanes invertidas.
+ */
+inline uint32_t invert_matrix_lanes(const MatrixLanes &m, MatrixLanes &out)
+{
+    const bool affine = matrix_lanes_affine(m);
+    MatrixLanes cof;
+    const v128_t det = matrix_lanes_cofactors(m, affine, cof);
+    const v128_t failed = wasm_f32x4_lt(wasm_f32x4_abs(det), wasm_f32x4_splat(MATRIX_INVERSE_EPSILON));
+    const v128_t inv_det = wasm_f32x4_div(wasm_f32x4_splat(1.0f), det);
+    const v128_t nan = wasm_f32x4_splat(std::numeric_limits<float>::quiet_NaN());
+    for (int k = 0; k < 9; ++k)
+        out.c[k] = wasm_v128_bitselect(nan, wasm_f32x4_mul(cof.c[k], inv_det), failed);
+    if (affine)
+    {
+        // La última fila de la inversa afín es exacta, también para lanes singulares
+        const v128_t zero = wasm_f32x4_splat(0.0f);
+        out.c[2] = wasm_v128_bitselect(nan, zero, failed);
+        out.c[5] = wasm_v128_bitselect(nan, zero, failed);
+        out.c[8] = wasm_v128_bitselect(nan, wasm_f32x4_splat(1.0f), failed);
+    }
+    return ~wasm_i32x4_bitmask(failed) & 0xfu;
+}
+
+// Recoge la matriz i de un array (AoS o SoA) en 9 floats contiguos, y al revés
+inline void gather_batch_matrix(const float *src, int count, int i, MatrixBatchLayout layout, float *m)
+{
+    for (int k = 0; k < 9; ++k)
+        m[k] = layout == MatrixBatchLayout::AoS ? src[(size_t)i * 9 + k] : src[(size_t)k * count + i];
+}
+
+inline void scatter_batch_matrix(const float *m, int count, int i, MatrixBatchLayout layout, float *dst)
+{
+    for (int k = 0; k < 9; ++k)
+    {
+        if (layout == MatrixBatchLayout::AoS)
+            dst[(size_t)i * 9 + k] = m[k];
+        else
+            dst[(size_t)k * count + i] = m[k];
+    }
+}
+
+inline void load_batch_lanes(const float *src, int count, int i, MatrixBatchLayout layout, MatrixLanes &out)
+{
+    if (layout == MatrixBatchLayout::AoS)
+        load_matrix_lanes_aos(src + (size_t)i * 9, out);
+    else
+        load_matrix_lanes_soa(src, count, i, out);
+}
+
+/**
+ * Inversas de count matrices. out puede ser exactamente m.
+ * @param mask Opcional: 1 por matriz invertida, 0 por singular (uint8).
+ * @returns Número de matrices invertidas.
+ */
+inline int invert_matrices_batch_kernel(const float *m, float *out, uint8_t *mask, int count,
+                                        MatrixBatchLayout layout)
+{
+    MatrixLanes lm, lo;
+    int inverted = 0;
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        load_batch_lanes(m, count, i, layout, lm);
+        const uint32_t ok = invert_matrix_lanes(lm, lo);
+        if (layout == MatrixBatchLayout::AoS)
+            store_matrix_lanes_aos(lo, out + (size_t)i * 9);
+        else
+            store_matrix_lanes_soa(lo, out, count, i);
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            const int bit = (ok >> lane) & 1;
+            inverted += bit;
+            if (mask)
+                mask[i + lane] = (uint8_t)bit;
+        }
+    }
+    for (; i < count; ++i)
+    {
+        float mi[9], mo[9];
+        gather_batch_matrix(m, count, i, layout, mi);
+        const int ok = invert_matrix_scalar(mi, mo);
+        scatter_batch_matrix(mo, count, i, layout, out);
+        inverted += ok;
+        if (mask)
+            mask[i] = (uint8_t)ok;
+    }
+    return inverted;
+}
+
+/** Determinantes de count matrices en out (count floats). */
+inline void determinants_batch_kernel(const float *m, float *out, int count, MatrixBatchLayout layout)
+{
+    MatrixLanes lm, cof;
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        load_batch_lanes(m, count, i, layout, lm);
+        wasm_v128_store(out + i, matrix_lanes_cofactors(lm, matrix_lanes_affine(lm), cof));
+    }
+    for (; i < count; ++i)
+    {
+        float mi[9];
+        gather_batch_matrix(m, count, i, layout, mi);
+        out[i] = determinant_scalar(mi);
+    }
+}
@@ -1,27 +1,35 @@
 // core_cpp/src/matrix_ops.cpp
 #include <vector>
+#include <memory>
 #include <cmath>
 #include <limits>
-#include <iostream> // Necesario para std::cout
-#include <wasm_simd128.h>
+#include "simd_compat.h"
 
 #include "../vendor/eigen-3.4.0/Eigen/Dense"
 #include "../vendor/eigen-3.4.0/Eigen/SVD"
 
 #include <emscripten/bind.h>
+#include <emscripten/emscripten.h>
 #include <emscripten/val.h>
 
+#include "matrix_types.h"
+#include "point_kernels.h"
+#include "point_formats.h"
+#include "point_kernels_f64.h"
+#include "thread_pool.h"
+#include "buffer_pool.h"
+#include "transform_plan.h"
+#include "spatial_sort.h"
+#include "point_codec.h"
+#include "matrix_batch.h"
+#include "transform_hierarchy.h"
+#include "keyframe_animation.h"
+#include "transform_program.h"
+#include "id_registry.h"
+
 using namespace Eigen;
 using namespace emscripten;
 
-// --- Tipos ---
-typedef Matrix<float, 3, 3> Matrix3f;
-typedef Matrix<float, 8, 8> Matrix8f;
-typedef Matrix<float, 8, 1> Vector8f;
-// Usar un epsilon consistente, quizás un poco más relajado que el de SVD si es necesario
-const float MATRIX_INVERSE_EPSILON = 1e-7f; // Epsilon específico para la inversa
-const float MATRIX_SVD_EPSILON = 1e-6f;     // Epsilon para SVD (como estaba antes)
-
 // --- Funciones C++ ---
 
 void multiply_matrices(uintptr_t a_ptr, uintptr_t b_ptr, uintptr_t out_ptr)
@@ -32,44 +40,129 @@ void multiply_matrices(uintptr_t a_ptr, uintptr_t b_ptr, uintptr_t out_ptr)
     out = a * b;
 }
 
+/**
+ * Producto por lotes de count matrices 3x3 (ver matrix_batch.h): out[i] = a[i] * b[i],
+ * o a[0] * b[i] con num_a == 1. layout 0 = AoS (9 floats por matriz), 1 = SoA (9
+ * planos de count floats). Con una sola A, a_ptr son 9 floats column-major en ambos
+ * layouts. out puede ser exactamente a o b, pero no solaparlos en parte.
+ * @returns 1 si se multiplicó, 0 si num_a, el layout o el solapamiento no son válidos.
+ */
+int multiply_matrices_batch(uintptr_t a_ptr, int num_a, uintptr_t b_ptr, uintptr_t out_ptr, int count,
+                            int layout)
+{
+    if (count < 0 || (num_a != 1 && num_a != count) ||
+        (layout != (int)MatrixBatchLayout::AoS && layout != (int)MatrixBatchLayout::SoA))
+        return 0;
+    const float *a = (const float *)a_ptr;
+    const float *b = (const float *)b_ptr;
+    float *out = (float *)out_ptr;
+    const size_t floats = (size_t)count * 9;
+    const FloatRange out_range{out, out + floats};
+    const FloatRange a_range{a, a + (size_t)num_a * 9};
+    const FloatRange b_range{b, b + floats};
+    // Solo se admite el alias exacto con una entrada del mismo tamaño que la salida
+    if (ranges_overlap(out_range, a_range) && (a != out || num_a != count))
+        return 0;
+    if (ranges_overlap(out_range, b_range) && b != out)
+        return 0;
+    multiply_matrices_batch_kernel(a, num_a == 1 && count != 1, b, out, count, (MatrixBatchLayout)layout);
+    return 1;
+}
+
 float determinant(uintptr_t m_ptr)
 {
-    Map<const Matrix3f> m((const float *)m_ptr);
-    return m.determinant();
+    return determinant_scalar((const float *)m_ptr);
 }
 
+// Forma cerrada por cofactores (matrix_batch.h): mismo criterio de fallo que
+// invert_matrices y sin el coste de una FullPivLU para una 3x3
 int invert_matrix(uintptr_t m_ptr, uintptr_t out_ptr)
 {
-    Map<const Matrix3f> m((const float *)m_ptr);
-    Map<Matrix3f> out((float *)out_ptr);
-
-    Eigen::IOFormat OctaveFmt(Eigen::StreamPrecision, 0, ", ", ";\n", "[", "]", "[", "]");
-    // std::cout << "invert_matrix C++: Input matrix M:\n" << m.format(OctaveFmt) << std::endl; // Log opcional
+    return invert_matrix_scalar((const float *)m_ptr, (float *)out_ptr);
+}
 
-    FullPivLU<Matrix3f> lu(m);
-    float det = lu.determinant();
+/**
+ * Inversas de count matrices (layout 0 = AoS, 1 = SoA; ver matrix_batch.h). Las
+ * singulares (|det| < MATRIX_INVERSE_EPSILON) quedan a NaN. out puede ser m, pero
+ * no solaparla en parte. Con mask_out_ptr != 0 escribe 1/0 por matriz (uint8).
+ * @returns Matrices invertidas, o -1 si el layout, el recuento o el solapamiento no son válidos.
+ */
+int invert_matrices(uintptr_t m_ptr, uintptr_t out_ptr, uintptr_t mask_out_ptr, int count, int layout)
+{
+    const float *m = (const float *)m_ptr;
+    float *out = (float *)out_ptr;
+    const size_t floats = (size_t)count * 9;
+    if (count < 0 || (layout != (int)MatrixBatchLayout::AoS && layout != (int)MatrixBatchLayout::SoA) ||
+        (m != out && ranges_overlap(FloatRange{m, m + floats}, FloatRange{out, out + floats})))
+        return -1;
+    return invert_matrices_batch_kernel(m, out, (uint8_t *)mask_out_ptr, count, (MatrixBatchLayout)layout);
+}
 
-    // std::cout << "invert_matrix C++: LU determinant: " << det << std::endl; // Log opcional
-    // std::cout << "invert_matrix C++: Comparing abs(det) < MATRIX_INVERSE_EPSILON (" << MATRIX_INVERSE_EPSILON << ")" << std::endl; // Log opcional
+/**
+ * Determinantes de count matrices (layout 0 = AoS, 1 = SoA) en out_ptr (count floats).
+ * @returns 1 si se calcularon, 0 si el layout o el recuento no son válidos.
+ */
+int determinants(uintptr_t m_ptr, uintptr_t out_ptr, int count, int layout)
+{
+    if (count < 0 || (layout != (int)MatrixBatchLayout::AoS && layout != (int)MatrixBatchLayout::SoA))
+        return 0;
+    determinants_batch_kernel((const float *)m_ptr, (float *)out_ptr, count, (MatrixBatchLayout)layout);
+    return 1;
+}
 
-    if (std::abs(det) < MATRIX_INVERSE_EPSILON)
+// --- Exportaciones C (ABI plana, sin Embind) ---
+// Para operaciones 3x3 el coste de Embind por llamada supera al cálculo: estas se
+// llaman directamente desde los exports de la instancia (module._multiply_matrices_raw...).
+// EMSCRIPTEN_KEEPALIVE las exporta sin tocar EXPORTED_FUNCTIONS.
+extern "C"
+{
+    EMSCRIPTEN_KEEPALIVE void multiply_matrices_raw(const float *a, const float *b, float *out)
     {
-        // std::cout << "invert_matrix C++: Determinant below epsilon, marking as non-invertible." << std::endl; // Log opcional
-        out.setConstant(std::numeric_limits<float>::quiet_NaN());
-        return 0; // <-- Devolver 0 para fallo
+        multiply_matrices((uintptr_t)a, (uintptr_t)b, (uintptr_t)out);
     }
 
-    out = lu.inverse();
-    // std::cout << "invert_matrix C++: Calculated inverse:\n" << out.format(OctaveFmt) << std::endl; // Log opcional
+    EMSCRIPTEN_KEEPALIVE float determinant_raw(const float *m)
+    {
+        return determinant((uintptr_t)m);
+    }
 
-    if (out.array().isNaN().any() || out.array().isInf().any())
+    // 1 éxito, 0 singular (out queda a NaN)
+    EMSCRIPTEN_KEEPALIVE int invert_matrix_raw(const float *m, float *out)
     {
-        // std::cerr << "invert_matrix C++: Warning - Inverse calculation resulted in NaN/Inf." << std::endl; // Log opcional
-        // return 0; // Podrías devolver fallo aquí también si quieres
+        return invert_matrix((uintptr_t)m, (uintptr_t)out);
     }
+}
 
-    // std::cout << "invert_matrix C++: Returning 1 (success)" << std::endl; // Log opcional
-    return 1; // <-- Devolver 1 para éxito
+// --- Funciones C++ (f64) ---
+// Mismas operaciones sobre Float64Array(9) column-major, para coordenadas grandes.
+
+void multiply_matrices_f64(uintptr_t a_ptr, uintptr_t b_ptr, uintptr_t out_ptr)
+{
+    Map<const Matrix3d> a((const double *)a_ptr);
+    Map<const Matrix3d> b((const double *)b_ptr);
+    Map<Matrix3d> out((double *)out_ptr);
+    out = a * b;
+}
+
+double determinant_f64(uintptr_t m_ptr)
+{
+    Map<const Matrix3d> m((const double *)m_ptr);
+    return m.determinant();
+}
+
+int invert_matrix_f64(uintptr_t m_ptr, uintptr_t out_ptr)
+{
+    Map<const Matrix3d> m((const double *)m_ptr);
+    Map<Matrix3d> out((double *)out_ptr);
+
+    FullPivLU<Matrix3d> lu(m);
+    if (std::abs(lu.determinant()) < MATRIX_INVERSE_EPSILON_F64)
+    {
+        out.setConstant(std::numeric_limits<double>::quiet_NaN());
+        return 0;
+    }
+    out = lu.inverse();
+    return 1;
 }
 
 bool solve_homography_svd(uintptr_t a_ptr, uintptr_t b_ptr, uintptr_t x_ptr)
@@ -104,121 +197,994 @@ bool solve_homography_svd(uintptr_t a_ptr, uintptr_t b_ptr, uintptr_t x_ptr)
     return true;
 }
 
+// Por debajo de este tamaño despertar a los workers cuesta más de lo que se gana
+const int PARALLEL_MIN_POINTS = 65536;
+// 16K puntos = 128 KiB de entrada + 128 KiB de salida por chunk (cabe en L2)
+const int PARALLEL_CHUNK_POINTS = 16384;
+
+/**
+ * Puntos por chunk para un lote xyxy. Con workers activos, los lotes grandes se
+ * reparten en chunks entre hilos, solo si los chunks son independientes: in-place
+ * exacto o buffers disjuntos. En otro caso, el lote entero (un chunk, en serie).
+ */
+static int batch_chunk_points(const float *pts_in, const float *pts_out, int num_points)
+{
+    const FloatRange in_range{pts_in, pts_in + (size_t)num_points * 2};
+    const FloatRange out_range{pts_out, pts_out + (size_t)num_points * 2};
+    if (ChunkThreadPool::instance().size() > 0 && num_points >= PARALLEL_MIN_POINTS &&
+        (pts_in == pts_out || !ranges_overlap(in_range, out_range)))
+        return PARALLEL_CHUNK_POINTS;
+    return std::max(num_points, 1);
+}
+
 void transform_points_batch(uintptr_t matrix_ptr, uintptr_t points_in_ptr, uintptr_t points_out_ptr, int num_points)
 {
-    Map<const Matrix3f> M((const float *)matrix_ptr);
+    const float *m = (const float *)matrix_ptr;
+
+    // Coeficientes splatteados una vez; el kernel se elige según la clase de la matriz
+    // (identidad/traslación/escala/afín evitan W, la división y las máscaras de NaN).
+    // Entrada y salida pueden ser el mismo buffer (in-place).
+    TransformCoeffs coeffs;
+    load_transform_coeffs(m, coeffs);
+    const MatrixClass cls = classify_matrix(m);
+    const float *pts_in = (const float *)points_in_ptr;
+    float *pts_out = (float *)points_out_ptr;
+
+    const int chunk_points = batch_chunk_points(pts_in, pts_out, num_points);
+    if (chunk_points >= num_points)
+    {
+        PackedLayout layout{pts_in, pts_out};
+        transform_points_dispatch(cls, coeffs, layout, num_points);
+        return;
+    }
+
+    const int num_chunks = (num_points + chunk_points - 1) / chunk_points;
+    ChunkThreadPool::instance().run(num_chunks, [&](int chunk)
+                                    {
+        const int begin = chunk * chunk_points;
+        const int count = std::min(chunk_points, num_points - begin);
+        PackedLayout layout{pts_in + (size_t)begin * 2, pts_out + (size_t)begin * 2};
+        transform_points_dispatch(cls, coeffs, layout, count); });
+}
+
+/**
+ * transform_points_batch con reducción fusionada: en la misma pasada calcula el AABB
+ * y el centroide de las salidas válidas y cuenta las degeneradas (NaN por W cercano
+ * a cero), evitando recorrer otra vez la salida desde JS.
+ * @param stats_ptr Puntero a un PointBatchStats (32 bytes) donde se escribe el resultado.
+ * @returns Número de puntos degenerados (igual a stats.invalid_count).
+ */
+int transform_points_batch_stats(uintptr_t matrix_ptr, uintptr_t points_in_ptr, uintptr_t points_out_ptr,
+                                 int num_points, uintptr_t stats_ptr)
+{
+    const float *m = (const float *)matrix_ptr;
+    PointBatchStats *stats = (PointBatchStats *)stats_ptr;
+
+    TransformCoeffs coeffs;
+    load_transform_coeffs(m, coeffs);
+    const MatrixClass cls = classify_matrix(m);
     const float *pts_in = (const float *)points_in_ptr;
     float *pts_out = (float *)points_out_ptr;
 
-    // --- Coeficientes de Matriz en Vectores SIMD ---
-    // Usamos wasm_f32x4_splat para repetir el coeficiente en las 4 vías del vector
-    const v128_t m0_v = wasm_f32x4_splat(M(0, 0)); // m[0]
-    const v128_t m1_v = wasm_f32x4_splat(M(1, 0)); // m[1]
-    const v128_t m2_v = wasm_f32x4_splat(M(2, 0)); // m[2]
-    const v128_t m3_v = wasm_f32x4_splat(M(0, 1)); // m[3]
-    const v128_t m4_v = wasm_f32x4_splat(M(1, 1)); // m[4]
-    const v128_t m5_v = wasm_f32x4_splat(M(2, 1)); // m[5]
-    const v128_t m6_v = wasm_f32x4_splat(M(0, 2)); // m[6] (Tx)
-    const v128_t m7_v = wasm_f32x4_splat(M(1, 2)); // m[7] (Ty)
-    const v128_t m8_v = wasm_f32x4_splat(M(2, 2)); // m[8] (W scale)
-
-    // --- Constantes SIMD ---
-    const v128_t epsilon_v = wasm_f32x4_splat(MATRIX_SVD_EPSILON); // Podría ser otro epsilon
-    const v128_t one_v = wasm_f32x4_splat(1.0f);
-    const v128_t nan_v = wasm_f32x4_splat(std::numeric_limits<float>::quiet_NaN());
+    const int chunk_points = batch_chunk_points(pts_in, pts_out, num_points);
+    PointStatsAccumulator total;
+    if (chunk_points >= num_points)
+    {
+        StatsLayout<PackedLayout> layout{{pts_in, pts_out}, &total};
+        transform_points_dispatch(cls, coeffs, layout, num_points);
+    }
+    else
+    {
+        // Un acumulador por chunk; se combinan al final en el hilo llamante
+        const int num_chunks = (num_points + chunk_points - 1) / chunk_points;
+        std::vector<PointStatsAccumulator> partials(num_chunks);
+        ChunkThreadPool::instance().run(num_chunks, [&](int chunk)
+                                        {
+            const int begin = chunk * chunk_points;
+            const int count = std::min(chunk_points, num_points - begin);
+            StatsLayout<PackedLayout> layout{{pts_in + (size_t)begin * 2, pts_out + (size_t)begin * 2}, &partials[chunk]};
+            transform_points_dispatch(cls, coeffs, layout, count); });
+        for (PointStatsAccumulator &partial : partials)
+            total.merge(partial);
+    }
+    total.finish(*stats);
+    return stats->invalid_count;
+}
+
+/**
+ * Ajusta los workers usados por transform_points_batch (0 = serie).
+ * Solo tiene efecto en la build con pthreads; en el resto devuelve siempre 0.
+ * @returns Número de workers activos (el hilo llamante también procesa chunks).
+ */
+int set_transform_threads(int num_workers)
+{
+    return ChunkThreadPool::instance().resize(num_workers);
+}
+
+int get_transform_threads()
+{
+    return ChunkThreadPool::instance().size();
+}
+
+/**
+ * Selecciona el modo de precisión de los kernels f32 (ver TransformPrecision):
+ * 0 = Exact, 1 = Fast. Afecta a todas las transformaciones posteriores.
+ * @returns El modo activo (valores desconocidos se ignoran).
+ */
+int set_transform_precision(int mode)
+{
+    if (mode == (int)TransformPrecision::Exact || mode == (int)TransformPrecision::Fast)
+        transform_precision() = (TransformPrecision)mode;
+    return (int)transform_precision();
+}
+
+int get_transform_precision()
+{
+    return (int)transform_precision();
+}
+
+// 1 si la build usa relaxed-SIMD (-mrelaxed-simd): el modo Fast usa FMA
+int has_relaxed_simd()
+{
+#ifdef __wasm_relaxed_simd__
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * Transforma puntos dentro de buffers de vértices intercalados.
+ * Offsets y pasos se expresan en floats: el punto i se lee de in[in_offset + i*in_stride]
+ * (x) y el siguiente float (y), y se escribe igual en la salida. El resto de atributos
+ * del vértice (u, v, rgba...) no se tocan.
+ * Entrada y salida pueden ser el mismo buffer; si solo se solapan parcialmente deben
+ * compartir el paso.
+ * @returns 1 si se transformó, 0 si los parámetros o el solapamiento no son válidos.
+ */
+int transform_points_strided(uintptr_t matrix_ptr,
+                             uintptr_t in_ptr, int in_offset, int in_stride,
+                             uintptr_t out_ptr, int out_offset, int out_stride,
+                             int num_points)
+{
+    if (num_points <= 0)
+        return 1;
+    if (in_stride < 2 || out_stride < 2 || in_offset < 0 || out_offset < 0)
+        return 0;
+
+    const float *m = (const float *)matrix_ptr;
+    const float *in = (const float *)in_ptr + in_offset;
+    float *out = (float *)out_ptr + out_offset;
+
+    FloatRange in_range{in, in + (size_t)(num_points - 1) * in_stride + 2};
+    FloatRange out_range{out, out + (size_t)(num_points - 1) * out_stride + 2};
+    int direction = 1;
+    if (ranges_overlap(out_range, in_range))
+    {
+        if (in_stride != out_stride)
+            return 0;
+        direction = layout_overlap_direction(&out_range, 1, &in_range, 1);
+    }
+
+    TransformCoeffs coeffs;
+    load_transform_coeffs(m, coeffs);
+    const MatrixClass cls = classify_matrix(m);
+    if (in_stride == 2 && out_stride == 2)
+    {
+        PackedLayout layout{in, out};
+        transform_points_dispatch(cls, coeffs, layout, num_points, direction < 0);
+    }
+    else
+    {
+        StridedLayout layout{in, in_stride, out, out_stride};
+        transform_points_dispatch(cls, coeffs, layout, num_points, direction < 0);
+    }
+    return 1;
+}
+
+/**
+ * Transforma puntos en formato SoA (x[] e y[] separados), sin shuffles.
+ * Cualquier array de salida puede coincidir con uno de entrada (in-place).
+ * @returns 1 si se transformó, 0 si el solapamiento parcial no es resoluble.
+ */
+int transform_points_soa(uintptr_t matrix_ptr,
+                         uintptr_t x_in_ptr, uintptr_t y_in_ptr,
+                         uintptr_t x_out_ptr, uintptr_t y_out_ptr,
+                         int num_points)
+{
+    if (num_points <= 0)
+        return 1;
+
+    const float *m = (const float *)matrix_ptr;
+    SoALayout layout{(const float *)x_in_ptr, (const float *)y_in_ptr, (float *)x_out_ptr, (float *)y_out_ptr};
+
+    FloatRange ins[2] = {{layout.x_in, layout.x_in + num_points}, {layout.y_in, layout.y_in + num_points}};
+    FloatRange outs[2] = {{layout.x_out, layout.x_out + num_points}, {layout.y_out, layout.y_out + num_points}};
+    if (ranges_overlap(outs[0], outs[1]))
+        return 0;
+    const int direction = layout_overlap_direction(outs, 2, ins, 2);
+    if (direction == 0)
+        return 0;
 
+    TransformCoeffs coeffs;
+    load_transform_coeffs(m, coeffs);
+    transform_points_dispatch(classify_matrix(m), coeffs, layout, num_points, direction < 0);
+    return 1;
+}
+
+/**
+ * Transforma cada punto con su propia matriz: matrices[indices[i]] (array de
+ * matrices 3x3 column-major contiguas, índices uint32 por punto).
+ * Los runs de puntos consecutivos con la misma matriz se procesan con el kernel
+ * especializado por clase; los tramos mezclados vectorizan con gather.
+ * Los puntos con índice fuera de rango se escriben como NaN.
+ * @returns Número de puntos con índice de instancia inválido (0 si todos son válidos).
+ */
+int transform_points_instanced(uintptr_t matrices_ptr, int num_matrices, uintptr_t indices_ptr,
+                               uintptr_t points_in_ptr, uintptr_t points_out_ptr, int num_points)
+{
+    const float *matrices = (const float *)matrices_ptr;
+    const uint32_t *indices = (const uint32_t *)indices_ptr;
+    const float *pts_in = (const float *)points_in_ptr;
+    float *pts_out = (float *)points_out_ptr;
+    PackedLayout layout{pts_in, pts_out};
+
+    int invalid_points = 0;
+    TransformCoeffs coeffs;
     int i = 0;
-    const int num_points_simd = num_points - (num_points % 4); // Número de puntos a procesar con SIMD
-
-    // --- Bucle Principal SIMD (procesa 4 puntos a la vez) ---
-    for (; i < num_points_simd; i += 4)
-    {
-        int base_idx = i * 2; // Índice base en el array de floats (xyxy...)
-
-        // Cargar 8 floats = 4 puntos (x1,y1,x2,y2) y (x3,y3,x4,y4)
-        // Asume alineación de 16 bytes. Usar wasm_v128_load_unaligned si no es seguro.
-        v128_t points_xy12 = wasm_v128_load(&pts_in[base_idx]);
-        v128_t points_xy34 = wasm_v128_load(&pts_in[base_idx + 4]);
-
-        // Reorganizar a xxxx y yyyy usando wasm_i32x4_shuffle
-        // Los índices se refieren a las vías de 32 bits:
-        // 0=x1, 1=y1, 2=x2, 3=y2 (en points_xy12)
-        // 4=x3, 5=y3, 6=x4, 7=y4 (en points_xy34)
-        v128_t x1234 = wasm_i32x4_shuffle(points_xy12, points_xy34, 0, 2, 4, 6); // x1,x2,x3,x4
-        v128_t y1234 = wasm_i32x4_shuffle(points_xy12, points_xy34, 1, 3, 5, 7); // y1,y2,y3,y4
-
-        // --- Calcular X = m0*x + m3*y + m6 ---
-        v128_t x_p1 = wasm_f32x4_mul(m0_v, x1234);
-        v128_t x_p2 = wasm_f32x4_mul(m3_v, y1234);
-        v128_t x_unscaled = wasm_f32x4_add(wasm_f32x4_add(x_p1, x_p2), m6_v);
-
-        // --- Calcular Y = m1*x + m4*y + m7 ---
-        v128_t y_p1 = wasm_f32x4_mul(m1_v, x1234);
-        v128_t y_p2 = wasm_f32x4_mul(m4_v, y1234);
-        v128_t y_unscaled = wasm_f32x4_add(wasm_f32x4_add(y_p1, y_p2), m7_v);
-
-        // --- Calcular W = m2*x + m5*y + m8 ---
-        v128_t w_p1 = wasm_f32x4_mul(m2_v, x1234);
-        v128_t w_p2 = wasm_f32x4_mul(m5_v, y1234);
-        v128_t w = wasm_f32x4_add(wasm_f32x4_add(w_p1, w_p2), m8_v);
-
-        // --- División por W y manejo de W cercano a cero ---
-        v128_t w_abs = wasm_f32x4_abs(w);
-        v128_t valid_w_mask = wasm_f32x4_ge(w_abs, epsilon_v); // 1s donde |W| >= eps, 0s donde |W| < eps
-        v128_t inv_w = wasm_f32x4_div(one_v, w); // Calcula 1/W (puede ser Inf si W=0)
-
-        // Multiplicar X e Y por invW
-        v128_t x_scaled = wasm_f32x4_mul(x_unscaled, inv_w);
-        v128_t y_scaled = wasm_f32x4_mul(y_unscaled, inv_w);
-
-        // Seleccionar el resultado escalado donde W es válido, o NaN donde no lo es
-        // wasm_v128_bitselect(if_mask_true, if_mask_false, mask)
-        v128_t x_final = wasm_v128_bitselect(x_scaled, nan_v, valid_w_mask);
-        v128_t y_final = wasm_v128_bitselect(y_scaled, nan_v, valid_w_mask);
-
-        // --- Reorganizar de nuevo a xyxy para almacenar ---
-        // Índices para shuffle se refieren a las vías de 32 bits:
-        // 0=x'1, 1=x'2, 2=x'3, 3=x'4 (en x_final)
-        // 4=y'1, 5=y'2, 6=y'3, 7=y'4 (en y_final)
-        v128_t out_xy12 = wasm_i32x4_shuffle(x_final, y_final, 0, 4, 1, 5); // x'1, y'1, x'2, y'2
-        v128_t out_xy34 = wasm_i32x4_shuffle(x_final, y_final, 2, 6, 3, 7); // x'3, y'3, x'4, y'4
-
-        // Almacenar los 8 floats = 4 puntos transformados
-        // Asume alineación. Usar wasm_v128_store_unaligned si no.
-        wasm_v128_store(&pts_out[base_idx], out_xy12);
-        wasm_v128_store(&pts_out[base_idx + 4], out_xy34);
-    }
-
-    // --- Bucle Escalar Residual (procesa los 0-3 puntos restantes) ---
-    // Extraer coeficientes escalares una vez si quedan puntos
-    if (i < num_points) {
-         const float m0_s = M(0, 0), m1_s = M(1, 0), m2_s = M(2, 0);
-         const float m3_s = M(0, 1), m4_s = M(1, 1), m5_s = M(2, 1);
-         const float m6_s = M(0, 2), m7_s = M(1, 2), m8_s = M(2, 2);
-
-         for (; i < num_points; ++i)
-         {
-             int idx = i * 2;
-             float x_in = pts_in[idx];
-             float y_in = pts_in[idx + 1];
-
-             float X = m0_s * x_in + m3_s * y_in + m6_s;
-             float Y = m1_s * x_in + m4_s * y_in + m7_s;
-             float W = m2_s * x_in + m5_s * y_in + m8_s;
-
-             if (std::abs(W) < MATRIX_SVD_EPSILON) // Usar el mismo epsilon
-             {
-                 pts_out[idx] = std::numeric_limits<float>::quiet_NaN();
-                 pts_out[idx + 1] = std::numeric_limits<float>::quiet_NaN();
-             }
-             else
-             {
-                 float invW = 1.0f / W;
-                 pts_out[idx] = X * invW;
-                 pts_out[idx + 1] = Y * invW;
-             }
-         }
+    while (i < num_points)
+    {
+        int run_end = instance_run_end(indices, i, num_points);
+        if (run_end - i >= INSTANCE_RUN_MIN)
+        {
+            const float *m = instance_matrix(matrices, num_matrices, indices[i]);
+            if (indices[i] >= (uint32_t)num_matrices)
+                invalid_points += run_end - i;
+            load_transform_coeffs(m, coeffs);
+            PackedLayout run_layout{pts_in + (size_t)i * 2, pts_out + (size_t)i * 2};
+            transform_points_dispatch(classify_matrix(m), coeffs, run_layout, run_end - i);
+            i = run_end;
+            continue;
+        }
+
+        // Tramo mezclado: avanzar hasta el próximo run largo
+        int mixed_end = run_end;
+        while (mixed_end < num_points)
+        {
+            int next_end = instance_run_end(indices, mixed_end, num_points);
+            if (next_end - mixed_end >= INSTANCE_RUN_MIN)
+                break;
+            mixed_end = next_end;
+        }
+        for (int k = i; k < mixed_end; ++k)
+            invalid_points += indices[k] >= (uint32_t)num_matrices;
+        transform_points_gather(matrices, num_matrices, indices, layout, i, mixed_end);
+        i = mixed_end;
+    }
+    return invalid_points;
+}
+
+/**
+ * Variante por rangos: la instancia k transforma los puntos
+ * [ranges[2k], ranges[2k] + ranges[2k+1]) con matrices[k]. Cada rango usa el
+ * kernel especializado por clase. Los puntos no cubiertos no se escriben.
+ * @returns 1 si se transformó, 0 si algún rango queda fuera de [0, num_points).
+ */
+int transform_points_instance_ranges(uintptr_t matrices_ptr, uintptr_t ranges_ptr, int num_instances,
+                                     uintptr_t points_in_ptr, uintptr_t points_out_ptr, int num_points)
+{
+    const float *matrices = (const float *)matrices_ptr;
+    const int32_t *ranges = (const int32_t *)ranges_ptr;
+    const float *pts_in = (const float *)points_in_ptr;
+    float *pts_out = (float *)points_out_ptr;
+
+    for (int k = 0; k < num_instances; ++k)
+    {
+        const int32_t start = ranges[k * 2];
+        const int32_t count = ranges[k * 2 + 1];
+        if (start < 0 || count < 0 || (int64_t)start + count > num_points)
+            return 0;
+    }
+
+    TransformCoeffs coeffs;
+    for (int k = 0; k < num_instances; ++k)
+    {
+        const int32_t start = ranges[k * 2];
+        const int32_t count = ranges[k * 2 + 1];
+        if (count == 0)
+            continue;
+        const float *m = &matrices[(size_t)k * 9];
+        load_transform_coeffs(m, coeffs);
+        PackedLayout layout{pts_in + (size_t)start * 2, pts_out + (size_t)start * 2};
+        transform_points_dispatch(classify_matrix(m), coeffs, layout, count);
+    }
+    return 1;
+}
+
+/**
+ * Transformación incremental: aplica una sola matriz solo a los tramos sucios
+ * [ranges[2k], ranges[2k] + ranges[2k+1]), para nubes casi estáticas donde la
+ * salida del frame anterior sigue siendo válida fuera de esos tramos. Los
+ * coeficientes y la clase se calculan una vez; cada tramo usa el kernel SIMD.
+ * @returns Puntos transformados, o -1 si algún rango queda fuera de [0, num_points).
+ */
+int transform_points_ranges(uintptr_t matrix_ptr, uintptr_t ranges_ptr, int num_ranges,
+                            uintptr_t points_in_ptr, uintptr_t points_out_ptr, int num_points)
+{
+    const float *m = (const float *)matrix_ptr;
+    const int32_t *ranges = (const int32_t *)ranges_ptr;
+    const float *pts_in = (const float *)points_in_ptr;
+    float *pts_out = (float *)points_out_ptr;
+
+    for (int k = 0; k < num_ranges; ++k)
+    {
+        const int32_t start = ranges[k * 2];
+        const int32_t count = ranges[k * 2 + 1];
+        if (start < 0 || count < 0 || (int64_t)start + count > num_points)
+            return -1;
+    }
+
+    TransformCoeffs coeffs;
+    load_transform_coeffs(m, coeffs);
+    const MatrixClass cls = classify_matrix(m);
+    int transformed = 0;
+    for (int k = 0; k < num_ranges; ++k)
+    {
+        const int32_t start = ranges[k * 2];
+        const int32_t count = ranges[k * 2 + 1];
+        if (count == 0)
+            continue;
+        PackedLayout layout{pts_in + (size_t)start * 2, pts_out + (size_t)start * 2};
+        transform_points_dispatch(cls, coeffs, layout, count);
+        transformed += count;
+    }
+    return transformed;
+}
+
+/**
+ * Orden espacial de un lote xyxy (ver spatial_sort.h): claves de Morton (curve = 0)
+ * o Hilbert (curve = 1) ordenadas con radix sort. perm_out recibe num_points
+ * índices originales en el nuevo orden; con keys_out_ptr != 0 también las claves
+ * ordenadas (uint32), útiles para buscar rangos de la curva.
+ * @returns 1 si se ordenó, 0 si la curva o el número de puntos no son válidos.
+ */
+int spatial_order(uintptr_t points_ptr, int num_points, int curve, uintptr_t perm_out_ptr,
+                  uintptr_t keys_out_ptr)
+{
+    if (num_points < 0 || (curve != (int)SpatialCurve::Morton && curve != (int)SpatialCurve::Hilbert))
+        return 0;
+    std::vector<uint32_t> scratch;
+    uint32_t *keys = (uint32_t *)keys_out_ptr;
+    if (!keys)
+    {
+        scratch.resize(num_points);
+        keys = scratch.data();
+    }
+    compute_spatial_keys((SpatialCurve)curve, (const float *)points_ptr, num_points, keys);
+    radix_sort_keys(keys, (uint32_t *)perm_out_ptr, num_points);
+    return 1;
+}
+
+/**
+ * Aplica una permutación de spatial_order a cualquier buffer de elementos de
+ * element_bytes bytes (puntos xyxy = 8, colores RGBA8 = 4...): dst[i] = src[perm[i]].
+ * src y dst pueden ser el mismo buffer (se copia la fuente), pero no solaparse en parte.
+ * @returns 1 si se aplicó, 0 si algún índice es >= num_elements o los buffers se solapan.
+ */
+int apply_permutation(uintptr_t perm_ptr, int num_elements, uintptr_t src_ptr, uintptr_t dst_ptr,
+                      int element_bytes)
+{
+    const uint32_t *perm = (const uint32_t *)perm_ptr;
+    if (num_elements < 0 || element_bytes <= 0)
+        return 0;
+    for (int i = 0; i < num_elements; ++i)
+    {
+        if (perm[i] >= (uint32_t)num_elements)
+            return 0;
+    }
+    const size_t bytes = (size_t)num_elements * element_bytes;
+    const uint8_t *src = (const uint8_t *)src_ptr;
+    uint8_t *dst = (uint8_t *)dst_ptr;
+    std::vector<uint8_t> copy;
+    if (src == dst)
+    {
+        copy.assign(src, src + bytes);
+        src = copy.data();
+    }
+    else if (src < dst + bytes && dst < src + bytes)
+        return 0;
+    permute_elements(perm, num_elements, src, dst, element_bytes);
+    return 1;
+}
+
+/**
+ * Codifica un lote xyxy con el formato de point_codec.h (cuantizar + delta + varint).
+ * out_capacity debe admitir point_codec_max_bytes(num_points); step <= 0 elige
+ * 2^16 celdas dentro del AABB.
+ * @returns Bytes escritos o un código POINT_CODEC_* negativo.
+ */
+int encode_points(uintptr_t points_ptr, int num_points, float step, uintptr_t out_ptr, int out_capacity)
+{
+    return encode_points_quantized((const float *)points_ptr, num_points, step, (uint8_t *)out_ptr,
+                                   out_capacity);
+}
+
+/**
+ * Decodificación reanudable: decodifica los puntos completos de los primeros
+ * available_bytes del stream y guarda el progreso en state_ptr (PointDecodeState,
+ * 4 int32 a cero al empezar). out_ptr debe admitir los num_points de la cabecera.
+ * @returns Puntos decodificados hasta ahora o un código POINT_CODEC_* negativo.
+ */
+int decode_points(uintptr_t in_ptr, int available_bytes, uintptr_t out_ptr, int out_capacity_points,
+                  uintptr_t state_ptr)
+{
+    const uint8_t *in = (const uint8_t *)in_ptr;
+    PointCodecHeader header;
+    const int ok = read_point_codec_header(in, available_bytes, header);
+    if (ok <= 0)
+        return ok;
+    if (header.num_points > (uint32_t)out_capacity_points)
+        return POINT_CODEC_NO_CAPACITY;
+    return decode_points_quantized(in, available_bytes, (float *)out_ptr, *(PointDecodeState *)state_ptr);
+}
+
+/**
+ * Transforma un lote xyxy y escribe compactados solo los puntos dentro del rectángulo
+ * de recorte [min_x, max_x] x [min_y, max_y] (inclusivo). Los degenerados (NaN) se
+ * descartan. Con indices_ptr != 0 guarda el índice original de cada superviviente.
+ * La salida puede ser la propia entrada (in-place) o un buffer disjunto; salida e
+ * índices deben admitir num_points elementos (más allá del recuento quedan restos).
+ * @returns Número de puntos supervivientes.
+ */
+int transform_points_cull(uintptr_t matrix_ptr, uintptr_t points_in_ptr, uintptr_t points_out_ptr,
+                          uintptr_t indices_out_ptr, int num_points,
+                          float min_x, float min_y, float max_x, float max_y)
+{
+    const float *m = (const float *)matrix_ptr;
+    TransformCoeffs coeffs;
+    load_transform_coeffs(m, coeffs);
+    const ClipRect rect = make_clip_rect(min_x, min_y, max_x, max_y);
+    return cull_points_dispatch(classify_matrix(m), coeffs, rect,
+                                (const float *)points_in_ptr, (float *)points_out_ptr,
+                                (uint32_t *)indices_out_ptr, num_points);
+}
+
+/**
+ * transform_points_batch con puntos xyxy en formatos reducidos (ver PointFormat):
+ * lee y/o escribe half floats o int16 normalizados con escala/bias, convirtiendo en
+ * registros dentro del mismo bucle. Con menos bytes por punto, los lotes limitados
+ * por ancho de banda van proporcionalmente más rápido.
+ * @param quant_ptr 0 (escala 1, bias 0) o puntero a dos PointQuantization (8 floats):
+ *                  [0] para la entrada y [1] para la salida, usados solo en SNorm16.
+ * Entrada y salida pueden ser el mismo buffer si la salida no usa más bytes por
+ * punto que la entrada; cualquier otro solapamiento se rechaza.
+ * @returns 1 si se transformó, 0 si el formato, la escala o el solapamiento no son válidos.
+ */
+int transform_points_typed(uintptr_t matrix_ptr,
+                           uintptr_t in_ptr, int in_format,
+                           uintptr_t out_ptr, int out_format,
+                           int num_points, uintptr_t quant_ptr)
+{
+    if (!is_valid_point_format(in_format) || !is_valid_point_format(out_format) || num_points < 0)
+        return 0;
+    const PointFormat in_fmt = (PointFormat)in_format;
+    const PointFormat out_fmt = (PointFormat)out_format;
+
+    const PointQuantization identity_q{1.0f, 1.0f, 0.0f, 0.0f};
+    const PointQuantization *q = (const PointQuantization *)quant_ptr;
+    const PointQuantization in_q = q ? q[0] : identity_q;
+    const PointQuantization out_q = q ? q[1] : identity_q;
+    if ((in_fmt == PointFormat::SNorm16 && (in_q.scale_x == 0.0f || in_q.scale_y == 0.0f)) ||
+        (out_fmt == PointFormat::SNorm16 && (out_q.scale_x == 0.0f || out_q.scale_y == 0.0f)))
+        return 0;
+
+    const size_t in_bytes = (size_t)num_points * 2 * point_format_bytes(in_fmt);
+    const size_t out_bytes = (size_t)num_points * 2 * point_format_bytes(out_fmt);
+    const bool overlap = in_ptr < out_ptr + out_bytes && out_ptr < in_ptr + in_bytes;
+    if (overlap && !(in_ptr == out_ptr && out_bytes <= in_bytes))
+        return 0;
+
+    const float *m = (const float *)matrix_ptr;
+    TransformCoeffs coeffs;
+    load_transform_coeffs(m, coeffs);
+    const MatrixClass cls = classify_matrix(m);
+
+    switch (in_fmt)
+    {
+    case PointFormat::F16:
+        transform_points_typed_write(cls, coeffs, F16Reader{(const uint16_t *)in_ptr}, out_ptr, out_fmt, out_q, num_points);
+        break;
+    case PointFormat::SNorm16:
+        transform_points_typed_write(cls, coeffs, SNorm16Reader{(const int16_t *)in_ptr, snorm_read_coeffs(in_q)}, out_ptr, out_fmt, out_q, num_points);
+        break;
+    default:
+        transform_points_typed_write(cls, coeffs, F32Reader{(const float *)in_ptr}, out_ptr, out_fmt, out_q, num_points);
+        break;
     }
+    return 1;
+}
+
+/**
+ * Transforma puntos xyxy en f64 con una matriz f64 (f64x2, 2 puntos por iteración).
+ * Entrada y salida pueden ser el mismo buffer.
+ */
+void transform_points_batch_f64(uintptr_t matrix_ptr, uintptr_t points_in_ptr, uintptr_t points_out_ptr, int num_points)
+{
+    transform_points_f64_dispatch((const double *)matrix_ptr, (const double *)points_in_ptr,
+                                  F64Writer{(double *)points_out_ptr}, num_points);
+}
+
+/**
+ * Modo mixto: lee puntos f64, transforma en f64 y escribe en f32 el resultado relativo
+ * a un origen local (origin_x, origin_y). Mantiene la precisión de coordenadas grandes
+ * mientras el resultado final (ya cerca del origen) cabe en f32 para la GPU.
+ * La salida no puede solapar la entrada.
+ */
+void transform_points_batch_f64_to_f32(uintptr_t matrix_ptr, uintptr_t points_in_ptr, uintptr_t points_out_ptr,
+                                       int num_points, double origin_x, double origin_y)
+{
+    LocalF32Writer writer{(float *)points_out_ptr, origin_x, origin_y, wasm_f64x2_make(origin_x, origin_y)};
+    transform_points_f64_dispatch((const double *)matrix_ptr, (const double *)points_in_ptr, writer, num_points);
+}
+
+// --- Command Buffer (muchas operaciones pequeñas en una sola llamada) ---
+// JS codifica un flujo de palabras int32: [opcode, status, operandos...]. Los operandos
+// de matriz son índices de slot en un arena de floats (SLOT_FLOATS por slot); los de
+// puntos son punteros WASM. El intérprete escribe status = 1 (éxito) o 0 (singular,
+// fallo de SVD o slots fuera de rango) y sigue con el siguiente comando.
+enum class CommandOp : int32_t
+{
+    Multiply = 1,        // a, b, out
+    Determinant = 2,     // m, out (escalar en el primer float del slot)
+    Invert = 3,          // m, out
+    SolveHomography = 4, // a (HOMOGRAPHY_A_SLOTS slots contiguos), b, x
+    TransformPoints = 5  // matrix, in_ptr, out_ptr, num_points
+};
+
+const int SLOT_FLOATS = 9;
+const int HOMOGRAPHY_A_SLOTS = 8; // 64 floats de A en 8 slots de 9
+const int COMMAND_HEADER_WORDS = 2;
+
+// Palabras totales del comando (cabecera incluida), 0 si el opcode es desconocido
+inline int command_word_count(int32_t opcode)
+{
+    switch ((CommandOp)opcode)
+    {
+    case CommandOp::Multiply:
+    case CommandOp::SolveHomography:
+        return COMMAND_HEADER_WORDS + 3;
+    case CommandOp::Determinant:
+    case CommandOp::Invert:
+        return COMMAND_HEADER_WORDS + 2;
+    case CommandOp::TransformPoints:
+        return COMMAND_HEADER_WORDS + 4;
+    default:
+        return 0;
+    }
+}
+
+extern "C"
+{
+    /**
+     * Ejecuta un command buffer completo.
+     * @param ops_ptr Palabras int32 de los comandos (el intérprete escribe los status).
+     * @param num_words Palabras válidas en ops_ptr.
+     * @param slots_ptr Arena de num_slots * SLOT_FLOATS floats.
+     * @returns Comandos ejecutados. Se detiene antes de un opcode desconocido o de un
+     *          comando truncado, así que un valor menor que el esperado indica error.
+     */
+    EMSCRIPTEN_KEEPALIVE int execute_ops(int32_t *ops, int num_words, float *slots, int num_slots)
+    {
+        // Slot [index, index + span) dentro del arena, o nullptr
+        auto slot = [&](int32_t index, int span = 1) -> float *
+        {
+            return index >= 0 && index <= num_slots - span ? &slots[(size_t)index * SLOT_FLOATS] : nullptr;
+        };
+
+        int executed = 0;
+        int pc = 0;
+        while (pc < num_words)
+        {
+            const int32_t opcode = ops[pc];
+            const int words = command_word_count(opcode);
+            if (words == 0 || pc + words > num_words)
+                break;
+            const int32_t *args = &ops[pc + COMMAND_HEADER_WORDS];
+            int32_t status = 0;
+
+            switch ((CommandOp)opcode)
+            {
+            case CommandOp::Multiply:
+            {
+                float *a = slot(args[0]), *b = slot(args[1]), *out = slot(args[2]);
+                if (a && b && out)
+                {
+                    multiply_matrices((uintptr_t)a, (uintptr_t)b, (uintptr_t)out);
+                    status = 1;
+                }
+                break;
+            }
+            case CommandOp::Determinant:
+            {
+                float *m = slot(args[0]), *out = slot(args[1]);
+                if (m && out)
+                {
+                    out[0] = determinant((uintptr_t)m);
+                    status = 1;
+                }
+                break;
+            }
+            case CommandOp::Invert:
+            {
+                float *m = slot(args[0]), *out = slot(args[1]);
+                if (m && out)
+                    status = invert_matrix((uintptr_t)m, (uintptr_t)out);
+                break;
+            }
+            case CommandOp::SolveHomography:
+            {
+                float *a = slot(args[0], HOMOGRAPHY_A_SLOTS), *b = slot(args[1]), *x = slot(args[2]);
+                if (a && b && x)
+                    status = solve_homography_svd((uintptr_t)a, (uintptr_t)b, (uintptr_t)x) ? 1 : 0;
+                break;
+            }
+            case CommandOp::TransformPoints:
+            {
+                float *m = slot(args[0]);
+                if (m && args[3] >= 0)
+                {
+                    transform_points_batch((uintptr_t)m, (uintptr_t)(uint32_t)args[1], (uintptr_t)(uint32_t)args[2], args[3]);
+                    status = 1;
+                }
+                break;
+            }
+            }
+
+            ops[pc + 1] = status;
+            pc += words;
+            ++executed;
+        }
+        return executed;
+    }
+}
+
+extern "C"
+{
+    /**
+     * Pliega todas las secuencias de un programa de transformación (ver
+     * transform_program.h) en una matriz por secuencia.
+     * @param code_ptr Palabras de 32 bits del programa (opcodes int32, argumentos f32).
+     * @param out_ptr max_matrices matrices; layout 0 = AoS, 1 = SoA (planos de max_matrices).
+     * @returns Número de secuencias, o -1 si el programa, el layout o la capacidad no
+     *          son válidos.
+     */
+    EMSCRIPTEN_KEEPALIVE int evaluate_transform_programs(uintptr_t code_ptr, int num_words, uintptr_t out_ptr,
+                                                         int max_matrices, int layout)
+    {
+        if (num_words < 0 || (layout != (int)MatrixBatchLayout::AoS && layout != (int)MatrixBatchLayout::SoA))
+            return -1;
+        return evaluate_transform_program((const int32_t *)code_ptr, num_words, (float *)out_ptr, max_matrices,
+                                          (MatrixBatchLayout)layout);
+    }
+}
+
+// --- Pool de buffers (handles) ---
+// Ver buffer_pool.h. Los handles son int32 > 0; JS resuelve el puntero con
+// pool_ptr justo antes de crear vistas o llamar a un kernel.
+extern "C"
+{
+    EMSCRIPTEN_KEEPALIVE int32_t pool_alloc(uint32_t bytes)
+    {
+        return BufferPool::instance().alloc(bytes);
+    }
+
+    /** Crece el buffer del handle (geométrico); 1 éxito, 0 handle inválido o sin memoria. */
+    EMSCRIPTEN_KEEPALIVE int pool_realloc(int32_t handle, uint32_t bytes, int preserve)
+    {
+        return BufferPool::instance().realloc(handle, bytes, preserve != 0) ? 1 : 0;
+    }
+
+    EMSCRIPTEN_KEEPALIVE void pool_free(int32_t handle)
+    {
+        BufferPool::instance().free(handle);
+    }
+
+    EMSCRIPTEN_KEEPALIVE int32_t arena_alloc(uint32_t bytes)
+    {
+        return BufferPool::instance().arena_alloc(bytes);
+    }
+
+    EMSCRIPTEN_KEEPALIVE void arena_reset()
+    {
+        BufferPool::instance().reset_arena();
+    }
+
+    EMSCRIPTEN_KEEPALIVE void pool_trim()
+    {
+        BufferPool::instance().trim();
+    }
+
+    /** Puntero del handle, 0 si está liberado o caducado. */
+    EMSCRIPTEN_KEEPALIVE uintptr_t pool_ptr(int32_t handle)
+    {
+        return (uintptr_t)BufferPool::instance().ptr(handle);
+    }
+
+    EMSCRIPTEN_KEEPALIVE uint32_t pool_capacity(int32_t handle)
+    {
+        return BufferPool::instance().capacity(handle);
+    }
+
+    /** Escribe BufferPoolStats (8 uint32) en out_ptr. */
+    EMSCRIPTEN_KEEPALIVE void pool_stats(uint32_t *out)
+    {
+        BufferPoolStats stats;
+        BufferPool::instance().stats(stats);
+        std::memcpy(out, &stats, sizeof(stats));
+    }
+}
+
+// --- Planes de transformación (ver transform_plan.h) ---
+static IdRegistry<TransformPlan> &transform_plans()
+{
+    static IdRegistry<TransformPlan> plans;
+    return plans;
+}
+
+static TransformPlan *find_plan(int32_t id)
+{
+    return transform_plans().find(id);
+}
+
+/**
+ * Valida layout, punteros y solapamiento con las mismas reglas que
+ * transform_points_batch / _strided / _soa, y fija la dirección y los chunks.
+ * @returns false si el solapamiento no es resoluble o los parámetros no son válidos.
+ */
+static bool configure_plan(TransformPlan &plan)
+{
+    const int n = plan.num_points;
+    if (n < 0)
+        return false;
+    if (n == 0)
+        return true;
+    switch (plan.layout)
+    {
+    case PlanLayout::Packed:
+        // Igual que transform_points_batch: chunks solo si son independientes
+        plan.chunk_points = batch_chunk_points(plan.in[0], plan.out[0], n);
+        return true;
+    case PlanLayout::Strided:
+    {
+        if (plan.in_stride < 2 || plan.out_stride < 2)
+            return false;
+        FloatRange in_range{plan.in[0], plan.in[0] + (size_t)(n - 1) * plan.in_stride + 2};
+        FloatRange out_range{plan.out[0], plan.out[0] + (size_t)(n - 1) * plan.out_stride + 2};
+        if (ranges_overlap(out_range, in_range))
+        {
+            if (plan.in_stride != plan.out_stride)
+                return false;
+            plan.reverse = layout_overlap_direction(&out_range, 1, &in_range, 1) < 0;
+        }
+        plan.chunk_points = n;
+        return true;
+    }
+    case PlanLayout::SoA:
+    {
+        FloatRange ins[2] = {{plan.in[0], plan.in[0] + n}, {plan.in[1], plan.in[1] + n}};
+        FloatRange outs[2] = {{plan.out[0], plan.out[0] + n}, {plan.out[1], plan.out[1] + n}};
+        if (ranges_overlap(outs[0], outs[1]))
+            return false;
+        const int direction = layout_overlap_direction(outs, 2, ins, 2);
+        if (direction == 0)
+            return false;
+        plan.reverse = direction < 0;
+        plan.chunk_points = n;
+        return true;
+    }
+    }
+    return false;
+}
+
+extern "C"
+{
+    /**
+     * Crea un plan para `num_points` puntos con el layout dado (ver PlanLayout).
+     * in1/out1 solo se usan en SoA (arrays y); los pasos solo en Strided.
+     * Los chunks para workers se fijan con los workers activos en este momento.
+     * La matriz inicial es la identidad: escribirla en plan_matrix_ptr y llamar a
+     * plan_update_matrix antes de ejecutar.
+     * @returns id del plan (> 0), o 0 si los parámetros o el solapamiento no son válidos.
+     */
+    EMSCRIPTEN_KEEPALIVE int32_t plan_create(int layout, uintptr_t in0, uintptr_t in1, uintptr_t out0,
+                                             uintptr_t out1, int in_stride, int out_stride, int num_points)
+    {
+        if (layout < (int)PlanLayout::Packed || layout > (int)PlanLayout::SoA)
+            return 0;
+        std::unique_ptr<TransformPlan> plan(new TransformPlan());
+        plan->layout = (PlanLayout)layout;
+        plan->in[0] = (const float *)in0;
+        plan->in[1] = (const float *)in1;
+        plan->out[0] = (float *)out0;
+        plan->out[1] = (float *)out1;
+        plan->in_stride = in_stride;
+        plan->out_stride = out_stride;
+        plan->num_points = num_points;
+        if (!configure_plan(*plan))
+            return 0;
+        plan_load_matrix(*plan);
+        return transform_plans().add(std::move(plan));
+    }
+
+    /** Puntero a los 9 floats de la matriz del plan (estable durante su vida). */
+    EMSCRIPTEN_KEEPALIVE uintptr_t plan_matrix_ptr(int32_t id)
+    {
+        TransformPlan *plan = find_plan(id);
+        return plan ? (uintptr_t)plan->matrix : 0;
+    }
+
+    /** Recarga la matriz del plan. @returns MatrixClass resultante, -1 si el id no es válido. */
+    EMSCRIPTEN_KEEPALIVE int plan_update_matrix(int32_t id)
+    {
+        TransformPlan *plan = find_plan(id);
+        return plan ? (int)plan_load_matrix(*plan) : -1;
+    }
+
+    /** Ejecuta el plan. @returns 1, o 0 si el id no es válido. */
+    EMSCRIPTEN_KEEPALIVE int plan_execute(int32_t id)
+    {
+        TransformPlan *plan = find_plan(id);
+        if (!plan)
+            return 0;
+        plan_run(*plan);
+        return 1;
+    }
+
+    EMSCRIPTEN_KEEPALIVE void plan_destroy(int32_t id)
+    {
+        transform_plans().destroy(id);
+    }
+}
+
+// --- Jerarquías de transformaciones (ver transform_hierarchy.h) ---
+static IdRegistry<TransformHierarchy> &transform_hierarchies()
+{
+    static IdRegistry<TransformHierarchy> hierarchies;
+    return hierarchies;
+}
+
+static TransformHierarchy *find_hierarchy(int32_t id)
+{
+    return transform_hierarchies().find(id);
+}
+
+extern "C"
+{
+    /**
+     * Crea una jerarquía de hasta `capacity` nodos: locales y world a la identidad,
+     * todos raíz y sucios, sin puntos. Los arrays no se mueven durante su vida.
+     * @returns id de la jerarquía (> 0), o 0 si la capacidad no es válida.
+     */
+    EMSCRIPTEN_KEEPALIVE int32_t hierarchy_create(int capacity)
+    {
+        if (capacity < 0)
+            return 0;
+        std::unique_ptr<TransformHierarchy> hierarchy(new TransformHierarchy(capacity));
+        return transform_hierarchies().add(std::move(hierarchy));
+    }
+
+    // Punteros a los arrays de la jerarquía (0 si el id no es válido)
+    EMSCRIPTEN_KEEPALIVE uintptr_t hierarchy_local_ptr(int32_t id)
+    {
+        TransformHierarchy *h = find_hierarchy(id);
+        return h ? (uintptr_t)h->local.data() : 0;
+    }
+
+    EMSCRIPTEN_KEEPALIVE uintptr_t hierarchy_world_ptr(int32_t id)
+    {
+        TransformHierarchy *h = find_hierarchy(id);
+        return h ? (uintptr_t)h->world.data() : 0;
+    }
+
+    EMSCRIPTEN_KEEPALIVE uintptr_t hierarchy_parent_ptr(int32_t id)
+    {
+        TransformHierarchy *h = find_hierarchy(id);
+        return h ? (uintptr_t)h->parent.data() : 0;
+    }
+
+    EMSCRIPTEN_KEEPALIVE uintptr_t hierarchy_dirty_ptr(int32_t id)
+    {
+        TransformHierarchy *h = find_hierarchy(id);
+        return h ? (uintptr_t)h->dirty.data() : 0;
+    }
+
+    EMSCRIPTEN_KEEPALIVE uintptr_t hierarchy_ranges_ptr(int32_t id)
+    {
+        TransformHierarchy *h = find_hierarchy(id);
+        return h ? (uintptr_t)h->point_ranges.data() : 0;
+    }
+
+    /**
+     * Propaga las matrices world de los subárboles sucios de los primeros num_nodes
+     * nodos. Con points_in_ptr != 0 transforma también el tramo de puntos de cada
+     * nodo recalculado (buffers xyxy de num_points puntos).
+     * @returns Nodos recalculados, o -1 si el id, el orden de los padres o algún
+     *          tramo de puntos no son válidos, o si hay entrada de puntos sin salida.
+     */
+    EMSCRIPTEN_KEEPALIVE int update_world_matrices(int32_t id, int num_nodes, uintptr_t points_in_ptr,
+                                                   uintptr_t points_out_ptr, int num_points)
+    {
+        TransformHierarchy *h = find_hierarchy(id);
+        if (!h || (points_in_ptr && !points_out_ptr))
+            return -1;
+        return update_hierarchy(*h, num_nodes, (const float *)points_in_ptr, (float *)points_out_ptr, num_points);
+    }
+
+    EMSCRIPTEN_KEEPALIVE void hierarchy_destroy(int32_t id)
+    {
+        transform_hierarchies().destroy(id);
+    }
+}
+
+// --- Animaciones por keyframes (ver keyframe_animation.h) ---
+static IdRegistry<KeyframeAnimation> &keyframe_animations()
+{
+    static IdRegistry<KeyframeAnimation> animations;
+    return animations;
+}
+
+static KeyframeAnimation *find_animation(int32_t id)
+{
+    return keyframe_animations().find(id);
+}
+
+extern "C"
+{
+    /** Crea una animación sin pistas. @returns id de la animación (> 0). */
+    EMSCRIPTEN_KEEPALIVE int32_t animation_create()
+    {
+        std::unique_ptr<KeyframeAnimation> animation(new KeyframeAnimation());
+        return keyframe_animations().add(std::move(animation));
+    }
+
+    /**
+     * Descompone num_keys matrices (AoS column-major) y las añade como una pista.
+     * times: float por keyframe, estrictamente crecientes; easings: uint8 por keyframe.
+     * @returns Índice de la pista, -1 si el id o los keyframes no son válidos, o -2
+     *          si alguna matriz no es afín.
+     */
+    EMSCRIPTEN_KEEPALIVE int animation_add_track(int32_t id, uintptr_t matrices_ptr, uintptr_t times_ptr,
+                                                 uintptr_t easings_ptr, int num_keys)
+    {
+        KeyframeAnimation *anim = find_animation(id);
+        if (!anim)
+            return -1;
+        return add_animation_track(*anim, (const float *)matrices_ptr, (const float *)times_ptr,
+                                   (const uint8_t *)easings_ptr, num_keys);
+    }
+
+    /**
+     * Evalúa todas las pistas en el tiempo t y escribe una matriz por pista en
+     * out_ptr (layout: 0 = AoS, 1 = SoA con planos de num_tracks floats).
+     * @returns Número de pistas, o -1 si el id o el layout no son válidos.
+     */
+    EMSCRIPTEN_KEEPALIVE int animation_evaluate(int32_t id, float t, uintptr_t out_ptr, int layout)
+    {
+        KeyframeAnimation *anim = find_animation(id);
+        if (!anim || (layout != (int)MatrixBatchLayout::AoS && layout != (int)MatrixBatchLayout::SoA))
+            return -1;
+        return evaluate_animation(*anim, t, (float *)out_ptr, (MatrixBatchLayout)layout);
+    }
+
+    EMSCRIPTEN_KEEPALIVE void animation_destroy(int32_t id)
+    {
+        keyframe_animations().destroy(id);
+    }
+}
+
+int classify_matrix_class(uintptr_t matrix_ptr)
+{
+    return static_cast<int>(classify_matrix((const float *)matrix_ptr));
 }
 
 // --- Embind ---
@@ -228,5 +1194,31 @@ EMSCRIPTEN_BINDINGS(matrix_module)
     function("determinant", &determinant, allow_raw_pointers());
     function("invertMatrix", &invert_matrix, allow_raw_pointers());
     function("solveHomographySVD", &solve_homography_svd, allow_raw_pointers());
+    function("multiplyMatricesBatch", &multiply_matrices_batch, allow_raw_pointers());
+    function("invertMatrices", &invert_matrices, allow_raw_pointers());
+    function("determinants", &determinants, allow_raw_pointers());
+    function("multiplyMatricesF64", &multiply_matrices_f64, allow_raw_pointers());
+    function("determinantF64", &determinant_f64, allow_raw_pointers());
+    function("invertMatrixF64", &invert_matrix_f64, allow_raw_pointers());
     function("transformPointsBatch", &transform_points_batch, allow_raw_pointers());
+    function("transformPointsBatchStats", &transform_points_batch_stats, allow_raw_pointers());
+    function("transformPointsCull", &transform_points_cull, allow_raw_pointers());
+    function("transformPointsTyped", &transform_points_typed, allow_raw_pointers());
+    function("transformPointsBatchF64", &transform_points_batch_f64, allow_raw_pointers());
+    function("transformPointsBatchF64ToF32", &transform_points_batch_f64_to_f32, allow_raw_pointers());
+    function("transformPointsStrided", &transform_points_strided, allow_raw_pointers());
+    function("transformPointsSoA", &transform_points_soa, allow_raw_pointers());
+    function("transformPointsInstanced", &transform_points_instanced, allow_raw_pointers());
+    function("transformPointsInstanceRanges", &transform_points_instance_ranges, allow_raw_pointers());
+    function("transformPointsRanges", &transform_points_ranges, allow_raw_pointers());
+    function("spatialOrder", &spatial_order, allow_raw_pointers());
+    function("applyPermutation", &apply_permutation, allow_raw_pointers());
+    function("encodePoints", &encode_points, allow_raw_pointers());
+    function("decodePoints", &decode_points, allow_raw_pointers());
+    function("classifyMatrix", &classify_matrix_class, allow_raw_pointers());
+    function("setTransformThreads", &set_transform_threads);
+    function("getTransformThreads", &get_transform_threads);
+    function("setTransformPrecision", &set_transform_precision);
+    function("getTransformPrecision", &get_transform_precision);
+    function("hasRelaxedSimd", &has_relaxed_simd);
 }
\ No newline at end of file
@@ -0,0 +1,17 @@
+// core_cpp/src/matrix_types.h
+#pragma once
+
+#include "../vendor/eigen-3.4.0/Eigen/Dense"
+
+// --- Tipos ---
+typedef Eigen::Matrix<float, 3, 3> Matrix3f;
+typedef Eigen::Matrix<float, 8, 8> Matrix8f;
+typedef Eigen::Matrix<float, 8, 1> Vector8f;
+typedef Eigen::Matrix<double, 3, 3> Matrix3d;
+// Usar un epsilon consistente, quizás un poco más relajado que el de SVD si es necesario
+const float MATRIX_INVERSE_EPSILON = 1e-7f; // Epsilon específico para la inversa
+const float MATRIX_SVD_EPSILON = 1e-6f;     // Epsilon para SVD (como estaba antes)
+// Mismo umbral que CONFIG.EPSILON (usado por MatrixUtils.isAffine en JS)
+const float MATRIX_CLASSIFY_EPSILON = 1e-10f;
+// Epsilon de la inversa en f64 (el determinante de matrices CAD/GIS puede ser muy pequeño en f32)
+const double MATRIX_INVERSE_EPSILON_F64 = 1e-14;
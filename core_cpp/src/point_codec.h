@@ -0,0 +1,264 @@
+// core_cpp/src/point_codec.h
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "simd_compat.h"
+
+// --- Codec de Puntos (cuantizar + delta + varint) ---
+// Formato compacto para guardar o transferir lotes xyxy grandes:
+// 1. Cuantizar a una rejilla: q = round((v - origin) / step), origin = mínimo del AABB.
+// 2. Delta en el orden del buffer: d = q[i] - q[i-1] por eje (q[-1] = 0).
+// 3. ZigZag (signo al bit bajo) y varint LEB128, intercalando x e y.
+// Con puntos espacialmente coherentes (p. ej. tras spatial_order) casi todos los
+// deltas caben en 1 byte: 2 bytes por punto frente a 8 del f32. El decoder procesa
+// 16 bytes de varints de un byte (8 puntos) por iteración SIMD y es reanudable,
+// así que puede decodificar mientras llegan los bytes.
+// Error máximo por eje: step / 2 (más el redondeo f32 de origin + q * step).
+
+const uint32_t POINT_CODEC_MAGIC = 0x31515450; // "PTQ1" en little endian
+const int POINT_CODEC_HEADER_BYTES = 24;
+const int POINT_CODEC_MAX_VARINT_BYTES = 5;
+// Celdas por eje: hasta 2^24 q es exacto en f32; por defecto 16 bits dentro del AABB
+const float POINT_CODEC_MAX_CELLS = 16777216.0f;
+const float POINT_CODEC_DEFAULT_CELLS = 65535.0f;
+
+const int POINT_CODEC_INVALID = -1;        // Entrada no finita, cabecera o datos corruptos
+const int POINT_CODEC_STEP_RANGE = -2;     // step <= 0 explícito o rango > 2^24 celdas
+const int POINT_CODEC_NO_CAPACITY = -3;    // Buffer de salida insuficiente
+
+struct PointCodecHeader
+{
+    uint32_t magic;
+    uint32_t num_points;
+    float origin_x;
+    float origin_y;
+    float step;
+    uint32_t payload_bytes; // Bytes de varints tras la cabecera
+};
+static_assert(sizeof(PointCodecHeader) == POINT_CODEC_HEADER_BYTES, "PointCodecHeader layout");
+
+// Progreso del decoder entre llamadas (se pone a cero antes de empezar un stream)
+struct PointDecodeState
+{
+    int32_t byte_offset; // 0 = aún no se ha leído la cabecera
+    int32_t points_decoded;
+    int32_t prev_x;
+    int32_t prev_y;
+};
+
+/** Tamaño máximo codificado de n puntos (cabecera + 2 varints de 5 bytes por punto). */
+inline int64_t point_codec_max_bytes(int n)
+{
+    return POINT_CODEC_HEADER_BYTES + (int64_t)n * 2 * POINT_CODEC_MAX_VARINT_BYTES;
+}
+
+inline uint8_t *write_varint(uint8_t *p, uint32_t v)
+{
+    while (v >= 0x80)
+    {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+// 1 leído, 0 faltan bytes (p no avanza), POINT_CODEC_INVALID si pasa de 5 bytes
+inline int read_varint(const uint8_t *&p, const uint8_t *end, uint32_t &v)
+{
+    uint32_t r = 0;
+    for (int k = 0; k < POINT_CODEC_MAX_VARINT_BYTES; ++k)
+    {
+        if (p + k >= end)
+            return 0;
+        const uint8_t b = p[k];
+        r |= (uint32_t)(b & 0x7f) << (7 * k);
+        if (!(b & 0x80))
+        {
+            p += k + 1;
+            v = r;
+            return 1;
+        }
+    }
+    return POINT_CODEC_INVALID;
+}
+
+inline uint32_t zigzag_encode(int32_t d) { return ((uint32_t)d << 1) ^ (uint32_t)(d >> 31); }
+inline int32_t zigzag_decode(uint32_t z) { return (int32_t)(z >> 1) ^ -(int32_t)(z & 1); }
+
+/**
+ * Codifica n puntos xyxy. step <= 0 elige 2^16 celdas dentro del AABB.
+ * @returns Bytes escritos (cabecera incluida) o un código POINT_CODEC_* negativo.
+ */
+inline int encode_points_quantized(const float *pts, int n, float step, uint8_t *out, int capacity)
+{
+    if (n < 0)
+        return POINT_CODEC_INVALID;
+    float min_x = 0.0f, min_y = 0.0f, max_x = 0.0f, max_y = 0.0f;
+    for (int i = 0; i < n; ++i)
+    {
+        const float x = pts[i * 2];
+        const float y = pts[i * 2 + 1];
+        if (!std::isfinite(x) || !std::isfinite(y))
+            return POINT_CODEC_INVALID;
+        if (i == 0 || x < min_x)
+            min_x = x;
+        if (i == 0 || x > max_x)
+            max_x = x;
+        if (i == 0 || y < min_y)
+            min_y = y;
+        if (i == 0 || y > max_y)
+            max_y = y;
+    }
+    const float extent = std::fmax(max_x - min_x, max_y - min_y);
+    if (!(step > 0.0f))
+    {
+        if (step < 0.0f || step != step)
+            return POINT_CODEC_STEP_RANGE;
+        step = extent > 0.0f ? extent / POINT_CODEC_DEFAULT_CELLS : 1.0f;
+    }
+    if (!std::isfinite(step) || !(extent / step < POINT_CODEC_MAX_CELLS))
+        return POINT_CODEC_STEP_RANGE;
+    if ((int64_t)capacity < point_codec_max_bytes(n))
+        return POINT_CODEC_NO_CAPACITY;
+
+    const float inv_step = 1.0f / step;
+    uint8_t *p = out + POINT_CODEC_HEADER_BYTES;
+    // 2 puntos por vector; prev guarda el punto anterior en las vías 2 y 3
+    const v128_t origin = wasm_f32x4_make(min_x, min_y, min_x, min_y);
+    const v128_t scale = wasm_f32x4_splat(inv_step);
+    v128_t prev = wasm_i32x4_splat(0);
+    uint32_t z[4];
+    int i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        const v128_t v = wasm_v128_load(pts + (size_t)i * 2);
+        const v128_t q = wasm_i32x4_trunc_sat_f32x4(
+            wasm_f32x4_nearest(wasm_f32x4_mul(wasm_f32x4_sub(v, origin), scale)));
+        const v128_t d = wasm_i32x4_sub(q, wasm_i32x4_shuffle(prev, q, 2, 3, 4, 5));
+        wasm_v128_store(z, wasm_v128_xor(wasm_i32x4_shl(d, 1), wasm_i32x4_shr(d, 31)));
+        for (int k = 0; k < 4; ++k)
+            p = write_varint(p, z[k]);
+        prev = q;
+    }
+    int32_t prev_x = wasm_i32x4_extract_lane(prev, 2);
+    int32_t prev_y = wasm_i32x4_extract_lane(prev, 3);
+    for (; i < n; ++i)
+    {
+        const int32_t qx = (int32_t)std::nearbyint((pts[i * 2] - min_x) * inv_step);
+        const int32_t qy = (int32_t)std::nearbyint((pts[i * 2 + 1] - min_y) * inv_step);
+        p = write_varint(p, zigzag_encode(qx - prev_x));
+        p = write_varint(p, zigzag_encode(qy - prev_y));
+        prev_x = qx;
+        prev_y = qy;
+    }
+
+    const PointCodecHeader header{POINT_CODEC_MAGIC, (uint32_t)n, min_x, min_y, step,
+                                  (uint32_t)(p - out - POINT_CODEC_HEADER_BYTES)};
+    std::memcpy(out, &header, sizeof(header));
+    return (int)(p - out);
+}
+
+/** Lee y valida la cabecera. @returns 1 válida, 0 faltan bytes, POINT_CODEC_INVALID. */
+inline int read_point_codec_header(const uint8_t *in, int available, PointCodecHeader &header)
+{
+    if (available < POINT_CODEC_HEADER_BYTES)
+        return 0;
+    std::memcpy(&header, in, sizeof(header));
+    if (header.magic != POINT_CODEC_MAGIC || header.num_points > (uint32_t)INT32_MAX / 2 ||
+        !(header.step > 0.0f) || !std::isfinite(header.step) || !std::isfinite(header.origin_x) ||
+        !std::isfinite(header.origin_y) ||
+        header.payload_bytes > (uint64_t)header.num_points * 2 * POINT_CODEC_MAX_VARINT_BYTES)
+        return POINT_CODEC_INVALID;
+    return 1;
+}
+
+/**
+ * Decodifica los puntos completos de in[0, available) a partir de state y lo
+ * actualiza; se puede llamar de nuevo cuando lleguen más bytes (in debe contener
+ * el stream desde el principio). out recibe cada punto en su posición final.
+ * @returns Puntos decodificados en total o POINT_CODEC_INVALID.
+ */
+inline int decode_points_quantized(const uint8_t *in, int available, float *out, PointDecodeState &state)
+{
+    PointCodecHeader header;
+    const int ok = read_point_codec_header(in, available, header);
+    if (ok <= 0)
+        return ok;
+    const int64_t total = POINT_CODEC_HEADER_BYTES + (int64_t)header.payload_bytes;
+    if (available > total)
+        available = (int)total;
+    if (state.byte_offset == 0)
+        state = PointDecodeState{POINT_CODEC_HEADER_BYTES, 0, 0, 0};
+
+    const int n = (int)header.num_points;
+    const uint8_t *p = in + state.byte_offset;
+    const uint8_t *end = in + available;
+    int i = state.points_decoded;
+    int32_t prev_x = state.prev_x;
+    int32_t prev_y = state.prev_y;
+    const float step = header.step;
+    const v128_t origin = wasm_f32x4_make(header.origin_x, header.origin_y, header.origin_x, header.origin_y);
+    const v128_t step4 = wasm_f32x4_splat(step);
+    const v128_t zero = wasm_i32x4_splat(0);
+    const v128_t one = wasm_i32x4_splat(1);
+    while (i < n)
+    {
+        // Vía rápida: 16 varints de un byte = 8 puntos
+        if (n - i >= 8 && end - p >= 16)
+        {
+            const v128_t bytes = wasm_v128_load(p);
+            if (wasm_i8x16_bitmask(bytes) == 0)
+            {
+                const v128_t lo = wasm_u16x8_extend_low_u8x16(bytes);
+                const v128_t hi = wasm_u16x8_extend_high_u8x16(bytes);
+                const v128_t zs[4] = {wasm_u32x4_extend_low_u16x8(lo), wasm_u32x4_extend_high_u16x8(lo),
+                                      wasm_u32x4_extend_low_u16x8(hi), wasm_u32x4_extend_high_u16x8(hi)};
+                v128_t carry = wasm_i32x4_make(prev_x, prev_y, prev_x, prev_y);
+                for (int k = 0; k < 4; ++k)
+                {
+                    const v128_t z = zs[k];
+                    v128_t d = wasm_v128_xor(wasm_u32x4_shr(z, 1), wasm_i32x4_sub(zero, wasm_v128_and(z, one)));
+                    // Prefijo por punto: [dx0, dy0, dx1, dy1] -> [dx0, dy0, dx0 + dx1, dy0 + dy1]
+                    d = wasm_i32x4_add(d, wasm_i32x4_shuffle(zero, d, 0, 1, 4, 5));
+                    const v128_t q = wasm_i32x4_add(d, carry);
+                    carry = wasm_i32x4_shuffle(q, q, 2, 3, 2, 3);
+                    const v128_t v = wasm_f32x4_add(wasm_f32x4_mul(wasm_f32x4_convert_i32x4(q), step4), origin);
+                    wasm_v128_store(out + (size_t)(i + k * 2) * 2, v);
+                }
+                prev_x = wasm_i32x4_extract_lane(carry, 0);
+                prev_y = wasm_i32x4_extract_lane(carry, 1);
+                i += 8;
+                p += 16;
+                continue;
+            }
+        }
+        const uint8_t *cursor = p;
+        uint32_t zx = 0, zy = 0;
+        int r = read_varint(cursor, end, zx);
+        if (r == 1)
+            r = read_varint(cursor, end, zy);
+        if (r < 0)
+            return POINT_CODEC_INVALID;
+        if (r == 0)
+            break; // Punto incompleto: esperar más bytes
+        // Aritmética sin signo: datos corruptos no deben provocar overflow con signo
+        prev_x = (int32_t)((uint32_t)prev_x + (uint32_t)zigzag_decode(zx));
+        prev_y = (int32_t)((uint32_t)prev_y + (uint32_t)zigzag_decode(zy));
+        out[(size_t)i * 2] = (float)prev_x * step + header.origin_x;
+        out[(size_t)i * 2 + 1] = (float)prev_y * step + header.origin_y;
+        p = cursor;
+        ++i;
+    }
+
+    state.byte_offset = (int32_t)(p - in);
+    state.points_decoded = i;
+    state.prev_x = prev_x;
+    state.prev_y = prev_y;
+    // Completo: el payload debe acabar justo aquí
+    if (i == n && p != in + total)
+        return POINT_CODEC_INVALID;
+    return i;
+}
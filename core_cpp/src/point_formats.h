@@ -0,0 +1,287 @@
+// core_cpp/src/point_formats.h
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include "simd_compat.h"
+
+#include "point_kernels.h"
+
+// --- Formatos de Elemento de Punto ---
+// Formatos de E/S xyxy de transform_points_typed. La conversión se hace en registros,
+// dentro del mismo bucle que la transformación (sin pasada previa ni posterior).
+enum class PointFormat : int
+{
+    F32 = 0,     // float IEEE de 32 bits
+    F16 = 1,     // half IEEE de 16 bits (el formato HALF_FLOAT de la GPU)
+    SNorm16 = 2, // int16 normalizado: valor = (q / 32767) * scale + bias
+};
+
+// Escala/bias por eje para SNorm16. Se ignoran en los demás formatos.
+struct PointQuantization
+{
+    float scale_x;
+    float scale_y;
+    float bias_x;
+    float bias_y;
+};
+
+// --- Conversión half <-> float (4 vías) ---
+// SIMD128 no tiene instrucciones f16, así que se hace con aritmética de bits:
+// redondeo al par más cercano, subnormales, Inf y NaN igual que la conversión IEEE.
+
+// Entrada: 4 halves en los 16 bits bajos de cada vía i32. Salida: 4 floats.
+inline v128_t half_to_float4(v128_t h)
+{
+    const v128_t shifted_exp = wasm_i32x4_splat(0x7c00 << 13);
+    v128_t o = wasm_i32x4_shl(wasm_v128_and(h, wasm_i32x4_splat(0x7fff)), 13);
+    const v128_t exp = wasm_v128_and(o, shifted_exp);
+    o = wasm_i32x4_add(o, wasm_i32x4_splat((127 - 15) << 23));
+
+    // Inf/NaN: llevar el exponente al máximo de f32
+    const v128_t is_inf_nan = wasm_i32x4_eq(exp, shifted_exp);
+    o = wasm_i32x4_add(o, wasm_v128_and(is_inf_nan, wasm_i32x4_splat((128 - 16) << 23)));
+
+    // Cero/subnormal: renormalizar restando un número mágico en coma flotante
+    const v128_t is_denorm = wasm_i32x4_eq(exp, wasm_i32x4_splat(0));
+    const v128_t magic = wasm_i32x4_splat(113 << 23);
+    const v128_t denorm = wasm_f32x4_sub(wasm_i32x4_add(o, wasm_i32x4_splat(1 << 23)), magic);
+    o = wasm_v128_bitselect(denorm, o, is_denorm);
+
+    const v128_t sign = wasm_i32x4_shl(wasm_v128_and(h, wasm_i32x4_splat(0x8000)), 16);
+    return wasm_v128_or(o, sign);
+}
+
+// Entrada: 4 floats. Salida: 4 halves en los 16 bits bajos de cada vía i32.
+inline v128_t float_to_half4(v128_t f)
+{
+    const v128_t sign_mask = wasm_i32x4_splat((int32_t)0x80000000u);
+    const v128_t sign = wasm_v128_and(f, sign_mask);
+    f = wasm_v128_xor(f, sign); // |f| como entero positivo
+
+    // |f| >= 65520 -> Inf (o NaN quieto si ya era NaN)
+    const v128_t f16_overflow = wasm_i32x4_splat((127 + 16) << 23);
+    const v128_t f32_inf = wasm_i32x4_splat(255 << 23);
+    const v128_t overflow = wasm_i32x4_ge(f, f16_overflow);
+    const v128_t inf_nan = wasm_v128_bitselect(wasm_i32x4_splat(0x7e00), wasm_i32x4_splat(0x7c00),
+                                               wasm_i32x4_gt(f, f32_inf));
+
+    // Subnormales de f16 (|f| < 2^-14): la suma en coma flotante redondea por nosotros
+    const v128_t denorm_magic = wasm_i32x4_splat(((127 - 15) + (23 - 10) + 1) << 23);
+    const v128_t is_denorm = wasm_i32x4_lt(f, wasm_i32x4_splat(113 << 23));
+    const v128_t denorm = wasm_i32x4_sub(wasm_f32x4_add(f, denorm_magic), denorm_magic);
+
+    // Normales: reajustar el exponente y redondear al par (0xfff + bit impar de la mantisa)
+    const v128_t mant_odd = wasm_v128_and(wasm_u32x4_shr(f, 13), wasm_i32x4_splat(1));
+    v128_t normal = wasm_i32x4_add(f, wasm_i32x4_splat(0xfff - ((127 - 15) << 23)));
+    normal = wasm_u32x4_shr(wasm_i32x4_add(normal, mant_odd), 13);
+
+    v128_t o = wasm_v128_bitselect(denorm, normal, is_denorm);
+    o = wasm_v128_bitselect(inf_nan, o, overflow);
+    return wasm_v128_or(o, wasm_u32x4_shr(sign, 16));
+}
+
+inline float half_to_float(uint16_t h)
+{
+    return wasm_f32x4_extract_lane(half_to_float4(wasm_i32x4_splat(h)), 0);
+}
+
+inline uint16_t float_to_half(float f)
+{
+    return (uint16_t)wasm_i32x4_extract_lane(float_to_half4(wasm_f32x4_splat(f)), 0);
+}
+
+// --- Lectores / Escritores por Formato ---
+// Mismo contrato que los layouts de point_kernels.h (load4/load1 o store4/store1),
+// siempre sobre puntos xyxy empaquetados.
+
+struct F32Reader
+{
+    const float *in;
+
+    inline void load4(int i, v128_t &x, v128_t &y) const
+    {
+        PackedLayout{in, nullptr}.load4(i, x, y);
+    }
+    inline void load1(int i, float &x, float &y) const
+    {
+        x = in[i * 2];
+        y = in[i * 2 + 1];
+    }
+};
+
+struct F32Writer
+{
+    float *out;
+
+    inline void store4(int i, v128_t x, v128_t y) const
+    {
+        PackedLayout{nullptr, out}.store4(i, x, y);
+    }
+    inline void store1(int i, float x, float y) const
+    {
+        out[i * 2] = x;
+        out[i * 2 + 1] = y;
+    }
+};
+
+struct F16Reader
+{
+    const uint16_t *in;
+
+    inline void load4(int i, v128_t &x, v128_t &y) const
+    {
+        const v128_t h = wasm_v128_load(&in[i * 2]); // 8 halves: x1 y1 ... x4 y4
+        const v128_t xy12 = half_to_float4(wasm_u32x4_extend_low_u16x8(h));
+        const v128_t xy34 = half_to_float4(wasm_u32x4_extend_high_u16x8(h));
+        x = wasm_i32x4_shuffle(xy12, xy34, 0, 2, 4, 6);
+        y = wasm_i32x4_shuffle(xy12, xy34, 1, 3, 5, 7);
+    }
+    inline void load1(int i, float &x, float &y) const
+    {
+        x = half_to_float(in[i * 2]);
+        y = half_to_float(in[i * 2 + 1]);
+    }
+};
+
+struct F16Writer
+{
+    uint16_t *out;
+
+    inline void store4(int i, v128_t x, v128_t y) const
+    {
+        const v128_t h12 = float_to_half4(wasm_i32x4_shuffle(x, y, 0, 4, 1, 5));
+        const v128_t h34 = float_to_half4(wasm_i32x4_shuffle(x, y, 2, 6, 3, 7));
+        // Las vías valen 0..0xffff: el estrechamiento sin signo no satura
+        wasm_v128_store(&out[i * 2], wasm_u16x8_narrow_i32x4(h12, h34));
+    }
+    inline void store1(int i, float x, float y) const
+    {
+        out[i * 2] = float_to_half(x);
+        out[i * 2 + 1] = float_to_half(y);
+    }
+};
+
+// Factores ya combinados: lectura v = q * mul + bias; escritura q = (v - bias) * mul
+struct SNormCoeffs
+{
+    float mul_x, mul_y, bias_x, bias_y;
+    v128_t mul_v;  // (mul_x, mul_y, mul_x, mul_y): se aplica sobre xyxy
+    v128_t bias_v; // (bias_x, bias_y, bias_x, bias_y)
+};
+
+inline SNormCoeffs snorm_read_coeffs(const PointQuantization &q)
+{
+    SNormCoeffs c{q.scale_x / 32767.0f, q.scale_y / 32767.0f, q.bias_x, q.bias_y, {}, {}};
+    c.mul_v = wasm_f32x4_make(c.mul_x, c.mul_y, c.mul_x, c.mul_y);
+    c.bias_v = wasm_f32x4_make(c.bias_x, c.bias_y, c.bias_x, c.bias_y);
+    return c;
+}
+
+inline SNormCoeffs snorm_write_coeffs(const PointQuantization &q)
+{
+    SNormCoeffs c{32767.0f / q.scale_x, 32767.0f / q.scale_y, q.bias_x, q.bias_y, {}, {}};
+    c.mul_v = wasm_f32x4_make(c.mul_x, c.mul_y, c.mul_x, c.mul_y);
+    c.bias_v = wasm_f32x4_make(c.bias_x, c.bias_y, c.bias_x, c.bias_y);
+    return c;
+}
+
+struct SNorm16Reader
+{
+    const int16_t *in;
+    SNormCoeffs q;
+
+    inline void load4(int i, v128_t &x, v128_t &y) const
+    {
+        const v128_t s = wasm_v128_load(&in[i * 2]);
+        const v128_t xy12 = wasm_f32x4_add(wasm_f32x4_mul(wasm_f32x4_convert_i32x4(wasm_i32x4_extend_low_i16x8(s)), q.mul_v), q.bias_v);
+        const v128_t xy34 = wasm_f32x4_add(wasm_f32x4_mul(wasm_f32x4_convert_i32x4(wasm_i32x4_extend_high_i16x8(s)), q.mul_v), q.bias_v);
+        x = wasm_i32x4_shuffle(xy12, xy34, 0, 2, 4, 6);
+        y = wasm_i32x4_shuffle(xy12, xy34, 1, 3, 5, 7);
+    }
+    inline void load1(int i, float &x, float &y) const
+    {
+        x = (float)in[i * 2] * q.mul_x + q.bias_x;
+        y = (float)in[i * 2 + 1] * q.mul_y + q.bias_y;
+    }
+};
+
+/**
+ * Escribe int16 normalizados redondeando al más cercano y saturando a [-32767, 32767]
+ * (el rango de SNORM en la GPU). Las salidas NaN (puntos degenerados) se escriben como 0.
+ */
+struct SNorm16Writer
+{
+    int16_t *out;
+    SNormCoeffs q;
+
+    static inline v128_t quantize4(v128_t v, const SNormCoeffs &q)
+    {
+        v128_t s = wasm_f32x4_nearest(wasm_f32x4_mul(wasm_f32x4_sub(v, q.bias_v), q.mul_v));
+        s = wasm_f32x4_max(wasm_f32x4_min(s, wasm_f32x4_splat(32767.0f)), wasm_f32x4_splat(-32767.0f));
+        return wasm_i32x4_trunc_sat_f32x4(s); // NaN -> 0
+    }
+    static inline int16_t quantize1(float v, float bias, float mul)
+    {
+        const float s = std::nearbyint((v - bias) * mul);
+        if (std::isnan(s))
+            return 0;
+        return (int16_t)std::max(-32767.0f, std::min(32767.0f, s));
+    }
+
+    inline void store4(int i, v128_t x, v128_t y) const
+    {
+        const v128_t s12 = quantize4(wasm_i32x4_shuffle(x, y, 0, 4, 1, 5), q);
+        const v128_t s34 = quantize4(wasm_i32x4_shuffle(x, y, 2, 6, 3, 7), q);
+        wasm_v128_store(&out[i * 2], wasm_i16x8_narrow_i32x4(s12, s34));
+    }
+    inline void store1(int i, float x, float y) const
+    {
+        out[i * 2] = quantize1(x, q.bias_x, q.mul_x);
+        out[i * 2 + 1] = quantize1(y, q.bias_y, q.mul_y);
+    }
+};
+
+// Combina un lector y un escritor en un layout para transform_points_kernel
+template <class Reader, class Writer>
+struct ConvertLayout
+{
+    Reader reader;
+    Writer writer;
+
+    inline void load4(int i, v128_t &x, v128_t &y) const { reader.load4(i, x, y); }
+    inline void store4(int i, v128_t x, v128_t y) const { writer.store4(i, x, y); }
+    inline void load1(int i, float &x, float &y) const { reader.load1(i, x, y); }
+    inline void store1(int i, float x, float y) const { writer.store1(i, x, y); }
+    // La identidad también convierte: siempre se recorre el bucle
+    inline bool copy_identity(int) const { return false; }
+};
+
+template <class Reader>
+void transform_points_typed_write(MatrixClass cls, const TransformCoeffs &c, const Reader &reader,
+                                  uintptr_t out_ptr, PointFormat out_format,
+                                  const PointQuantization &out_q, int num_points)
+{
+    switch (out_format)
+    {
+    case PointFormat::F16:
+        transform_points_dispatch(cls, c, ConvertLayout<Reader, F16Writer>{reader, {(uint16_t *)out_ptr}}, num_points);
+        break;
+    case PointFormat::SNorm16:
+        transform_points_dispatch(cls, c, ConvertLayout<Reader, SNorm16Writer>{reader, {(int16_t *)out_ptr, snorm_write_coeffs(out_q)}}, num_points);
+        break;
+    default:
+        transform_points_dispatch(cls, c, ConvertLayout<Reader, F32Writer>{reader, {(float *)out_ptr}}, num_points);
+        break;
+    }
+}
+
+inline bool is_valid_point_format(int format)
+{
+    return format >= (int)PointFormat::F32 && format <= (int)PointFormat::SNorm16;
+}
+
+inline int point_format_bytes(PointFormat format)
+{
+    return format == PointFormat::F32 ? 4 : 2;
+}
@@ -0,0 +1,843 @@
+// core_cpp/src/point_kernels.h
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include "simd_compat.h"
+
+#include "matrix_types.h"
+
+// --- Clasificación de Matrices ---
+// Ordenadas de menor a mayor coste: cada clase es un caso particular de la siguiente.
+enum class MatrixClass : int
+{
+    Identity = 0,
+    Translate = 1,
+    ScaleTranslate = 2,
+    Affine = 3,
+    Projective = 4
+};
+
+inline bool coeff_near(float value, float target)
+{
+    return std::abs(value - target) < MATRIX_CLASSIFY_EPSILON;
+}
+
+/**
+ * Clasifica una matriz 3x3 (column-major, mismo layout que Matrix3x3 en JS).
+ * La frontera afín/proyectiva usa la misma prueba que MatrixUtils.isAffine:
+ * fila de perspectiva (m2, m5, m8) == (0, 0, 1). Coeficientes NaN caen en Projective.
+ */
+inline MatrixClass classify_matrix(const float *m)
+{
+    if (!coeff_near(m[2], 0.0f) || !coeff_near(m[5], 0.0f) || !coeff_near(m[8], 1.0f))
+        return MatrixClass::Projective;
+    if (!coeff_near(m[1], 0.0f) || !coeff_near(m[3], 0.0f))
+        return MatrixClass::Affine;
+    if (!coeff_near(m[0], 1.0f) || !coeff_near(m[4], 1.0f))
+        return MatrixClass::ScaleTranslate;
+    if (!coeff_near(m[6], 0.0f) || !coeff_near(m[7], 0.0f))
+        return MatrixClass::Translate;
+    return MatrixClass::Identity;
+}
+
+// --- Modos de Precisión ---
+// Exact: mul + add separados y división completa para 1/W (resultado idéntico al de
+//        la build sin relaxed-SIMD).
+// Fast:  a*b+c con relaxed_madd (si la build tiene -mrelaxed-simd; si no, mul + add)
+//        y 1/W por estimación + 2 pasos de Newton-Raphson. Error relativo de 1/W
+//        <= FAST_RECIPROCAL_MAX_REL_ERROR para |W| en [MATRIX_SVD_EPSILON, 1e38];
+//        en la salida, |fast - exact| <= FAST_TRANSFORM_MAX_ERROR * max(|exact|, 1)
+//        para coordenadas de pantalla. El residuo escalar (0-3 puntos) es siempre Exact.
+enum class TransformPrecision : int
+{
+    Exact = 0,
+    Fast = 1
+};
+
+const float FAST_RECIPROCAL_MAX_REL_ERROR = 1e-5f; // Medido: 6.6e-6
+const float FAST_TRANSFORM_MAX_ERROR = 1e-4f;
+
+// Modo global usado por load_transform_coeffs (se cambia desde JS, un solo hilo)
+inline TransformPrecision &transform_precision()
+{
+    static TransformPrecision precision = TransformPrecision::Exact;
+    return precision;
+}
+
+// a*b + c y -(a*b) + c. En relaxed-SIMD el motor puede fusionar o no el redondeo.
+inline v128_t f32x4_madd(v128_t a, v128_t b, v128_t c)
+{
+#ifdef __wasm_relaxed_simd__
+    return wasm_f32x4_relaxed_madd(a, b, c);
+#else
+    return wasm_f32x4_add(wasm_f32x4_mul(a, b), c);
+#endif
+}
+
+inline v128_t f32x4_nmadd(v128_t a, v128_t b, v128_t c)
+{
+#ifdef __wasm_relaxed_simd__
+    return wasm_f32x4_relaxed_nmadd(a, b, c);
+#else
+    return wasm_f32x4_sub(c, wasm_f32x4_mul(a, b));
+#endif
+}
+
+// Estimación inicial de 1/w restando los bits a una constante (error relativo ~5%,
+// conserva el signo); cada paso de Newton-Raphson r += r*(1 - w*r) eleva el error al
+// cuadrado: 2.6e-3 y 6.6e-6. Relaxed-SIMD no tiene recíproca aproximada.
+const int32_t FAST_RECIPROCAL_MAGIC = 0x7EF311C3;
+
+inline v128_t f32x4_reciprocal_fast(v128_t w, v128_t one_v)
+{
+    v128_t r = wasm_i32x4_sub(wasm_i32x4_splat(FAST_RECIPROCAL_MAGIC), w);
+    r = f32x4_madd(r, f32x4_nmadd(w, r, one_v), r);
+    r = f32x4_madd(r, f32x4_nmadd(w, r, one_v), r);
+    return r;
+}
+
+// --- Coeficientes Pre-Splatteados ---
+// s[k] = m[k] escalar, v[k] = m[k] repetido en las 4 vías.
+struct TransformCoeffs
+{
+    float s[9];
+    v128_t v[9];
+    v128_t epsilon_v;
+    v128_t one_v;
+    v128_t nan_v;
+    TransformPrecision precision = TransformPrecision::Exact;
+};
+
+inline void load_transform_coeffs(const float *m, TransformCoeffs &c)
+{
+    for (int k = 0; k < 9; ++k)
+    {
+        c.s[k] = m[k];
+        c.v[k] = wasm_f32x4_splat(m[k]);
+    }
+    c.epsilon_v = wasm_f32x4_splat(MATRIX_SVD_EPSILON);
+    c.one_v = wasm_f32x4_splat(1.0f);
+    c.nan_v = wasm_f32x4_splat(std::numeric_limits<float>::quiet_NaN());
+    c.precision = transform_precision();
+}
+
+// --- Núcleo de Transformación por Clase ---
+// Transforma 4 puntos ya separados en xxxx / yyyy. Solo Projective calcula W,
+// la recíproca y la máscara de W cercano a cero.
+template <MatrixClass C, TransformPrecision P = TransformPrecision::Exact>
+inline void transform_xy_simd(const TransformCoeffs &c, v128_t &x, v128_t &y)
+{
+    if constexpr (C == MatrixClass::Identity)
+    {
+        (void)c;
+    }
+    else if constexpr (C == MatrixClass::Translate)
+    {
+        x = wasm_f32x4_add(x, c.v[6]);
+        y = wasm_f32x4_add(y, c.v[7]);
+    }
+    else if constexpr (P == TransformPrecision::Fast && C == MatrixClass::ScaleTranslate)
+    {
+        x = f32x4_madd(c.v[0], x, c.v[6]);
+        y = f32x4_madd(c.v[4], y, c.v[7]);
+    }
+    else if constexpr (P == TransformPrecision::Fast && C == MatrixClass::Affine)
+    {
+        v128_t nx = f32x4_madd(c.v[0], x, f32x4_madd(c.v[3], y, c.v[6]));
+        v128_t ny = f32x4_madd(c.v[1], x, f32x4_madd(c.v[4], y, c.v[7]));
+        x = nx;
+        y = ny;
+    }
+    else if constexpr (P == TransformPrecision::Fast)
+    {
+        v128_t x_unscaled = f32x4_madd(c.v[0], x, f32x4_madd(c.v[3], y, c.v[6]));
+        v128_t y_unscaled = f32x4_madd(c.v[1], x, f32x4_madd(c.v[4], y, c.v[7]));
+        v128_t w = f32x4_madd(c.v[2], x, f32x4_madd(c.v[5], y, c.v[8]));
+
+        v128_t valid_w_mask = wasm_f32x4_ge(wasm_f32x4_abs(w), c.epsilon_v);
+        v128_t inv_w = f32x4_reciprocal_fast(w, c.one_v); // Basura si W=0, lo enmascara el bitselect
+
+        x = wasm_v128_bitselect(wasm_f32x4_mul(x_unscaled, inv_w), c.nan_v, valid_w_mask);
+        y = wasm_v128_bitselect(wasm_f32x4_mul(y_unscaled, inv_w), c.nan_v, valid_w_mask);
+    }
+    else if constexpr (C == MatrixClass::ScaleTranslate)
+    {
+        x = wasm_f32x4_add(wasm_f32x4_mul(c.v[0], x), c.v[6]);
+        y = wasm_f32x4_add(wasm_f32x4_mul(c.v[4], y), c.v[7]);
+    }
+    else if constexpr (C == MatrixClass::Affine)
+    {
+        v128_t nx = wasm_f32x4_add(wasm_f32x4_add(wasm_f32x4_mul(c.v[0], x), wasm_f32x4_mul(c.v[3], y)), c.v[6]);
+        v128_t ny = wasm_f32x4_add(wasm_f32x4_add(wasm_f32x4_mul(c.v[1], x), wasm_f32x4_mul(c.v[4], y)), c.v[7]);
+        x = nx;
+        y = ny;
+    }
+    else
+    {
+        v128_t x_unscaled = wasm_f32x4_add(wasm_f32x4_add(wasm_f32x4_mul(c.v[0], x), wasm_f32x4_mul(c.v[3], y)), c.v[6]);
+        v128_t y_unscaled = wasm_f32x4_add(wasm_f32x4_add(wasm_f32x4_mul(c.v[1], x), wasm_f32x4_mul(c.v[4], y)), c.v[7]);
+        v128_t w = wasm_f32x4_add(wasm_f32x4_add(wasm_f32x4_mul(c.v[2], x), wasm_f32x4_mul(c.v[5], y)), c.v[8]);
+
+        // 1s donde |W| >= eps, 0s donde |W| < eps
+        v128_t valid_w_mask = wasm_f32x4_ge(wasm_f32x4_abs(w), c.epsilon_v);
+        v128_t inv_w = wasm_f32x4_div(c.one_v, w); // Puede ser Inf si W=0, lo enmascara el bitselect
+
+        x = wasm_v128_bitselect(wasm_f32x4_mul(x_unscaled, inv_w), c.nan_v, valid_w_mask);
+        y = wasm_v128_bitselect(wasm_f32x4_mul(y_unscaled, inv_w), c.nan_v, valid_w_mask);
+    }
+}
+
+// Versión escalar equivalente (para el residuo de 0-3 puntos)
+template <MatrixClass C>
+inline void transform_xy_scalar(const TransformCoeffs &c, float &x, float &y)
+{
+    const float *m = c.s;
+    if constexpr (C == MatrixClass::Identity)
+    {
+        (void)m;
+    }
+    else if constexpr (C == MatrixClass::Translate)
+    {
+        x = x + m[6];
+        y = y + m[7];
+    }
+    else if constexpr (C == MatrixClass::ScaleTranslate)
+    {
+        x = m[0] * x + m[6];
+        y = m[4] * y + m[7];
+    }
+    else if constexpr (C == MatrixClass::Affine)
+    {
+        float nx = m[0] * x + m[3] * y + m[6];
+        float ny = m[1] * x + m[4] * y + m[7];
+        x = nx;
+        y = ny;
+    }
+    else
+    {
+        float X = m[0] * x + m[3] * y + m[6];
+        float Y = m[1] * x + m[4] * y + m[7];
+        float W = m[2] * x + m[5] * y + m[8];
+        if (std::abs(W) < MATRIX_SVD_EPSILON)
+        {
+            x = std::numeric_limits<float>::quiet_NaN();
+            y = std::numeric_limits<float>::quiet_NaN();
+        }
+        else
+        {
+            float invW = 1.0f / W;
+            x = X * invW;
+            y = Y * invW;
+        }
+    }
+}
+
+// --- Layouts de Puntos ---
+// Cada layout sabe cargar/guardar 4 puntos (como xxxx / yyyy) o 1 punto escalar.
+// wasm_v128_load/store no exigen alineación de 16 bytes, solo la de float (4 bytes),
+// así que cualquier offset en floats es válido.
+
+// xyxy contiguo (el formato clásico de transformPointsBatch)
+struct PackedLayout
+{
+    const float *in;
+    float *out;
+
+    inline void load4(int i, v128_t &x, v128_t &y) const
+    {
+        v128_t xy12 = wasm_v128_load(&in[i * 2]);
+        v128_t xy34 = wasm_v128_load(&in[i * 2 + 4]);
+        x = wasm_i32x4_shuffle(xy12, xy34, 0, 2, 4, 6); // x1,x2,x3,x4
+        y = wasm_i32x4_shuffle(xy12, xy34, 1, 3, 5, 7); // y1,y2,y3,y4
+    }
+    inline void store4(int i, v128_t x, v128_t y) const
+    {
+        wasm_v128_store(&out[i * 2], wasm_i32x4_shuffle(x, y, 0, 4, 1, 5));     // x'1,y'1,x'2,y'2
+        wasm_v128_store(&out[i * 2 + 4], wasm_i32x4_shuffle(x, y, 2, 6, 3, 7)); // x'3,y'3,x'4,y'4
+    }
+    inline void load1(int i, float &x, float &y) const
+    {
+        x = in[i * 2];
+        y = in[i * 2 + 1];
+    }
+    inline void store1(int i, float x, float y) const
+    {
+        out[i * 2] = x;
+        out[i * 2 + 1] = y;
+    }
+    // Identidad: memmove resuelve también el solapamiento
+    inline bool copy_identity(int num_points) const
+    {
+        if (in != out && num_points > 0)
+            std::memmove(out, in, (size_t)num_points * 2 * sizeof(float));
+        return true;
+    }
+};
+
+// x[] e y[] en arrays separados: cargas directas, sin shuffles
+struct SoALayout
+{
+    const float *x_in;
+    const float *y_in;
+    float *x_out;
+    float *y_out;
+
+    inline void load4(int i, v128_t &x, v128_t &y) const
+    {
+        x = wasm_v128_load(&x_in[i]);
+        y = wasm_v128_load(&y_in[i]);
+    }
+    inline void store4(int i, v128_t x, v128_t y) const
+    {
+        wasm_v128_store(&x_out[i], x);
+        wasm_v128_store(&y_out[i], y);
+    }
+    inline void load1(int i, float &x, float &y) const
+    {
+        x = x_in[i];
+        y = y_in[i];
+    }
+    inline void store1(int i, float x, float y) const
+    {
+        x_out[i] = x;
+        y_out[i] = y;
+    }
+    inline bool copy_identity(int) const
+    {
+        return x_in == x_out && y_in == y_out;
+    }
+};
+
+// Vértices intercalados (x,y,u,v,rgba...): x en p[0], y en p[1], paso en floats.
+// Gather/scatter escalar, pero la aritmética sigue siendo SIMD.
+struct StridedLayout
+{
+    const float *in;
+    int in_stride;
+    float *out;
+    int out_stride;
+
+    inline void load4(int i, v128_t &x, v128_t &y) const
+    {
+        const float *p = &in[i * in_stride];
+        const int s = in_stride;
+        x = wasm_f32x4_make(p[0], p[s], p[2 * s], p[3 * s]);
+        y = wasm_f32x4_make(p[1], p[s + 1], p[2 * s + 1], p[3 * s + 1]);
+    }
+    inline void store4(int i, v128_t x, v128_t y) const
+    {
+        float *p = &out[i * out_stride];
+        const int s = out_stride;
+        p[0] = wasm_f32x4_extract_lane(x, 0);
+        p[1] = wasm_f32x4_extract_lane(y, 0);
+        p[s] = wasm_f32x4_extract_lane(x, 1);
+        p[s + 1] = wasm_f32x4_extract_lane(y, 1);
+        p[2 * s] = wasm_f32x4_extract_lane(x, 2);
+        p[2 * s + 1] = wasm_f32x4_extract_lane(y, 2);
+        p[3 * s] = wasm_f32x4_extract_lane(x, 3);
+        p[3 * s + 1] = wasm_f32x4_extract_lane(y, 3);
+    }
+    inline void load1(int i, float &x, float &y) const
+    {
+        x = in[i * in_stride];
+        y = in[i * in_stride + 1];
+    }
+    inline void store1(int i, float x, float y) const
+    {
+        out[i * out_stride] = x;
+        out[i * out_stride + 1] = y;
+    }
+    inline bool copy_identity(int) const
+    {
+        return in == out && in_stride == out_stride;
+    }
+};
+
+// --- Bucle por Clase ---
+// `reverse` recorre los puntos de atrás hacia delante; necesario cuando la salida
+// solapa la entrada desplazada hacia direcciones mayores (ver layout_overlap_direction).
+template <MatrixClass C, TransformPrecision P, class Layout>
+void transform_points_kernel(const TransformCoeffs &c, const Layout &layout, int num_points, bool reverse = false)
+{
+    if constexpr (C == MatrixClass::Identity)
+    {
+        // Nada que calcular: copia directa (o nada si es in-place)
+        if (layout.copy_identity(num_points))
+            return;
+    }
+
+    const int num_points_simd = num_points - (num_points % 4);
+
+    if (!reverse)
+    {
+        int i = 0;
+        for (; i < num_points_simd; i += 4)
+        {
+            v128_t x, y;
+            layout.load4(i, x, y);
+            transform_xy_simd<C, P>(c, x, y);
+            layout.store4(i, x, y);
+        }
+        // Residuo escalar (0-3 puntos)
+        for (; i < num_points; ++i)
+        {
+            float x, y;
+            layout.load1(i, x, y);
+            transform_xy_scalar<C>(c, x, y);
+            layout.store1(i, x, y);
+        }
+    }
+    else
+    {
+        for (int i = num_points - 1; i >= num_points_simd; --i)
+        {
+            float x, y;
+            layout.load1(i, x, y);
+            transform_xy_scalar<C>(c, x, y);
+            layout.store1(i, x, y);
+        }
+        for (int i = num_points_simd - 4; i >= 0; i -= 4)
+        {
+            v128_t x, y;
+            layout.load4(i, x, y);
+            transform_xy_simd<C, P>(c, x, y);
+            layout.store4(i, x, y);
+        }
+    }
+}
+
+// --- Selección de Kernel ---
+// Identidad y traslación no multiplican: no tienen variante Fast.
+template <MatrixClass C, class Layout>
+void transform_points_kernel_precision(const TransformCoeffs &c, const Layout &layout, int num_points,
+                                       bool reverse)
+{
+    if (c.precision == TransformPrecision::Fast)
+        transform_points_kernel<C, TransformPrecision::Fast>(c, layout, num_points, reverse);
+    else
+        transform_points_kernel<C, TransformPrecision::Exact>(c, layout, num_points, reverse);
+}
+
+template <class Layout>
+void transform_points_dispatch(MatrixClass cls, const TransformCoeffs &c, const Layout &layout,
+                               int num_points, bool reverse = false)
+{
+    switch (cls)
+    {
+    case MatrixClass::Identity:
+        transform_points_kernel<MatrixClass::Identity, TransformPrecision::Exact>(c, layout, num_points, reverse);
+        break;
+    case MatrixClass::Translate:
+        transform_points_kernel<MatrixClass::Translate, TransformPrecision::Exact>(c, layout, num_points, reverse);
+        break;
+    case MatrixClass::ScaleTranslate:
+        transform_points_kernel_precision<MatrixClass::ScaleTranslate>(c, layout, num_points, reverse);
+        break;
+    case MatrixClass::Affine:
+        transform_points_kernel_precision<MatrixClass::Affine>(c, layout, num_points, reverse);
+        break;
+    default:
+        transform_points_kernel_precision<MatrixClass::Projective>(c, layout, num_points, reverse);
+        break;
+    }
+}
+
+// --- Reducción Fusionada (AABB, centroide, puntos degenerados) ---
+// Resultado escrito en memoria WASM: 8 campos de 4 bytes, leídos desde JS en este orden.
+struct PointBatchStats
+{
+    float min_x;
+    float min_y;
+    float max_x;
+    float max_y;
+    float centroid_x;
+    float centroid_y;
+    int32_t valid_count;
+    int32_t invalid_count; // Salidas NaN (W cercano a cero o entrada NaN)
+};
+
+// Las sumas parciales f32x4 se vuelcan a double cada tantos bloques de 4 puntos,
+// para que el centroide no pierda precisión en lotes de millones de puntos.
+const int STATS_FLUSH_BLOCKS = 256;
+
+/**
+ * Acumula bounds, suma y recuento de los puntos transformados. Las vías NaN se
+ * sustituyen por +-Inf (min/max) y 0 (suma), así que no contaminan el resultado.
+ */
+struct PointStatsAccumulator
+{
+    v128_t min_x, min_y, max_x, max_y;
+    v128_t sum_x, sum_y;
+    double total_x = 0.0;
+    double total_y = 0.0;
+    int64_t valid = 0;
+    int64_t invalid = 0;
+    int pending_blocks = 0;
+
+    PointStatsAccumulator()
+    {
+        min_x = min_y = wasm_f32x4_splat(std::numeric_limits<float>::infinity());
+        max_x = max_y = wasm_f32x4_splat(-std::numeric_limits<float>::infinity());
+        sum_x = sum_y = wasm_f32x4_splat(0.0f);
+    }
+
+    inline void add4(v128_t x, v128_t y)
+    {
+        const v128_t valid_mask = wasm_v128_and(wasm_f32x4_eq(x, x), wasm_f32x4_eq(y, y));
+        const v128_t pos_inf = wasm_f32x4_splat(std::numeric_limits<float>::infinity());
+        const v128_t neg_inf = wasm_f32x4_splat(-std::numeric_limits<float>::infinity());
+        min_x = wasm_f32x4_min(min_x, wasm_v128_bitselect(x, pos_inf, valid_mask));
+        min_y = wasm_f32x4_min(min_y, wasm_v128_bitselect(y, pos_inf, valid_mask));
+        max_x = wasm_f32x4_max(max_x, wasm_v128_bitselect(x, neg_inf, valid_mask));
+        max_y = wasm_f32x4_max(max_y, wasm_v128_bitselect(y, neg_inf, valid_mask));
+        sum_x = wasm_f32x4_add(sum_x, wasm_v128_and(x, valid_mask));
+        sum_y = wasm_f32x4_add(sum_y, wasm_v128_and(y, valid_mask));
+
+        const int num_valid = __builtin_popcount(wasm_i32x4_bitmask(valid_mask));
+        valid += num_valid;
+        invalid += 4 - num_valid;
+        if (++pending_blocks == STATS_FLUSH_BLOCKS)
+            flush();
+    }
+
+    inline void add1(float x, float y)
+    {
+        if (std::isnan(x) || std::isnan(y))
+        {
+            ++invalid;
+            return;
+        }
+        min_x = wasm_f32x4_min(min_x, wasm_f32x4_splat(x));
+        min_y = wasm_f32x4_min(min_y, wasm_f32x4_splat(y));
+        max_x = wasm_f32x4_max(max_x, wasm_f32x4_splat(x));
+        max_y = wasm_f32x4_max(max_y, wasm_f32x4_splat(y));
+        total_x += x;
+        total_y += y;
+        ++valid;
+    }
+
+    inline void flush()
+    {
+        total_x += (double)wasm_f32x4_extract_lane(sum_x, 0) + wasm_f32x4_extract_lane(sum_x, 1) +
+                   wasm_f32x4_extract_lane(sum_x, 2) + wasm_f32x4_extract_lane(sum_x, 3);
+        total_y += (double)wasm_f32x4_extract_lane(sum_y, 0) + wasm_f32x4_extract_lane(sum_y, 1) +
+                   wasm_f32x4_extract_lane(sum_y, 2) + wasm_f32x4_extract_lane(sum_y, 3);
+        sum_x = sum_y = wasm_f32x4_splat(0.0f);
+        pending_blocks = 0;
+    }
+
+    void merge(PointStatsAccumulator &other)
+    {
+        other.flush();
+        min_x = wasm_f32x4_min(min_x, other.min_x);
+        min_y = wasm_f32x4_min(min_y, other.min_y);
+        max_x = wasm_f32x4_max(max_x, other.max_x);
+        max_y = wasm_f32x4_max(max_y, other.max_y);
+        total_x += other.total_x;
+        total_y += other.total_y;
+        valid += other.valid;
+        invalid += other.invalid;
+    }
+
+    /** Reduce las 4 vías y escribe el resultado. Sin puntos válidos, bounds y centroide son NaN. */
+    void finish(PointBatchStats &out)
+    {
+        flush();
+        out.valid_count = (int32_t)valid;
+        out.invalid_count = (int32_t)invalid;
+        if (valid == 0)
+        {
+            const float nan = std::numeric_limits<float>::quiet_NaN();
+            out.min_x = out.min_y = out.max_x = out.max_y = nan;
+            out.centroid_x = out.centroid_y = nan;
+            return;
+        }
+        out.min_x = horizontal_min(min_x);
+        out.min_y = horizontal_min(min_y);
+        out.max_x = horizontal_max(max_x);
+        out.max_y = horizontal_max(max_y);
+        out.centroid_x = (float)(total_x / (double)valid);
+        out.centroid_y = (float)(total_y / (double)valid);
+    }
+
+    static inline float horizontal_min(v128_t v)
+    {
+        return std::min(std::min(wasm_f32x4_extract_lane(v, 0), wasm_f32x4_extract_lane(v, 1)),
+                        std::min(wasm_f32x4_extract_lane(v, 2), wasm_f32x4_extract_lane(v, 3)));
+    }
+
+    static inline float horizontal_max(v128_t v)
+    {
+        return std::max(std::max(wasm_f32x4_extract_lane(v, 0), wasm_f32x4_extract_lane(v, 1)),
+                        std::max(wasm_f32x4_extract_lane(v, 2), wasm_f32x4_extract_lane(v, 3)));
+    }
+};
+
+// Envuelve un layout y acumula cada punto al guardarlo: la reducción va en la
+// misma pasada que la transformación, sin releer la salida.
+template <class Layout>
+struct StatsLayout
+{
+    Layout inner;
+    PointStatsAccumulator *stats;
+
+    inline void load4(int i, v128_t &x, v128_t &y) const { inner.load4(i, x, y); }
+    inline void store4(int i, v128_t x, v128_t y) const
+    {
+        stats->add4(x, y);
+        inner.store4(i, x, y);
+    }
+    inline void load1(int i, float &x, float &y) const { inner.load1(i, x, y); }
+    inline void store1(int i, float x, float y) const
+    {
+        stats->add1(x, y);
+        inner.store1(i, x, y);
+    }
+    // Incluso con la identidad hay que recorrer los puntos para acumularlos
+    inline bool copy_identity(int) const { return false; }
+};
+
+// --- Solapamiento Entrada/Salida ---
+struct FloatRange
+{
+    const float *begin;
+    const float *end; // exclusivo
+};
+
+inline bool ranges_overlap(const FloatRange &a, const FloatRange &b)
+{
+    return a.begin < b.end && b.begin < a.end;
+}
+
+/**
+ * Decide el sentido de recorrido seguro para una salida que puede solapar la entrada.
+ * Cada bloque carga sus puntos antes de escribirlos, así que basta con que toda salida
+ * solapada esté en direcciones <= que su entrada (adelante) o >= (atrás).
+ * Solo es válido cuando entrada y salida avanzan al mismo paso por punto.
+ * @returns 1 hacia delante, -1 hacia atrás, 0 si el solapamiento no es resoluble.
+ */
+inline int layout_overlap_direction(const FloatRange *outs, int num_outs, const FloatRange *ins, int num_ins)
+{
+    bool needs_forward = false;
+    bool needs_reverse = false;
+    for (int o = 0; o < num_outs; ++o)
+    {
+        for (int k = 0; k < num_ins; ++k)
+        {
+            if (!ranges_overlap(outs[o], ins[k]))
+                continue;
+            if (outs[o].begin < ins[k].begin)
+                needs_forward = true;
+            else if (outs[o].begin > ins[k].begin)
+                needs_reverse = true;
+        }
+    }
+    if (needs_forward && needs_reverse)
+        return 0;
+    return needs_reverse ? -1 : 1;
+}
+
+// --- Transformación por Instancia (una matriz por punto) ---
+// Runs de al menos este número de puntos con la misma matriz usan el kernel
+// especializado por clase; los tramos mezclados usan gather de coeficientes.
+const int INSTANCE_RUN_MIN = 8;
+
+// Matriz de relleno para índices fuera de rango: W = NaN -> salida NaN
+inline const float *invalid_instance_matrix()
+{
+    static const float nan_matrix[9] = {
+        std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::quiet_NaN(),
+        std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::quiet_NaN(),
+        std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::quiet_NaN()};
+    return nan_matrix;
+}
+
+inline const float *instance_matrix(const float *matrices, int num_matrices, uint32_t index)
+{
+    return index < (uint32_t)num_matrices ? &matrices[(size_t)index * 9] : invalid_instance_matrix();
+}
+
+/**
+ * Tramo [begin, end) con matrices distintas por punto. Cada vía del vector lleva
+ * los coeficientes de su propia matriz (gather) y se aplica la fórmula proyectiva
+ * completa, que para matrices afines da el mismo resultado (W = 1).
+ */
+inline void transform_points_gather(const float *matrices, int num_matrices, const uint32_t *indices,
+                                    const PackedLayout &layout, int begin, int end)
+{
+    TransformCoeffs gc;
+    gc.epsilon_v = wasm_f32x4_splat(MATRIX_SVD_EPSILON);
+    gc.one_v = wasm_f32x4_splat(1.0f);
+    gc.nan_v = wasm_f32x4_splat(std::numeric_limits<float>::quiet_NaN());
+
+    int i = begin;
+    for (; i + 4 <= end; i += 4)
+    {
+        const float *m0 = instance_matrix(matrices, num_matrices, indices[i]);
+        const float *m1 = instance_matrix(matrices, num_matrices, indices[i + 1]);
+        const float *m2 = instance_matrix(matrices, num_matrices, indices[i + 2]);
+        const float *m3 = instance_matrix(matrices, num_matrices, indices[i + 3]);
+        for (int k = 0; k < 9; ++k)
+            gc.v[k] = wasm_f32x4_make(m0[k], m1[k], m2[k], m3[k]);
+
+        v128_t x, y;
+        layout.load4(i, x, y);
+        transform_xy_simd<MatrixClass::Projective>(gc, x, y);
+        layout.store4(i, x, y);
+    }
+    for (; i < end; ++i)
+    {
+        std::memcpy(gc.s, instance_matrix(matrices, num_matrices, indices[i]), sizeof(gc.s));
+        float x, y;
+        layout.load1(i, x, y);
+        transform_xy_scalar<MatrixClass::Projective>(gc, x, y);
+        layout.store1(i, x, y);
+    }
+}
+
+// Final del run de índices iguales que empieza en `begin`
+inline int instance_run_end(const uint32_t *indices, int begin, int num_points)
+{
+    int end = begin + 1;
+    while (end < num_points && indices[end] == indices[begin])
+        ++end;
+    return end;
+}
+
+// --- Culling con Compactación ---
+// Tabla de swizzle para compactar: para cada máscara de 4 vías (bitmask), los bytes
+// que mueven las vías activas al principio del vector, en orden. El resto de bytes
+// vale 0x80 (fuera de rango -> 0 en wasm_i8x16_swizzle).
+struct CompactShuffleTable
+{
+    uint8_t bytes[16][16];
+};
+
+constexpr CompactShuffleTable make_compact_shuffle_table()
+{
+    CompactShuffleTable table{};
+    for (int mask = 0; mask < 16; ++mask)
+    {
+        int dst = 0;
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            if (!(mask & (1 << lane)))
+                continue;
+            for (int b = 0; b < 4; ++b)
+                table.bytes[mask][dst * 4 + b] = (uint8_t)(lane * 4 + b);
+            ++dst;
+        }
+        for (; dst < 4; ++dst)
+            for (int b = 0; b < 4; ++b)
+                table.bytes[mask][dst * 4 + b] = 0x80;
+    }
+    return table;
+}
+
+inline constexpr CompactShuffleTable COMPACT_SHUFFLE_TABLE = make_compact_shuffle_table();
+
+// Rectángulo de recorte inclusivo [min, max], en escalar y splatteado
+struct ClipRect
+{
+    float min_x, min_y, max_x, max_y;
+    v128_t min_x_v, min_y_v, max_x_v, max_y_v;
+};
+
+inline ClipRect make_clip_rect(float min_x, float min_y, float max_x, float max_y)
+{
+    return ClipRect{min_x, min_y, max_x, max_y,
+                    wasm_f32x4_splat(min_x), wasm_f32x4_splat(min_y),
+                    wasm_f32x4_splat(max_x), wasm_f32x4_splat(max_y)};
+}
+
+/**
+ * Transforma puntos xyxy y escribe compactados solo los que caen dentro del
+ * rectángulo (las salidas NaN nunca pasan la prueba). Si `indices` no es nulo,
+ * guarda también el índice original de cada superviviente.
+ * Cada bloque guarda 4 puntos/índices completos en la posición `count` (los que
+ * sobran se sobrescriben en el bloque siguiente); como count <= i, la escritura
+ * nunca pasa del bloque recién cargado y la salida puede ser la propia entrada.
+ * @returns Número de puntos supervivientes.
+ */
+template <MatrixClass C, TransformPrecision P>
+int cull_points_kernel(const TransformCoeffs &c, const ClipRect &rect, const float *in, float *out,
+                       uint32_t *indices, int num_points)
+{
+    const int num_points_simd = num_points - (num_points % 4);
+    const v128_t lane_offsets = wasm_i32x4_make(0, 1, 2, 3);
+    int count = 0;
+
+    int i = 0;
+    for (; i < num_points_simd; i += 4)
+    {
+        v128_t xy12 = wasm_v128_load(&in[i * 2]);
+        v128_t xy34 = wasm_v128_load(&in[i * 2 + 4]);
+        v128_t x = wasm_i32x4_shuffle(xy12, xy34, 0, 2, 4, 6);
+        v128_t y = wasm_i32x4_shuffle(xy12, xy34, 1, 3, 5, 7);
+        transform_xy_simd<C, P>(c, x, y);
+
+        v128_t inside = wasm_v128_and(wasm_v128_and(wasm_f32x4_ge(x, rect.min_x_v), wasm_f32x4_le(x, rect.max_x_v)),
+                                      wasm_v128_and(wasm_f32x4_ge(y, rect.min_y_v), wasm_f32x4_le(y, rect.max_y_v)));
+        const uint32_t mask = wasm_i32x4_bitmask(inside);
+        if (mask == 0)
+            continue;
+
+        const v128_t compact = wasm_v128_load(COMPACT_SHUFFLE_TABLE.bytes[mask]);
+        x = wasm_i8x16_swizzle(x, compact);
+        y = wasm_i8x16_swizzle(y, compact);
+        wasm_v128_store(&out[count * 2], wasm_i32x4_shuffle(x, y, 0, 4, 1, 5));
+        wasm_v128_store(&out[count * 2 + 4], wasm_i32x4_shuffle(x, y, 2, 6, 3, 7));
+        if (indices)
+        {
+            v128_t idx = wasm_i32x4_add(wasm_i32x4_splat(i), lane_offsets);
+            wasm_v128_store(&indices[count], wasm_i8x16_swizzle(idx, compact));
+        }
+        count += __builtin_popcount(mask);
+    }
+    // Residuo escalar (0-3 puntos)
+    for (; i < num_points; ++i)
+    {
+        float x = in[i * 2];
+        float y = in[i * 2 + 1];
+        transform_xy_scalar<C>(c, x, y);
+        if (!(x >= rect.min_x && x <= rect.max_x && y >= rect.min_y && y <= rect.max_y))
+            continue;
+        out[count * 2] = x;
+        out[count * 2 + 1] = y;
+        if (indices)
+            indices[count] = (uint32_t)i;
+        ++count;
+    }
+    return count;
+}
+
+template <MatrixClass C>
+int cull_points_kernel_precision(const TransformCoeffs &c, const ClipRect &rect, const float *in, float *out,
+                                 uint32_t *indices, int num_points)
+{
+    if (c.precision == TransformPrecision::Fast)
+        return cull_points_kernel<C, TransformPrecision::Fast>(c, rect, in, out, indices, num_points);
+    return cull_points_kernel<C, TransformPrecision::Exact>(c, rect, in, out, indices, num_points);
+}
+
+inline int cull_points_dispatch(MatrixClass cls, const TransformCoeffs &c, const ClipRect &rect,
+                                const float *in, float *out, uint32_t *indices, int num_points)
+{
+    switch (cls)
+    {
+    case MatrixClass::Identity:
+        return cull_points_kernel<MatrixClass::Identity, TransformPrecision::Exact>(c, rect, in, out, indices, num_points);
+    case MatrixClass::Translate:
+        return cull_points_kernel<MatrixClass::Translate, TransformPrecision::Exact>(c, rect, in, out, indices, num_points);
+    case MatrixClass::ScaleTranslate:
+        return cull_points_kernel_precision<MatrixClass::ScaleTranslate>(c, rect, in, out, indices, num_points);
+    case MatrixClass::Affine:
+        return cull_points_kernel_precision<MatrixClass::Affine>(c, rect, in, out, indices, num_points);
+    default:
+        return cull_points_kernel_precision<MatrixClass::Projective>(c, rect, in, out, indices, num_points);
+    }
+}
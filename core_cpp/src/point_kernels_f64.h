@@ -0,0 +1,161 @@
+// core_cpp/src/point_kernels_f64.h
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include "simd_compat.h"
+
+#include "matrix_types.h"
+
+// --- Transformación de Puntos en f64 ---
+// Para coordenadas grandes (CAD/GIS en el rango 1e6) donde f32 pierde la precisión
+// submilimétrica. Mismo layout column-major y misma regla de W que el kernel f32.
+
+// Solo dos clases: la afín cubre identidad/traslación/escala (en f64x2 la diferencia
+// de coste entre ellas es mínima), la proyectiva calcula W y divide.
+// La fila inferior se compara exacta: a 1e6 un término de perspectiva de 1e-11 ya
+// mueve W en 1e-5 (unas 10 unidades en la salida), así que ninguna tolerancia fija
+// permite descartar W.
+inline bool is_affine_f64(const double *m)
+{
+    return m[2] == 0.0 && m[5] == 0.0 && m[8] == 1.0;
+}
+
+struct TransformCoeffsF64
+{
+    double s[9];
+    v128_t v[9];
+    v128_t epsilon_v;
+    v128_t nan_v;
+};
+
+inline void load_transform_coeffs_f64(const double *m, TransformCoeffsF64 &c)
+{
+    for (int k = 0; k < 9; ++k)
+    {
+        c.s[k] = m[k];
+        c.v[k] = wasm_f64x2_splat(m[k]);
+    }
+    c.epsilon_v = wasm_f64x2_splat(MATRIX_SVD_EPSILON);
+    c.nan_v = wasm_f64x2_splat(std::numeric_limits<double>::quiet_NaN());
+}
+
+// Transforma 2 puntos ya separados en xx / yy
+template <bool Projective>
+inline void transform_xy_f64x2(const TransformCoeffsF64 &c, v128_t &x, v128_t &y)
+{
+    v128_t nx = wasm_f64x2_add(wasm_f64x2_add(wasm_f64x2_mul(c.v[0], x), wasm_f64x2_mul(c.v[3], y)), c.v[6]);
+    v128_t ny = wasm_f64x2_add(wasm_f64x2_add(wasm_f64x2_mul(c.v[1], x), wasm_f64x2_mul(c.v[4], y)), c.v[7]);
+    if constexpr (Projective)
+    {
+        v128_t w = wasm_f64x2_add(wasm_f64x2_add(wasm_f64x2_mul(c.v[2], x), wasm_f64x2_mul(c.v[5], y)), c.v[8]);
+        v128_t valid_w_mask = wasm_f64x2_ge(wasm_f64x2_abs(w), c.epsilon_v);
+        nx = wasm_v128_bitselect(wasm_f64x2_div(nx, w), c.nan_v, valid_w_mask);
+        ny = wasm_v128_bitselect(wasm_f64x2_div(ny, w), c.nan_v, valid_w_mask);
+    }
+    x = nx;
+    y = ny;
+}
+
+template <bool Projective>
+inline void transform_xy_f64(const TransformCoeffsF64 &c, double &x, double &y)
+{
+    const double *m = c.s;
+    double X = m[0] * x + m[3] * y + m[6];
+    double Y = m[1] * x + m[4] * y + m[7];
+    if constexpr (Projective)
+    {
+        double W = m[2] * x + m[5] * y + m[8];
+        if (std::abs(W) < MATRIX_SVD_EPSILON)
+        {
+            X = Y = std::numeric_limits<double>::quiet_NaN();
+        }
+        else
+        {
+            X /= W;
+            Y /= W;
+        }
+    }
+    x = X;
+    y = Y;
+}
+
+// Salida xyxy en f64
+struct F64Writer
+{
+    double *out;
+
+    inline void store2(int i, v128_t x, v128_t y) const
+    {
+        wasm_v128_store(&out[i * 2], wasm_i64x2_shuffle(x, y, 0, 2));     // x'1,y'1
+        wasm_v128_store(&out[i * 2 + 2], wasm_i64x2_shuffle(x, y, 1, 3)); // x'2,y'2
+    }
+    inline void store1(int i, double x, double y) const
+    {
+        out[i * 2] = x;
+        out[i * 2 + 1] = y;
+    }
+};
+
+// Salida xyxy en f32 relativa a un origen local: la resta se hace en f64 y solo el
+// resultado (ya pequeño) se redondea a f32.
+struct LocalF32Writer
+{
+    float *out;
+    double origin_x;
+    double origin_y;
+    v128_t origin_v; // (origin_x, origin_y)
+
+    inline void store2(int i, v128_t x, v128_t y) const
+    {
+        const v128_t p1 = wasm_f64x2_sub(wasm_i64x2_shuffle(x, y, 0, 2), origin_v);
+        const v128_t p2 = wasm_f64x2_sub(wasm_i64x2_shuffle(x, y, 1, 3), origin_v);
+        // demote deja (x, y, 0, 0): juntar las dos mitades bajas en x1,y1,x2,y2
+        const v128_t f1 = wasm_f32x4_demote_f64x2_zero(p1);
+        const v128_t f2 = wasm_f32x4_demote_f64x2_zero(p2);
+        wasm_v128_store(&out[i * 2], wasm_i32x4_shuffle(f1, f2, 0, 1, 4, 5));
+    }
+    inline void store1(int i, double x, double y) const
+    {
+        out[i * 2] = (float)(x - origin_x);
+        out[i * 2 + 1] = (float)(y - origin_y);
+    }
+};
+
+/**
+ * Bucle f64x2: 2 puntos por iteración desde xyxy en f64. Cada par se carga antes de
+ * escribirse, así que con F64Writer la salida puede ser la propia entrada.
+ */
+template <bool Projective, class Writer>
+void transform_points_f64_kernel(const TransformCoeffsF64 &c, const double *in, const Writer &writer, int num_points)
+{
+    const int num_points_simd = num_points - (num_points % 2);
+    int i = 0;
+    for (; i < num_points_simd; i += 2)
+    {
+        const v128_t xy1 = wasm_v128_load(&in[i * 2]);
+        const v128_t xy2 = wasm_v128_load(&in[i * 2 + 2]);
+        v128_t x = wasm_i64x2_shuffle(xy1, xy2, 0, 2);
+        v128_t y = wasm_i64x2_shuffle(xy1, xy2, 1, 3);
+        transform_xy_f64x2<Projective>(c, x, y);
+        writer.store2(i, x, y);
+    }
+    if (i < num_points)
+    {
+        double x = in[i * 2];
+        double y = in[i * 2 + 1];
+        transform_xy_f64<Projective>(c, x, y);
+        writer.store1(i, x, y);
+    }
+}
+
+template <class Writer>
+void transform_points_f64_dispatch(const double *m, const double *in, const Writer &writer, int num_points)
+{
+    TransformCoeffsF64 coeffs;
+    load_transform_coeffs_f64(m, coeffs);
+    if (is_affine_f64(m))
+        transform_points_f64_kernel<false>(coeffs, in, writer, num_points);
+    else
+        transform_points_f64_kernel<true>(coeffs, in, writer, num_points);
+}
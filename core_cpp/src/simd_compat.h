@@ -0,0 +1,422 @@
+// core_cpp/src/simd_compat.h
+#pragma once
+
+// --- SIMD128 o Emulación Escalar ---
+// Con -msimd128 se usan los intrínsecos reales de <wasm_simd128.h>. La build
+// `baseline` (motores sin SIMD) compila sin -msimd128: aquí se define el mismo
+// subconjunto de intrínsecos que usan los kernels sobre un v128_t escalar, con la
+// semántica de WebAssembly (máscaras de todo unos, min/max que propagan NaN,
+// conversiones saturadas). Los kernels no cambian; el compilador genera código escalar.
+// Añadir aquí cualquier intrínseco nuevo que usen los kernels.
+
+#ifdef __wasm_simd128__
+#include <wasm_simd128.h>
+#else
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+// Unión de vías: clang y gcc definen la lectura de un miembro distinto del escrito
+union v128_t
+{
+    float f32[4];
+    int32_t i32[4];
+    uint32_t u32[4];
+    double f64[2];
+    int64_t i64[2];
+    int16_t i16[8];
+    uint16_t u16[8];
+    uint8_t u8[16];
+};
+
+namespace simd_compat
+{
+    template <class Fn>
+    inline v128_t map_f32(v128_t a, Fn fn)
+    {
+        v128_t r;
+        for (int k = 0; k < 4; ++k)
+            r.f32[k] = fn(a.f32[k]);
+        return r;
+    }
+
+    template <class Fn>
+    inline v128_t zip_f32(v128_t a, v128_t b, Fn fn)
+    {
+        v128_t r;
+        for (int k = 0; k < 4; ++k)
+            r.f32[k] = fn(a.f32[k], b.f32[k]);
+        return r;
+    }
+
+    template <class Fn>
+    inline v128_t zip_f64(v128_t a, v128_t b, Fn fn)
+    {
+        v128_t r;
+        for (int k = 0; k < 2; ++k)
+            r.f64[k] = fn(a.f64[k], b.f64[k]);
+        return r;
+    }
+
+    template <class Fn>
+    inline v128_t zip_i32(v128_t a, v128_t b, Fn fn)
+    {
+        v128_t r;
+        for (int k = 0; k < 4; ++k)
+            r.i32[k] = fn(a.i32[k], b.i32[k]);
+        return r;
+    }
+
+    inline int32_t lane_mask(bool value) { return value ? -1 : 0; }
+
+    inline v128_t shuffle_i32x4(v128_t a, v128_t b, int c0, int c1, int c2, int c3)
+    {
+        const int lanes[4] = {c0, c1, c2, c3};
+        v128_t r;
+        for (int k = 0; k < 4; ++k)
+            r.i32[k] = lanes[k] < 4 ? a.i32[lanes[k]] : b.i32[lanes[k] - 4];
+        return r;
+    }
+
+    inline v128_t shuffle_i64x2(v128_t a, v128_t b, int c0, int c1)
+    {
+        v128_t r;
+        r.i64[0] = c0 < 2 ? a.i64[c0] : b.i64[c0 - 2];
+        r.i64[1] = c1 < 2 ? a.i64[c1] : b.i64[c1 - 2];
+        return r;
+    }
+
+    inline int16_t saturate_i16(int32_t v) { return (int16_t)std::max(-32768, std::min(32767, v)); }
+    inline uint16_t saturate_u16(int32_t v) { return (uint16_t)std::max(0, std::min(65535, v)); }
+
+    // f32x4.min/max: NaN si cualquiera de los dos es NaN
+    inline float wasm_min(float a, float b)
+    {
+        if (a != a || b != b)
+            return std::numeric_limits<float>::quiet_NaN();
+        return std::fmin(a, b);
+    }
+    inline float wasm_max(float a, float b)
+    {
+        if (a != a || b != b)
+            return std::numeric_limits<float>::quiet_NaN();
+        return std::fmax(a, b);
+    }
+} // namespace simd_compat
+
+// --- Carga / Almacenamiento / Construcción ---
+inline v128_t wasm_v128_load(const void *p)
+{
+    v128_t r;
+    std::memcpy(&r, p, sizeof(r));
+    return r;
+}
+inline void wasm_v128_store(void *p, v128_t a) { std::memcpy(p, &a, sizeof(a)); }
+
+inline v128_t wasm_f32x4_make(float a, float b, float c, float d)
+{
+    v128_t r;
+    r.f32[0] = a;
+    r.f32[1] = b;
+    r.f32[2] = c;
+    r.f32[3] = d;
+    return r;
+}
+inline v128_t wasm_i32x4_make(int32_t a, int32_t b, int32_t c, int32_t d)
+{
+    v128_t r;
+    r.i32[0] = a;
+    r.i32[1] = b;
+    r.i32[2] = c;
+    r.i32[3] = d;
+    return r;
+}
+inline v128_t wasm_f64x2_make(double a, double b)
+{
+    v128_t r;
+    r.f64[0] = a;
+    r.f64[1] = b;
+    return r;
+}
+inline v128_t wasm_f32x4_splat(float a) { return wasm_f32x4_make(a, a, a, a); }
+inline v128_t wasm_i32x4_splat(int32_t a) { return wasm_i32x4_make(a, a, a, a); }
+inline v128_t wasm_f64x2_splat(double a) { return wasm_f64x2_make(a, a); }
+
+#define wasm_f32x4_extract_lane(a, lane) ((a).f32[(lane)])
+#define wasm_i32x4_extract_lane(a, lane) ((a).i32[(lane)])
+#define wasm_i32x4_shuffle(a, b, c0, c1, c2, c3) simd_compat::shuffle_i32x4((a), (b), (c0), (c1), (c2), (c3))
+#define wasm_i64x2_shuffle(a, b, c0, c1) simd_compat::shuffle_i64x2((a), (b), (c0), (c1))
+
+// Índices >= 16 (p. ej. 0x80) dan 0
+inline v128_t wasm_i8x16_swizzle(v128_t a, v128_t idx)
+{
+    v128_t r;
+    for (int k = 0; k < 16; ++k)
+        r.u8[k] = idx.u8[k] < 16 ? a.u8[idx.u8[k]] : 0;
+    return r;
+}
+
+// --- Bits ---
+inline v128_t wasm_v128_and(v128_t a, v128_t b)
+{
+    return simd_compat::zip_i32(a, b, [](int32_t x, int32_t y) { return x & y; });
+}
+inline v128_t wasm_v128_or(v128_t a, v128_t b)
+{
+    return simd_compat::zip_i32(a, b, [](int32_t x, int32_t y) { return x | y; });
+}
+inline v128_t wasm_v128_xor(v128_t a, v128_t b)
+{
+    return simd_compat::zip_i32(a, b, [](int32_t x, int32_t y) { return x ^ y; });
+}
+// (a & mask) | (b & ~mask)
+inline v128_t wasm_v128_bitselect(v128_t a, v128_t b, v128_t mask)
+{
+    v128_t r;
+    for (int k = 0; k < 4; ++k)
+        r.u32[k] = (a.u32[k] & mask.u32[k]) | (b.u32[k] & ~mask.u32[k]);
+    return r;
+}
+inline uint32_t wasm_i32x4_bitmask(v128_t a)
+{
+    uint32_t mask = 0;
+    for (int k = 0; k < 4; ++k)
+        mask |= (a.u32[k] >> 31) << k;
+    return mask;
+}
+inline uint32_t wasm_i8x16_bitmask(v128_t a)
+{
+    uint32_t mask = 0;
+    for (int k = 0; k < 16; ++k)
+        mask |= (uint32_t)(a.u8[k] >> 7) << k;
+    return mask;
+}
+
+// --- f32x4 ---
+inline v128_t wasm_f32x4_add(v128_t a, v128_t b)
+{
+    return simd_compat::zip_f32(a, b, [](float x, float y) { return x + y; });
+}
+inline v128_t wasm_f32x4_sub(v128_t a, v128_t b)
+{
+    return simd_compat::zip_f32(a, b, [](float x, float y) { return x - y; });
+}
+inline v128_t wasm_f32x4_mul(v128_t a, v128_t b)
+{
+    return simd_compat::zip_f32(a, b, [](float x, float y) { return x * y; });
+}
+inline v128_t wasm_f32x4_div(v128_t a, v128_t b)
+{
+    return simd_compat::zip_f32(a, b, [](float x, float y) { return x / y; });
+}
+inline v128_t wasm_f32x4_min(v128_t a, v128_t b) { return simd_compat::zip_f32(a, b, simd_compat::wasm_min); }
+inline v128_t wasm_f32x4_max(v128_t a, v128_t b) { return simd_compat::zip_f32(a, b, simd_compat::wasm_max); }
+inline v128_t wasm_f32x4_abs(v128_t a)
+{
+    return wasm_v128_and(a, wasm_i32x4_splat(0x7FFFFFFF));
+}
+// Redondeo al par más cercano (modo de redondeo por defecto)
+inline v128_t wasm_f32x4_nearest(v128_t a)
+{
+    return simd_compat::map_f32(a, [](float x) { return std::nearbyint(x); });
+}
+
+inline v128_t wasm_f32x4_eq(v128_t a, v128_t b)
+{
+    v128_t r;
+    for (int k = 0; k < 4; ++k)
+        r.i32[k] = simd_compat::lane_mask(a.f32[k] == b.f32[k]);
+    return r;
+}
+inline v128_t wasm_f32x4_ge(v128_t a, v128_t b)
+{
+    v128_t r;
+    for (int k = 0; k < 4; ++k)
+        r.i32[k] = simd_compat::lane_mask(a.f32[k] >= b.f32[k]);
+    return r;
+}
+inline v128_t wasm_f32x4_le(v128_t a, v128_t b)
+{
+    v128_t r;
+    for (int k = 0; k < 4; ++k)
+        r.i32[k] = simd_compat::lane_mask(a.f32[k] <= b.f32[k]);
+    return r;
+}
+inline v128_t wasm_f32x4_lt(v128_t a, v128_t b)
+{
+    v128_t r;
+    for (int k = 0; k < 4; ++k)
+        r.i32[k] = simd_compat::lane_mask(a.f32[k] < b.f32[k]);
+    return r;
+}
+
+inline v128_t wasm_f32x4_convert_i32x4(v128_t a)
+{
+    v128_t r;
+    for (int k = 0; k < 4; ++k)
+        r.f32[k] = (float)a.i32[k];
+    return r;
+}
+inline v128_t wasm_f32x4_demote_f64x2_zero(v128_t a)
+{
+    return wasm_f32x4_make((float)a.f64[0], (float)a.f64[1], 0.0f, 0.0f);
+}
+
+// --- i32x4 ---
+inline v128_t wasm_i32x4_add(v128_t a, v128_t b)
+{
+    v128_t r;
+    for (int k = 0; k < 4; ++k)
+        r.u32[k] = a.u32[k] + b.u32[k];
+    return r;
+}
+inline v128_t wasm_i32x4_sub(v128_t a, v128_t b)
+{
+    v128_t r;
+    for (int k = 0; k < 4; ++k)
+        r.u32[k] = a.u32[k] - b.u32[k];
+    return r;
+}
+inline v128_t wasm_i32x4_shl(v128_t a, uint32_t n)
+{
+    v128_t r;
+    for (int k = 0; k < 4; ++k)
+        r.u32[k] = a.u32[k] << (n & 31);
+    return r;
+}
+inline v128_t wasm_u32x4_shr(v128_t a, uint32_t n)
+{
+    v128_t r;
+    for (int k = 0; k < 4; ++k)
+        r.u32[k] = a.u32[k] >> (n & 31);
+    return r;
+}
+// Desplazamiento aritmético (replica el signo)
+inline v128_t wasm_i32x4_shr(v128_t a, uint32_t n)
+{
+    v128_t r;
+    for (int k = 0; k < 4; ++k)
+        r.i32[k] = a.i32[k] >> (n & 31);
+    return r;
+}
+inline v128_t wasm_i32x4_eq(v128_t a, v128_t b)
+{
+    return simd_compat::zip_i32(a, b, [](int32_t x, int32_t y) { return simd_compat::lane_mask(x == y); });
+}
+inline v128_t wasm_i32x4_lt(v128_t a, v128_t b)
+{
+    return simd_compat::zip_i32(a, b, [](int32_t x, int32_t y) { return simd_compat::lane_mask(x < y); });
+}
+inline v128_t wasm_i32x4_gt(v128_t a, v128_t b)
+{
+    return simd_compat::zip_i32(a, b, [](int32_t x, int32_t y) { return simd_compat::lane_mask(x > y); });
+}
+inline v128_t wasm_i32x4_ge(v128_t a, v128_t b)
+{
+    return simd_compat::zip_i32(a, b, [](int32_t x, int32_t y) { return simd_compat::lane_mask(x >= y); });
+}
+
+// Saturado: NaN -> 0, fuera de rango -> INT32_MIN / INT32_MAX
+inline v128_t wasm_i32x4_trunc_sat_f32x4(v128_t a)
+{
+    v128_t r;
+    for (int k = 0; k < 4; ++k)
+    {
+        const float x = a.f32[k];
+        if (x != x)
+            r.i32[k] = 0;
+        else if (x >= 2147483648.0f)
+            r.i32[k] = std::numeric_limits<int32_t>::max();
+        else if (x < -2147483648.0f)
+            r.i32[k] = std::numeric_limits<int32_t>::min();
+        else
+            r.i32[k] = (int32_t)x;
+    }
+    return r;
+}
+
+// --- Ensanchar / Estrechar (8 -> 16, 16 <-> 32 bits) ---
+inline v128_t wasm_u16x8_extend_low_u8x16(v128_t a)
+{
+    v128_t r;
+    for (int k = 0; k < 8; ++k)
+        r.u16[k] = a.u8[k];
+    return r;
+}
+inline v128_t wasm_u16x8_extend_high_u8x16(v128_t a)
+{
+    v128_t r;
+    for (int k = 0; k < 8; ++k)
+        r.u16[k] = a.u8[k + 8];
+    return r;
+}
+inline v128_t wasm_i32x4_extend_low_i16x8(v128_t a)
+{
+    return wasm_i32x4_make(a.i16[0], a.i16[1], a.i16[2], a.i16[3]);
+}
+inline v128_t wasm_i32x4_extend_high_i16x8(v128_t a)
+{
+    return wasm_i32x4_make(a.i16[4], a.i16[5], a.i16[6], a.i16[7]);
+}
+inline v128_t wasm_u32x4_extend_low_u16x8(v128_t a)
+{
+    return wasm_i32x4_make(a.u16[0], a.u16[1], a.u16[2], a.u16[3]);
+}
+inline v128_t wasm_u32x4_extend_high_u16x8(v128_t a)
+{
+    return wasm_i32x4_make(a.u16[4], a.u16[5], a.u16[6], a.u16[7]);
+}
+inline v128_t wasm_i16x8_narrow_i32x4(v128_t a, v128_t b)
+{
+    v128_t r;
+    for (int k = 0; k < 4; ++k)
+    {
+        r.i16[k] = simd_compat::saturate_i16(a.i32[k]);
+        r.i16[k + 4] = simd_compat::saturate_i16(b.i32[k]);
+    }
+    return r;
+}
+inline v128_t wasm_u16x8_narrow_i32x4(v128_t a, v128_t b)
+{
+    v128_t r;
+    for (int k = 0; k < 4; ++k)
+    {
+        r.u16[k] = simd_compat::saturate_u16(a.i32[k]);
+        r.u16[k + 4] = simd_compat::saturate_u16(b.i32[k]);
+    }
+    return r;
+}
+
+// --- f64x2 ---
+inline v128_t wasm_f64x2_add(v128_t a, v128_t b)
+{
+    return simd_compat::zip_f64(a, b, [](double x, double y) { return x + y; });
+}
+inline v128_t wasm_f64x2_sub(v128_t a, v128_t b)
+{
+    return simd_compat::zip_f64(a, b, [](double x, double y) { return x - y; });
+}
+inline v128_t wasm_f64x2_mul(v128_t a, v128_t b)
+{
+    return simd_compat::zip_f64(a, b, [](double x, double y) { return x * y; });
+}
+inline v128_t wasm_f64x2_div(v128_t a, v128_t b)
+{
+    return simd_compat::zip_f64(a, b, [](double x, double y) { return x / y; });
+}
+inline v128_t wasm_f64x2_abs(v128_t a)
+{
+    return simd_compat::zip_f64(a, a, [](double x, double) { return std::abs(x); });
+}
+inline v128_t wasm_f64x2_ge(v128_t a, v128_t b)
+{
+    v128_t r;
+    for (int k = 0; k < 2; ++k)
+        r.i64[k] = a.f64[k] >= b.f64[k] ? -1 : 0;
+    return r;
+}
+
+#endif
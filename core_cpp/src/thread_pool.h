@@ -0,0 +1,174 @@
+// core_cpp/src/thread_pool.h
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+#ifdef __EMSCRIPTEN_PTHREADS__
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+// Límite de workers; la build con pthreads debe precrear al menos estos hilos
+// (-sPTHREAD_POOL_SIZE) porque el hilo principal no puede ceder el control al
+// event loop mientras espera a que arranque un worker nuevo.
+const int THREAD_POOL_MAX_WORKERS = 8;
+
+/**
+ * Pool persistente de hilos para trabajos divididos en chunks.
+ * Los workers duermen hasta que `run` publica un trabajo; el hilo llamante también
+ * procesa chunks y vuelve cuando todos han terminado. Los chunks se reparten con un
+ * contador atómico, así que los hilos más rápidos se llevan más trabajo.
+ * En builds sin pthreads (`__EMSCRIPTEN_PTHREADS__` no definido) `run` es serie.
+ * `run` no es reentrante: debe llamarse siempre desde el mismo hilo (el de JS).
+ */
+class ChunkThreadPool
+{
+public:
+    static ChunkThreadPool &instance()
+    {
+        static ChunkThreadPool pool;
+        return pool;
+    }
+
+    /** Ajusta el número de workers (0 = todo en el hilo llamante). Devuelve los activos. */
+    int resize(int num_workers)
+    {
+#ifdef __EMSCRIPTEN_PTHREADS__
+        num_workers = std::max(0, std::min(num_workers, THREAD_POOL_MAX_WORKERS));
+        if (num_workers == (int)workers_.size())
+            return num_workers;
+        stop_workers();
+        uint64_t generation;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = false;
+            generation = generation_;
+        }
+        // Los workers nuevos parten de la generación actual: el último trabajo
+        // publicado ya terminó y no deben procesarlo (ni descontarse) otra vez
+        for (int i = 0; i < num_workers; ++i)
+            workers_.emplace_back([this, generation]
+                                  { worker_loop(generation); });
+        return (int)workers_.size();
+#else
+        (void)num_workers;
+        return 0;
+#endif
+    }
+
+    int size() const
+    {
+#ifdef __EMSCRIPTEN_PTHREADS__
+        return (int)workers_.size();
+#else
+        return 0;
+#endif
+    }
+
+    /** Ejecuta fn(chunk) para cada chunk en [0, num_chunks). Bloquea hasta terminar. */
+    void run(int num_chunks, const std::function<void(int)> &fn)
+    {
+#ifdef __EMSCRIPTEN_PTHREADS__
+        if (!workers_.empty() && num_chunks > 1)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                job_ = &fn;
+                num_chunks_ = num_chunks;
+                next_chunk_.store(0, std::memory_order_relaxed);
+                pending_workers_ = (int)workers_.size();
+                ++generation_;
+            }
+            wake_cv_.notify_all();
+            drain(fn, num_chunks);
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            done_cv_.wait(lock, [this]
+                          { return pending_workers_ == 0; });
+            job_ = nullptr;
+            return;
+        }
+#endif
+        for (int chunk = 0; chunk < num_chunks; ++chunk)
+            fn(chunk);
+    }
+
+    ~ChunkThreadPool()
+    {
+#ifdef __EMSCRIPTEN_PTHREADS__
+        stop_workers();
+#endif
+    }
+
+private:
+    ChunkThreadPool() = default;
+    ChunkThreadPool(const ChunkThreadPool &) = delete;
+    ChunkThreadPool &operator=(const ChunkThreadPool &) = delete;
+
+    void drain(const std::function<void(int)> &fn, int num_chunks)
+    {
+        for (;;)
+        {
+            int chunk = next_chunk_.fetch_add(1, std::memory_order_relaxed);
+            if (chunk >= num_chunks)
+                break;
+            fn(chunk);
+        }
+    }
+
+    std::atomic<int> next_chunk_{0};
+
+#ifdef __EMSCRIPTEN_PTHREADS__
+    void worker_loop(uint64_t seen_generation)
+    {
+        for (;;)
+        {
+            const std::function<void(int)> *job;
+            int num_chunks;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_cv_.wait(lock, [&]
+                              { return stopping_ || generation_ != seen_generation; });
+                if (stopping_)
+                    return;
+                seen_generation = generation_;
+                job = job_;
+                num_chunks = num_chunks_;
+            }
+            drain(*job, num_chunks);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (--pending_workers_ == 0)
+                    done_cv_.notify_one();
+            }
+        }
+    }
+
+    void stop_workers()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_cv_.notify_all();
+        for (std::thread &worker : workers_)
+            worker.join();
+        workers_.clear();
+    }
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_cv_;
+    std::condition_variable done_cv_;
+    const std::function<void(int)> *job_ = nullptr;
+    int num_chunks_ = 0;
+    int pending_workers_ = 0;
+    uint64_t generation_ = 0;
+    bool stopping_ = false;
+#endif
+};
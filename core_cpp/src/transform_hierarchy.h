@@ -0,0 +1,168 @@
+// core_cpp/src/transform_hierarchy.h
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "matrix_batch.h"
+#include "point_kernels.h"
+
+// --- Jerarquía de Transformaciones (Scene Graph) ---
+// world[i] = world[parent[i]] * local[i] para todos los nodos de una escena, en una
+// sola llamada. Los nodos están en orden topológico (parent[i] < i, -1 = raíz), así
+// que una pasada hacia delante basta: primero hereda los flags dirty de cada padre
+// (un nodo sucio ensucia todo su subárbol) y después recalcula solo los nodos sucios.
+// local y world son SoA (9 planos de `capacity` floats, como MatrixBatchLayout::SoA):
+// 4 nodos sucios consecutivos cuyos padres ya están calculados se multiplican en un
+// vector SIMD; el resto (p. ej. un hijo justo detrás de su padre) va de uno en uno.
+// Opcionalmente, cada nodo recalculado transforma su tramo de puntos
+// [start, start + count) de un buffer xyxy con su nueva matriz world, en la misma pasada.
+
+const int32_t HIERARCHY_ROOT = -1;
+
+struct TransformHierarchy
+{
+    int capacity = 0;
+    std::vector<float> local;          // 9 planos de capacity floats; JS escribe aquí
+    std::vector<float> world;          // Mismo layout; lo escribe update_hierarchy
+    std::vector<int32_t> parent;       // HIERARCHY_ROOT o un índice menor
+    std::vector<uint8_t> dirty;        // 1 = recalcular el nodo y su subárbol
+    std::vector<int32_t> point_ranges; // [start, count] por nodo; count 0 = sin puntos
+
+    explicit TransformHierarchy(int cap)
+        : capacity(cap), local((size_t)cap * 9, 0.0f), world((size_t)cap * 9, 0.0f),
+          parent(cap, HIERARCHY_ROOT), dirty(cap, 1), point_ranges((size_t)cap * 2, 0)
+    {
+        // Identidad en los planos 0, 4 y 8
+        for (int k = 0; k < 9; k += 4)
+        {
+            std::fill(local.begin() + (size_t)k * cap, local.begin() + (size_t)(k + 1) * cap, 1.0f);
+            std::fill(world.begin() + (size_t)k * cap, world.begin() + (size_t)(k + 1) * cap, 1.0f);
+        }
+    }
+};
+
+const float HIERARCHY_IDENTITY[9] = {1, 0, 0, 0, 1, 0, 0, 0, 1};
+
+// Coeficiente k de la matriz world del padre (la identidad para las raíces)
+inline float hierarchy_parent_coeff(const TransformHierarchy &h, int32_t p, int k)
+{
+    return p < 0 ? HIERARCHY_IDENTITY[k] : h.world[(size_t)k * h.capacity + p];
+}
+
+inline void hierarchy_update_node(TransformHierarchy &h, int i)
+{
+    const int cap = h.capacity;
+    const int32_t p = h.parent[i];
+    float parent_world[9], local[9], world[9];
+    for (int k = 0; k < 9; ++k)
+    {
+        parent_world[k] = hierarchy_parent_coeff(h, p, k);
+        local[k] = h.local[(size_t)k * cap + i];
+    }
+    multiply_matrix_scalar(parent_world, local, world);
+    for (int k = 0; k < 9; ++k)
+        h.world[(size_t)k * cap + i] = world[k];
+}
+
+// Nodos [i, i + 4): todos sucios y con el padre antes de i
+inline void hierarchy_update_block(TransformHierarchy &h, int i)
+{
+    const int32_t *p = &h.parent[i];
+    MatrixLanes parent_world, local, world;
+    for (int k = 0; k < 9; ++k)
+    {
+        parent_world.c[k] = wasm_f32x4_make(hierarchy_parent_coeff(h, p[0], k), hierarchy_parent_coeff(h, p[1], k),
+                                            hierarchy_parent_coeff(h, p[2], k), hierarchy_parent_coeff(h, p[3], k));
+    }
+    load_matrix_lanes_soa(h.local.data(), h.capacity, i, local);
+    multiply_matrix_lanes(parent_world, local, world);
+    store_matrix_lanes_soa(world, h.world.data(), h.capacity, i);
+}
+
+inline bool hierarchy_block_ready(const TransformHierarchy &h, int i, int num_nodes)
+{
+    if (i + 4 > num_nodes)
+        return false;
+    for (int j = i; j < i + 4; ++j)
+    {
+        if (!h.dirty[j] || h.parent[j] >= i)
+            return false;
+    }
+    return true;
+}
+
+// Transforma el tramo de puntos del nodo i con su matriz world
+inline void hierarchy_transform_node_points(const TransformHierarchy &h, int i, const float *pts_in, float *pts_out)
+{
+    const int32_t start = h.point_ranges[(size_t)i * 2];
+    const int32_t count = h.point_ranges[(size_t)i * 2 + 1];
+    if (count == 0)
+        return;
+    float m[9];
+    for (int k = 0; k < 9; ++k)
+        m[k] = h.world[(size_t)k * h.capacity + i];
+    TransformCoeffs coeffs;
+    load_transform_coeffs(m, coeffs);
+    PackedLayout layout{pts_in + (size_t)start * 2, pts_out + (size_t)start * 2};
+    transform_points_dispatch(classify_matrix(m), coeffs, layout, count);
+}
+
+/**
+ * Recalcula world para los nodos sucios de [0, num_nodes) y sus subárboles, y
+ * limpia los flags. Con pts_in != nullptr transforma también los puntos de cada
+ * nodo recalculado (pts_in/pts_out xyxy de num_points puntos; pueden coincidir).
+ * @returns Nodos recalculados, o -1 si algún padre no precede a su hijo o algún
+ *          tramo de puntos queda fuera de [0, num_points). En ese caso no cambia nada.
+ */
+inline int update_hierarchy(TransformHierarchy &h, int num_nodes, const float *pts_in, float *pts_out,
+                            int num_points)
+{
+    if (num_nodes < 0 || num_nodes > h.capacity)
+        return -1;
+    for (int i = 0; i < num_nodes; ++i)
+    {
+        const int32_t p = h.parent[i];
+        if (p < HIERARCHY_ROOT || p >= i)
+            return -1;
+        if (!pts_in)
+            continue;
+        const int32_t start = h.point_ranges[(size_t)i * 2];
+        const int32_t count = h.point_ranges[(size_t)i * 2 + 1];
+        if (start < 0 || count < 0 || (int64_t)start + count > num_points)
+            return -1;
+    }
+
+    // Un nodo es sucio si lo es él o su padre (ya propagado, porque p < i)
+    for (int i = 0; i < num_nodes; ++i)
+    {
+        const int32_t p = h.parent[i];
+        if (p >= 0 && h.dirty[p])
+            h.dirty[i] = 1;
+    }
+
+    int updated = 0;
+    for (int i = 0; i < num_nodes;)
+    {
+        if (!h.dirty[i])
+        {
+            ++i;
+            continue;
+        }
+        const int span = hierarchy_block_ready(h, i, num_nodes) ? 4 : 1;
+        if (span == 4)
+            hierarchy_update_block(h, i);
+        else
+            hierarchy_update_node(h, i);
+        for (int j = i; j < i + span; ++j)
+        {
+            if (pts_in)
+                hierarchy_transform_node_points(h, j, pts_in, pts_out);
+            h.dirty[j] = 0;
+        }
+        updated += span;
+        i += span;
+    }
+    return updated;
+}
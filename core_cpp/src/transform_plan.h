@@ -0,0 +1,134 @@
+// core_cpp/src/transform_plan.h
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#include "point_kernels.h"
+#include "thread_pool.h"
+
+// --- Planes de Transformación Precompilados ---
+// Para buffers del mismo tamaño transformados cada frame con matrices que cambian
+// poco: layout, punteros, dirección y reparto en chunks se validan una vez al crear
+// el plan; la matriz se escribe en el propio plan y solo al actualizarla se
+// re-splattean los coeficientes y se reelige el kernel (clase x precisión x layout).
+// Ejecutar el plan es una llamada indirecta al kernel ya elegido.
+
+enum class PlanLayout : int32_t
+{
+    Packed = 0,  // xyxy: in[0] -> out[0]
+    Strided = 1, // intercalado: in[0]/out[0] ya desplazados, pasos en floats
+    SoA = 2      // in[0] = x_in, in[1] = y_in, out[0] = x_out, out[1] = y_out
+};
+
+struct TransformPlan;
+using PlanKernel = void (*)(const TransformPlan &plan, int begin, int count);
+
+struct TransformPlan
+{
+    TransformCoeffs coeffs;
+    float matrix[9] = {1, 0, 0, 0, 1, 0, 0, 0, 1}; // JS escribe aquí (plan_matrix_ptr)
+    MatrixClass cls = MatrixClass::Identity;
+    PlanLayout layout = PlanLayout::Packed;
+    const float *in[2] = {nullptr, nullptr};
+    float *out[2] = {nullptr, nullptr};
+    int in_stride = 2;
+    int out_stride = 2;
+    int num_points = 0;
+    int chunk_points = 1; // >= num_points: en serie
+    bool reverse = false;
+    PlanKernel kernel = nullptr;
+};
+
+// Layout del tramo [begin, begin + count) del plan
+template <class Layout>
+Layout plan_layout(const TransformPlan &plan, int begin);
+
+template <>
+inline PackedLayout plan_layout<PackedLayout>(const TransformPlan &plan, int begin)
+{
+    return {plan.in[0] + (size_t)begin * 2, plan.out[0] + (size_t)begin * 2};
+}
+
+template <>
+inline StridedLayout plan_layout<StridedLayout>(const TransformPlan &plan, int begin)
+{
+    return {plan.in[0] + (size_t)begin * plan.in_stride, plan.in_stride,
+            plan.out[0] + (size_t)begin * plan.out_stride, plan.out_stride};
+}
+
+template <>
+inline SoALayout plan_layout<SoALayout>(const TransformPlan &plan, int begin)
+{
+    return {plan.in[0] + begin, plan.in[1] + begin, plan.out[0] + begin, plan.out[1] + begin};
+}
+
+template <MatrixClass C, TransformPrecision P, class Layout>
+void plan_kernel(const TransformPlan &plan, int begin, int count)
+{
+    transform_points_kernel<C, P>(plan.coeffs, plan_layout<Layout>(plan, begin), count, plan.reverse);
+}
+
+// Misma selección que transform_points_dispatch, pero resuelta a un puntero
+template <MatrixClass C, class Layout>
+PlanKernel select_plan_kernel_precision(TransformPrecision precision)
+{
+    if (precision == TransformPrecision::Fast)
+        return &plan_kernel<C, TransformPrecision::Fast, Layout>;
+    return &plan_kernel<C, TransformPrecision::Exact, Layout>;
+}
+
+template <class Layout>
+PlanKernel select_plan_kernel_class(MatrixClass cls, TransformPrecision precision)
+{
+    switch (cls)
+    {
+    case MatrixClass::Identity:
+        return &plan_kernel<MatrixClass::Identity, TransformPrecision::Exact, Layout>;
+    case MatrixClass::Translate:
+        return &plan_kernel<MatrixClass::Translate, TransformPrecision::Exact, Layout>;
+    case MatrixClass::ScaleTranslate:
+        return select_plan_kernel_precision<MatrixClass::ScaleTranslate, Layout>(precision);
+    case MatrixClass::Affine:
+        return select_plan_kernel_precision<MatrixClass::Affine, Layout>(precision);
+    default:
+        return select_plan_kernel_precision<MatrixClass::Projective, Layout>(precision);
+    }
+}
+
+inline PlanKernel select_plan_kernel(PlanLayout layout, MatrixClass cls, TransformPrecision precision)
+{
+    switch (layout)
+    {
+    case PlanLayout::Strided:
+        return select_plan_kernel_class<StridedLayout>(cls, precision);
+    case PlanLayout::SoA:
+        return select_plan_kernel_class<SoALayout>(cls, precision);
+    default:
+        return select_plan_kernel_class<PackedLayout>(cls, precision);
+    }
+}
+
+/** Re-splattea plan.matrix y reelige el kernel (también recoge el modo de precisión). */
+inline MatrixClass plan_load_matrix(TransformPlan &plan)
+{
+    load_transform_coeffs(plan.matrix, plan.coeffs);
+    plan.cls = classify_matrix(plan.matrix);
+    plan.kernel = select_plan_kernel(plan.layout, plan.cls, plan.coeffs.precision);
+    return plan.cls;
+}
+
+inline void plan_run(const TransformPlan &plan)
+{
+    if (plan.chunk_points >= plan.num_points)
+    {
+        plan.kernel(plan, 0, plan.num_points);
+        return;
+    }
+    const int chunk_points = plan.chunk_points;
+    const int num_chunks = (plan.num_points + chunk_points - 1) / chunk_points;
+    ChunkThreadPool::instance().run(num_chunks, [&](int chunk)
+                                    {
+        const int begin = chunk * chunk_points;
+        plan.kernel(plan, begin, std::min(chunk_points, plan.num_points - begin)); });
+}
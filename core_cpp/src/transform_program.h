@@ -0,0 +1,160 @@
+// core_cpp/src/transform_program.h
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "matrix_batch.h"
+
+// --- Programas de Transformación (bytecode de TransformCommand) ---
+// Una secuencia de TransformCommand (MatrixUtils.combine) codificada como palabras de
+// 32 bits: [opcode int32, argumentos float32...]. Varias secuencias van seguidas en el
+// mismo flujo, cada una terminada en End, y evaluate_transform_program las pliega
+// todas en una llamada: una matriz por secuencia, sin alocar nada por comando.
+// Semántica (la de execute de cada comando, partiendo de la identidad):
+// - Translate/Rotate/Scale/Skew/Matrix: m = op * m. Las cuatro primeras son afines y se
+//   aplican como operación de filas (12 mul) en lugar de un producto 3x3 completo.
+// - PostMatrix: m = m * op (PerspectiveCommand, con la inversa de la homografía ya
+//   calculada al codificar: no se reinvierte en cada evaluación).
+// - Reset: m = identidad (CropCommand, ResizeCommand).
+
+enum class TransformOp : int32_t
+{
+    End = 0,        // Emite m y vuelve a la identidad
+    Translate = 1,  // dx, dy
+    Rotate = 2,     // angle, cx, cy (rotación alrededor de (cx, cy))
+    Scale = 3,      // sx, sy, cx, cy (escala alrededor de (cx, cy))
+    Skew = 4,       // skew_x, skew_y (ángulos en radianes)
+    Matrix = 5,     // 9 floats column-major (CustomTransformCommand)
+    PostMatrix = 6, // 9 floats column-major
+    Reset = 7
+};
+
+// Palabras de argumentos del opcode, o -1 si no existe
+inline int transform_op_args(int32_t opcode)
+{
+    switch ((TransformOp)opcode)
+    {
+    case TransformOp::End:
+    case TransformOp::Reset:
+        return 0;
+    case TransformOp::Translate:
+    case TransformOp::Skew:
+        return 2;
+    case TransformOp::Rotate:
+        return 3;
+    case TransformOp::Scale:
+        return 4;
+    case TransformOp::Matrix:
+    case TransformOp::PostMatrix:
+        return 9;
+    default:
+        return -1;
+    }
+}
+
+// m = A * m con A afín de filas [a00 a01 a02; a10 a11 a12; 0 0 1]
+inline void premultiply_affine(float *m, float a00, float a01, float a02, float a10, float a11, float a12)
+{
+    for (int j = 0; j < 9; j += 3)
+    {
+        const float x = m[j], y = m[j + 1], w = m[j + 2];
+        m[j] = a00 * x + a01 * y + a02 * w;
+        m[j + 1] = a10 * x + a11 * y + a12 * w;
+    }
+}
+
+inline void set_identity_matrix(float *m)
+{
+    for (int k = 0; k < 9; ++k)
+        m[k] = (k % 4 == 0) ? 1.0f : 0.0f;
+}
+
+/**
+ * Cuenta las secuencias del flujo. @returns Número de End, o -1 si hay un opcode
+ * desconocido, un comando truncado o palabras después del último End.
+ */
+inline int count_transform_sequences(const int32_t *code, int num_words)
+{
+    int sequences = 0;
+    int pc = 0;
+    bool open = false;
+    while (pc < num_words)
+    {
+        const int args = transform_op_args(code[pc]);
+        if (args < 0 || pc + 1 + args > num_words)
+            return -1;
+        open = code[pc] != (int32_t)TransformOp::End;
+        if (!open)
+            ++sequences;
+        pc += 1 + args;
+    }
+    return open ? -1 : sequences;
+}
+
+/**
+ * Evalúa todas las secuencias del flujo y escribe la matriz de la secuencia i en la
+ * posición i de out (layout AoS, o SoA con planos de max_matrices floats).
+ * @returns Número de secuencias, o -1 si el flujo no es válido o tiene más de
+ *          max_matrices secuencias. En ese caso no escribe nada.
+ */
+inline int evaluate_transform_program(const int32_t *code, int num_words, float *out, int max_matrices,
+                                      MatrixBatchLayout layout)
+{
+    const int sequences = count_transform_sequences(code, num_words);
+    if (sequences < 0 || sequences > max_matrices)
+        return -1;
+
+    float m[9];
+    float a[9]; // Argumentos float del comando actual
+    set_identity_matrix(m);
+    int seq = 0;
+    for (int pc = 0; pc < num_words;)
+    {
+        const int32_t opcode = code[pc];
+        const int args = transform_op_args(opcode);
+        std::memcpy(a, code + pc + 1, (size_t)args * sizeof(float));
+        pc += 1 + args;
+
+        switch ((TransformOp)opcode)
+        {
+        case TransformOp::Translate:
+            premultiply_affine(m, 1.0f, 0.0f, a[0], 0.0f, 1.0f, a[1]);
+            break;
+        case TransformOp::Rotate:
+        {
+            const float c = std::cos(a[0]), s = std::sin(a[0]);
+            premultiply_affine(m, c, -s, a[1] - a[1] * c + a[2] * s, s, c, a[2] - a[1] * s - a[2] * c);
+            break;
+        }
+        case TransformOp::Scale:
+            premultiply_affine(m, a[0], 0.0f, a[2] * (1.0f - a[0]), 0.0f, a[1], a[3] * (1.0f - a[1]));
+            break;
+        case TransformOp::Skew:
+            premultiply_affine(m, 1.0f, std::tan(a[1]), 0.0f, std::tan(a[0]), 1.0f, 0.0f);
+            break;
+        case TransformOp::Matrix:
+            multiply_matrix_scalar(a, m, m);
+            break;
+        case TransformOp::PostMatrix:
+            multiply_matrix_scalar(m, a, m);
+            break;
+        case TransformOp::Reset:
+            set_identity_matrix(m);
+            break;
+        case TransformOp::End:
+            if (layout == MatrixBatchLayout::AoS)
+                std::memcpy(out + (size_t)seq * 9, m, sizeof(m));
+            else
+            {
+                for (int k = 0; k < 9; ++k)
+                    out[(size_t)k * max_matrices + seq] = m[k];
+            }
+            ++seq;
+            set_identity_matrix(m);
+            break;
+        }
+    }
+    return sequences;
+}
@@ -340,6 +340,7 @@ async function animationLoop() {
   // --- Ejecución y Medición WASM ---
   let wasmTime = NaN; // Empezar como NaN
   let wasmError = false;
+  let wasmVisibleCount = 0;
   if (isWasmReady && bufferManager) {
     try {
       const t0 = performance.now();
@@ -347,14 +348,17 @@ async function animationLoop() {
       const inputBuffer = await bufferManager.getInputBuffer(particleCount);
       inputBuffer.view.set(currentInputSubarray);
 
-      // Ejecutar WASM
-      await bufferManager.transformPointsBatchManaged(
+      // Ejecutar WASM: transformar + descartar las partículas fuera del canvas
+      // en la misma pasada; la salida queda compactada con solo las visibles
+      wasmVisibleCount = await bufferManager.transformPointsCullManaged(
         currentMatrix,
-        particleCount
+        particleCount,
+        { minX: 0, minY: 0, maxX: CANVAS_WIDTH, maxY: CANVAS_HEIGHT },
+        false
       );
 
       // Obtener vista de salida para leer/dibujar
-      pointsWASMOutputView = bufferManager.getOutputView(particleCount);
+      pointsWASMOutputView = bufferManager.getOutputView(wasmVisibleCount);
       const t1 = performance.now();
       wasmTime = t1 - t0; // Tiempo incluye copia entrada + cálculo WASM
       if (!pointsWASMOutputView) wasmError = true;
@@ -381,7 +385,7 @@ async function animationLoop() {
     } else {
       drawLimitedParticles(
         wasmCtx,
-        particleCount,
+        wasmVisibleCount,
         pointsWASMOutputView,
         PARTICLE_COLOR_WASM
       );
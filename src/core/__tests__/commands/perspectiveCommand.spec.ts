@@ -477,6 +477,18 @@ describe("PerspectiveCommand", () => {
     inverseSpy.mockRestore();
   });
 
+  it("execute() should invert the homography only once", async () => {
+    command = await PerspectiveCommand.create(srcPts, dstPts);
+    const inverseSpy = vi.spyOn(MatrixUtils, "inverse");
+
+    const first = command.execute(identityMatrix);
+    const second = command.execute(identityMatrix);
+    expectMatrixCloseTo(second, first, tolerance);
+    expect(command.getInverseHomographyMatrix()).toBeDefined();
+    expect(inverseSpy).toHaveBeenCalledTimes(1);
+    inverseSpy.mockRestore();
+  });
+
   // --- Tests for Static Helpers (Conceptual - Keep as placeholder or test indirectly) ---
   describe("Internal Helpers (Conceptual)", () => {
     // These are private static methods. Testing them directly is hard without workarounds
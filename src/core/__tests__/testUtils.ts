@@ -1,5 +1,9 @@
 import { expect } from 'vitest';
 import type { Matrix3x3, Point, Rect } from '../../types/core.types'; // Ajusta ruta
+import { MatrixUtils } from '../matrix/MatrixUtils';
+
+/** Afín genérica (escala, cizalla y traslación) para los specs de puntos WASM. */
+export const TEST_AFFINE = MatrixUtils.fromValues(1.5, 0.2, 0, -0.3, 0.8, 0, 4, -2, 1);
 
 export function expectMatrixCloseTo(
     actual: Matrix3x3,
@@ -35,6 +39,35 @@ export function expectPointCloseTo(actual: Point, expected: Point, epsilon = 1e-
     expect(diffY).toBeLessThanOrEqual(epsilon);
 }
 
+/**
+ * Comprueba que la salida contiene los puntos xyxy de `input` transformados por `m`
+ * (referencia: `MatrixUtils.transformPoint`).
+ * @param output Salida xyxy, o lector del punto `i` para otros layouts.
+ * @param indices Puntos a comprobar. Por defecto todos; con una salida xyxy
+ *   también se exige la misma longitud que `input`.
+ */
+export function expectTransformed(
+    m: Matrix3x3,
+    input: ArrayLike<number>,
+    output: ArrayLike<number> | ((i: number) => [number, number]),
+    indices?: Iterable<number>,
+    digits = 3,
+) {
+    const read =
+        typeof output === 'function'
+            ? output
+            : (i: number): [number, number] => [output[i * 2], output[i * 2 + 1]];
+    if (!indices && typeof output !== 'function') {
+        expect(output.length).toBe(input.length);
+    }
+    for (const i of indices ?? Array.from({ length: input.length / 2 }, (_, k) => k)) {
+        const p = MatrixUtils.transformPoint(m, { x: input[i * 2], y: input[i * 2 + 1] });
+        const [x, y] = read(i);
+        expect(x).toBeCloseTo(p.x, digits);
+        expect(y).toBeCloseTo(p.y, digits);
+    }
+}
+
 export function expectRectCloseTo(actual: Rect, expected: Rect, epsilon = 1e-6) {
     expect(actual.x).toBeCloseTo(expected.x, epsilon);
     expect(actual.y).toBeCloseTo(expected.y, epsilon);
@@ -13,6 +13,8 @@ export class PerspectiveCommand implements TransformCommand {
   private readonly sourcePointsInternal: Readonly<[Point, Point, Point, Point]>;
   private readonly destPointsInternal: Readonly<[Point, Point, Point, Point]>;
   private readonly homography: Matrix3x3;
+  // Inversa de la homografía, calculada en el primer uso (la homografía no cambia)
+  private homographyInverse: Matrix3x3 | null = null;
 
   /**
    * Constructor privado.
@@ -40,6 +42,28 @@ export class PerspectiveCommand implements TransformCommand {
     return this.homography;
   }
 
+  /**
+   * Inversa de la homografía (la que aplica `execute`), cacheada tras el
+   * primer cálculo. Devuelve la referencia interna: no la modifiques.
+   * @throws MatrixError si la homografía es singular.
+   */
+  public getInverseHomographyMatrix(): Matrix3x3 {
+    if (!this.homographyInverse) {
+      const inverse = MatrixUtils.inverse(this.homography);
+      if (!inverse) {
+        console.error(
+          "PerspectiveCommand execution failed: Internal homography matrix is singular."
+        );
+        throw new MatrixError(
+          "Cannot execute command: the precomputed homography matrix is singular.",
+          "SINGULAR_MATRIX"
+        );
+      }
+      this.homographyInverse = inverse;
+    }
+    return this.homographyInverse;
+  }
+
   /**
    * Crea una instancia de PerspectiveCommand. (Sigue siendo ASÍNCRONO por SVD)
    */
@@ -106,18 +130,8 @@ export class PerspectiveCommand implements TransformCommand {
    */
   execute(matrix: Matrix3x3): Matrix3x3 {
     try {
-      // Calcula la inversa de la homografía precalculada (síncrono)
-      const homographyInv = MatrixUtils.inverse(this.homography);
-      if (!homographyInv) {
-        // La inversa no pudo ser calculada (matriz singular)
-        console.error(
-          "PerspectiveCommand execution failed: Internal homography matrix is singular."
-        );
-        throw new MatrixError(
-          "Cannot execute command: the precomputed homography matrix is singular.",
-          "SINGULAR_MATRIX"
-        );
-      }
+      // Inversa de la homografía, calculada solo en la primera ejecución
+      const homographyInv = this.getInverseHomographyMatrix();
       // Aplica la transformación multiplicando la matriz de entrada por la inversa (síncrono)
       // Devuelve una nueva matriz resultado de la multiplicación
       return MatrixUtils.multiply(matrix, homographyInv);
@@ -1,10 +1,23 @@
 // src/core/wasm/WasmBufferManager.ts
 
-import { loadWasmModule } from "./wasm-loader"; // Importa el loader
+import {
+  detectWasmFeatures,
+  getWasmDiagnostics,
+  loadWasmModule,
+  WasmPointFormat,
+  WasmTransformPrecision,
+} from "./wasm-loader"; // Importa el loader
 // Importar tipos necesarios
 import type { Matrix3x3 } from "../../types/core.types";
 // Importar la interfaz del módulo WASM (asumiendo que wasm-loader.ts la exporta)
-import type { MatrixOpsWasmModule } from "./wasm-loader";
+import type { MatrixOpsWasmModule, WasmModuleVariant } from "./wasm-loader";
+import { WasmCommandBuffer } from "./WasmCommandBuffer";
+import type { WasmCommandBufferOptions } from "./WasmCommandBuffer";
+import { PlanLayoutCode, WasmTransformPlan } from "./WasmTransformPlan";
+import { WasmTransformHierarchy } from "./WasmTransformHierarchy";
+import { WasmKeyframeAnimation } from "./WasmKeyframeAnimation";
+import { WasmTransformProgram } from "./WasmTransformProgram";
+import type { WasmTransformProgramOptions } from "./WasmTransformProgram";
 
 // --- Interfaz Pública del Buffer Gestionado ---
 
@@ -32,10 +45,571 @@ export interface ManagedWasmBuffer {
   readonly sizeBytes: number;
 }
 
+/**
+ * Vista sobre un buffer auxiliar gestionado (matrices, índices, resultados).
+ * Igual que en `ManagedWasmBuffer`, `view` se relee en cada acceso, así que
+ * sigue siendo válida si la memoria WASM crece o el buffer se realoca al
+ * crecer. Guarda el objeto, no la vista.
+ */
+export interface ManagedWasmView<T extends ArrayBufferView> {
+  readonly view: T;
+  /** Tamaño actual en bytes del bloque WASM (puede superar a `view`). */
+  readonly sizeBytes: number;
+}
+
 interface InternalWasmBufferInfo extends ManagedWasmBuffer {
   readonly internalPointer: number; // Mantenemos el puntero internamente
 }
 
+/**
+ * Buffer del pool WASM (`buffer_pool.h`) visto desde JS. El handle es estable;
+ * `pointer` y `sizeBytes` se actualizan al crecer, y las vistas vivas los
+ * releen, así que nunca apuntan a un bloque ya devuelto al pool.
+ */
+interface PooledBufferRecord {
+  readonly handle: number;
+  pointer: number;
+  sizeBytes: number;
+  /** Alocado en la arena por frame: caduca en el siguiente `beginFrame()`. */
+  readonly frame: boolean;
+  /** Última vista de `getBufferView` (clave tipo:puntos), reutilizable. */
+  cachedView?: { key: string; read: () => ArrayBufferView };
+}
+
+/** Contadores del pool WASM (`getPoolStats`), en orden de `BufferPoolStats`. */
+export interface WasmPoolStats {
+  /** Handles vivos (pool + arena). */
+  liveHandles: number;
+  /** Bytes en uso por handles del pool. */
+  pooledBytes: number;
+  /** Bytes cacheados en las listas libres, listos para reutilizar. */
+  cachedBytes: number;
+  /** Bytes reservados por la arena por frame. */
+  arenaCapacity: number;
+  /** Bytes usados por la arena en el frame actual. */
+  arenaUsed: number;
+  /** Llamadas acumuladas a malloc del sistema (churn). */
+  systemAllocs: number;
+  /** Llamadas acumuladas a free del sistema. */
+  systemFrees: number;
+  /** Alocaciones servidas desde una lista libre sin malloc. */
+  reuseHits: number;
+}
+
+const POOL_STATS_FIELDS: (keyof WasmPoolStats)[] = [
+  "liveHandles",
+  "pooledBytes",
+  "cachedBytes",
+  "arenaCapacity",
+  "arenaUsed",
+  "systemAllocs",
+  "systemFrees",
+  "reuseHits",
+];
+
+/** Buffers auxiliares (matrices, índices...) que acompañan a los de puntos. */
+type AuxBufferKind =
+  | "matrices"
+  | "instanceIndices"
+  | "instanceRanges"
+  | "batchStats"
+  | "cullIndices"
+  | "quantization"
+  | "matrixF64"
+  | "poolStats"
+  | "dirtyRanges"
+  | "spatialOrder"
+  | "encodedPoints"
+  | "decodeState"
+  | "matrixBatchA"
+  | "matrixBatchB"
+  | "matrixBatchOut"
+  | "matrixBatchScalars";
+
+/**
+ * Resultado de `transformPointsBatchStatsManaged`, calculado en la misma pasada
+ * que la transformación. Bounds y centroide solo cuentan los puntos válidos;
+ * si no hay ninguno son NaN.
+ */
+export interface PointBatchStats {
+  minX: number;
+  minY: number;
+  maxX: number;
+  maxY: number;
+  centroidX: number;
+  centroidY: number;
+  /** Puntos con salida finita o infinita (no NaN). */
+  validCount: number;
+  /** Puntos con salida NaN (W cercano a cero o entrada NaN). */
+  invalidCount: number;
+}
+
+/** Rectángulo de recorte inclusivo para `transformPointsCullManaged`. */
+export interface ClipRect {
+  minX: number;
+  minY: number;
+  maxX: number;
+  maxY: number;
+}
+
+/**
+ * Tipo de elemento de los buffers de puntos xyxy para `transformPointsTypedManaged`.
+ * - `f32`: `Float32Array`.
+ * - `f16`: `Uint16Array` con los bits de half IEEE (HALF_FLOAT en WebGL/WebGPU).
+ * - `snorm16`: `Int16Array` normalizado: valor = q / 32767 * scale + bias.
+ */
+export type PointElementType = "f32" | "f16" | "snorm16";
+
+/**
+ * Tipos de elemento de los buffers tipados: los de `PointElementType` más `f64`
+ * (`Float64Array`), usado por `transformPointsF64Managed` y el modo mixto f64 -> f32.
+ */
+export type BufferElementType = PointElementType | "f64";
+
+/** Vista JS que corresponde a cada `BufferElementType`. */
+export interface PointElementArrayMap {
+  f32: Float32Array;
+  f16: Uint16Array;
+  snorm16: Int16Array;
+  f64: Float64Array;
+}
+
+const BUFFER_ELEMENT_BYTES: Record<BufferElementType, number> = {
+  f32: 4,
+  f16: 2,
+  snorm16: 2,
+  f64: 8,
+};
+
+/** Vista del tipo de elemento pedido sobre el heap WASM. */
+function createElementView<T extends BufferElementType>(
+  heap: ArrayBufferLike,
+  pointer: number,
+  elementType: T,
+  length: number
+): PointElementArrayMap[T] {
+  return (
+    elementType === "f32"
+      ? new Float32Array(heap, pointer, length)
+      : elementType === "f16"
+        ? new Uint16Array(heap, pointer, length)
+        : elementType === "f64"
+          ? new Float64Array(heap, pointer, length)
+          : new Int16Array(heap, pointer, length)
+  ) as PointElementArrayMap[T];
+}
+
+/** Buffer gestionado cuya vista usa el tipo de elemento pedido. */
+export interface TypedManagedWasmBuffer<T extends BufferElementType> {
+  readonly view: PointElementArrayMap[T];
+  readonly elementType: T;
+  /** Capacidad en puntos xyxy de este tipo de elemento. */
+  readonly capacityPoints: number;
+  readonly sizeBytes: number;
+}
+
+/** Escala/bias por eje de los puntos `snorm16` (ignorados en otros tipos). */
+export interface PointQuantization {
+  scaleX: number;
+  scaleY: number;
+  biasX: number;
+  biasY: number;
+}
+
+/** Opciones de `transformPointsTypedManaged`. */
+export interface TypedTransformOptions {
+  /** Tipo de elemento del buffer de entrada. Por defecto `f32`. */
+  inType?: PointElementType;
+  /** Tipo de elemento del buffer de salida. Por defecto `f32`. */
+  outType?: PointElementType;
+  /** Cuantización de la entrada `snorm16` (por defecto escala 1, bias 0). */
+  inQuantization?: PointQuantization;
+  /** Cuantización de la salida `snorm16` (por defecto escala 1, bias 0). */
+  outQuantization?: PointQuantization;
+}
+
+const POINT_ELEMENT_INFO: Record<
+  PointElementType,
+  { format: WasmPointFormat; bytes: number }
+> = {
+  f32: { format: WasmPointFormat.F32, bytes: 4 },
+  f16: { format: WasmPointFormat.F16, bytes: 2 },
+  snorm16: { format: WasmPointFormat.SNorm16, bytes: 2 },
+};
+
+const IDENTITY_QUANTIZATION: PointQuantization = {
+  scaleX: 1,
+  scaleY: 1,
+  biasX: 0,
+  biasY: 0,
+};
+
+// PointBatchStats en C++: 6 floats + 2 int32
+const BATCH_STATS_SIZE_BYTES = 8 * 4;
+
+/**
+ * Disposición de los puntos dentro de un buffer gestionado. Offsets y pasos en floats.
+ * - `interleaved`: vértices intercalados (x,y,u,v,rgba...). La x del punto i está en
+ *   `offset + i * stride` y la y justo después. `{ kind: "interleaved", stride: 2 }`
+ *   es el formato empaquetado xyxy clásico.
+ * - `soa`: todas las x seguidas de todas las y. Las y empiezan en `yOffset`
+ *   (por defecto `numPoints`, es decir, justo después de las x).
+ */
+export type PointLayout =
+  | { kind: "interleaved"; stride: number; offset?: number }
+  | { kind: "soa"; yOffset?: number };
+
+/** Layout xyxy empaquetado (el usado por `transformPointsBatchManaged`). */
+export const PACKED_POINT_LAYOUT: PointLayout = {
+  kind: "interleaved",
+  stride: 2,
+};
+
+/** Opciones de `transformPointsLayoutManaged`. */
+export interface LayoutTransformOptions {
+  /** Layout del buffer de entrada. Por defecto `PACKED_POINT_LAYOUT`. */
+  inLayout?: PointLayout;
+  /** Layout de salida. Por defecto igual a `inLayout`; debe ser del mismo `kind`. */
+  outLayout?: PointLayout;
+  /**
+   * Si es `true`, el resultado se escribe sobre el propio buffer de entrada
+   * (p. ej. transformar xy en su sitio, o de xy a uv dentro del mismo vértice).
+   */
+  inPlace?: boolean;
+}
+
+/** Opciones de `createTransformPlan`. */
+export interface TransformPlanOptions extends LayoutTransformOptions {
+  /** Handle (`allocBuffer`) de entrada. Por defecto la entrada gestionada. */
+  input?: number;
+  /** Handle de salida. Por defecto la salida gestionada. */
+  output?: number;
+}
+
+/**
+ * Fuente de `transformPointsStream`: un array xyxy (de cualquier tamaño) o un
+ * iterador, síncrono o asíncrono, de chunks xyxy (cada uno con longitud par).
+ */
+export type PointStreamSource =
+  | Float32Array
+  | Iterable<Float32Array>
+  | AsyncIterable<Float32Array>;
+
+/** Opciones de `transformPointsStream`. */
+export interface PointStreamOptions {
+  /**
+   * Puntos por slot de la ventana WASM (hay dos). La memoria WASM usada es
+   * `2 * windowPoints * 8` bytes, sea cual sea el tamaño de la entrada.
+   * Por defecto `DEFAULT_STREAM_WINDOW_POINTS`.
+   */
+  windowPoints?: number;
+}
+
+/** 64K puntos (512 KiB por slot): a partir de aquí el lote se reparte entre workers. */
+export const DEFAULT_STREAM_WINDOW_POINTS = 65536;
+
+/**
+ * Huecos de hasta este número de puntos limpios entre dos tramos sucios se
+ * transforman igualmente: una llamada al kernel cuesta más que 8 puntos.
+ */
+const DIRTY_MERGE_GAP_POINTS = 8;
+
+/** Salida de la última pasada sobre los buffers gestionados (ver `transformPointsIncrementalManaged`). */
+interface IncrementalTransformState {
+  readonly matrix: Float32Array;
+  readonly numPoints: number;
+  readonly inputPointer: number;
+  readonly outputPointer: number;
+  readonly precision: number;
+}
+
+/** Modo de precisión activo (`Exact` en builds sin la precisión `fast`). */
+function precisionMode(module: MatrixOpsWasmModule): number {
+  return typeof module.getTransformPrecision === "function"
+    ? module.getTransformPrecision()
+    : WasmTransformPrecision.Exact;
+}
+
+type ChunkIterator<T> = AsyncIterator<T> | Iterator<T>;
+
+function toChunkIterator<T extends Float32Array | Uint8Array>(
+  source: T | Iterable<T> | AsyncIterable<T>
+): ChunkIterator<T> {
+  // Un typed array también es iterable (de números): es un único chunk
+  if (ArrayBuffer.isView(source)) return [source as T][Symbol.iterator]();
+  if (Symbol.asyncIterator in source) return source[Symbol.asyncIterator]();
+  return source[Symbol.iterator]();
+}
+
+/** Número de floats que ocupan `numPoints` puntos con el layout dado. */
+function layoutFloatCount(layout: PointLayout, numPoints: number): number {
+  if (numPoints <= 0) return 0;
+  if (layout.kind === "soa") return (layout.yOffset ?? numPoints) + numPoints;
+  return (layout.offset ?? 0) + numPoints * layout.stride;
+}
+
+/** Puntos que caben en `capacityFloats` floats con el layout dado. */
+function layoutCapacityPoints(
+  layout: PointLayout,
+  capacityFloats: number
+): number {
+  if (layout.kind === "soa")
+    return layout.yOffset !== undefined
+      ? Math.max(0, Math.min(layout.yOffset, capacityFloats - layout.yOffset))
+      : Math.floor(capacityFloats / 2);
+  return Math.max(
+    0,
+    Math.floor((capacityFloats - (layout.offset ?? 0)) / layout.stride)
+  );
+}
+
+function validateLayout(layout: PointLayout): void {
+  if (layout.kind === "soa") {
+    if (
+      layout.yOffset !== undefined &&
+      !(Number.isInteger(layout.yOffset) && layout.yOffset >= 0)
+    )
+      throw new Error(`Invalid SoA yOffset: ${layout.yOffset}.`);
+    return;
+  }
+  const offset = layout.offset ?? 0;
+  if (!Number.isInteger(layout.stride) || layout.stride < 2)
+    throw new Error(`Invalid interleaved stride: ${layout.stride} (min 2).`);
+  if (!Number.isInteger(offset) || offset < 0)
+    throw new Error(`Invalid interleaved offset: ${offset}.`);
+}
+
+/**
+ * Layout de los arrays de las operaciones de matrices por lotes:
+ * - `aos`: 9 floats column-major contiguos por matriz (como `Matrix3x3`).
+ * - `soa`: 9 planos de `count` floats; el plano k tiene el coeficiente k de
+ *   todas las matrices (`view[k * count + i]`).
+ */
+export type MatrixBatchLayout = "aos" | "soa";
+
+const MATRIX_BATCH_LAYOUT_CODES: Record<MatrixBatchLayout, number> = {
+  aos: 0,
+  soa: 1,
+};
+
+/** Código del layout para WASM; valida también el número de matrices. */
+function matrixBatchLayoutCode(
+  count: number,
+  layout: MatrixBatchLayout = "aos"
+): number {
+  const code = MATRIX_BATCH_LAYOUT_CODES[layout];
+  if (code === undefined) {
+    throw new Error(`Unsupported matrix batch layout: ${layout}.`);
+  }
+  if (!Number.isInteger(count) || count < 0) {
+    throw new Error(`Invalid matrix count: ${count}.`);
+  }
+  return code;
+}
+
+/** Opciones de `getMatrixBatchBuffers` y `multiplyMatricesBatchManaged`. */
+export interface MatrixBatchOptions {
+  /** Por defecto `aos`. */
+  layout?: MatrixBatchLayout;
+  /** Una sola A (9 floats column-major) para todas las B: out[i] = A * B[i]. */
+  sharedA?: boolean;
+}
+
+/** Vistas vivas sobre memoria WASM de los buffers de matrices por lotes. */
+export interface MatrixBatchBuffers {
+  a: ManagedWasmView<Float32Array>;
+  b: ManagedWasmView<Float32Array>;
+  out: ManagedWasmView<Float32Array>;
+}
+
+/** Opciones de `invertMatricesBatchManaged` y `determinantsBatchManaged`. */
+export interface MatrixBatchUnaryOptions {
+  /** Por defecto `aos`. */
+  layout?: MatrixBatchLayout;
+  /**
+   * Buffer de entrada: `a` (por defecto) u `out`, p. ej. para invertir el
+   * resultado de `multiplyMatricesBatchManaged` sin copiarlo.
+   */
+  source?: "a" | "out";
+}
+
+/** Resultado de `invertMatricesBatchManaged`. */
+export interface MatrixBatchInverseResult {
+  /** Vista del buffer `out`; las matrices singulares quedan a NaN. */
+  out: ManagedWasmView<Float32Array>;
+  /** Copia: 1 por matriz invertida, 0 si |det| < epsilon de la inversa. */
+  mask: Uint8Array;
+  /** Número de matrices invertidas. */
+  inverted: number;
+}
+
+/**
+ * Destino de las operaciones que producen un array de matrices
+ * (`evaluateKeyframeAnimationManaged`, `evaluateTransformProgramManaged`).
+ */
+export interface MatrixTargetOptions {
+  /**
+   * Buffer de destino: `instances` (por defecto, el de
+   * `getMatrixArrayBuffer`, listo para `transformPointsInstancedManaged`) o
+   * los buffers `a`/`b` de `getMatrixBatchBuffers`.
+   */
+  target?: "instances" | "batchA" | "batchB";
+  /** Por defecto `aos`; `instances` solo admite `aos`. */
+  layout?: MatrixBatchLayout;
+}
+
+/** Opciones de `evaluateKeyframeAnimationManaged`. */
+export type KeyframeEvaluateOptions = MatrixTargetOptions;
+
+const MATRIX_TARGET_BUFFERS: Record<
+  NonNullable<MatrixTargetOptions["target"]>,
+  AuxBufferKind
+> = {
+  instances: "matrices",
+  batchA: "matrixBatchA",
+  batchB: "matrixBatchB",
+};
+
+/** Curva de `reorderPointsSpatiallyManaged`: Hilbert tiene mejor localidad, Morton es más barata. */
+export type SpatialCurve = "morton" | "hilbert";
+
+const SPATIAL_CURVE_CODES: Record<SpatialCurve, number> = {
+  morton: 0,
+  hilbert: 1,
+};
+
+/** Arrays que pueden acompañar a los puntos (colores, ids, tamaños...). */
+export type PointAttributeArray =
+  | Int8Array
+  | Uint8Array
+  | Uint8ClampedArray
+  | Int16Array
+  | Uint16Array
+  | Int32Array
+  | Uint32Array
+  | Float32Array
+  | Float64Array;
+
+/**
+ * Atributo por punto a reordenar junto con los puntos: un array JS (cuyo
+ * `length` es múltiplo del número de puntos) o un buffer del pool por handle.
+ */
+export type PointAttribute =
+  | PointAttributeArray
+  | { handle: number; bytesPerPoint: number };
+
+/** Opciones de `reorderPointsSpatiallyManaged`. */
+export interface SpatialReorderOptions {
+  /** Por defecto `hilbert`. */
+  curve?: SpatialCurve;
+  /** Atributos por punto que se permutan igual que los puntos. */
+  attributes?: PointAttribute[];
+}
+
+/** data[i] = copia[order[i]] con `length / numPoints` componentes por punto. */
+function permuteAttributeArray(
+  order: Uint32Array,
+  numPoints: number,
+  data: PointAttributeArray
+): void {
+  const components = data.length / numPoints;
+  const source = data.slice(0, numPoints * components);
+  if (components === 1) {
+    for (let i = 0; i < numPoints; i++) data[i] = source[order[i]];
+    return;
+  }
+  for (let i = 0; i < numPoints; i++) {
+    const from = order[i] * components;
+    const to = i * components;
+    for (let c = 0; c < components; c++) data[to + c] = source[from + c];
+  }
+}
+
+/**
+ * Fuente de `decodePointsManaged`: el stream codificado completo o sus bytes
+ * en chunks de cualquier tamaño (p. ej. los de un `fetch`).
+ */
+export type EncodedPointSource =
+  | Uint8Array
+  | Iterable<Uint8Array>
+  | AsyncIterable<Uint8Array>;
+
+/** Opciones de `encodePointsManaged`. */
+export interface PointEncodeOptions {
+  /**
+   * Tamaño de celda de la cuantización: error máximo `step / 2` por eje (más
+   * el redondeo f32). Por defecto 2^16 celdas dentro del AABB del lote.
+   */
+  step?: number;
+  /** Buffer gestionado a codificar. Por defecto `output`. */
+  source?: "input" | "output";
+}
+
+// Formato de point_codec.h: cabecera de 24 bytes y hasta 2 varints de 5 bytes por punto
+const POINT_CODEC_MAGIC = 0x31515450;
+const POINT_CODEC_HEADER_BYTES = 24;
+const POINT_CODEC_MAX_BYTES_PER_POINT = 10;
+/** Puntos máximos de un stream: sus floats (2 por punto) deben caber en int32. */
+const POINT_CODEC_MAX_POINTS = Math.floor(0x7fffffff / 2);
+const DECODE_STATE_BYTES = 4 * Int32Array.BYTES_PER_ELEMENT;
+
+const POINT_CODEC_ERRORS: Record<number, string> = {
+  [-1]: "non-finite points or corrupt data",
+  [-2]: "step out of range (at most 2^24 cells per axis)",
+  [-3]: "buffer too small",
+};
+
+/** Lee la cabecera del codec. @returns Puntos y bytes totales del stream. */
+function parsePointCodecHeader(header: Uint8Array): {
+  numPoints: number;
+  totalBytes: number;
+} {
+  const data = new DataView(header.buffer, header.byteOffset, header.length);
+  const numPoints = data.getUint32(4, true);
+  const payloadBytes = data.getUint32(20, true);
+  // La cabecera no es de fiar: validar antes de alocar nada con sus tamaños
+  if (numPoints > POINT_CODEC_MAX_POINTS) {
+    throw new Error(
+      `Point stream header declares ${numPoints} points (limit ${POINT_CODEC_MAX_POINTS}).`
+    );
+  }
+  if (
+    data.getUint32(0, true) !== POINT_CODEC_MAGIC ||
+    payloadBytes > numPoints * POINT_CODEC_MAX_BYTES_PER_POINT ||
+    POINT_CODEC_HEADER_BYTES + payloadBytes > 0x7fffffff
+  ) {
+    throw new Error("Invalid point stream header.");
+  }
+  return { numPoints, totalBytes: POINT_CODEC_HEADER_BYTES + payloadBytes };
+}
+
+/** Opciones de `WasmBufferManager.initialize`. */
+export interface WasmBufferManagerOptions {
+  /**
+   * Workers para `transformPointsBatchManaged` (build con pthreads).
+   * Si es > 0 se carga la variante `threads` del módulo; los lotes pequeños siguen
+   * ejecutándose en serie. Por defecto 0 (variante `simd`, un solo hilo).
+   */
+  threads?: number;
+  /**
+   * Carga la variante `relaxed` (FMA en el modo `fast`). Se ignora si `threads` > 0.
+   */
+  relaxedSimd?: boolean;
+  /** Modo de precisión inicial de los kernels f32 (por defecto `exact`). */
+  precision?: TransformPrecision;
+}
+
+/**
+ * Precisión de los kernels f32: `exact` (mul + add, división completa) o `fast`
+ * (FMA en la build relaxed, 1/W aproximada). Ver `TRANSFORM_PRECISION_MAX_ERROR`.
+ */
+export type TransformPrecision = "exact" | "fast";
+
+const TRANSFORM_PRECISION_MODES: Record<TransformPrecision, number> = {
+  exact: WasmTransformPrecision.Exact,
+  fast: WasmTransformPrecision.Fast,
+};
+
 // --- Clase del Gestor de Buffers ---
 
 /**
@@ -58,6 +632,8 @@ interface InternalWasmBufferInfo extends ManagedWasmBuffer {
 export class WasmBufferManager {
   private module: MatrixOpsWasmModule | null = null;
   private initialized: boolean = false;
+  // Variante pedida explícitamente (null = módulo por defecto del loader)
+  private variant: WasmModuleVariant | null = null;
   private staticMemoryEnsured: boolean = false; // Flag para memoria estática propia
 
   // Memoria estática necesaria para las operaciones gestionadas (ej. matriz)
@@ -67,14 +643,42 @@ export class WasmBufferManager {
   // Referencias internas a los buffers dinámicos reutilizables
   private inputBufferInternal: InternalWasmBufferInfo | null = null;
   private outputBufferInternal: InternalWasmBufferInfo | null = null;
+  // Bloques del pool WASM detrás de los buffers de entrada/salida
+  private pointBufferRecords: Record<
+    "input" | "output",
+    PooledBufferRecord | null
+  > = { input: null, output: null };
+  // Buffers con handle creados con allocBuffer/allocFrameBuffer
+  private pooledBuffers = new Map<number, PooledBufferRecord>();
+  // Último handle local (builds sin pool WASM, ver `hasPool`)
+  private fallbackHandle = 0;
+  // Buffers auxiliares reutilizables (transformaciones por instancia, etc.)
+  private auxBuffers = new Map<AuxBufferKind, PooledBufferRecord>();
+  // Command buffers creados por este gestor (se liberan en cleanup)
+  private commandBuffers = new Set<WasmCommandBuffer>();
+  // Planes de transformación creados por este gestor (se liberan en cleanup)
+  private transformPlans = new Set<WasmTransformPlan>();
+  // Jerarquías de transformaciones creadas por este gestor (ídem)
+  private transformHierarchies = new Set<WasmTransformHierarchy>();
+  // Animaciones por keyframes creadas por este gestor (ídem)
+  private keyframeAnimations = new Set<WasmKeyframeAnimation>();
+  // Programas de transformación creados por este gestor (ídem)
+  private transformPrograms = new Set<WasmTransformProgram>();
+  // Slots de la ventana de los streams activos (se liberan al terminar cada uno)
+  private streamSlots = new Set<PooledBufferRecord>();
+  // Tramos de entrada modificados desde la última pasada: [inicio, cuenta] planos
+  private dirtyRanges: number[] = [];
+  // Estado de la última pasada completa o incremental (null = salida desconocida)
+  private incrementalState: IncrementalTransformState | null = null;
 
   /**
    * Inicializa el gestor. Carga el módulo WebAssembly si aún no está cargado
    * y aloca la memoria estática requerida por las operaciones del gestor.
    * Debe llamarse y esperarse (`await`) antes de usar otros métodos.
+   * @param options Ver `WasmBufferManagerOptions` (p. ej. `{ threads: 4 }`).
    * @throws Error si la carga del módulo WASM o la alocación de memoria fallan.
    */
-  async initialize(): Promise<void> {
+  async initialize(options: WasmBufferManagerOptions = {}): Promise<void> {
     if (this.initialized) {
       console.warn("[BufferMgr] Already initialized.");
       return;
@@ -82,7 +686,19 @@ export class WasmBufferManager {
     console.log("[BufferMgr] Initializing...");
     try {
       // Carga o obtiene la instancia singleton del módulo WASM
-      this.module = await loadWasmModule();
+      let threads = Math.max(0, Math.floor(options.threads ?? 0));
+      if (threads > 0 && !detectWasmFeatures().threads) {
+        console.warn(
+          "[BufferMgr] Threads not supported here (SharedArrayBuffer/atomics): using the default build."
+        );
+        threads = 0;
+      }
+      if (threads > 0 && options.relaxedSimd)
+        console.warn("[BufferMgr] relaxedSimd ignored: using threads build.");
+      // Sin opciones: módulo por defecto (la variante más rápida soportada)
+      this.variant =
+        threads > 0 ? "threads" : options.relaxedSimd ? "relaxed" : null;
+      this.module = await loadWasmModule(this.variant ?? undefined);
 
       // Verificar funciones y propiedades esenciales del módulo
       if (
@@ -108,6 +724,9 @@ export class WasmBufferManager {
         );
       }
       this.staticMemoryEnsured = true; // Marcar como alocada
+
+      if (threads > 0) this.module.setTransformThreads(threads);
+      if (options.precision) this.setTransformPrecision(options.precision);
       this.initialized = true;
       console.log("[BufferMgr] Initialized successfully.");
     } catch (error) {
@@ -125,6 +744,42 @@ export class WasmBufferManager {
     return this.initialized && !!this.module;
   }
 
+  /**
+   * Workers activos en el pool de `transformPointsBatchManaged`
+   * (0 si se usa la build sin hilos o no se inicializó con `threads`).
+   */
+  getThreadCount(): number {
+    return this.module ? this.module.getTransformThreads() : 0;
+  }
+
+  /** Variante WASM en uso (`null` si no está inicializado). */
+  getVariant(): WasmModuleVariant | null {
+    if (!this.module) return null;
+    return this.variant ?? getWasmDiagnostics()?.variant ?? null;
+  }
+
+  /**
+   * Cambia el modo de precisión de las transformaciones f32 posteriores.
+   * El modo es global al módulo WASM: afecta a todos los gestores que lo comparten.
+   */
+  setTransformPrecision(precision: TransformPrecision): void {
+    if (!this.module) {
+      throw new Error("WasmBufferManager not initialized.");
+    }
+    const mode = TRANSFORM_PRECISION_MODES[precision];
+    if (mode === undefined) {
+      throw new Error(`Invalid transform precision: ${precision}.`);
+    }
+    this.module.setTransformPrecision(mode);
+  }
+
+  getTransformPrecision(): TransformPrecision {
+    if (!this.module) return "exact";
+    return this.module.getTransformPrecision() === WasmTransformPrecision.Fast
+      ? "fast"
+      : "exact";
+  }
+
   /**
    * Método interno para asegurar que el gestor esté inicializado antes de operar.
    * @throws Error si no está inicializado.
@@ -152,22 +807,34 @@ export class WasmBufferManager {
    * Obtiene un buffer gestionado para escribir datos de ENTRADA.
    * Reutiliza el buffer interno si tiene capacidad suficiente, de lo contrario
    * libera el antiguo (si existe) y aloca uno nuevo más grande.
-   * La `view` del objeto devuelto tendrá exactamente `minCapacityPoints * 2` elementos.
+   * La `view` del objeto devuelto tendrá exactamente `minCapacityPoints * 2` elementos
+   * (o los floats que ocupen esos puntos con el `layout` indicado).
    *
    * @param minCapacityPoints La capacidad mínima requerida (en número de puntos).
+   * @param layout Disposición de los puntos en el buffer (por defecto xyxy empaquetado).
    * @returns Una promesa que resuelve con la información del buffer de entrada.
    * @throws Error si la alocación de memoria falla o el gestor no está inicializado.
    */
-  async getInputBuffer(minCapacityPoints: number): Promise<ManagedWasmBuffer> {
+  async getInputBuffer(
+    minCapacityPoints: number,
+    layout: PointLayout = PACKED_POINT_LAYOUT
+  ): Promise<ManagedWasmBuffer> {
+    validateLayout(layout);
     // Llama a getManagedBuffer que devuelve InternalWasmBufferInfo
     const internalBuffer = await this.getManagedBuffer(
-      minCapacityPoints,
+      layoutFloatCount(layout, minCapacityPoints),
       "input"
     );
-    // Devuelve un objeto que cumple la interfaz PÚBLICA (sin internalPointer)
+    // Devuelve un objeto que cumple la interfaz PÚBLICA (sin internalPointer);
+    // `view` se relee para seguir válida si la memoria WASM crece
     return {
-      view: internalBuffer.view,
-      capacityPoints: internalBuffer.capacityPoints,
+      get view() {
+        return internalBuffer.view;
+      },
+      capacityPoints: layoutCapacityPoints(
+        layout,
+        internalBuffer.sizeBytes / Float32Array.BYTES_PER_ELEMENT
+      ),
       sizeBytes: internalBuffer.sizeBytes,
     };
   }
@@ -176,119 +843,268 @@ export class WasmBufferManager {
    * Obtiene un buffer gestionado para leer datos de SALIDA.
    * Reutiliza el buffer interno si tiene capacidad suficiente, de lo contrario
    * libera el antiguo (si existe) y aloca uno nuevo más grande.
-   * La `view` del objeto devuelto tendrá exactamente `capacityPoints * 2` elementos.
+   * La `view` del objeto devuelto tendrá exactamente `capacityPoints * 2` elementos
+   * (o los floats que ocupen esos puntos con el `layout` indicado).
    *
    * @param capacityPoints La capacidad exacta requerida (en número de puntos).
+   * @param layout Disposición de los puntos en el buffer (por defecto xyxy empaquetado).
    * @returns Una promesa que resuelve con la información del buffer de salida.
    * @throws Error si la alocación de memoria falla o el gestor no está inicializado.
    */
-  async getOutputBuffer(capacityPoints: number): Promise<ManagedWasmBuffer> {
+  async getOutputBuffer(
+    capacityPoints: number,
+    layout: PointLayout = PACKED_POINT_LAYOUT
+  ): Promise<ManagedWasmBuffer> {
+    validateLayout(layout);
     const internalBuffer = await this.getManagedBuffer(
-      capacityPoints,
+      layoutFloatCount(layout, capacityPoints),
       "output"
     );
     // Devuelve un objeto que cumple la interfaz PÚBLICA
     return {
-      view: internalBuffer.view,
-      capacityPoints: internalBuffer.capacityPoints,
+      get view() {
+        return internalBuffer.view;
+      },
+      capacityPoints: layoutCapacityPoints(
+        layout,
+        internalBuffer.sizeBytes / Float32Array.BYTES_PER_ELEMENT
+      ),
       sizeBytes: internalBuffer.sizeBytes,
     };
   }
 
+  /**
+   * Como `getInputBuffer`, pero con una vista del tipo de elemento indicado
+   * (`Uint16Array` para `f16`, `Int16Array` para `snorm16`). Usa el mismo buffer
+   * interno de entrada, así que sustituye a la vista devuelta por `getInputBuffer`.
+   *
+   * @param minCapacityPoints La capacidad mínima requerida (en número de puntos).
+   * @param elementType Tipo de elemento de los puntos xyxy.
+   * @returns Una promesa que resuelve con el buffer tipado de entrada.
+   * @throws Error si la alocación de memoria falla o el gestor no está inicializado.
+   */
+  async getTypedInputBuffer<T extends BufferElementType>(
+    minCapacityPoints: number,
+    elementType: T
+  ): Promise<TypedManagedWasmBuffer<T>> {
+    return this.getTypedBuffer(minCapacityPoints, elementType, "input");
+  }
+
+  /**
+   * Como `getOutputBuffer`, pero con una vista del tipo de elemento indicado.
+   * Usa el mismo buffer interno de salida.
+   *
+   * @param capacityPoints La capacidad requerida (en número de puntos).
+   * @param elementType Tipo de elemento de los puntos xyxy.
+   * @returns Una promesa que resuelve con el buffer tipado de salida.
+   * @throws Error si la alocación de memoria falla o el gestor no está inicializado.
+   */
+  async getTypedOutputBuffer<T extends BufferElementType>(
+    capacityPoints: number,
+    elementType: T
+  ): Promise<TypedManagedWasmBuffer<T>> {
+    return this.getTypedBuffer(capacityPoints, elementType, "output");
+  }
+
+  private async getTypedBuffer<T extends BufferElementType>(
+    numPoints: number,
+    elementType: T,
+    type: "input" | "output"
+  ): Promise<TypedManagedWasmBuffer<T>> {
+    const bytes = BUFFER_ELEMENT_BYTES[elementType];
+    if (!bytes) throw new Error(`Unknown point element type: ${elementType}`);
+    const requiredBytes = numPoints * 2 * bytes;
+    const internal = await this.getManagedBuffer(
+      Math.ceil(requiredBytes / Float32Array.BYTES_PER_ELEMENT),
+      type
+    );
+    const view = this.liveView(
+      this.pointBufferRecords[type]!,
+      elementType,
+      numPoints * 2
+    );
+    return {
+      get view() {
+        return view();
+      },
+      elementType,
+      capacityPoints: Math.floor(internal.sizeBytes / (2 * bytes)),
+      sizeBytes: internal.sizeBytes,
+    };
+  }
+
   /**
    * Lógica interna centralizada para obtener/gestionar buffers dinámicos reutilizables.
-   * @param requiredPoints Número de puntos requeridos para esta operación.
+   * Cada buffer es un handle del pool WASM: al crecer pasa a la siguiente clase
+   * de tamaño (potencia de 2), así que un tamaño que oscila no vuelve a
+   * alocar, y el bloque antiguo queda en el pool para otros buffers.
+   * @param requiredFloats Número de floats requeridos para esta operación.
    * @param type Indica si es el buffer de 'input' o 'output'.
    * @returns Información del buffer adecuado con una vista del tamaño correcto.
+   *          Su `capacityPoints` se expresa en puntos xyxy empaquetados.
    */
   private async getManagedBuffer(
-    requiredPoints: number,
+    requiredFloats: number,
     type: "input" | "output"
   ): Promise<InternalWasmBufferInfo> {
-    const module = this.ensureInitialized(); // Asegura inicialización y obtiene módulo
-    const requiredSizeBytes =
-      requiredPoints * 2 * Float32Array.BYTES_PER_ELEMENT;
-    let currentBufferInternal =
-      type === "input" ? this.inputBufferInternal : this.outputBufferInternal;
-    let finalBufferInfo: InternalWasmBufferInfo; // Para almacenar el buffer a devolver
-
-    // Determinar si necesitamos alocar/realocar
-    const needsAllocation =
-      !currentBufferInternal ||
-      currentBufferInternal.sizeBytes < requiredSizeBytes;
-
-    if (needsAllocation) {
-      // Liberar el buffer antiguo si existe antes de crear uno nuevo
-      if (currentBufferInternal) {
-        try {
-          console.log(
-            `[BufferMgr] Freeing old ${type} buffer (size ${currentBufferInternal.sizeBytes}) at ptr ${currentBufferInternal.internalPointer}`
-          );
-          module._free(currentBufferInternal.internalPointer);
-        } catch (e) {
-          console.error(`[BufferMgr] Error freeing old ${type} buffer:`, e);
-        }
+    this.ensureInitialized(); // Asegura inicialización
+    const requiredSizeBytes = requiredFloats * Float32Array.BYTES_PER_ELEMENT;
+    let record = this.pointBufferRecords[type];
+    if (!record) {
+      record = this.allocPooled(requiredSizeBytes, false, `${type} buffer`);
+      this.pointBufferRecords[type] = record;
+    } else if (record.sizeBytes < requiredSizeBytes) {
+      // El contenido anterior no se conserva: el llamador reescribe la entrada
+      this.growPooled(record, requiredSizeBytes, false);
+    }
+
+    const view = this.liveView(record, "f32", requiredFloats);
+    const info: InternalWasmBufferInfo = {
+      internalPointer: record.pointer,
+      sizeBytes: record.sizeBytes,
+      capacityPoints: Math.floor(
+        record.sizeBytes / (2 * Float32Array.BYTES_PER_ELEMENT)
+      ),
+      get view() {
+        return view();
+      },
+    };
+    if (type === "input") this.inputBufferInternal = info;
+    else this.outputBufferInternal = info;
+    return info;
+  }
+
+  /**
+   * `false` con builds generadas antes de `buffer_pool.h`: los buffers pasan a
+   * ser bloques de `_malloc` con handles locales, sin reutilización por clase.
+   */
+  private hasPool(module: MatrixOpsWasmModule): boolean {
+    return typeof module._pool_alloc === "function";
+  }
+
+  /** Aloca un handle del pool (o de la arena por frame) y lo resuelve. */
+  private allocPooled(
+    sizeBytes: number,
+    frame: boolean,
+    label: string
+  ): PooledBufferRecord {
+    const module = this.ensureInitialized();
+    const bytes = Math.max(sizeBytes, 16);
+    if (!this.hasPool(module)) {
+      const pointer = module._malloc(bytes);
+      if (!pointer) {
+        throw new Error(`Failed to allocate ${bytes} bytes for ${label}.`);
       }
+      const handle = ++this.fallbackHandle;
+      return { handle, pointer, sizeBytes: bytes, frame };
+    }
+    const handle = frame
+      ? module._arena_alloc(bytes)
+      : module._pool_alloc(bytes);
+    if (!handle) {
+      throw new Error(`Failed to allocate ${bytes} bytes for ${label}.`);
+    }
+    return {
+      handle,
+      pointer: module._pool_ptr(handle),
+      sizeBytes: module._pool_capacity(handle),
+      frame,
+    };
+  }
 
-      // Alocar el nuevo buffer
-      // console.log(`[BufferMgr] Allocating new ${type} buffer: ${requiredSizeBytes} bytes for ${requiredPoints} points`);
-      const newPointer = module._malloc(requiredSizeBytes);
-      if (!newPointer) {
-        // Verificar si malloc falló
+  /** Crece un handle del pool en su sitio (el handle no cambia). */
+  private growPooled(
+    record: PooledBufferRecord,
+    sizeBytes: number,
+    preserve: boolean
+  ): void {
+    const module = this.ensureInitialized();
+    if (!this.hasPool(module)) {
+      const pointer = module._malloc(sizeBytes);
+      if (!pointer) {
         throw new Error(
-          `Failed to _malloc ${requiredSizeBytes} bytes for ${type} buffer.`
+          `Failed to grow pooled buffer ${record.handle} to ${sizeBytes} bytes.`
         );
       }
-
-      // Crear la nueva estructura de información del buffer
-      finalBufferInfo = {
-        internalPointer: newPointer,
-        sizeBytes: requiredSizeBytes,
-        capacityPoints: requiredPoints, // Capacidad actual coincide con lo solicitado
-        view: new Float32Array(
-          module.HEAPF32.buffer,
-          newPointer,
-          requiredPoints * 2
-        ),
-      };
-
-      // Actualizar la referencia interna del manager al NUEVO buffer
-      if (type === "input") this.inputBufferInternal = finalBufferInfo;
-      else this.outputBufferInternal = finalBufferInfo;
-      console.log(
-        `[BufferMgr] Allocated new ${type} buffer: ${finalBufferInfo.sizeBytes} bytes at ptr ${finalBufferInfo.internalPointer}`
-      );
-    } else {
-      // Reutilizar el buffer existente
-      // ¡Asegurarle a TypeScript que no es null aquí!
-      if (!currentBufferInternal) {
-        throw new Error(
-          "Internal error: existing buffer is unexpectedly null during reuse logic."
+      if (preserve) {
+        new Uint8Array(module.HEAPF32.buffer).copyWithin(
+          pointer,
+          record.pointer,
+          record.pointer + record.sizeBytes
         );
       }
-      // console.log(`[BufferMgr] Reusing existing ${type} buffer (capacity ${currentBufferInternal.capacityPoints} points / ${currentBufferInternal.sizeBytes} bytes) for ${requiredPoints} points`);
-
-      // Crear una NUEVA VISTA con la longitud correcta sobre el buffer existente
-      const currentView = new Float32Array(
-        module.HEAPF32.buffer,
-        currentBufferInternal.internalPointer,
-        requiredPoints * 2
+      module._free(record.pointer);
+      record.pointer = pointer;
+      record.sizeBytes = sizeBytes;
+      return;
+    }
+    if (!module._pool_realloc(record.handle, sizeBytes, preserve ? 1 : 0)) {
+      throw new Error(
+        `Failed to grow pooled buffer ${record.handle} to ${sizeBytes} bytes.`
       );
-
-      // Crear un NUEVO objeto ManagedWasmBuffer para devolver.
-      // Esto es importante para que la 'view' devuelta tenga la longitud correcta
-      // y para evitar que diferentes llamadas modifiquen la misma referencia de objeto JS.
-      finalBufferInfo = {
-        internalPointer: currentBufferInternal.internalPointer, // Puntero del buffer existente
-        sizeBytes: currentBufferInternal.sizeBytes, // Tamaño total alocado del buffer
-        capacityPoints: currentBufferInternal.capacityPoints, // Capacidad total del buffer
-        view: currentView, // La vista con la longitud correcta
-      };
-      // NO actualizamos this.inputBufferInternal/this.outputBufferInternal aquí,
-      // ya que la referencia interna debe mantener la información del buffer completo.
     }
+    record.pointer = module._pool_ptr(record.handle);
+    record.sizeBytes = module._pool_capacity(record.handle);
+  }
 
-    return finalBufferInfo; // Devolver la información del buffer (nuevo o reutilizado con vista actualizada)
+  /** Devuelve un bloque que no es de frame al pool (o a `_free`). */
+  private freePooled(
+    module: MatrixOpsWasmModule,
+    record: PooledBufferRecord
+  ): void {
+    if (this.hasPool(module)) module._pool_free(record.handle);
+    else module._free(record.pointer);
+    record.pointer = 0; // Invalida planes y vistas vivas
+  }
+
+  /**
+   * Devuelve una función que da la vista del buffer, recreándola solo si la
+   * memoria WASM creció (cambia `HEAPF32.buffer`) o el bloque se movió.
+   */
+  private liveView<T extends BufferElementType>(
+    record: PooledBufferRecord,
+    elementType: T,
+    length: number
+  ): () => PointElementArrayMap[T] {
+    return this.liveArray(record, (heap, pointer) =>
+      createElementView(heap, pointer, elementType, length)
+    );
+  }
+
+  /** Como `liveView`, con cualquier vista creada por `create`. */
+  private liveArray<V extends ArrayBufferView>(
+    record: PooledBufferRecord,
+    create: (heap: ArrayBufferLike, pointer: number) => V
+  ): () => V {
+    const module = this.module!;
+    let heap: ArrayBufferLike | null = null;
+    let pointer = 0;
+    let view: V | null = null;
+    return () => {
+      const current = module.HEAPF32.buffer;
+      if (!view || current !== heap || record.pointer !== pointer) {
+        view = create(current, record.pointer);
+        heap = current;
+        pointer = record.pointer;
+      }
+      return view;
+    };
+  }
+
+  /** Envuelve la vista viva de un buffer auxiliar (ver `ManagedWasmView`). */
+  private auxView<V extends ArrayBufferView>(
+    record: PooledBufferRecord,
+    create: (heap: ArrayBufferLike, pointer: number) => V
+  ): ManagedWasmView<V> {
+    const read = this.liveArray(record, create);
+    return {
+      get view() {
+        return read();
+      },
+      get sizeBytes() {
+        return record.sizeBytes;
+      },
+    };
   }
 
   /**
@@ -334,25 +1150,1798 @@ export class WasmBufferManager {
       this.outputBufferInternal.internalPointer, // Usar puntero interno
       numPoints
     );
+    // Pasada completa: la salida queda al día para las incrementales
+    this.recordIncrementalState(module, matrix, numPoints);
   }
 
   /**
-   * Obtiene una VISTA del buffer de salida interno con la longitud especificada.
-   * Útil para leer resultados DESPUÉS de llamar a `transformPointsBatchManaged`.
-   *
-   * ¡PRECAUCIÓN! No almacene esta vista a largo plazo si la memoria WASM puede crecer.
+   * Marca como modificados los puntos `[start, start + count)` del buffer de
+   * entrada gestionado, para que `transformPointsIncrementalManaged` los vuelva
+   * a transformar. Coste O(1); los tramos se ordenan y fusionan al transformar.
+   */
+  markInputDirty(start: number, count: number = 1): void {
+    if (
+      !Number.isInteger(start) ||
+      !Number.isInteger(count) ||
+      start < 0 ||
+      count < 0
+    ) {
+      throw new Error(`Invalid dirty range [${start}, +${count}).`);
+    }
+    if (count > 0) this.dirtyRanges.push(start, count);
+  }
+
+  /**
+   * Olvida la salida de la última pasada: la próxima incremental transforma todo.
+   * Necesario si se rellena la entrada sin marcarla. Las operaciones del gestor
+   * que escriben en la salida gestionada (cull, stats, typed, f64, layouts,
+   * instancias, jerarquías, planes y `transformPointsManaged` de los command
+   * buffers...) ya lo llaman.
+   */
+  markInputDirtyAll(): void {
+    this.dirtyRanges.length = 0;
+    this.incrementalState = null;
+  }
+
+  /**
+   * Transformación incremental para nubes casi estáticas: si la matriz, el número
+   * de puntos, los buffers y la precisión coinciden con la pasada anterior, solo
+   * transforma los tramos marcados con `markInputDirty` y el coste del frame es
+   * proporcional a las ediciones. Si algo cambió (o hay demasiados tramos
+   * sucios) hace una pasada completa.
    *
-   * @param numPoints El número de puntos cuyo resultado se quiere leer (longitud de la vista = numPoints * 2)
-   * @returns Una `Float32Array` apuntando a la memoria de salida WASM, o `null` si el buffer no está listo.
-   * @throws Error si `numPoints` excede la capacidad del buffer de salida.
+   * @param matrix La matriz de transformación 3x3.
+   * @param numPoints El número de puntos de los buffers gestionados.
+   * @returns Puntos transformados en esta llamada (0 si no había cambios).
+   * @throws Error si el gestor no está inicializado o los buffers no tienen capacidad.
    */
-  getOutputView(numPoints: number): Float32Array | null {
-    const module = this.module; // Usar instancia guardada
-    const outputBuffer = this.outputBufferInternal; // Usar buffer interno
+  async transformPointsIncrementalManaged(
+    matrix: Matrix3x3,
+    numPoints: number
+  ): Promise<number> {
+    const module = this.ensureInitialized();
+    this.ensurePointBuffers(numPoints);
+    const ranges = this.canTransformIncrementally(module, matrix, numPoints)
+      ? this.mergeDirtyRanges(numPoints)
+      : null;
+    let dirtyPoints = 0;
+    if (ranges) {
+      for (let k = 1; k < ranges.length; k += 2) dirtyPoints += ranges[k];
+    }
+    // Con la mitad de los puntos sucios, una pasada lineal sale más barata
+    if (!ranges || dirtyPoints * 2 >= numPoints) {
+      await this.transformPointsBatchManaged(matrix, numPoints);
+      this.dirtyRanges.length = 0;
+      return numPoints;
+    }
+    this.dirtyRanges.length = 0;
+    if (dirtyPoints === 0) return 0;
 
-    if (!module?.HEAPF32?.buffer || !outputBuffer) {
-      console.warn(
-        "[BufferMgr] Cannot get output view: Not initialized or output buffer missing."
+    const numRanges = ranges.length / 2;
+    const aux = this.ensureAuxBuffer(
+      "dirtyRanges",
+      ranges.length * Int32Array.BYTES_PER_ELEMENT
+    );
+    new Int32Array(module.HEAPF32.buffer, aux.pointer, ranges.length).set(
+      ranges
+    );
+    // Otras operaciones reutilizan el buffer estático de la matriz
+    module.HEAPF32.set(matrix, this.staticMatrixPtr! / 4);
+    const transformed = module.transformPointsRanges(
+      this.staticMatrixPtr!,
+      aux.pointer,
+      numRanges,
+      this.inputBufferInternal!.internalPointer,
+      this.outputBufferInternal!.internalPointer,
+      numPoints
+    );
+    if (transformed < 0) {
+      throw new Error(
+        `Dirty ranges exceed the ${numPoints} points of the managed buffers.`
+      );
+    }
+    return transformed;
+  }
+
+  private recordIncrementalState(
+    module: MatrixOpsWasmModule,
+    matrix: Matrix3x3,
+    numPoints: number
+  ): void {
+    this.incrementalState = {
+      matrix: Float32Array.from(matrix),
+      numPoints,
+      inputPointer: this.inputBufferInternal!.internalPointer,
+      outputPointer: this.outputBufferInternal!.internalPointer,
+      precision: precisionMode(module),
+    };
+  }
+
+  /** Indica si la salida de la pasada anterior sigue valiendo fuera de los tramos sucios. */
+  private canTransformIncrementally(
+    module: MatrixOpsWasmModule,
+    matrix: Matrix3x3,
+    numPoints: number
+  ): boolean {
+    const state = this.incrementalState;
+    if (
+      !state ||
+      !this.staticMatrixPtr ||
+      state.numPoints !== numPoints ||
+      state.inputPointer !== this.inputBufferInternal!.internalPointer ||
+      state.outputPointer !== this.outputBufferInternal!.internalPointer ||
+      state.precision !== precisionMode(module)
+    ) {
+      return false;
+    }
+    // Comparar en f32, que es lo que ve el kernel
+    const current = Float32Array.from(matrix);
+    for (let i = 0; i < 9; i++) {
+      if (!Object.is(current[i], state.matrix[i])) return false;
+    }
+    return true;
+  }
+
+  /**
+   * Ordena, recorta a `[0, numPoints)` y fusiona los tramos sucios (también los
+   * separados por huecos de hasta `DIRTY_MERGE_GAP_POINTS`).
+   * @returns Pares [inicio, cuenta] planos, ordenados y disjuntos.
+   */
+  private mergeDirtyRanges(numPoints: number): number[] {
+    const pending = this.dirtyRanges;
+    const order: number[] = [];
+    for (let k = 0; k < pending.length; k += 2) {
+      if (pending[k] < numPoints) order.push(k);
+    }
+    order.sort((a, b) => pending[a] - pending[b]);
+
+    const merged: number[] = [];
+    let start = -1;
+    let end = -1;
+    for (const k of order) {
+      const rangeStart = pending[k];
+      const rangeEnd = Math.min(rangeStart + pending[k + 1], numPoints);
+      if (start >= 0 && rangeStart <= end + DIRTY_MERGE_GAP_POINTS) {
+        end = Math.max(end, rangeEnd);
+        continue;
+      }
+      if (start >= 0) merged.push(start, end - start);
+      start = rangeStart;
+      end = rangeEnd;
+    }
+    if (start >= 0) merged.push(start, end - start);
+    return merged;
+  }
+
+  /**
+   * Igual que `transformPointsBatchManaged`, pero en la misma pasada SIMD calcula
+   * el AABB y el centroide de la salida y cuenta los puntos degenerados (NaN),
+   * sin recorrer de nuevo el buffer de salida en JS.
+   * El resultado se escribe en un pequeño buffer WASM reutilizable y se devuelve
+   * copiado en un objeto.
+   *
+   * @param matrix La matriz de transformación 3x3.
+   * @param numPoints El número de puntos a transformar.
+   * @returns Bounds, centroide y recuentos de puntos válidos/degenerados.
+   * @throws Error si el gestor no está inicializado o los buffers no tienen capacidad.
+   */
+  async transformPointsBatchStatsManaged(
+    matrix: Matrix3x3,
+    numPoints: number
+  ): Promise<PointBatchStats> {
+    const module = this.ensureInitialized();
+    if (!this.staticMatrixPtr) {
+      throw new Error("Static matrix buffer not allocated.");
+    }
+    this.ensurePointBuffers(numPoints);
+    const stats = this.ensureAuxBuffer("batchStats", BATCH_STATS_SIZE_BYTES);
+    this.markInputDirtyAll();
+
+    module.HEAPF32.set(matrix, this.staticMatrixPtr / 4);
+    module.transformPointsBatchStats(
+      this.staticMatrixPtr,
+      this.inputBufferInternal!.internalPointer,
+      this.outputBufferInternal!.internalPointer,
+      numPoints,
+      stats.pointer
+    );
+
+    const f = new Float32Array(module.HEAPF32.buffer, stats.pointer, 6);
+    const counts = new Int32Array(
+      module.HEAPF32.buffer,
+      stats.pointer + 24,
+      2
+    );
+    return {
+      minX: f[0],
+      minY: f[1],
+      maxX: f[2],
+      maxY: f[3],
+      centroidX: f[4],
+      centroidY: f[5],
+      validCount: counts[0],
+      invalidCount: counts[1],
+    };
+  }
+
+  /**
+   * Transforma los puntos del buffer de entrada y escribe en el de salida, compactados
+   * al principio, solo los que caen dentro de `rect` (los degenerados se descartan).
+   * Opcionalmente guarda el índice original de cada superviviente (ver
+   * `getCulledIndexView`). El coste de dibujo/subida posterior escala con los puntos
+   * visibles: basta con leer `getOutputView(count)`.
+   * Más allá de `count` la salida contiene restos y no debe leerse.
+   *
+   * @param matrix La matriz de transformación 3x3.
+   * @param numPoints El número de puntos de entrada.
+   * @param rect Rectángulo de recorte (inclusivo) en coordenadas de salida.
+   * @param withIndices Si se escriben los índices originales (por defecto `true`).
+   * @returns Número de puntos supervivientes.
+   * @throws Error si el gestor no está inicializado o los buffers no tienen capacidad.
+   */
+  async transformPointsCullManaged(
+    matrix: Matrix3x3,
+    numPoints: number,
+    rect: ClipRect,
+    withIndices: boolean = true
+  ): Promise<number> {
+    const module = this.ensureInitialized();
+    if (!this.staticMatrixPtr) {
+      throw new Error("Static matrix buffer not allocated.");
+    }
+    this.ensurePointBuffers(numPoints);
+    const indices = withIndices
+      ? this.ensureAuxBuffer(
+          "cullIndices",
+          numPoints * Uint32Array.BYTES_PER_ELEMENT
+        )
+      : null;
+    // La salida queda compactada: ya no corresponde punto a punto
+    this.markInputDirtyAll();
+
+    module.HEAPF32.set(matrix, this.staticMatrixPtr / 4);
+    return module.transformPointsCull(
+      this.staticMatrixPtr,
+      this.inputBufferInternal!.internalPointer,
+      this.outputBufferInternal!.internalPointer,
+      indices ? indices.pointer : 0,
+      numPoints,
+      rect.minX,
+      rect.minY,
+      rect.maxX,
+      rect.maxY
+    );
+  }
+
+  /**
+   * Vista de los índices originales escritos por `transformPointsCullManaged`:
+   * el superviviente k de la salida es el punto `view[k]` de la entrada.
+   *
+   * @param count Número de supervivientes devuelto por la llamada de culling.
+   * @returns Vista viva de `count` índices `uint32`, o `null` si no los hay.
+   */
+  getCulledIndexView(count: number): ManagedWasmView<Uint32Array> | null {
+    const info = this.auxBuffers.get("cullIndices");
+    if (
+      !this.module ||
+      !info ||
+      count * Uint32Array.BYTES_PER_ELEMENT > info.sizeBytes
+    )
+      return null;
+    return this.auxView(info, (heap, pointer) => {
+      return new Uint32Array(heap, pointer, count);
+    });
+  }
+
+  /**
+   * Variante de `transformPointsBatchManaged` con puntos en formatos reducidos:
+   * lee y/o escribe half floats (`f16`) o int16 normalizados (`snorm16`) con
+   * escala/bias, los formatos que se suben a la GPU. La conversión se hace en
+   * registros dentro del kernel SIMD; con la mitad de bytes por punto, los lotes
+   * limitados por ancho de banda van casi el doble de rápido.
+   * Prepara los buffers con `getTypedInputBuffer`/`getTypedOutputBuffer`.
+   *
+   * Las salidas NaN (W cercano a cero) se conservan en `f16` y se escriben como 0
+   * en `snorm16`, que además satura a [-32767, 32767].
+   *
+   * @param matrix La matriz de transformación 3x3.
+   * @param numPoints El número de puntos a transformar.
+   * @param options Tipos de elemento de entrada/salida y cuantización `snorm16`.
+   * @throws Error si el gestor no está inicializado, los buffers no tienen capacidad
+   *         o la cuantización no es válida (escala 0).
+   */
+  async transformPointsTypedManaged(
+    matrix: Matrix3x3,
+    numPoints: number,
+    options: TypedTransformOptions = {}
+  ): Promise<void> {
+    const module = this.ensureInitialized();
+    if (!this.staticMatrixPtr) {
+      throw new Error("Static matrix buffer not allocated.");
+    }
+    // `f64` no es un PointElementType: usar transformPointsF64Managed
+    const inInfo = POINT_ELEMENT_INFO[options.inType ?? "f32"];
+    const outInfo = POINT_ELEMENT_INFO[options.outType ?? "f32"];
+    if (!inInfo || !outInfo) {
+      throw new Error(
+        `Unknown point element type: ${options.inType} -> ${options.outType}`
+      );
+    }
+    this.ensureTypedPointBuffers(
+      numPoints,
+      options.inType ?? "f32",
+      options.outType ?? "f32"
+    );
+
+    const quant = this.ensureAuxBuffer("quantization", 8 * 4);
+    const inQ = options.inQuantization ?? IDENTITY_QUANTIZATION;
+    const outQ = options.outQuantization ?? IDENTITY_QUANTIZATION;
+    module.HEAPF32.set(
+      [
+        inQ.scaleX,
+        inQ.scaleY,
+        inQ.biasX,
+        inQ.biasY,
+        outQ.scaleX,
+        outQ.scaleY,
+        outQ.biasX,
+        outQ.biasY,
+      ],
+      quant.pointer / 4
+    );
+    module.HEAPF32.set(matrix, this.staticMatrixPtr / 4);
+    this.markInputDirtyAll();
+    const ok = module.transformPointsTyped(
+      this.staticMatrixPtr,
+      this.inputBufferInternal!.internalPointer,
+      inInfo.format,
+      this.outputBufferInternal!.internalPointer,
+      outInfo.format,
+      numPoints,
+      quant.pointer
+    );
+    if (!ok) {
+      throw new Error(
+        "Invalid typed transform (zero snorm16 scale or unsupported overlap)."
+      );
+    }
+  }
+
+  /**
+   * Transforma puntos xyxy en doble precisión (f64x2) con una matriz f64.
+   * Para coordenadas CAD/GIS en el rango 1e6, donde f32 pierde la precisión
+   * submilimétrica. Prepara los buffers con `getTypedInputBuffer(n, "f64")` y
+   * `getTypedOutputBuffer(n, "f64")`.
+   *
+   * @param matrix Matriz 3x3 column-major en `Float64Array(9)`.
+   * @param numPoints El número de puntos a transformar.
+   * @throws Error si el gestor no está inicializado o los buffers no tienen capacidad.
+   */
+  async transformPointsF64Managed(
+    matrix: Float64Array,
+    numPoints: number
+  ): Promise<void> {
+    const module = this.ensureInitialized();
+    this.ensureTypedPointBuffers(numPoints, "f64", "f64");
+    this.markInputDirtyAll();
+    module.transformPointsBatchF64(
+      this.writeMatrixF64(matrix),
+      this.inputBufferInternal!.internalPointer,
+      this.outputBufferInternal!.internalPointer,
+      numPoints
+    );
+  }
+
+  /**
+   * Modo mixto: lee puntos f64, transforma en f64 y escribe en f32 el resultado
+   * relativo a `origin` (p. ej. el centro de la vista). La resta se hace en f64,
+   * así que la salida f32 conserva la precisión cerca del origen sin salir de WASM.
+   * Prepara los buffers con `getTypedInputBuffer(n, "f64")` y `getOutputBuffer(n)`.
+   *
+   * @param matrix Matriz 3x3 column-major en `Float64Array(9)`.
+   * @param numPoints El número de puntos a transformar.
+   * @param origin Origen local restado a cada punto transformado.
+   * @throws Error si el gestor no está inicializado o los buffers no tienen capacidad.
+   */
+  async transformPointsF64ToLocalF32Managed(
+    matrix: Float64Array,
+    numPoints: number,
+    origin: { x: number; y: number }
+  ): Promise<void> {
+    const module = this.ensureInitialized();
+    this.ensureTypedPointBuffers(numPoints, "f64", "f32");
+    this.markInputDirtyAll();
+    module.transformPointsBatchF64ToF32(
+      this.writeMatrixF64(matrix),
+      this.inputBufferInternal!.internalPointer,
+      this.outputBufferInternal!.internalPointer,
+      numPoints,
+      origin.x,
+      origin.y
+    );
+  }
+
+  /** Copia una matriz f64 a su buffer auxiliar y devuelve el puntero. */
+  private writeMatrixF64(matrix: Float64Array): number {
+    if (matrix.length !== 9) {
+      throw new Error("F64 matrix must have 9 elements (column-major 3x3).");
+    }
+    const info = this.ensureAuxBuffer(
+      "matrixF64",
+      9 * Float64Array.BYTES_PER_ELEMENT
+    );
+    new Float64Array(this.module!.HEAPF32.buffer, info.pointer, 9).set(matrix);
+    return info.pointer;
+  }
+
+  /** Verifica la capacidad en bytes de los buffers para puntos de los tipos dados. */
+  private ensureTypedPointBuffers(
+    numPoints: number,
+    inType: BufferElementType,
+    outType: BufferElementType
+  ): void {
+    if (
+      !this.inputBufferInternal ||
+      !this.outputBufferInternal ||
+      this.inputBufferInternal.sizeBytes <
+        numPoints * 2 * BUFFER_ELEMENT_BYTES[inType] ||
+      this.outputBufferInternal.sizeBytes <
+        numPoints * 2 * BUFFER_ELEMENT_BYTES[outType]
+    ) {
+      throw new Error(
+        `Managed buffers not ready/lack capacity for ${numPoints} ${inType} -> ${outType} points.`
+      );
+    }
+  }
+
+  /**
+   * Variante de `transformPointsBatchManaged` para buffers con layout propio:
+   * vértices intercalados con paso/offset (x,y,u,v,rgba...), SoA (x[] e y[]
+   * separados, sin shuffles) y modo in-place sobre el buffer de entrada.
+   * Evita las copias gather/scatter en JS antes y después de cada llamada.
+   *
+   * Los offsets no necesitan alineación de 16 bytes. Entrada y salida pueden
+   * solaparse (p. ej. xy -> uv del mismo vértice) siempre que compartan el paso.
+   *
+   * @param matrix La matriz de transformación 3x3.
+   * @param numPoints El número de puntos a transformar.
+   * @param options Layouts de entrada/salida y modo in-place.
+   * @throws Error si el gestor no está inicializado, los buffers no tienen capacidad,
+   *         los layouts no son válidos/compatibles o el solapamiento no es resoluble.
+   */
+  async transformPointsLayoutManaged(
+    matrix: Matrix3x3,
+    numPoints: number,
+    options: LayoutTransformOptions = {}
+  ): Promise<void> {
+    const module = this.ensureInitialized();
+    if (!this.staticMatrixPtr) {
+      throw new Error("Static matrix buffer not allocated.");
+    }
+    const inLayout = options.inLayout ?? PACKED_POINT_LAYOUT;
+    const outLayout = options.outLayout ?? inLayout;
+    validateLayout(inLayout);
+    validateLayout(outLayout);
+
+    const inBuffer = this.inputBufferInternal;
+    const outBuffer = options.inPlace
+      ? this.inputBufferInternal
+      : this.outputBufferInternal;
+    if (
+      !inBuffer ||
+      !outBuffer ||
+      inBuffer.sizeBytes <
+        layoutFloatCount(inLayout, numPoints) *
+          Float32Array.BYTES_PER_ELEMENT ||
+      outBuffer.sizeBytes <
+        layoutFloatCount(outLayout, numPoints) *
+          Float32Array.BYTES_PER_ELEMENT
+    ) {
+      throw new Error(
+        `Managed buffers not ready/lack capacity for ${numPoints} points with the requested layouts.`
+      );
+    }
+
+    // Con `inPlace` también cambia la entrada
+    this.markInputDirtyAll();
+    module.HEAPF32.set(matrix, this.staticMatrixPtr / 4);
+    const inPtr = inBuffer.internalPointer;
+    const outPtr = outBuffer.internalPointer;
+    let ok: number;
+    if (inLayout.kind === "interleaved") {
+      if (outLayout.kind !== "interleaved")
+        throw new Error("Input and output layouts must be of the same kind.");
+      ok = module.transformPointsStrided(
+        this.staticMatrixPtr,
+        inPtr,
+        inLayout.offset ?? 0,
+        inLayout.stride,
+        outPtr,
+        outLayout.offset ?? 0,
+        outLayout.stride,
+        numPoints
+      );
+    } else {
+      if (outLayout.kind !== "soa")
+        throw new Error("Input and output layouts must be of the same kind.");
+      const bytes = Float32Array.BYTES_PER_ELEMENT;
+      ok = module.transformPointsSoA(
+        this.staticMatrixPtr,
+        inPtr,
+        inPtr + (inLayout.yOffset ?? numPoints) * bytes,
+        outPtr,
+        outPtr + (outLayout.yOffset ?? numPoints) * bytes,
+        numPoints
+      );
+    }
+    if (!ok) {
+      throw new Error(
+        "Unsupported overlap between input and output layouts (in-place requires equal strides)."
+      );
+    }
+  }
+
+  /**
+   * Garantiza un buffer auxiliar de al menos `requiredBytes`. Igual que los de
+   * puntos es un handle del pool: crece en su sitio al menos al doble (sin
+   * conservar el contenido, que el llamador reescribe), así que el handle y
+   * las vistas vivas de `auxView` sobreviven al crecimiento.
+   */
+  private ensureAuxBuffer(
+    kind: AuxBufferKind,
+    requiredBytes: number
+  ): PooledBufferRecord {
+    this.ensureInitialized();
+    const current = this.auxBuffers.get(kind);
+    if (!current) {
+      const record = this.allocPooled(requiredBytes, false, `${kind} buffer`);
+      this.auxBuffers.set(kind, record);
+      return record;
+    }
+    if (current.sizeBytes < requiredBytes) {
+      this.growPooled(
+        current,
+        Math.max(requiredBytes, current.sizeBytes * 2),
+        false
+      );
+    }
+    return current;
+  }
+
+  /**
+   * Obtiene el buffer gestionado con el array de matrices 3x3 (column-major,
+   * 9 floats por matriz, contiguas) para las transformaciones por instancia.
+   * Escribe las matrices en la vista devuelta antes de transformar.
+   *
+   * @param numMatrices Número de matrices que debe admitir el buffer.
+   * @returns Vista viva `Float32Array` de `numMatrices * 9` elementos.
+   */
+  async getMatrixArrayBuffer(
+    numMatrices: number
+  ): Promise<ManagedWasmView<Float32Array>> {
+    const info = this.ensureAuxBuffer(
+      "matrices",
+      numMatrices * this.MATRIX_SIZE_BYTES
+    );
+    return this.auxView(info, (heap, pointer) => {
+      return new Float32Array(heap, pointer, numMatrices * 9);
+    });
+  }
+
+  /**
+   * Obtiene el buffer de índices de instancia por punto (uint32): el punto i se
+   * transforma con la matriz `indices[i]` del buffer de matrices.
+   *
+   * @param numPoints Número de puntos (un índice por punto).
+   * @returns Vista viva `Uint32Array` de `numPoints` elementos.
+   */
+  async getInstanceIndexBuffer(
+    numPoints: number
+  ): Promise<ManagedWasmView<Uint32Array>> {
+    const info = this.ensureAuxBuffer(
+      "instanceIndices",
+      numPoints * Uint32Array.BYTES_PER_ELEMENT
+    );
+    return this.auxView(info, (heap, pointer) => {
+      return new Uint32Array(heap, pointer, numPoints);
+    });
+  }
+
+  /**
+   * Obtiene el buffer de rangos por instancia: pares `[start, count]` (int32).
+   * La instancia k transforma los puntos `[start, start + count)` con la matriz k.
+   *
+   * @param numInstances Número de instancias (un par por instancia).
+   * @returns Vista viva `Int32Array` de `numInstances * 2` elementos.
+   */
+  async getInstanceRangeBuffer(
+    numInstances: number
+  ): Promise<ManagedWasmView<Int32Array>> {
+    const info = this.ensureAuxBuffer(
+      "instanceRanges",
+      numInstances * 2 * Int32Array.BYTES_PER_ELEMENT
+    );
+    return this.auxView(info, (heap, pointer) => {
+      return new Int32Array(heap, pointer, numInstances * 2);
+    });
+  }
+
+  /**
+   * Transforma cada punto del buffer de entrada con su propia matriz, según el
+   * buffer de índices de instancia, en una única llamada WASM. Los puntos
+   * consecutivos que comparten matriz se vectorizan con el kernel especializado.
+   * Los puntos con un índice fuera de rango se escriben como NaN.
+   *
+   * @param numMatrices Número de matrices válidas en el buffer de matrices.
+   * @param numPoints Número de puntos a transformar.
+   * @returns Número de puntos con índice de instancia inválido (0 si todo es válido).
+   * @throws Error si el gestor no está inicializado o los buffers no tienen capacidad.
+   */
+  async transformPointsInstancedManaged(
+    numMatrices: number,
+    numPoints: number
+  ): Promise<number> {
+    const module = this.ensureInitialized();
+    const matrices = this.auxBuffers.get("matrices");
+    const indices = this.auxBuffers.get("instanceIndices");
+    if (
+      !matrices ||
+      !indices ||
+      matrices.sizeBytes < numMatrices * this.MATRIX_SIZE_BYTES ||
+      indices.sizeBytes < numPoints * Uint32Array.BYTES_PER_ELEMENT
+    ) {
+      throw new Error(
+        `Instance buffers not ready/lack capacity for ${numMatrices} matrices and ${numPoints} points.`
+      );
+    }
+    this.ensurePointBuffers(numPoints);
+    this.markInputDirtyAll();
+    return module.transformPointsInstanced(
+      matrices.pointer,
+      numMatrices,
+      indices.pointer,
+      this.inputBufferInternal!.internalPointer,
+      this.outputBufferInternal!.internalPointer,
+      numPoints
+    );
+  }
+
+  /**
+   * Transforma rangos de puntos con una matriz por instancia, en una única
+   * llamada WASM: la instancia k usa la matriz k y el par k del buffer de rangos.
+   * Los puntos no cubiertos por ningún rango no se escriben.
+   *
+   * @param numInstances Número de instancias (matrices y pares de rango).
+   * @param numPoints Número de puntos de los buffers de entrada/salida.
+   * @throws Error si faltan buffers o algún rango queda fuera de `[0, numPoints)`.
+   */
+  async transformPointsInstanceRangesManaged(
+    numInstances: number,
+    numPoints: number
+  ): Promise<void> {
+    const module = this.ensureInitialized();
+    const matrices = this.auxBuffers.get("matrices");
+    const ranges = this.auxBuffers.get("instanceRanges");
+    if (
+      !matrices ||
+      !ranges ||
+      matrices.sizeBytes < numInstances * this.MATRIX_SIZE_BYTES ||
+      ranges.sizeBytes < numInstances * 2 * Int32Array.BYTES_PER_ELEMENT
+    ) {
+      throw new Error(
+        `Instance buffers not ready/lack capacity for ${numInstances} instances.`
+      );
+    }
+    this.ensurePointBuffers(numPoints);
+    this.markInputDirtyAll();
+    const ok = module.transformPointsInstanceRanges(
+      matrices.pointer,
+      ranges.pointer,
+      numInstances,
+      this.inputBufferInternal!.internalPointer,
+      this.outputBufferInternal!.internalPointer,
+      numPoints
+    );
+    if (!ok) {
+      throw new Error(
+        `Instance ranges exceed the ${numPoints} points of the managed buffers.`
+      );
+    }
+  }
+
+  /**
+   * Obtiene los buffers gestionados del producto de matrices por lotes. Con
+   * layout `soa` los planos dependen de `count`: usa el mismo `count` al
+   * escribir y al multiplicar.
+   *
+   * @param count Número de matrices B (y de resultados).
+   * @param options Layout y si A es una sola matriz compartida.
+   * @returns Vistas vivas `a` (9 floats si `sharedA`, si no `count * 9`), `b`
+   *   y `out`.
+   */
+  async getMatrixBatchBuffers(
+    count: number,
+    options: MatrixBatchOptions = {}
+  ): Promise<MatrixBatchBuffers> {
+    const bytes = count * this.MATRIX_SIZE_BYTES;
+    const a = this.ensureAuxBuffer(
+      "matrixBatchA",
+      options.sharedA ? this.MATRIX_SIZE_BYTES : bytes
+    );
+    const b = this.ensureAuxBuffer("matrixBatchB", bytes);
+    const out = this.ensureAuxBuffer("matrixBatchOut", bytes);
+    return {
+      a: this.matrixView(a, options.sharedA ? 1 : count),
+      b: this.matrixView(b, count),
+      out: this.matrixView(out, count),
+    };
+  }
+
+  /** Vista viva de las `count` primeras matrices de un buffer auxiliar. */
+  private matrixView(
+    record: PooledBufferRecord,
+    count: number
+  ): ManagedWasmView<Float32Array> {
+    return this.auxView(record, (heap, pointer) => {
+      return new Float32Array(heap, pointer, count * 9);
+    });
+  }
+
+  /**
+   * Multiplica en una única llamada WASM los arrays de matrices de
+   * `getMatrixBatchBuffers`: out[i] = A[i] * B[i] (o A * B[i] con `sharedA`).
+   * El kernel procesa 4 matrices por vector SIMD; para componer miles de
+   * transformaciones por frame evita una llamada y una copia por par.
+   *
+   * @param count Número de matrices a multiplicar.
+   * @param options Deben coincidir con las usadas al obtener los buffers.
+   * @returns Vista viva de los `count * 9` floats del resultado, en el mismo
+   *   layout.
+   * @throws Error si los buffers no están listos o no tienen capacidad.
+   */
+  async multiplyMatricesBatchManaged(
+    count: number,
+    options: MatrixBatchOptions = {}
+  ): Promise<ManagedWasmView<Float32Array>> {
+    const module = this.ensureInitialized();
+    const layout = matrixBatchLayoutCode(count, options.layout);
+    const a = this.matrixBatchBuffer(
+      "matrixBatchA",
+      options.sharedA ? 1 : count
+    );
+    const b = this.matrixBatchBuffer("matrixBatchB", count);
+    const out = this.matrixBatchBuffer("matrixBatchOut", count);
+    module.multiplyMatricesBatch(
+      a.pointer,
+      options.sharedA ? 1 : count,
+      b.pointer,
+      out.pointer,
+      count,
+      layout
+    );
+    return this.matrixView(out, count);
+  }
+
+  /**
+   * Invierte en una única llamada WASM `count` matrices del buffer `a` (o
+   * `out`) de `getMatrixBatchBuffers` y escribe las inversas en `out`. Usa
+   * cofactores en forma cerrada, 4 matrices por vector SIMD, con un camino
+   * afín cuando el bloque no tiene perspectiva. Falla la matriz con
+   * |det| < 1e-7, igual que `invertMatrix`.
+   *
+   * @param count Número de matrices.
+   * @param options Layout y buffer de entrada.
+   * @returns Vista de las inversas, máscara de éxito y número de invertidas.
+   * @throws Error si los buffers no están listos o no tienen capacidad.
+   */
+  async invertMatricesBatchManaged(
+    count: number,
+    options: MatrixBatchUnaryOptions = {}
+  ): Promise<MatrixBatchInverseResult> {
+    const module = this.ensureInitialized();
+    const layout = matrixBatchLayoutCode(count, options.layout);
+    const source = this.matrixBatchBuffer(
+      options.source === "out" ? "matrixBatchOut" : "matrixBatchA",
+      count
+    );
+    const out = this.matrixBatchBuffer("matrixBatchOut", count);
+    const mask = this.ensureAuxBuffer("matrixBatchScalars", count * 4);
+    const inverted = module.invertMatrices(
+      source.pointer,
+      out.pointer,
+      mask.pointer,
+      count,
+      layout
+    );
+    return {
+      out: this.matrixView(out, count),
+      mask: new Uint8Array(module.HEAPF32.buffer, mask.pointer, count).slice(),
+      inverted,
+    };
+  }
+
+  /**
+   * Determinantes de `count` matrices del buffer `a` (o `out`) de
+   * `getMatrixBatchBuffers`, en una única llamada WASM.
+   *
+   * @param count Número de matrices.
+   * @param options Layout y buffer de entrada.
+   * @returns Copia con un determinante por matriz.
+   * @throws Error si los buffers no están listos o no tienen capacidad.
+   */
+  async determinantsBatchManaged(
+    count: number,
+    options: MatrixBatchUnaryOptions = {}
+  ): Promise<Float32Array> {
+    const module = this.ensureInitialized();
+    const layout = matrixBatchLayoutCode(count, options.layout);
+    const source = this.matrixBatchBuffer(
+      options.source === "out" ? "matrixBatchOut" : "matrixBatchA",
+      count
+    );
+    const dets = this.ensureAuxBuffer("matrixBatchScalars", count * 4);
+    module.determinants(source.pointer, dets.pointer, count, layout);
+    return new Float32Array(module.HEAPF32.buffer, dets.pointer, count).slice();
+  }
+
+  /** Buffer de matrices por lotes ya reservado con capacidad para `count` matrices. */
+  private matrixBatchBuffer(
+    kind: AuxBufferKind,
+    count: number
+  ): PooledBufferRecord {
+    const info = this.auxBuffers.get(kind);
+    if (!info || info.sizeBytes < count * this.MATRIX_SIZE_BYTES) {
+      throw new Error(
+        `Matrix batch buffers not ready/lack capacity for ${count} matrices.`
+      );
+    }
+    return info;
+  }
+
+  /** Verifica que los buffers de entrada/salida admiten `numPoints` puntos xyxy. */
+  private ensurePointBuffers(numPoints: number): void {
+    if (
+      !this.inputBufferInternal ||
+      !this.outputBufferInternal ||
+      this.inputBufferInternal.capacityPoints < numPoints ||
+      this.outputBufferInternal.capacityPoints < numPoints
+    ) {
+      throw new Error(
+        `Managed buffers not ready/lack capacity for ${numPoints} points.`
+      );
+    }
+  }
+
+  /**
+   * Calcula en WASM el orden espacial de los puntos del buffer de entrada:
+   * claves de la curva (16 bits por eje dentro del AABB) ordenadas con radix
+   * sort. Los puntos no finitos van al final.
+   *
+   * @returns Copia de la permutación: `order[i]` es el índice original del punto
+   *   que queda en la posición `i`.
+   * @throws Error si el gestor no está inicializado o los buffers no tienen capacidad.
+   */
+  async computeSpatialOrderManaged(
+    numPoints: number,
+    curve: SpatialCurve = "hilbert"
+  ): Promise<Uint32Array> {
+    const module = this.ensureInitialized();
+    this.ensurePointBuffers(numPoints);
+    const code = SPATIAL_CURVE_CODES[curve];
+    if (code === undefined) {
+      throw new Error(`Invalid spatial curve: ${curve}.`);
+    }
+    const order = this.ensureAuxBuffer(
+      "spatialOrder",
+      numPoints * Uint32Array.BYTES_PER_ELEMENT
+    );
+    module.spatialOrder(
+      this.inputBufferInternal!.internalPointer,
+      numPoints,
+      code,
+      order.pointer,
+      0
+    );
+    return new Uint32Array(
+      module.HEAPF32.buffer,
+      order.pointer,
+      numPoints
+    ).slice();
+  }
+
+  /**
+   * Reordena una vez (p. ej. al cargar) los puntos del buffer de entrada según
+   * una curva de Morton/Hilbert, para que hit testing, búsqueda de vecinos o
+   * tiles recorran memoria contigua. Los atributos indicados se permutan igual.
+   * La incremental siguiente hace una pasada completa.
+   *
+   * @returns La permutación aplicada (ver `computeSpatialOrderManaged`), para
+   *   reordenar más datos después con `applyPointOrder`.
+   * @throws Error si el gestor no está inicializado, los buffers no tienen
+   *   capacidad o algún atributo no cuadra con `numPoints`.
+   */
+  async reorderPointsSpatiallyManaged(
+    numPoints: number,
+    options: SpatialReorderOptions = {}
+  ): Promise<Uint32Array> {
+    const module = this.ensureInitialized();
+    const order = await this.computeSpatialOrderManaged(
+      numPoints,
+      options.curve
+    );
+    // Atributos primero: si alguno no cuadra, los puntos quedan intactos
+    this.applyPointOrder(order, options.attributes ?? []);
+    const orderBuffer = this.ensureAuxBuffer(
+      "spatialOrder",
+      numPoints * Uint32Array.BYTES_PER_ELEMENT
+    );
+    new Uint32Array(module.HEAPF32.buffer, orderBuffer.pointer, numPoints).set(
+      order
+    );
+    const input = this.inputBufferInternal!.internalPointer;
+    module.applyPermutation(
+      orderBuffer.pointer,
+      numPoints,
+      input,
+      input,
+      2 * Float32Array.BYTES_PER_ELEMENT
+    );
+    this.markInputDirtyAll();
+    return order;
+  }
+
+  /**
+   * Aplica una permutación de `computeSpatialOrderManaged` a atributos por
+   * punto: `attr[i] = copia[order[i]]`. Los buffers del pool se permutan en
+   * WASM; los arrays JS, en JS.
+   *
+   * @throws Error si `order` tiene índices fuera de rango o un atributo no
+   *   tiene un número entero de componentes por punto.
+   */
+  applyPointOrder(order: Uint32Array, attributes: PointAttribute[]): void {
+    const numPoints = order.length;
+    if (numPoints === 0 || attributes.length === 0) return;
+    for (let i = 0; i < numPoints; i++) {
+      if (order[i] >= numPoints) {
+        throw new Error(`Invalid point order: index ${order[i]} at ${i}.`);
+      }
+    }
+    // Validar todos antes de tocar ninguno
+    for (const attribute of attributes) {
+      if (ArrayBuffer.isView(attribute)) {
+        if (attribute.length % numPoints !== 0) {
+          throw new Error(
+            `Attribute of length ${attribute.length} does not match ${numPoints} points.`
+          );
+        }
+        continue;
+      }
+      const { handle, bytesPerPoint } = attribute;
+      if (!Number.isInteger(bytesPerPoint) || bytesPerPoint <= 0) {
+        throw new Error(`Invalid bytesPerPoint for buffer ${handle}.`);
+      }
+      if (this.pooledRecord(handle).sizeBytes < numPoints * bytesPerPoint) {
+        throw new Error(
+          `Buffer ${handle} lacks capacity for ${numPoints} x ${bytesPerPoint} bytes.`
+        );
+      }
+    }
+
+    // Arrays JS antes de alocar en WASM (una vista del heap caducaría si crece)
+    for (const attribute of attributes) {
+      if (ArrayBuffer.isView(attribute)) {
+        permuteAttributeArray(order, numPoints, attribute);
+      }
+    }
+    let orderPointer = 0;
+    for (const attribute of attributes) {
+      if (ArrayBuffer.isView(attribute)) continue;
+      const module = this.ensureInitialized();
+      if (!orderPointer) {
+        orderPointer = this.ensureAuxBuffer(
+          "spatialOrder",
+          numPoints * Uint32Array.BYTES_PER_ELEMENT
+        ).pointer;
+        new Uint32Array(module.HEAPF32.buffer, orderPointer, numPoints).set(
+          order
+        );
+      }
+      const pointer = this.pooledRecord(attribute.handle).pointer;
+      module.applyPermutation(
+        orderPointer,
+        numPoints,
+        pointer,
+        pointer,
+        attribute.bytesPerPoint
+      );
+    }
+  }
+
+  /**
+   * Codifica en WASM los puntos de un buffer gestionado: cuantiza a una rejilla,
+   * hace delta en el orden del buffer y empaqueta en varints. Con puntos
+   * coherentes (p. ej. tras `reorderPointsSpatiallyManaged`) ocupan unos 2 bytes
+   * por punto en lugar de 8.
+   *
+   * @returns Copia del stream codificado, lista para guardar o enviar.
+   * @throws Error si hay puntos no finitos, `step` deja más de 2^24 celdas por
+   *   eje o los buffers no tienen capacidad.
+   */
+  async encodePointsManaged(
+    numPoints: number,
+    options: PointEncodeOptions = {}
+  ): Promise<Uint8Array> {
+    const module = this.ensureInitialized();
+    this.ensurePointBuffers(numPoints);
+    const source =
+      options.source === "input"
+        ? this.inputBufferInternal!
+        : this.outputBufferInternal!;
+    const capacity =
+      POINT_CODEC_HEADER_BYTES + numPoints * POINT_CODEC_MAX_BYTES_PER_POINT;
+    const encoded = this.ensureAuxBuffer("encodedPoints", capacity);
+    const bytes = module.encodePoints(
+      source.internalPointer,
+      numPoints,
+      options.step ?? 0,
+      encoded.pointer,
+      capacity
+    );
+    if (bytes < 0) {
+      throw new Error(
+        `Failed to encode ${numPoints} points: ${POINT_CODEC_ERRORS[bytes]}.`
+      );
+    }
+    return new Uint8Array(
+      module.HEAPF32.buffer,
+      encoded.pointer,
+      bytes
+    ).slice();
+  }
+
+  /**
+   * Decodifica un stream de `encodePointsManaged` directamente en el buffer de
+   * entrada gestionado, sin arrays JS intermedios: cada chunk se copia a WASM y
+   * se decodifica en cuanto llega, así que al terminar el stream los puntos ya
+   * están listos para `transformPointsBatchManaged`.
+   *
+   * @returns Número de puntos decodificados (los del buffer de entrada).
+   * @throws Error si el stream está corrupto, truncado o tiene bytes de más.
+   */
+  async decodePointsManaged(source: EncodedPointSource): Promise<number> {
+    const module = this.ensureInitialized();
+    const header = new Uint8Array(POINT_CODEC_HEADER_BYTES);
+    let headerBytes = 0;
+    let numPoints = 0;
+    let totalBytes = 0; // 0 hasta tener la cabecera
+    let received = 0;
+    let decoded = 0;
+    let encodedPtr = 0;
+    let statePtr = 0;
+    const iterator = toChunkIterator(source);
+    let finished = false;
+    try {
+      while (true) {
+        const result = await iterator.next();
+        if (result.done) {
+          finished = true;
+          break;
+        }
+        let chunk = result.value;
+        if (!totalBytes) {
+          const take = Math.min(chunk.length, header.length - headerBytes);
+          header.set(chunk.subarray(0, take), headerBytes);
+          headerBytes += take;
+          if (headerBytes < header.length) continue;
+          chunk = chunk.subarray(take);
+          ({ numPoints, totalBytes } = parsePointCodecHeader(header));
+          await this.getInputBuffer(Math.max(numPoints, 1));
+          encodedPtr = this.ensureAuxBuffer(
+            "encodedPoints",
+            totalBytes
+          ).pointer;
+          statePtr = this.ensureAuxBuffer(
+            "decodeState",
+            DECODE_STATE_BYTES
+          ).pointer;
+          new Int32Array(module.HEAPF32.buffer, statePtr, 4).fill(0);
+          new Uint8Array(module.HEAPF32.buffer, encodedPtr).set(header);
+          received = header.length;
+        }
+        if (chunk.length > totalBytes - received) {
+          throw new Error(
+            "Unexpected bytes after the end of the point stream."
+          );
+        }
+        new Uint8Array(module.HEAPF32.buffer, encodedPtr + received).set(chunk);
+        received += chunk.length;
+        decoded = module.decodePoints(
+          encodedPtr,
+          received,
+          this.inputBufferInternal!.internalPointer,
+          this.inputBufferInternal!.capacityPoints,
+          statePtr
+        );
+        if (decoded < 0) {
+          throw new Error(
+            `Failed to decode point stream: ${POINT_CODEC_ERRORS[decoded]}.`
+          );
+        }
+      }
+    } finally {
+      if (!finished) await iterator.return?.();
+    }
+    if (!totalBytes) {
+      throw new Error("Truncated point stream header.");
+    }
+    if (decoded !== numPoints) {
+      throw new Error(
+        `Truncated point stream: ${decoded} of ${numPoints} points decoded.`
+      );
+    }
+    this.markInputDirtyAll();
+    return numPoints;
+  }
+
+  /**
+   * Crea un command buffer para encadenar muchas operaciones 3x3 pequeñas
+   * (multiplicar, invertir, determinante, homografía, transformar puntos) y
+   * ejecutarlas en una sola llamada WASM. Su `transformPointsManaged` usa los
+   * buffers de entrada/salida de este gestor.
+   * El command buffer se libera en `cleanup()` o antes con su `dispose()`.
+   *
+   * @param options Capacidad del arena de slots y del flujo de comandos.
+   * @throws Error si el gestor no está inicializado o falla la alocación.
+   */
+  createCommandBuffer(
+    options: WasmCommandBufferOptions = {}
+  ): WasmCommandBuffer {
+    const module = this.ensureInitialized();
+    const commandBuffer = new WasmCommandBuffer(
+      module,
+      options,
+      () => {
+        const input = this.inputBufferInternal;
+        const output = this.outputBufferInternal;
+        if (!input || !output) return null;
+        return {
+          inputPtr: input.internalPointer,
+          outputPtr: output.internalPointer,
+          capacityPoints: Math.min(
+            input.capacityPoints,
+            output.capacityPoints
+          ),
+        };
+      },
+      () => this.markInputDirtyAll()
+    );
+    this.commandBuffers.add(commandBuffer);
+    return commandBuffer;
+  }
+
+  // --- Buffers con handle (pool por clases de tamaño + arena por frame) ---
+
+  /**
+   * Aloca un buffer de puntos xyxy en el pool WASM y devuelve su handle.
+   * Pensado para muchos conjuntos de puntos simultáneos (mallas, partículas,
+   * overlays): los bloques liberados se reutilizan por clase de tamaño sin
+   * volver a pasar por malloc.
+   *
+   * @param numPoints Capacidad mínima en puntos.
+   * @param elementType Tipo de elemento (por defecto `f32`).
+   * @returns Handle entero (> 0), estable aunque el buffer crezca.
+   * @throws Error si el gestor no está inicializado o no hay memoria.
+   */
+  allocBuffer(
+    numPoints: number,
+    elementType: BufferElementType = "f32"
+  ): number {
+    const record = this.allocPooled(
+      this.pointBytes(numPoints, elementType),
+      false,
+      "pooled buffer"
+    );
+    this.pooledBuffers.set(record.handle, record);
+    return record.handle;
+  }
+
+  /**
+   * Como `allocBuffer`, pero en la arena por frame (un bump de puntero).
+   * Todos los buffers de frame caducan juntos en el siguiente `beginFrame()`;
+   * no se liberan ni se redimensionan individualmente.
+   */
+  allocFrameBuffer(
+    numPoints: number,
+    elementType: BufferElementType = "f32"
+  ): number {
+    const record = this.allocPooled(
+      this.pointBytes(numPoints, elementType),
+      true,
+      "frame buffer"
+    );
+    this.pooledBuffers.set(record.handle, record);
+    return record.handle;
+  }
+
+  /**
+   * Empieza un frame: invalida los handles de `allocFrameBuffer` y recicla la
+   * arena. La arena es del módulo WASM, así que afecta a todos los gestores.
+   */
+  beginFrame(): void {
+    const module = this.ensureInitialized();
+    const hasPool = this.hasPool(module);
+    if (hasPool) module._arena_reset();
+    this.pooledBuffers.forEach((record, handle) => {
+      if (!record.frame) return;
+      if (!hasPool) module._free(record.pointer);
+      record.pointer = 0; // Invalida planes y vistas vivas
+      this.pooledBuffers.delete(handle);
+    });
+  }
+
+  /**
+   * Garantiza capacidad para `numPoints` en un buffer del pool. El handle no
+   * cambia; si hace falta un bloque mayor se salta a la siguiente potencia
+   * de 2.
+   *
+   * @param preserve Copiar el contenido al bloque nuevo (por defecto sí).
+   * @throws Error si el handle no existe, es de frame o no hay memoria.
+   */
+  resizeBuffer(
+    handle: number,
+    numPoints: number,
+    elementType: BufferElementType = "f32",
+    preserve: boolean = true
+  ): void {
+    const record = this.pooledRecord(handle);
+    if (record.frame) {
+      throw new Error(`Frame buffer ${handle} cannot be resized.`);
+    }
+    const bytes = this.pointBytes(numPoints, elementType);
+    if (record.sizeBytes < bytes) this.growPooled(record, bytes, preserve);
+  }
+
+  /** Devuelve el buffer al pool. Ignora handles desconocidos o de frame. */
+  releaseBuffer(handle: number): void {
+    const record = this.pooledBuffers.get(handle);
+    if (!record || record.frame || !this.module) return;
+    this.freePooled(this.module, record);
+    this.pooledBuffers.delete(handle);
+  }
+
+  /**
+   * Vista de `numPoints` puntos (por defecto toda la capacidad) del buffer con
+   * handle. Se reutiliza mientras no crezca la memoria WASM ni se mueva el
+   * bloque; si no, se recrea, así que basta con pedirla de nuevo cada frame.
+   */
+  getBufferView<T extends BufferElementType = "f32">(
+    handle: number,
+    elementType: T = "f32" as T,
+    numPoints?: number
+  ): PointElementArrayMap[T] {
+    const record = this.pooledRecord(handle);
+    const bytes = BUFFER_ELEMENT_BYTES[elementType];
+    const capacity = Math.floor(record.sizeBytes / (2 * bytes));
+    const points = numPoints ?? capacity;
+    if (points > capacity) {
+      throw new Error(
+        `Buffer ${handle} holds ${capacity} ${elementType} points, not ${points}.`
+      );
+    }
+    const key = `${elementType}:${points}`;
+    if (record.cachedView?.key !== key) {
+      record.cachedView = {
+        key,
+        read: this.liveView(record, elementType, points * 2),
+      };
+    }
+    return record.cachedView.read() as PointElementArrayMap[T];
+  }
+
+  /** Capacidad en puntos del buffer con handle para ese tipo de elemento. */
+  getBufferCapacity(
+    handle: number,
+    elementType: BufferElementType = "f32"
+  ): number {
+    const record = this.pooledRecord(handle);
+    return Math.floor(
+      record.sizeBytes / (2 * BUFFER_ELEMENT_BYTES[elementType])
+    );
+  }
+
+  /**
+   * `transformPointsBatchManaged` entre dos buffers con handle (f32 xyxy).
+   * Pueden ser el mismo handle para transformar en sitio.
+   *
+   * @throws Error si algún handle no existe o no admite `numPoints` puntos.
+   */
+  async transformPointsHandles(
+    matrix: Matrix3x3,
+    inputHandle: number,
+    outputHandle: number,
+    numPoints: number
+  ): Promise<void> {
+    const module = this.ensureInitialized();
+    if (!this.staticMatrixPtr) {
+      throw new Error("Static matrix buffer not allocated.");
+    }
+    const input = this.pooledRecord(inputHandle);
+    const output = this.pooledRecord(outputHandle);
+    const requiredBytes = this.pointBytes(numPoints, "f32");
+    if (input.sizeBytes < requiredBytes || output.sizeBytes < requiredBytes) {
+      throw new Error(
+        `Buffers ${inputHandle}/${outputHandle} lack capacity for ${numPoints} points.`
+      );
+    }
+    module.HEAPF32.set(matrix, this.staticMatrixPtr / 4);
+    module.transformPointsBatch(
+      this.staticMatrixPtr,
+      input.pointer,
+      output.pointer,
+      numPoints
+    );
+  }
+
+  /**
+   * Transforma en streaming un conjunto de puntos mayor que el heap WASM a
+   * través de una ventana fija de dos slots, así que la memoria WASM no
+   * depende del tamaño de la entrada.
+   *
+   * Cada chunk de la fuente se copia a un slot (en bloques de como mucho
+   * `windowPoints`), se transforma en sitio y se entrega como vista del slot.
+   * Antes de transformar se pide ya el siguiente chunk a la fuente, así que la
+   * lectura/decodificación de una fuente asíncrona se solapa con el cálculo.
+   *
+   * Los slots se alternan: la vista entregada sigue válida mientras se procesa
+   * el bloque siguiente y se sobrescribe al pedir el posterior. Cópiala si hay
+   * que conservarla más, o si otra operación puede hacer crecer la memoria
+   * WASM mientras se usa (como con `getOutputView`).
+   *
+   * @param matrix Matriz de transformación (se escribe antes de cada bloque).
+   * @param source Array xyxy o iterador (síncrono o asíncrono) de chunks xyxy.
+   * @param options Tamaño de la ventana.
+   * @throws Error si un chunk tiene longitud impar o no hay memoria para la ventana.
+   */
+  async *transformPointsStream(
+    matrix: Matrix3x3,
+    source: PointStreamSource,
+    options: PointStreamOptions = {}
+  ): AsyncGenerator<Float32Array, void, undefined> {
+    const module = this.ensureInitialized();
+    if (!this.staticMatrixPtr) {
+      throw new Error("Static matrix buffer not allocated.");
+    }
+    const matrixPtr = this.staticMatrixPtr;
+    const windowPoints = options.windowPoints ?? DEFAULT_STREAM_WINDOW_POINTS;
+    if (!Number.isInteger(windowPoints) || windowPoints <= 0) {
+      throw new Error(`Invalid stream window size: ${windowPoints}`);
+    }
+    const windowBytes = this.pointBytes(windowPoints, "f32");
+    const slots: PooledBufferRecord[] = [];
+    let iterator: ChunkIterator<Float32Array> | null = null;
+    let pending:
+      | Promise<IteratorResult<Float32Array>>
+      | IteratorResult<Float32Array>
+      | null = null;
+    let finished = false;
+    try {
+      for (let k = 0; k < 2; k++) {
+        const slot = this.allocPooled(windowBytes, false, "stream window");
+        slots.push(slot);
+        this.streamSlots.add(slot);
+      }
+
+      iterator = toChunkIterator(source);
+      pending = iterator.next();
+      let current = 0;
+      while (true) {
+        const result = await pending;
+        if (result.done) {
+          finished = true;
+          break;
+        }
+        const chunk = result.value;
+        if (chunk.length % 2 !== 0) {
+          throw new Error(
+            `Stream chunk has an odd number of floats (${chunk.length}).`
+          );
+        }
+        for (let offset = 0; offset < chunk.length; ) {
+          const floats = Math.min(windowPoints * 2, chunk.length - offset);
+          const slot = slots[current];
+          module.HEAPF32.set(
+            chunk.subarray(offset, offset + floats),
+            slot.pointer / 4
+          );
+          offset += floats;
+          // Chunk ya copiado: pedir el siguiente antes de transformar
+          if (offset === chunk.length) pending = iterator.next();
+
+          module.HEAPF32.set(matrix, matrixPtr / 4);
+          module.transformPointsBatch(
+            matrixPtr,
+            slot.pointer,
+            slot.pointer,
+            floats / 2
+          );
+          yield new Float32Array(module.HEAPF32.buffer, slot.pointer, floats);
+          current ^= 1;
+        }
+        // Chunk vacío: no se entra en el bucle y hay que avanzar aquí
+        if (chunk.length === 0) pending = iterator.next();
+      }
+    } finally {
+      slots.forEach((slot) => {
+        if (this.streamSlots.delete(slot)) this.freePooled(module, slot);
+      });
+      if (iterator && !finished) {
+        // Cortado antes de agotar la fuente: cerrarla y descartar lo pedido
+        Promise.resolve(pending).catch(() => {});
+        await iterator.return?.();
+      }
+    }
+  }
+
+  /**
+   * `transformPointsStream` sobre un array completo: transforma `points` por
+   * ventanas y escribe el resultado en `output` (puede ser el propio `points`).
+   *
+   * @returns `output` (por defecto un array nuevo del tamaño de `points`).
+   * @throws Error si `points` tiene longitud impar u `output` es menor.
+   */
+  async transformPointsChunked(
+    matrix: Matrix3x3,
+    points: Float32Array,
+    output: Float32Array = new Float32Array(points.length),
+    options: PointStreamOptions = {}
+  ): Promise<Float32Array> {
+    if (output.length < points.length) {
+      throw new Error(
+        `Output holds ${output.length} floats, input has ${points.length}.`
+      );
+    }
+    let offset = 0;
+    for await (const block of this.transformPointsStream(
+      matrix,
+      points,
+      options
+    )) {
+      output.set(block, offset);
+      offset += block.length;
+    }
+    return output;
+  }
+
+  /**
+   * Crea un plan de transformación para buffers que se transforman cada frame
+   * con el mismo tamaño y layout y una matriz que cambia poco. Layout,
+   * capacidad, solapamiento y reparto entre workers se validan aquí una vez;
+   * después `plan.updateMatrix(m)` + `plan.execute()` son dos llamadas WASM
+   * baratas, sin validar buffers ni re-splattear si la matriz no cambia.
+   *
+   * Los buffers son los gestionados de entrada/salida (o los handles de
+   * `options.input`/`options.output`). Si crecen o se liberan, el plan queda
+   * obsoleto y `execute` lanza un error. El plan se libera en `cleanup()` o
+   * antes con su `dispose()`.
+   *
+   * @param matrix Matriz inicial.
+   * @param numPoints Puntos que transforma cada ejecución.
+   * @param options Layouts, modo in-place y handles opcionales.
+   * @throws Error si los buffers no tienen capacidad, los layouts no son
+   *         compatibles o el solapamiento no es resoluble.
+   */
+  createTransformPlan(
+    matrix: Matrix3x3,
+    numPoints: number,
+    options: TransformPlanOptions = {}
+  ): WasmTransformPlan {
+    const module = this.ensureInitialized();
+    const inLayout = options.inLayout ?? PACKED_POINT_LAYOUT;
+    const outLayout = options.outLayout ?? inLayout;
+    validateLayout(inLayout);
+    validateLayout(outLayout);
+    if (inLayout.kind !== outLayout.kind) {
+      throw new Error("Input and output layouts must be of the same kind.");
+    }
+    if (!Number.isInteger(numPoints) || numPoints < 0) {
+      throw new Error(`Invalid point count: ${numPoints}`);
+    }
+
+    const input =
+      options.input !== undefined
+        ? this.pooledRecord(options.input)
+        : this.pointBufferRecords.input;
+    const output = options.inPlace
+      ? input
+      : options.output !== undefined
+        ? this.pooledRecord(options.output)
+        : this.pointBufferRecords.output;
+    const bytes = Float32Array.BYTES_PER_ELEMENT;
+    if (
+      !input ||
+      !output ||
+      input.sizeBytes < layoutFloatCount(inLayout, numPoints) * bytes ||
+      output.sizeBytes < layoutFloatCount(outLayout, numPoints) * bytes
+    ) {
+      throw new Error(
+        `Plan buffers not ready/lack capacity for ${numPoints} points with the requested layouts.`
+      );
+    }
+
+    let id: number;
+    if (inLayout.kind === "interleaved" && outLayout.kind === "interleaved") {
+      const inOffset = inLayout.offset ?? 0;
+      const outOffset = outLayout.offset ?? 0;
+      // xyxy sin solapamiento parcial: kernel empaquetado (y reparto en chunks)
+      const packed =
+        inLayout.stride === 2 &&
+        outLayout.stride === 2 &&
+        (input !== output || inOffset === outOffset);
+      id = module._plan_create(
+        packed ? PlanLayoutCode.Packed : PlanLayoutCode.Strided,
+        input.pointer + inOffset * bytes,
+        0,
+        output.pointer + outOffset * bytes,
+        0,
+        inLayout.stride,
+        outLayout.stride,
+        numPoints
+      );
+    } else {
+      const inY = inLayout.kind === "soa" ? inLayout.yOffset : undefined;
+      const outY = outLayout.kind === "soa" ? outLayout.yOffset : undefined;
+      id = module._plan_create(
+        PlanLayoutCode.SoA,
+        input.pointer,
+        input.pointer + (inY ?? numPoints) * bytes,
+        output.pointer,
+        output.pointer + (outY ?? numPoints) * bytes,
+        0,
+        0,
+        numPoints
+      );
+    }
+    if (!id) {
+      throw new Error(
+        "Unsupported overlap between input and output layouts (in-place requires equal strides)."
+      );
+    }
+
+    const managed = this.pointBufferRecords;
+    const writesManaged = output === managed.input || output === managed.output;
+    const plan = new WasmTransformPlan(
+      module,
+      id,
+      numPoints,
+      [input, output],
+      writesManaged ? () => this.markInputDirtyAll() : null
+    );
+    plan.updateMatrix(matrix);
+    this.transformPlans.add(plan);
+    return plan;
+  }
+
+  /**
+   * Crea una jerarquía de transformaciones (scene graph) en WASM con sitio
+   * para `capacity` nodos. Sustituye a componer world = padre * local en JS
+   * nodo a nodo: `hierarchy.update()` propaga en una llamada solo los
+   * subárboles sucios. Se libera en `cleanup()` o antes con su `dispose()`.
+   *
+   * @param capacity Número máximo de nodos.
+   * @throws Error si la capacidad no es válida o WASM no puede reservarla.
+   */
+  createTransformHierarchy(capacity: number): WasmTransformHierarchy {
+    const module = this.ensureInitialized();
+    if (!Number.isInteger(capacity) || capacity < 0) {
+      throw new Error(`Invalid hierarchy capacity: ${capacity}`);
+    }
+    const id = module._hierarchy_create(capacity);
+    if (!id) {
+      throw new Error(`Failed to create a hierarchy of ${capacity} nodes.`);
+    }
+    const hierarchy = new WasmTransformHierarchy(module, id, capacity);
+    this.transformHierarchies.add(hierarchy);
+    return hierarchy;
+  }
+
+  /**
+   * Actualiza la jerarquía y, en la misma pasada, transforma los puntos de
+   * cada nodo recalculado (`setPointRange`) del buffer de entrada al de
+   * salida con su matriz world. Los tramos de los nodos limpios conservan la
+   * salida anterior.
+   *
+   * @param hierarchy Jerarquía creada por este gestor.
+   * @param numPoints Puntos de los buffers gestionados que cubren los tramos.
+   * @returns Número de nodos recalculados.
+   * @throws Error si los buffers no tienen capacidad o algún tramo la excede.
+   */
+  updateTransformHierarchyManaged(
+    hierarchy: WasmTransformHierarchy,
+    numPoints: number
+  ): number {
+    this.ensureInitialized();
+    if (!this.transformHierarchies.has(hierarchy)) {
+      throw new Error("Transform hierarchy does not belong to this manager.");
+    }
+    this.ensurePointBuffers(numPoints);
+    // La salida cambia por tramos: la incremental no puede fiarse de ella
+    this.markInputDirtyAll();
+    return hierarchy.update({
+      inputPointer: this.inputBufferInternal!.internalPointer,
+      outputPointer: this.outputBufferInternal!.internalPointer,
+      numPoints,
+    });
+  }
+
+  /**
+   * Crea un conjunto de pistas de animación por keyframes en WASM. Cada pista
+   * produce una matriz por frame; `evaluateKeyframeAnimationManaged` las
+   * evalúa todas en una llamada, sin descomponer ni interpolar en JS. Se
+   * libera en `cleanup()` o antes con su `dispose()`.
+   */
+  createKeyframeAnimation(): WasmKeyframeAnimation {
+    const module = this.ensureInitialized();
+    const id = module._animation_create();
+    if (!id) {
+      throw new Error("Failed to create a keyframe animation.");
+    }
+    const animation = new WasmKeyframeAnimation(module, id);
+    this.keyframeAnimations.add(animation);
+    return animation;
+  }
+
+  /**
+   * Evalúa todas las pistas de la animación en `time` y escribe sus matrices
+   * (la de la pista i en la posición i) en un buffer gestionado: por defecto
+   * el de matrices por instancia, o uno de los de matrices por lotes. Crece
+   * el buffer si hace falta.
+   *
+   * @param animation Animación creada por este gestor.
+   * @param time Tiempo en las mismas unidades que los keyframes.
+   * @param options Buffer de destino y layout.
+   * @returns Vista viva de las `numTracks * 9` floats escritas.
+   * @throws Error si `instances` se pide en SoA o la animación no es de este gestor.
+   */
+  evaluateKeyframeAnimationManaged(
+    animation: WasmKeyframeAnimation,
+    time: number,
+    options: KeyframeEvaluateOptions = {}
+  ): ManagedWasmView<Float32Array> {
+    this.ensureInitialized();
+    if (!this.keyframeAnimations.has(animation)) {
+      throw new Error("Keyframe animation does not belong to this manager.");
+    }
+    const count = animation.numTracks;
+    const { info, layout } = this.matrixTargetBuffer(count, options);
+    animation.evaluate(time, info.pointer, layout);
+    return this.matrixView(info, count);
+  }
+
+  /** Buffer de destino (con capacidad para `count` matrices) y código de layout. */
+  private matrixTargetBuffer(
+    count: number,
+    options: MatrixTargetOptions
+  ): { info: PooledBufferRecord; layout: number } {
+    const layout = matrixBatchLayoutCode(count, options.layout);
+    const target = options.target ?? "instances";
+    const kind = MATRIX_TARGET_BUFFERS[target];
+    if (kind === undefined) {
+      throw new Error(`Unsupported matrix target: ${target}.`);
+    }
+    if (target === "instances" && options.layout === "soa") {
+      throw new Error("Instance matrices must use the aos layout.");
+    }
+    const info = this.ensureAuxBuffer(kind, count * this.MATRIX_SIZE_BYTES);
+    return { info, layout };
+  }
+
+  /**
+   * Crea un programa de transformación: secuencias de `TransformCommand`
+   * compiladas a bytecode en WASM, para recomponer muchas matrices
+   * (p. ej. la de cada documento abierto) en una llamada en lugar de un
+   * `MatrixUtils.combine` por secuencia. Se libera en `cleanup()` o antes con
+   * su `dispose()`.
+   *
+   * @param options Capacidad del programa en palabras de 32 bits.
+   * @throws Error si el gestor no está inicializado o falla la alocación.
+   */
+  createTransformProgram(
+    options: WasmTransformProgramOptions = {}
+  ): WasmTransformProgram {
+    const module = this.ensureInitialized();
+    const program = new WasmTransformProgram(module, options);
+    this.transformPrograms.add(program);
+    return program;
+  }
+
+  /**
+   * Pliega en una llamada WASM todas las secuencias del programa y escribe
+   * sus matrices (la de la secuencia i en la posición i) en un buffer
+   * gestionado: por defecto el de matrices por instancia, o uno de los de
+   * matrices por lotes. Crece el buffer si hace falta.
+   *
+   * @param program Programa creado por este gestor.
+   * @param options Buffer de destino y layout.
+   * @returns Vista viva de las `sequenceCount * 9` floats escritas.
+   * @throws Error si `instances` se pide en SoA o el programa no es de este gestor.
+   */
+  evaluateTransformProgramManaged(
+    program: WasmTransformProgram,
+    options: MatrixTargetOptions = {}
+  ): ManagedWasmView<Float32Array> {
+    this.ensureInitialized();
+    if (!this.transformPrograms.has(program)) {
+      throw new Error("Transform program does not belong to this manager.");
+    }
+    const count = program.sequenceCount;
+    const { info, layout } = this.matrixTargetBuffer(count, options);
+    program.evaluate(info.pointer, count, layout);
+    return this.matrixView(info, count);
+  }
+
+  /**
+   * Contadores del pool WASM. `systemAllocs` debería estabilizarse tras los
+   * primeros frames: si sigue creciendo hay churn (tamaños siempre nuevos).
+   */
+  getPoolStats(): WasmPoolStats {
+    const module = this.ensureInitialized();
+    if (!this.hasPool(module)) {
+      throw new Error(
+        "Pool stats require a WASM build with the buffer pool (pnpm build:wasm)."
+      );
+    }
+    const info = this.ensureAuxBuffer(
+      "poolStats",
+      POOL_STATS_FIELDS.length * Uint32Array.BYTES_PER_ELEMENT
+    );
+    module._pool_stats(info.pointer);
+    const raw = new Uint32Array(
+      module.HEAPF32.buffer,
+      info.pointer,
+      POOL_STATS_FIELDS.length
+    );
+    const stats = {} as WasmPoolStats;
+    POOL_STATS_FIELDS.forEach((field, k) => (stats[field] = raw[k]));
+    return stats;
+  }
+
+  private pointBytes(
+    numPoints: number,
+    elementType: BufferElementType
+  ): number {
+    const bytes = BUFFER_ELEMENT_BYTES[elementType];
+    if (!bytes) throw new Error(`Unknown point element type: ${elementType}`);
+    if (!Number.isInteger(numPoints) || numPoints < 0) {
+      throw new Error(`Invalid point count: ${numPoints}`);
+    }
+    return numPoints * 2 * bytes;
+  }
+
+  private pooledRecord(handle: number): PooledBufferRecord {
+    const record = this.pooledBuffers.get(handle);
+    if (!record) {
+      throw new Error(`Unknown or released buffer handle ${handle}.`);
+    }
+    return record;
+  }
+
+  /**
+   * Obtiene una VISTA del buffer de salida interno con la longitud especificada.
+   * Útil para leer resultados DESPUÉS de llamar a `transformPointsBatchManaged`.
+   *
+   * ¡PRECAUCIÓN! No almacene esta vista a largo plazo si la memoria WASM puede crecer.
+   *
+   * @param numPoints El número de puntos cuyo resultado se quiere leer (longitud de la vista = numPoints * 2)
+   * @returns Una `Float32Array` apuntando a la memoria de salida WASM, o `null` si el buffer no está listo.
+   * @throws Error si `numPoints` excede la capacidad del buffer de salida.
+   */
+  getOutputView(numPoints: number): Float32Array | null {
+    const module = this.module; // Usar instancia guardada
+    const outputBuffer = this.outputBufferInternal; // Usar buffer interno
+
+    if (!module?.HEAPF32?.buffer || !outputBuffer) {
+      console.warn(
+        "[BufferMgr] Cannot get output view: Not initialized or output buffer missing."
       );
       return null;
     }
@@ -391,17 +2980,44 @@ export class WasmBufferManager {
       } catch (e) {}
     }
     const canFree = module && typeof module._free === "function";
-    [this.inputBufferInternal, this.outputBufferInternal].forEach(
-      (bufferInfo) => {
-        if (bufferInfo && canFree) {
-          try {
-            module!._free(bufferInfo.internalPointer);
-          } catch (e) {
-            /*...*/
+    // Buffers del pool: se devuelven a sus listas libres y luego se recortan
+    const pooled = [
+      this.pointBufferRecords.input,
+      this.pointBufferRecords.output,
+      ...this.pooledBuffers.values(),
+      ...this.streamSlots,
+      ...this.auxBuffers.values(),
+    ];
+    if (canFree) {
+      try {
+        const hasPool = this.hasPool(module!);
+        pooled.forEach((record) => {
+          // Los de frame son de la arena, salvo sin pool (bloques de _malloc)
+          if (record && (!record.frame || !hasPool)) {
+            this.freePooled(module!, record);
           }
-        }
+        });
+        if (hasPool) module!._pool_trim();
+      } catch (e) {
+        console.error("[BufferMgr] Error releasing pooled buffers:", e);
       }
-    );
+    }
+    this.pointBufferRecords = { input: null, output: null };
+    this.pooledBuffers.clear();
+    this.streamSlots.clear();
+    this.dirtyRanges.length = 0;
+    this.incrementalState = null;
+    this.auxBuffers.clear();
+    this.commandBuffers.forEach((commandBuffer) => commandBuffer.dispose());
+    this.commandBuffers.clear();
+    this.transformPlans.forEach((plan) => plan.dispose());
+    this.transformPlans.clear();
+    this.transformHierarchies.forEach((hierarchy) => hierarchy.dispose());
+    this.transformHierarchies.clear();
+    this.keyframeAnimations.forEach((animation) => animation.dispose());
+    this.keyframeAnimations.clear();
+    this.transformPrograms.forEach((program) => program.dispose());
+    this.transformPrograms.clear();
     this.inputBufferInternal = null;
     this.outputBufferInternal = null;
     if (this.staticMatrixPtr && canFree) {
@@ -0,0 +1,318 @@
+// src/core/wasm/WasmCommandBuffer.ts
+
+import type { Matrix3x3 } from "../../types/core.types";
+import type { MatrixOpsWasmModule } from "./wasm-loader";
+
+/** Floats por slot del arena (una matriz 3x3). */
+export const SLOT_FLOATS = 9;
+/** Slots contiguos que ocupa la matriz A (8x8) de `solveHomography`. */
+export const HOMOGRAPHY_A_SLOTS = 8;
+
+/** Opcodes de `execute_ops` (deben coincidir con `CommandOp` en matrix_ops.cpp). */
+const CommandOp = {
+  Multiply: 1,
+  Determinant: 2,
+  Invert: 3,
+  SolveHomography: 4,
+  TransformPoints: 5,
+} as const;
+
+// [opcode, status]
+const COMMAND_HEADER_WORDS = 2;
+
+export interface WasmCommandBufferOptions {
+  /** Slots de 9 floats del arena de operandos/resultados. */
+  maxSlots?: number;
+  /** Palabras int32 máximas del flujo de comandos. */
+  maxCommandWords?: number;
+}
+
+/**
+ * Punteros y capacidad de los buffers de puntos gestionados, resueltos al
+ * codificar `transformPointsManaged` (los da `WasmBufferManager`).
+ */
+export interface ManagedPointsProvider {
+  (): { inputPtr: number; outputPtr: number; capacityPoints: number } | null;
+}
+
+/**
+ * Command buffer para muchas operaciones 3x3 pequeñas en una sola llamada WASM.
+ *
+ * Los operandos viven en un arena de slots (9 floats cada uno) en el heap de
+ * WASM: se escriben con `setMatrix`/`setValues`, se codifican los comandos
+ * referenciando slots y `execute()` los ejecuta todos con una única llamada a
+ * `_execute_ops`. Cada comando tiene una palabra de status que el intérprete
+ * rellena (1 éxito, 0 singular o slots fuera de rango) sin abortar el resto.
+ *
+ * Uso típico:
+ * ```ts
+ * const cb = manager.createCommandBuffer();
+ * const [a, b, ab, inv] = [cb.allocSlots(), cb.allocSlots(), cb.allocSlots(), cb.allocSlots()];
+ * cb.setMatrix(a, A); cb.setMatrix(b, B);
+ * cb.multiply(a, b, ab);
+ * const cmd = cb.invert(ab, inv);
+ * cb.execute();
+ * if (cb.succeeded(cmd)) cb.getMatrix(inv, out);
+ * ```
+ */
+export class WasmCommandBuffer {
+  private readonly maxSlots: number;
+  private readonly maxCommandWords: number;
+  private opsPtr: number;
+  private slotsPtr: number;
+  private numWords = 0;
+  private numCommands = 0;
+  private nextSlot = 0;
+  // Offset (en palabras) de cada comando codificado, para leer su status
+  private commandOffsets: number[] = [];
+
+  // Vistas cacheadas; se recrean si HEAPF32.buffer cambia (crecimiento)
+  private viewBuffer: ArrayBufferLike | null = null;
+  private opsView!: Int32Array;
+  private slotsView!: Float32Array;
+  private module: MatrixOpsWasmModule | null;
+  private readonly managedPoints: ManagedPointsProvider | null;
+  private readonly onManagedOutput: (() => void) | null;
+  // Si el flujo actual escribe en la salida gestionada
+  private writesManagedOutput = false;
+
+  /**
+   * @param onManagedOutput Se llama en cada `execute()` cuyo flujo incluye
+   *   `transformPointsManaged` (el gestor invalida su estado incremental).
+   */
+  constructor(
+    module: MatrixOpsWasmModule,
+    options: WasmCommandBufferOptions = {},
+    managedPoints: ManagedPointsProvider | null = null,
+    onManagedOutput: (() => void) | null = null
+  ) {
+    this.maxSlots = options.maxSlots ?? 1024;
+    this.maxCommandWords = options.maxCommandWords ?? 8192;
+    if (this.maxSlots <= 0 || this.maxCommandWords <= 0) {
+      throw new Error("Command buffer capacities must be positive.");
+    }
+    this.opsPtr = module._malloc(this.maxCommandWords * 4);
+    this.slotsPtr = module._malloc(this.maxSlots * SLOT_FLOATS * 4);
+    if (!this.opsPtr || !this.slotsPtr) {
+      if (this.opsPtr) module._free(this.opsPtr);
+      if (this.slotsPtr) module._free(this.slotsPtr);
+      throw new Error("Failed to _malloc command buffer memory.");
+    }
+    this.module = module;
+    this.managedPoints = managedPoints;
+    this.onManagedOutput = onManagedOutput;
+  }
+
+  private ensureModule(): MatrixOpsWasmModule {
+    if (!this.module) {
+      throw new Error("Command buffer has been disposed.");
+    }
+    return this.module;
+  }
+
+  private refreshViews(): void {
+    const module = this.ensureModule();
+    const buffer = module.HEAPF32.buffer;
+    if (buffer === this.viewBuffer) return;
+    this.opsView = new Int32Array(buffer, this.opsPtr, this.maxCommandWords);
+    this.slotsView = new Float32Array(
+      buffer,
+      this.slotsPtr,
+      this.maxSlots * SLOT_FLOATS
+    );
+    this.viewBuffer = buffer;
+  }
+
+  private checkSlot(slot: number, span = 1): void {
+    if (!Number.isInteger(slot) || slot < 0 || slot + span > this.maxSlots) {
+      throw new Error(
+        `Slot ${slot} (span ${span}) is outside the ${this.maxSlots}-slot arena.`
+      );
+    }
+  }
+
+  /**
+   * Reserva `count` slots contiguos y devuelve el índice del primero.
+   * @throws Error si el arena no tiene sitio.
+   */
+  allocSlots(count = 1): number {
+    if (this.nextSlot + count > this.maxSlots) {
+      throw new Error(
+        `Command buffer slot arena exhausted (${this.maxSlots} slots).`
+      );
+    }
+    const first = this.nextSlot;
+    this.nextSlot += count;
+    return first;
+  }
+
+  /** Libera todos los slots reservados (el contenido no se borra). */
+  resetSlots(): void {
+    this.nextSlot = 0;
+  }
+
+  /** Escribe una matriz 3x3 (column-major) en el slot. */
+  setMatrix(slot: number, m: Matrix3x3): void {
+    this.setValues(slot, m);
+  }
+
+  /**
+   * Escribe floats arbitrarios a partir del slot (p. ej. los 64 de A de una
+   * homografía en `HOMOGRAPHY_A_SLOTS` slots, o los 8 de b).
+   */
+  setValues(slot: number, values: ArrayLike<number>): void {
+    this.checkSlot(slot, Math.max(1, Math.ceil(values.length / SLOT_FLOATS)));
+    this.refreshViews();
+    this.slotsView.set(values, slot * SLOT_FLOATS);
+  }
+
+  /** Copia la matriz del slot en `out` (o en una nueva `Float32Array`). */
+  getMatrix(slot: number, out?: Matrix3x3): Matrix3x3 {
+    this.checkSlot(slot);
+    this.refreshViews();
+    const result = out ?? new Float32Array(SLOT_FLOATS);
+    const base = slot * SLOT_FLOATS;
+    for (let k = 0; k < SLOT_FLOATS; k++) {
+      result[k] = this.slotsView[base + k];
+    }
+    return result;
+  }
+
+  /** Primer float del slot (resultado de `determinant`). */
+  getScalar(slot: number): number {
+    this.checkSlot(slot);
+    this.refreshViews();
+    return this.slotsView[slot * SLOT_FLOATS];
+  }
+
+  private encode(opcode: number, args: number[]): number {
+    const words = COMMAND_HEADER_WORDS + args.length;
+    if (this.numWords + words > this.maxCommandWords) {
+      throw new Error(`Command buffer full (${this.maxCommandWords} words).`);
+    }
+    this.refreshViews();
+    const offset = this.numWords;
+    this.opsView[offset] = opcode;
+    this.opsView[offset + 1] = 0;
+    for (let k = 0; k < args.length; k++) {
+      this.opsView[offset + COMMAND_HEADER_WORDS + k] = args[k];
+    }
+    this.numWords += words;
+    this.commandOffsets.push(offset);
+    return this.numCommands++;
+  }
+
+  /** out = a * b. Devuelve el índice del comando. */
+  multiply(a: number, b: number, out: number): number {
+    return this.encode(CommandOp.Multiply, [a, b, out]);
+  }
+
+  /** Escribe det(m) en el primer float del slot `out`. */
+  determinant(m: number, out: number): number {
+    return this.encode(CommandOp.Determinant, [m, out]);
+  }
+
+  /** out = m^-1; status 0 si m es singular. */
+  invert(m: number, out: number): number {
+    return this.encode(CommandOp.Invert, [m, out]);
+  }
+
+  /**
+   * Resuelve A·x = b (A 8x8 en `HOMOGRAPHY_A_SLOTS` slots desde `aSlot`,
+   * b y x con 8 floats). Status 0 si el sistema es singular.
+   */
+  solveHomography(aSlot: number, bSlot: number, xSlot: number): number {
+    return this.encode(CommandOp.SolveHomography, [aSlot, bSlot, xSlot]);
+  }
+
+  /**
+   * Transforma `numPoints` puntos xyxy entre punteros WASM con la matriz del
+   * slot. Los punteros los valida quien llama.
+   */
+  transformPoints(
+    matrixSlot: number,
+    inputPtr: number,
+    outputPtr: number,
+    numPoints: number
+  ): number {
+    return this.encode(CommandOp.TransformPoints, [
+      matrixSlot,
+      inputPtr,
+      outputPtr,
+      numPoints,
+    ]);
+  }
+
+  /**
+   * Igual que `transformPoints` sobre los buffers de entrada/salida gestionados
+   * del `WasmBufferManager` que creó este command buffer. Los punteros se
+   * resuelven ahora: no cambies la capacidad de esos buffers antes de `execute()`.
+   */
+  transformPointsManaged(matrixSlot: number, numPoints: number): number {
+    const buffers = this.managedPoints?.() ?? null;
+    if (!buffers || buffers.capacityPoints < numPoints) {
+      throw new Error(
+        `Managed buffers not ready/lack capacity for ${numPoints} points.`
+      );
+    }
+    const command = this.transformPoints(
+      matrixSlot,
+      buffers.inputPtr,
+      buffers.outputPtr,
+      numPoints
+    );
+    this.writesManagedOutput = true;
+    return command;
+  }
+
+  /** Comandos codificados desde el último `reset()`. */
+  get commandCount(): number {
+    return this.numCommands;
+  }
+
+  /**
+   * Ejecuta todos los comandos codificados con una sola llamada a WASM.
+   * @returns Comandos ejecutados (igual a `commandCount` salvo flujo corrupto).
+   */
+  execute(): number {
+    const module = this.ensureModule();
+    if (this.writesManagedOutput) this.onManagedOutput?.();
+    return module._execute_ops(
+      this.opsPtr,
+      this.numWords,
+      this.slotsPtr,
+      this.maxSlots
+    );
+  }
+
+  /** Status escrito por el último `execute()` para el comando `command`. */
+  succeeded(command: number): boolean {
+    const offset = this.commandOffsets[command];
+    if (offset === undefined) {
+      throw new Error(`Unknown command index ${command}.`);
+    }
+    this.refreshViews();
+    return this.opsView[offset + 1] === 1;
+  }
+
+  /** Vacía el flujo de comandos (los slots se conservan). */
+  reset(): void {
+    this.numWords = 0;
+    this.numCommands = 0;
+    this.commandOffsets = [];
+    this.writesManagedOutput = false;
+  }
+
+  /** Libera la memoria WASM. El command buffer no puede usarse después. */
+  dispose(): void {
+    if (!this.module) return;
+    try {
+      this.module._free(this.opsPtr);
+      this.module._free(this.slotsPtr);
+    } catch (e) {
+      console.error("[BufferMgr] Error freeing command buffer:", e);
+    }
+    this.module = null;
+    this.viewBuffer = null;
+  }
+}
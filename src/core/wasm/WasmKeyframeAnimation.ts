@@ -0,0 +1,155 @@
+// src/core/wasm/WasmKeyframeAnimation.ts
+
+import type { Matrix3x3 } from "../../types/core.types";
+import type { MatrixOpsWasmModule } from "./wasm-loader";
+
+/**
+ * Curva de la transición desde un keyframe hasta el siguiente:
+ * - `linear`: interpolación lineal.
+ * - `step`: mantiene el keyframe hasta que llega el siguiente.
+ * - `easeIn` / `easeOut`: cuadráticas.
+ * - `easeInOut`: smoothstep (3u² - 2u³).
+ */
+export type KeyframeEasing =
+  | "linear"
+  | "step"
+  | "easeIn"
+  | "easeOut"
+  | "easeInOut";
+
+/** Códigos de `KeyframeEasing` en keyframe_animation.h. */
+export const KEYFRAME_EASING_CODES: Record<KeyframeEasing, number> = {
+  linear: 0,
+  step: 1,
+  easeIn: 2,
+  easeOut: 3,
+  easeInOut: 4,
+};
+
+export interface Keyframe {
+  time: number;
+  /** Matriz afín del keyframe (sin perspectiva). */
+  matrix: Matrix3x3;
+  /** Curva hacia el siguiente keyframe (por defecto `linear`). */
+  easing?: KeyframeEasing;
+}
+
+/**
+ * Pistas de animación por keyframes en WASM (ver
+ * `WasmBufferManager.createKeyframeAnimation`).
+ *
+ * Al añadir una pista, cada matriz se descompone en traslación, rotación y
+ * estiramiento simétrico (escala + skew) por descomposición polar; los
+ * parámetros se guardan en SoA compacto. `evaluate` interpola todas las pistas
+ * para un tiempo en una sola llamada (rotación por el arco corto) y escribe una
+ * matriz por pista directamente en memoria WASM.
+ */
+export class WasmKeyframeAnimation {
+  private module: MatrixOpsWasmModule | null;
+  private readonly id: number;
+  private trackCount = 0;
+
+  constructor(module: MatrixOpsWasmModule, id: number) {
+    this.module = module;
+    this.id = id;
+  }
+
+  /** Pistas añadidas con `addTrack` (una matriz por pista al evaluar). */
+  get numTracks(): number {
+    return this.trackCount;
+  }
+
+  private ensureModule(): MatrixOpsWasmModule {
+    if (!this.module) {
+      throw new Error("Keyframe animation has been disposed.");
+    }
+    return this.module;
+  }
+
+  /**
+   * Añade una pista.
+   * @param keys Keyframes con tiempos estrictamente crecientes.
+   * @returns Índice de la pista (posición de su matriz al evaluar).
+   * @throws Error si no hay keyframes, los tiempos no crecen, alguna curva no
+   *         existe o alguna matriz tiene perspectiva.
+   */
+  addTrack(keys: readonly Keyframe[]): number {
+    const module = this.ensureModule();
+    const n = keys.length;
+    const easings = keys.map((key) => {
+      const code = KEYFRAME_EASING_CODES[key.easing ?? "linear"];
+      if (code === undefined) {
+        throw new Error(`Unsupported keyframe easing: ${key.easing}.`);
+      }
+      return code;
+    });
+    // Staging temporal: añadir pistas es configuración, no ruta por frame
+    const bytes = Math.max(n, 1) * (9 + 1) * 4 + Math.max(n, 1);
+    const pointer = module._malloc(bytes);
+    if (!pointer) {
+      throw new Error(`Failed to _malloc ${bytes} bytes for keyframes.`);
+    }
+    let track: number;
+    try {
+      const buffer = module.HEAPF32.buffer;
+      const matrices = new Float32Array(buffer, pointer, n * 9);
+      const times = new Float32Array(buffer, pointer + n * 36, n);
+      const codes = new Uint8Array(buffer, pointer + n * 40, n);
+      keys.forEach((key, i) => {
+        matrices.set(key.matrix, i * 9);
+        times[i] = key.time;
+        codes[i] = easings[i];
+      });
+      track = module._animation_add_track(
+        this.id,
+        pointer,
+        pointer + n * 36,
+        pointer + n * 40,
+        n
+      );
+    } finally {
+      module._free(pointer);
+    }
+    if (track === -2) {
+      throw new Error("Keyframe matrices must be affine (no perspective).");
+    }
+    if (track < 0) {
+      throw new Error(
+        "Invalid keyframes: need at least one, with strictly increasing finite times."
+      );
+    }
+    this.trackCount = track + 1;
+    return track;
+  }
+
+  /**
+   * Evalúa todas las pistas en `time` y escribe `numTracks` matrices en
+   * `outputPointer` (memoria WASM). Fuera del rango de una pista se usa su
+   * primer o último keyframe. Normalmente se usa a través de
+   * `WasmBufferManager.evaluateKeyframeAnimationManaged`.
+   * @param layoutCode 0 = AoS (9 floats por matriz), 1 = SoA (9 planos).
+   */
+  evaluate(time: number, outputPointer: number, layoutCode: number): number {
+    const evaluated = this.ensureModule()._animation_evaluate(
+      this.id,
+      time,
+      outputPointer,
+      layoutCode
+    );
+    if (evaluated < 0) {
+      throw new Error(`Invalid keyframe evaluation layout: ${layoutCode}.`);
+    }
+    return evaluated;
+  }
+
+  /** Libera la animación en WASM. No puede usarse después. */
+  dispose(): void {
+    if (!this.module) return;
+    try {
+      this.module._animation_destroy(this.id);
+    } catch (e) {
+      console.error("[BufferMgr] Error destroying keyframe animation:", e);
+    }
+    this.module = null;
+  }
+}
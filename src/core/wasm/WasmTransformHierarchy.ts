@@ -0,0 +1,200 @@
+// src/core/wasm/WasmTransformHierarchy.ts
+
+import type { Matrix3x3 } from "../../types/core.types";
+import type { MatrixOpsWasmModule } from "./wasm-loader";
+
+/** Padre de los nodos raíz. */
+export const HIERARCHY_ROOT = -1;
+
+const IDENTITY = [1, 0, 0, 0, 1, 0, 0, 0, 1];
+
+/**
+ * Buffers xyxy (punteros WASM) cuyos tramos transforma `update` con la matriz
+ * world de cada nodo recalculado. Lo rellena
+ * `WasmBufferManager.updateTransformHierarchyManaged`.
+ */
+export interface HierarchyPointBuffers {
+  inputPointer: number;
+  outputPointer: number;
+  numPoints: number;
+}
+
+interface HierarchyViews {
+  buffer: ArrayBufferLike;
+  local: Float32Array;
+  world: Float32Array;
+  parent: Int32Array;
+  dirty: Uint8Array;
+  ranges: Int32Array;
+}
+
+/**
+ * Jerarquía de transformaciones en WASM (ver
+ * `WasmBufferManager.createTransformHierarchy`).
+ *
+ * Las matrices locales y world viven en memoria WASM en SoA (9 planos de
+ * `capacity` floats). Los nodos se añaden en orden topológico: el padre de un
+ * nodo siempre es un nodo anterior. `setLocal` escribe la matriz y marca el
+ * nodo como sucio; `update` recalcula en una sola llamada las matrices world
+ * de los subárboles sucios, sin alocar ni cruzar JS↔WASM por nodo.
+ */
+export class WasmTransformHierarchy {
+  readonly capacity: number;
+  private module: MatrixOpsWasmModule | null;
+  private readonly id: number;
+  private nodeCount = 0;
+  // Vistas de los arrays de la jerarquía; se recrean si HEAPF32.buffer cambia
+  private views: HierarchyViews | null = null;
+
+  constructor(module: MatrixOpsWasmModule, id: number, capacity: number) {
+    this.module = module;
+    this.id = id;
+    this.capacity = capacity;
+  }
+
+  /** Nodos añadidos con `addNode`. */
+  get numNodes(): number {
+    return this.nodeCount;
+  }
+
+  private ensureViews(): HierarchyViews {
+    if (!this.module) {
+      throw new Error("Transform hierarchy has been disposed.");
+    }
+    const buffer = this.module.HEAPF32.buffer;
+    if (!this.views || this.views.buffer !== buffer) {
+      const m = this.module;
+      const n = this.capacity;
+      this.views = {
+        buffer,
+        local: new Float32Array(buffer, m._hierarchy_local_ptr(this.id), n * 9),
+        world: new Float32Array(buffer, m._hierarchy_world_ptr(this.id), n * 9),
+        parent: new Int32Array(buffer, m._hierarchy_parent_ptr(this.id), n),
+        dirty: new Uint8Array(buffer, m._hierarchy_dirty_ptr(this.id), n),
+        ranges: new Int32Array(buffer, m._hierarchy_ranges_ptr(this.id), n * 2),
+      };
+    }
+    return this.views;
+  }
+
+  private checkNode(node: number): void {
+    if (!Number.isInteger(node) || node < 0 || node >= this.nodeCount) {
+      throw new Error(`Invalid hierarchy node: ${node}.`);
+    }
+  }
+
+  /**
+   * Añade un nodo al final de la jerarquía.
+   * @param parent Nodo padre ya añadido, o `HIERARCHY_ROOT`.
+   * @param local Matriz local inicial (por defecto la identidad).
+   * @returns Índice del nuevo nodo.
+   * @throws Error si la jerarquía está llena o el padre no existe.
+   */
+  addNode(parent: number = HIERARCHY_ROOT, local?: Matrix3x3): number {
+    if (this.nodeCount >= this.capacity) {
+      throw new Error(`Transform hierarchy is full (${this.capacity} nodes).`);
+    }
+    if (parent !== HIERARCHY_ROOT) this.checkNode(parent);
+    const node = this.nodeCount++;
+    const views = this.ensureViews();
+    views.parent[node] = parent;
+    views.ranges[node * 2] = 0;
+    views.ranges[node * 2 + 1] = 0;
+    this.writeLocal(views, node, local ?? IDENTITY);
+    return node;
+  }
+
+  /** Cambia la matriz local del nodo y lo marca como sucio. */
+  setLocal(node: number, local: Matrix3x3): void {
+    this.checkNode(node);
+    this.writeLocal(this.ensureViews(), node, local);
+  }
+
+  private writeLocal(
+    views: HierarchyViews,
+    node: number,
+    local: ArrayLike<number>
+  ): void {
+    for (let k = 0; k < 9; k++) {
+      views.local[k * this.capacity + node] = local[k];
+    }
+    views.dirty[node] = 1;
+  }
+
+  /**
+   * Asocia al nodo los puntos `[start, start + count)` de los buffers
+   * gestionados: `updateTransformHierarchyManaged` los transforma con su
+   * matriz world cada vez que el nodo se recalcula. Marca el nodo como sucio.
+   */
+  setPointRange(node: number, start: number, count: number): void {
+    this.checkNode(node);
+    if (
+      !Number.isInteger(start) ||
+      !Number.isInteger(count) ||
+      start < 0 ||
+      count < 0
+    ) {
+      throw new Error(`Invalid point range: [${start}, ${start + count}).`);
+    }
+    const views = this.ensureViews();
+    views.ranges[node * 2] = start;
+    views.ranges[node * 2 + 1] = count;
+    views.dirty[node] = 1;
+  }
+
+  /** Fuerza el recálculo del nodo y su subárbol en el próximo `update`. */
+  markDirty(node: number): void {
+    this.checkNode(node);
+    this.ensureViews().dirty[node] = 1;
+  }
+
+  /**
+   * Matriz world del nodo tras el último `update`.
+   * @param out Matriz destino opcional (evita alocar).
+   */
+  getWorld(
+    node: number,
+    out: Matrix3x3 = new Float32Array(9) as Matrix3x3
+  ): Matrix3x3 {
+    this.checkNode(node);
+    const { world } = this.ensureViews();
+    for (let k = 0; k < 9; k++) out[k] = world[k * this.capacity + node];
+    return out;
+  }
+
+  /**
+   * Recalcula las matrices world de los nodos sucios y de sus subárboles
+   * (world = world del padre * local) y limpia los flags.
+   * @param points Buffers cuyos tramos por nodo se transforman en la misma pasada.
+   * @returns Número de nodos recalculados.
+   * @throws Error si algún tramo de puntos excede `points.numPoints`.
+   */
+  update(points?: HierarchyPointBuffers): number {
+    this.ensureViews();
+    const updated = this.module!._update_world_matrices(
+      this.id,
+      this.nodeCount,
+      points?.inputPointer ?? 0,
+      points?.outputPointer ?? 0,
+      points?.numPoints ?? 0
+    );
+    if (updated < 0) {
+      throw new Error(
+        `Hierarchy point ranges exceed the ${points?.numPoints ?? 0} points of the buffers.`
+      );
+    }
+    return updated;
+  }
+
+  /** Libera la jerarquía en WASM. No puede usarse después. */
+  dispose(): void {
+    if (!this.module) return;
+    try {
+      this.module._hierarchy_destroy(this.id);
+    } catch (e) {
+      console.error("[BufferMgr] Error destroying transform hierarchy:", e);
+    }
+    this.module = null;
+    this.views = null;
+  }
+}
@@ -0,0 +1,127 @@
+// src/core/wasm/WasmTransformPlan.ts
+
+import type { Matrix3x3 } from "../../types/core.types";
+import type { MatrixOpsWasmModule, WasmMatrixClass } from "./wasm-loader";
+
+/** Layouts de `_plan_create` (igual que `PlanLayout` en transform_plan.h). */
+export const PlanLayoutCode = {
+  Packed: 0,
+  Strided: 1,
+  SoA: 2,
+} as const;
+
+/**
+ * Buffer sobre el que se creó el plan. `pointer` es el puntero actual del
+ * buffer (cambia si crece o se libera); el plan lo compara con el que validó.
+ */
+export interface PlanBufferSource {
+  readonly pointer: number;
+}
+
+/**
+ * Plan de transformación precompilado (ver `WasmBufferManager.createTransformPlan`).
+ *
+ * Layout, punteros, dirección de recorrido y reparto entre workers se validan
+ * una vez al crear el plan. `updateMatrix` escribe la matriz directamente en
+ * el plan y reelige el kernel; `execute` es una sola llamada WASM sin
+ * validaciones ni copias de matriz.
+ *
+ * Si un buffer del plan crece (el bloque se mueve) o se libera, `execute` lanza
+ * un error: hay que crear un plan nuevo.
+ */
+export class WasmTransformPlan {
+  readonly numPoints: number;
+  private module: MatrixOpsWasmModule | null;
+  private readonly id: number;
+  private readonly matrixPtr: number;
+  private readonly sources: PlanBufferSource[];
+  private readonly plannedPointers: number[];
+  private readonly onExecute: (() => void) | null;
+  private matrixClassValue: WasmMatrixClass;
+  // Vista de la matriz del plan; se recrea si HEAPF32.buffer cambia
+  private matrixView: Float32Array | null = null;
+
+  /**
+   * @param onExecute Se llama antes de cada `execute()`; el gestor lo pasa si
+   *   el plan escribe en sus buffers gestionados (invalida la incremental).
+   */
+  constructor(
+    module: MatrixOpsWasmModule,
+    id: number,
+    numPoints: number,
+    sources: PlanBufferSource[],
+    onExecute: (() => void) | null = null
+  ) {
+    this.module = module;
+    this.id = id;
+    this.numPoints = numPoints;
+    this.matrixPtr = module._plan_matrix_ptr(id);
+    this.sources = sources;
+    this.plannedPointers = sources.map((source) => source.pointer);
+    this.onExecute = onExecute;
+    this.matrixClassValue = 0;
+  }
+
+  private ensureModule(): MatrixOpsWasmModule {
+    if (!this.module) {
+      throw new Error("Transform plan has been disposed.");
+    }
+    return this.module;
+  }
+
+  /** Clase de la matriz actual (decide el kernel que usa `execute`). */
+  get matrixClass(): WasmMatrixClass {
+    return this.matrixClassValue;
+  }
+
+  /**
+   * Cambia la matriz del plan: se copia al plan, se re-splattean los
+   * coeficientes y se reelige el kernel. También recoge el modo de precisión
+   * activo (`setTransformPrecision`).
+   * @returns La clase de la nueva matriz.
+   */
+  updateMatrix(matrix: Matrix3x3): WasmMatrixClass {
+    const module = this.ensureModule();
+    if (!this.matrixView || this.matrixView.buffer !== module.HEAPF32.buffer) {
+      this.matrixView = new Float32Array(
+        module.HEAPF32.buffer,
+        this.matrixPtr,
+        9
+      );
+    }
+    this.matrixView.set(matrix);
+    this.matrixClassValue = module._plan_update_matrix(
+      this.id
+    ) as WasmMatrixClass;
+    return this.matrixClassValue;
+  }
+
+  /**
+   * Ejecuta el plan con la última matriz.
+   * @throws Error si el plan se liberó o algún buffer cambió de bloque.
+   */
+  execute(): void {
+    const module = this.ensureModule();
+    for (let k = 0; k < this.sources.length; k++) {
+      if (this.sources[k].pointer !== this.plannedPointers[k]) {
+        throw new Error(
+          "Transform plan is stale: a planned buffer was resized or released."
+        );
+      }
+    }
+    this.onExecute?.();
+    module._plan_execute(this.id);
+  }
+
+  /** Libera el plan en WASM. No puede usarse después. */
+  dispose(): void {
+    if (!this.module) return;
+    try {
+      this.module._plan_destroy(this.id);
+    } catch (e) {
+      console.error("[BufferMgr] Error destroying transform plan:", e);
+    }
+    this.module = null;
+    this.matrixView = null;
+  }
+}
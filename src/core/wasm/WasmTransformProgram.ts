@@ -0,0 +1,228 @@
+// src/core/wasm/WasmTransformProgram.ts
+
+import type {
+  CustomTransformCommand,
+  PerspectiveCommand,
+  RotateCommand,
+  ScaleCommand,
+  SkewCommand,
+  TransformCommand,
+  TranslateCommand,
+} from "../commands";
+import type { MatrixOpsWasmModule } from "./wasm-loader";
+
+/** Opcodes de `evaluate_transform_programs` (deben coincidir con `TransformOp`). */
+const TransformOp = {
+  End: 0,
+  Translate: 1,
+  Rotate: 2,
+  Scale: 3,
+  Skew: 4,
+  Matrix: 5,
+  PostMatrix: 6,
+  Reset: 7,
+} as const;
+
+export interface WasmTransformProgramOptions {
+  /** Palabras de 32 bits máximas del programa. */
+  maxWords?: number;
+}
+
+/**
+ * Secuencias de `TransformCommand` compiladas a bytecode en memoria WASM.
+ *
+ * `addSequence` codifica una secuencia (lo que plegaría `MatrixUtils.combine`)
+ * como palabras de 32 bits: un opcode int32 seguido de sus argumentos f32.
+ * `WasmBufferManager.evaluateTransformProgramManaged` pliega después todas
+ * las secuencias en una sola llamada WASM, una matriz por secuencia, sin
+ * alocar matrices por comando. La inversa de cada `PerspectiveCommand` se
+ * calcula una vez (queda cacheada en el comando) y se guarda en el programa.
+ */
+export class WasmTransformProgram {
+  private readonly maxWords: number;
+  private readonly codePtr: number;
+  private numWords = 0;
+  private numSequences = 0;
+
+  // Vistas int32/f32 sobre el mismo código; se recrean si HEAPF32.buffer cambia
+  private viewBuffer: ArrayBufferLike | null = null;
+  private words!: Int32Array;
+  private floats!: Float32Array;
+  private module: MatrixOpsWasmModule | null;
+
+  constructor(
+    module: MatrixOpsWasmModule,
+    options: WasmTransformProgramOptions = {}
+  ) {
+    this.maxWords = options.maxWords ?? 16384;
+    if (!Number.isInteger(this.maxWords) || this.maxWords <= 0) {
+      throw new Error("Transform program capacity must be positive.");
+    }
+    this.codePtr = module._malloc(this.maxWords * 4);
+    if (!this.codePtr) {
+      throw new Error("Failed to _malloc transform program memory.");
+    }
+    this.module = module;
+  }
+
+  /** Secuencias codificadas desde el último `reset()` (una matriz cada una). */
+  get sequenceCount(): number {
+    return this.numSequences;
+  }
+
+  /** Palabras de 32 bits ocupadas por el programa. */
+  get wordCount(): number {
+    return this.numWords;
+  }
+
+  private ensureModule(): MatrixOpsWasmModule {
+    if (!this.module) {
+      throw new Error("Transform program has been disposed.");
+    }
+    return this.module;
+  }
+
+  private refreshViews(): void {
+    const buffer = this.ensureModule().HEAPF32.buffer;
+    if (buffer === this.viewBuffer) return;
+    this.words = new Int32Array(buffer, this.codePtr, this.maxWords);
+    this.floats = new Float32Array(buffer, this.codePtr, this.maxWords);
+    this.viewBuffer = buffer;
+  }
+
+  /** Escribe el opcode y devuelve la palabra del primer argumento. */
+  private emit(opcode: number, numArgs: number): number {
+    if (this.numWords + 1 + numArgs > this.maxWords) {
+      throw new Error(`Transform program full (${this.maxWords} words).`);
+    }
+    this.words[this.numWords] = opcode;
+    const args = this.numWords + 1;
+    this.numWords += 1 + numArgs;
+    return args;
+  }
+
+  private emitMatrix(opcode: number, m: ArrayLike<number>): void {
+    const at = this.emit(opcode, 9);
+    for (let k = 0; k < 9; k++) this.floats[at + k] = m[k];
+  }
+
+  private encodeCommand(cmd: TransformCommand): void {
+    const f = this.floats;
+    switch (cmd?.name) {
+      case "translate": {
+        const { dx, dy } = (cmd as TranslateCommand).toJSON();
+        const at = this.emit(TransformOp.Translate, 2);
+        f[at] = dx;
+        f[at + 1] = dy;
+        break;
+      }
+      case "rotate": {
+        const { angle, center } = (cmd as RotateCommand).toJSON();
+        const at = this.emit(TransformOp.Rotate, 3);
+        f[at] = angle;
+        f[at + 1] = center?.x ?? 0;
+        f[at + 2] = center?.y ?? 0;
+        break;
+      }
+      case "scale": {
+        const { sx, sy, center } = (cmd as ScaleCommand).toJSON();
+        const at = this.emit(TransformOp.Scale, 4);
+        f[at] = sx;
+        f[at + 1] = sy;
+        f[at + 2] = center?.x ?? 0;
+        f[at + 3] = center?.y ?? 0;
+        break;
+      }
+      case "skew": {
+        const { skewX, skewY } = (cmd as SkewCommand).toJSON();
+        const at = this.emit(TransformOp.Skew, 2);
+        f[at] = skewX;
+        f[at + 1] = skewY;
+        break;
+      }
+      case "custom":
+        this.emitMatrix(
+          TransformOp.Matrix,
+          (cmd as CustomTransformCommand).toJSON().matrix
+        );
+        break;
+      case "perspective":
+        this.emitMatrix(
+          TransformOp.PostMatrix,
+          (cmd as PerspectiveCommand).getInverseHomographyMatrix()
+        );
+        break;
+      case "crop":
+      case "resize":
+        this.emit(TransformOp.Reset, 0);
+        break;
+      default:
+        throw new Error(`Unsupported transform command: ${cmd?.name}.`);
+    }
+  }
+
+  /**
+   * Codifica una secuencia de comandos, en el orden en que `MatrixUtils.combine`
+   * los aplicaría. Si falla no queda nada de la secuencia en el programa.
+   * @returns Índice de la secuencia (posición de su matriz al evaluar).
+   * @throws Error si algún comando no es de los tipos del núcleo, la
+   *         homografía de un `PerspectiveCommand` es singular o el programa se llena.
+   */
+  addSequence(commands: readonly TransformCommand[]): number {
+    this.refreshViews();
+    const start = this.numWords;
+    try {
+      for (const cmd of commands) this.encodeCommand(cmd);
+      this.emit(TransformOp.End, 0);
+    } catch (e) {
+      this.numWords = start;
+      throw e;
+    }
+    return this.numSequences++;
+  }
+
+  /** Vacía el programa (la memoria se conserva). */
+  reset(): void {
+    this.numWords = 0;
+    this.numSequences = 0;
+  }
+
+  /**
+   * Pliega todas las secuencias y escribe `sequenceCount` matrices en
+   * `outputPointer` (memoria WASM). Normalmente se usa a través de
+   * `WasmBufferManager.evaluateTransformProgramManaged`.
+   * @param maxMatrices Capacidad de la salida; en SoA, floats por plano.
+   * @param layoutCode 0 = AoS (9 floats por matriz), 1 = SoA (9 planos).
+   */
+  evaluate(
+    outputPointer: number,
+    maxMatrices: number,
+    layoutCode: number
+  ): number {
+    const evaluated = this.ensureModule()._evaluate_transform_programs(
+      this.codePtr,
+      this.numWords,
+      outputPointer,
+      maxMatrices,
+      layoutCode
+    );
+    if (evaluated < 0) {
+      throw new Error(
+        `Failed to evaluate transform program (${this.numSequences} sequences, capacity ${maxMatrices}).`
+      );
+    }
+    return evaluated;
+  }
+
+  /** Libera la memoria WASM. El programa no puede usarse después. */
+  dispose(): void {
+    if (!this.module) return;
+    try {
+      this.module._free(this.codePtr);
+    } catch (e) {
+      console.error("[BufferMgr] Error freeing transform program:", e);
+    }
+    this.module = null;
+    this.viewBuffer = null;
+  }
+}
@@ -0,0 +1,446 @@
+// src/core/wasm/WasmWorkerPipeline.ts
+
+import type { Matrix3x3 } from "../../types/core.types";
+import {
+  detectWasmFeatures,
+  getCompiledWasmModule,
+  getWasmDiagnostics,
+  getWasmModuleUrls,
+  getWasmVariantCandidates,
+} from "./wasm-loader";
+import type { WasmModuleVariant } from "./wasm-loader";
+
+// --- Layout de la Memoria Compartida ---
+// Control: [CONTROL_INTS int32][un descriptor por slot]. Los puntos viven en el
+// heap WASM del worker si es compartido (build `threads`); si no, en un
+// SharedArrayBuffer de staging [entradas][salidas] que el worker copia.
+// Palabras de control y campos del descriptor (igual que en transform-worker.js)
+const CONTROL_SUBMITTED = 0; // Id del último job publicado (hilo principal)
+const CONTROL_COMPLETED = 1; // Id del último job terminado (worker)
+const CONTROL_STOP = 2;
+const CONTROL_SIGNAL = 3; // Contador para despertar al worker (Atomics.wait)
+const CONTROL_INTS = 8;
+const JOB_POINTS = 0;
+const JOB_MATRIX = 4; // 9 floats
+const DESCRIPTOR_INTS = 16;
+
+// Espera máxima de cada Atomics.waitAsync, para detectar que el worker murió
+const WAIT_TIMEOUT_MS = 1000;
+
+/** Buffers de entrada/salida de los slots: offsets en `buffer`. */
+interface PipelineSlots {
+  buffer: ArrayBufferLike;
+  inputOffsets: number[];
+  outputOffsets: number[];
+}
+
+/** Layout que recibe el worker en el mensaje "init". */
+interface PipelineLayout {
+  maxPoints: number;
+  slots: number;
+  controlInts: number;
+  descriptorOffset: number;
+  descriptorInts: number;
+  /** Sin heap compartido: slots en un SharedArrayBuffer aparte. */
+  staging: PipelineSlots | null;
+}
+
+/** Worker del navegador o de worker_threads, con la misma interfaz mínima. */
+interface PipelineWorker {
+  post(message: unknown): void;
+  onMessage(listener: (message: WorkerReply) => void): void;
+  onError(listener: (error: unknown) => void): void;
+  terminate(): void;
+}
+
+/** "ready" lleva el heap y los offsets de los slots si el heap es compartido. */
+type WorkerReply =
+  | {
+      type: "ready";
+      heap?: SharedArrayBuffer;
+      inputOffsets?: number[];
+      outputOffsets?: number[];
+    }
+  | { type: "error"; message: string };
+
+// Atomics.waitAsync (ES2024) aún no está en la lib ES2020 del proyecto
+type AtomicsWaitAsync = (
+  array: Int32Array,
+  index: number,
+  value: number,
+  timeout?: number
+) => { async: boolean; value: Promise<string> | string };
+
+/**
+ * Build del worker: la pedida o, por defecto, `threads` (heap compartido) si el
+ * motor la soporta, y si no la del módulo por defecto (o la primera candidata
+ * que exista, como en `loadWasmModule`).
+ */
+async function loadWorkerModule(requested?: WasmModuleVariant): Promise<{
+  variant: WasmModuleVariant;
+  wasmModule: WebAssembly.Module;
+}> {
+  const loaded = getWasmDiagnostics()?.variant;
+  const candidates: WasmModuleVariant[] = requested
+    ? [requested]
+    : [
+        ...(detectWasmFeatures().threads ? ["threads" as const] : []),
+        ...(loaded ? [loaded] : getWasmVariantCandidates()),
+      ];
+  let failure: unknown = null;
+  for (const variant of candidates) {
+    try {
+      return { variant, wasmModule: await getCompiledWasmModule(variant) };
+    } catch (error) {
+      failure = error; // Build no generada: probar la siguiente
+    }
+  }
+  throw failure;
+}
+
+async function spawnWorker(): Promise<PipelineWorker> {
+  if (typeof Worker !== "undefined") {
+    // URL literal para que Vite empaquete el worker
+    const worker = new Worker(
+      new URL("./transform-worker.js", import.meta.url),
+      { type: "module" }
+    );
+    return {
+      post: (message) => worker.postMessage(message),
+      onMessage: (listener) =>
+        worker.addEventListener("message", (event) => listener(event.data)),
+      onError: (listener) => worker.addEventListener("error", listener),
+      terminate: () => worker.terminate(),
+    };
+  }
+  // Especificador en variable para que Vite no intente resolverlo en el navegador
+  const workerThreads = "node:worker_threads";
+  const { Worker: NodeWorker } = await import(
+    /* @vite-ignore */ workerThreads
+  );
+  const worker = new NodeWorker(
+    new URL("./transform-worker.js", import.meta.url)
+  );
+  return {
+    post: (message) => worker.postMessage(message),
+    onMessage: (listener) => worker.on("message", listener),
+    onError: (listener) => {
+      worker.on("error", listener);
+      worker.on("exit", (code: number) =>
+        listener(new Error(`Transform worker exited with code ${code}.`))
+      );
+    },
+    terminate: () => void worker.terminate(),
+  };
+}
+
+/** Opciones de `WasmWorkerPipeline.create`. */
+export interface WasmWorkerPipelineOptions {
+  /** Puntos máximos por job (tamaño de cada buffer de entrada y salida). */
+  maxPoints: number;
+  /**
+   * Juegos de buffers entrada/salida (slots). Con 2 (por defecto) el frame
+   * N+1 se transforma mientras se dibuja el N.
+   */
+  buffers?: number;
+  /**
+   * Build que carga el worker. Por defecto `threads` si el motor la soporta y
+   * existe (heap compartido, sin copias); si no, la del módulo por defecto.
+   */
+  variant?: WasmModuleVariant;
+}
+
+/**
+ * Transformación de puntos en un worker dedicado, sin bloquear el hilo
+ * principal.
+ *
+ * El worker tiene su propia instancia WASM. Cada job se publica en el
+ * descriptor de su slot dentro de un SharedArrayBuffer (sin postMessage por
+ * frame) y los slots forman un doble buffer: mientras el worker transforma el
+ * frame N+1 en uno, el frame N se dibuja desde la salida del otro.
+ *
+ * Con la build `threads` el heap WASM del worker es un SharedArrayBuffer: los
+ * slots se alocan en él, `nextInput()` y `result()` son vistas de ese heap y
+ * el worker transforma sin copiar nada (`sharedHeap`). Con las demás builds
+ * los puntos pasan por buffers compartidos de staging, con una copia de
+ * entrada y otra de salida por job.
+ *
+ * Uso por frame:
+ * ```ts
+ * pipeline.nextInput(n).set(points);    // entrada del siguiente slot
+ * const job = pipeline.submit(matrix, n); // no bloquea
+ * if (prev) draw(await pipeline.result(prev));
+ * prev = job;
+ * ```
+ * La salida de un job sigue válida hasta que se envía el job `buffers`
+ * posiciones después (el que reutiliza su slot).
+ *
+ * Requiere SharedArrayBuffer: aislamiento cross-origin (COOP/COEP) en el
+ * navegador; en Node usa worker_threads.
+ */
+export class WasmWorkerPipeline {
+  readonly maxPoints: number;
+  readonly buffers: number;
+  /** `true` si los slots están en el heap WASM del worker (sin copias). */
+  readonly sharedHeap: boolean;
+  private worker: PipelineWorker | null;
+  private readonly control: Int32Array;
+  private readonly descInts: Int32Array;
+  private readonly descFloats: Float32Array;
+  private readonly inputs: Float32Array[];
+  private readonly outputs: Float32Array[];
+  // Puntos del último job de cada slot
+  private readonly slotPoints: number[];
+  private lastJob = 0;
+  private failure: Error | null = null;
+
+  private constructor(
+    worker: PipelineWorker,
+    control: SharedArrayBuffer,
+    layout: PipelineLayout,
+    slots: PipelineSlots
+  ) {
+    this.worker = worker;
+    this.maxPoints = layout.maxPoints;
+    this.buffers = layout.slots;
+    this.sharedHeap = layout.staging === null;
+    this.control = new Int32Array(control, 0, CONTROL_INTS);
+    const length = layout.slots * DESCRIPTOR_INTS;
+    this.descInts = new Int32Array(control, layout.descriptorOffset, length);
+    this.descFloats = new Float32Array(
+      control,
+      layout.descriptorOffset,
+      length
+    );
+    const floats = layout.maxPoints * 2;
+    this.inputs = slots.inputOffsets.map(
+      (offset) => new Float32Array(slots.buffer, offset, floats)
+    );
+    this.outputs = slots.outputOffsets.map(
+      (offset) => new Float32Array(slots.buffer, offset, floats)
+    );
+    this.slotPoints = new Array(this.buffers).fill(0);
+    worker.onError((error) => {
+      if (this.failure) return;
+      this.failure = error instanceof Error ? error : new Error(String(error));
+    });
+  }
+
+  /**
+   * Arranca el worker, le envía el módulo ya compilado (`getCompiledWasmModule`)
+   * y espera a que esté listo.
+   * @throws Error si no hay SharedArrayBuffer o el worker no arranca.
+   */
+  static async create(
+    options: WasmWorkerPipelineOptions
+  ): Promise<WasmWorkerPipeline> {
+    const { maxPoints, buffers = 2 } = options;
+    if (!Number.isInteger(maxPoints) || maxPoints <= 0) {
+      throw new Error(`Invalid maxPoints: ${maxPoints}`);
+    }
+    if (!Number.isInteger(buffers) || buffers < 2) {
+      throw new Error(`Invalid buffer count: ${buffers} (min 2).`);
+    }
+    if (
+      typeof SharedArrayBuffer === "undefined" ||
+      (typeof crossOriginIsolated !== "undefined" && !crossOriginIsolated)
+    ) {
+      throw new Error(
+        "WasmWorkerPipeline requires SharedArrayBuffer (cross-origin isolation in browsers)."
+      );
+    }
+    const { variant, wasmModule } = await loadWorkerModule(options.variant);
+
+    const descriptorOffset = CONTROL_INTS * Int32Array.BYTES_PER_ELEMENT;
+    const descriptorBytes = DESCRIPTOR_INTS * Int32Array.BYTES_PER_ELEMENT;
+    const control = new SharedArrayBuffer(
+      descriptorOffset + buffers * descriptorBytes
+    );
+    // Solo las builds sin heap compartido necesitan staging
+    let staging: PipelineSlots | null = null;
+    if (variant !== "threads") {
+      const pointBytes = maxPoints * 2 * Float32Array.BYTES_PER_ELEMENT;
+      staging = {
+        buffer: new SharedArrayBuffer(2 * buffers * pointBytes),
+        inputOffsets: [],
+        outputOffsets: [],
+      };
+      for (let k = 0; k < buffers; k++) {
+        staging.inputOffsets.push(k * pointBytes);
+        staging.outputOffsets.push((buffers + k) * pointBytes);
+      }
+    }
+    const layout: PipelineLayout = {
+      maxPoints,
+      slots: buffers,
+      controlInts: CONTROL_INTS,
+      descriptorOffset,
+      descriptorInts: DESCRIPTOR_INTS,
+      staging,
+    };
+
+    const worker = await spawnWorker();
+    const ready = new Promise<PipelineSlots>((resolve, reject) => {
+      worker.onMessage((reply) => {
+        if (reply.type === "error") {
+          reject(new Error(`Transform worker failed: ${reply.message}`));
+        } else if (staging) {
+          resolve(staging);
+        } else if (reply.heap && reply.inputOffsets && reply.outputOffsets) {
+          resolve({
+            buffer: reply.heap,
+            inputOffsets: reply.inputOffsets,
+            outputOffsets: reply.outputOffsets,
+          });
+        } else {
+          reject(new Error("Transform worker did not share its WASM heap."));
+        }
+      });
+      worker.onError(reject);
+    });
+    worker.post({
+      type: "init",
+      buffer: control,
+      layout,
+      wasmModule,
+      glueUrl: getWasmModuleUrls(variant).js,
+    });
+    let slots: PipelineSlots;
+    try {
+      slots = await ready;
+    } catch (error) {
+      worker.terminate();
+      throw error;
+    }
+    return new WasmWorkerPipeline(worker, control, layout, slots);
+  }
+
+  private ensureOpen(): void {
+    if (!this.worker) throw new Error("Worker pipeline has been disposed.");
+    if (this.failure) throw this.failure;
+  }
+
+  private slotOf(job: number): number {
+    return (job - 1) % this.buffers;
+  }
+
+  /**
+   * Vista de entrada del slot que usará el siguiente `submit`. Escribe ahí los
+   * puntos (xyxy) antes de enviarlo.
+   * @throws Error si el job anterior de ese slot aún no terminó.
+   */
+  nextInput(numPoints: number = this.maxPoints): Float32Array {
+    this.ensureOpen();
+    const job = this.lastJob + 1;
+    this.ensureSlotFree(job);
+    this.validatePoints(numPoints);
+    return this.inputs[this.slotOf(job)].subarray(0, numPoints * 2);
+  }
+
+  /**
+   * Publica un job con la entrada ya escrita en `nextInput()`. No bloquea.
+   * @returns Id del job, para `isDone`/`result`.
+   */
+  submit(matrix: Matrix3x3, numPoints: number): number {
+    this.ensureOpen();
+    this.validatePoints(numPoints);
+    const job = this.lastJob + 1;
+    this.ensureSlotFree(job);
+    const slot = this.slotOf(job);
+
+    // El slot está libre (ensureSlotFree): el worker ya no lee su descriptor
+    const base = slot * DESCRIPTOR_INTS;
+    this.descInts[base + JOB_POINTS] = numPoints;
+    this.descFloats.set(matrix, base + JOB_MATRIX);
+    this.slotPoints[slot] = numPoints;
+    this.lastJob = job;
+    // El store atómico publica el descriptor y la entrada escritos antes
+    Atomics.store(this.control, CONTROL_SUBMITTED, job);
+    Atomics.add(this.control, CONTROL_SIGNAL, 1);
+    Atomics.notify(this.control, CONTROL_SIGNAL);
+    return job;
+  }
+
+  /** `true` si el worker ya terminó el job. */
+  isDone(job: number): boolean {
+    return Atomics.load(this.control, CONTROL_COMPLETED) >= job;
+  }
+
+  /**
+   * Espera (sin bloquear el hilo) a que termine el job y devuelve su salida,
+   * una vista del buffer compartido válida hasta que se reutilice su slot.
+   * @throws Error si el job no existe, ya se sobrescribió o el worker falló.
+   */
+  async result(job: number): Promise<Float32Array> {
+    if (!Number.isInteger(job) || job <= 0 || job > this.lastJob) {
+      throw new Error(`Unknown worker job ${job}.`);
+    }
+    if (job <= this.lastJob - this.buffers) {
+      throw new Error(`Output of worker job ${job} was already overwritten.`);
+    }
+    const waitAsync = (Atomics as { waitAsync?: AtomicsWaitAsync }).waitAsync;
+    while (!this.isDone(job)) {
+      this.ensureOpen();
+      const completed = Atomics.load(this.control, CONTROL_COMPLETED);
+      if (waitAsync) {
+        const wait = waitAsync(
+          this.control,
+          CONTROL_COMPLETED,
+          completed,
+          WAIT_TIMEOUT_MS
+        );
+        if (wait.async) await wait.value;
+      } else {
+        // Sin waitAsync (p. ej. Firefox): sondeo cediendo el hilo
+        await new Promise((resolve) => setTimeout(resolve, 0));
+      }
+    }
+    const slot = this.slotOf(job);
+    return this.outputs[slot].subarray(0, this.slotPoints[slot] * 2);
+  }
+
+  /**
+   * Copia `points`, lo transforma en el worker y espera el resultado. Útil
+   * fuera de un bucle por frames; para pipelining usar `submit`/`result`.
+   */
+  async transform(
+    matrix: Matrix3x3,
+    points: Float32Array
+  ): Promise<Float32Array> {
+    const numPoints = points.length / 2;
+    if (this.lastJob > 0) await this.result(this.lastJob);
+    this.nextInput(numPoints).set(points);
+    return this.result(this.submit(matrix, numPoints));
+  }
+
+  /** Detiene el worker. El pipeline no puede usarse después. */
+  dispose(): void {
+    if (!this.worker) return;
+    Atomics.store(this.control, CONTROL_STOP, 1);
+    Atomics.add(this.control, CONTROL_SIGNAL, 1);
+    Atomics.notify(this.control, CONTROL_SIGNAL);
+    this.worker.terminate();
+    this.worker = null;
+  }
+
+  private ensureSlotFree(job: number): void {
+    const previous = job - this.buffers;
+    if (previous > 0 && !this.isDone(previous)) {
+      throw new Error(
+        `Worker buffer busy: job ${previous} has not finished (await result() first).`
+      );
+    }
+  }
+
+  private validatePoints(numPoints: number): void {
+    if (
+      !Number.isInteger(numPoints) ||
+      numPoints < 0 ||
+      numPoints > this.maxPoints
+    ) {
+      throw new Error(
+        `Invalid point count ${numPoints} (pipeline holds ${this.maxPoints}).`
+      );
+    }
+  }
+}
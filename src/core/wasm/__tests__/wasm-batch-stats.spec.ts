@@ -0,0 +1,125 @@
+// src/core/wasm/__tests__/wasm-batch-stats.spec.ts
+
+import { describe, it, expect, beforeAll, afterAll } from "vitest";
+import { WasmBufferManager } from "../WasmBufferManager";
+import { cleanupWasm } from "../wasm-loader";
+import { MatrixUtils } from "../../matrix/MatrixUtils";
+import type { Matrix3x3 } from "../../../types/core.types";
+
+// Referencia JS: recorre la salida como hacía el código de culling
+function referenceStats(output: Float32Array, numPoints: number) {
+  let minX = Infinity,
+    minY = Infinity,
+    maxX = -Infinity,
+    maxY = -Infinity,
+    sumX = 0,
+    sumY = 0,
+    valid = 0;
+  for (let i = 0; i < numPoints; i++) {
+    const x = output[i * 2];
+    const y = output[i * 2 + 1];
+    if (isNaN(x) || isNaN(y)) continue;
+    minX = Math.min(minX, x);
+    minY = Math.min(minY, y);
+    maxX = Math.max(maxX, x);
+    maxY = Math.max(maxY, y);
+    sumX += x;
+    sumY += y;
+    valid++;
+  }
+  return {
+    minX,
+    minY,
+    maxX,
+    maxY,
+    centroidX: sumX / valid,
+    centroidY: sumY / valid,
+    validCount: valid,
+  };
+}
+
+describe("WasmBufferManager - fused transform + stats", () => {
+  const manager = new WasmBufferManager();
+
+  beforeAll(async () => {
+    await manager.initialize();
+  });
+
+  afterAll(async () => {
+    await manager.cleanup();
+    await cleanupWasm();
+  });
+
+  async function prepare(numPoints: number) {
+    const input = await manager.getInputBuffer(numPoints);
+    await manager.getOutputBuffer(numPoints);
+    for (let i = 0; i < numPoints * 2; i++)
+      input.view[i] = ((i * 37) % 101) - 50;
+    return input.view;
+  }
+
+  const CASES: { name: string; matrix: Matrix3x3 }[] = [
+    { name: "identity", matrix: MatrixUtils.identity() },
+    {
+      name: "affine",
+      matrix: MatrixUtils.fromValues(1, 0.4, 0, -0.3, 1.2, 0, 5, -3, 1),
+    },
+    {
+      // W = 1 + 0.02 * x: se anula en x = -50 (puntos degenerados)
+      name: "projective with degenerate points",
+      matrix: MatrixUtils.fromValues(1, 0, 0.02, 0, 1, 0, 0, 0, 1),
+    },
+  ];
+
+  CASES.forEach(({ name, matrix }) => {
+    it(`should match a JS pass over the output for ${name}`, async () => {
+      const numPoints = 203; // incluye residuo escalar
+      await prepare(numPoints);
+
+      const stats = await manager.transformPointsBatchStatsManaged(
+        matrix,
+        numPoints
+      );
+
+      const output = manager.getOutputView(numPoints)!;
+      const ref = referenceStats(output, numPoints);
+      expect(stats.validCount).toBe(ref.validCount);
+      expect(stats.invalidCount).toBe(numPoints - ref.validCount);
+      expect(stats.minX).toBe(ref.minX);
+      expect(stats.minY).toBe(ref.minY);
+      expect(stats.maxX).toBe(ref.maxX);
+      expect(stats.maxY).toBe(ref.maxY);
+      expect(stats.centroidX).toBeCloseTo(ref.centroidX, 3);
+      expect(stats.centroidY).toBeCloseTo(ref.centroidY, 3);
+    });
+  });
+
+  it("should count degenerate points produced by near-zero W", async () => {
+    const numPoints = 8;
+    const input = await prepare(numPoints);
+    input.set([-50, 0, 0, 0, 10, 1, -50, 7, 1, 1, 2, 2, 3, 3, 4, 4]);
+
+    const stats = await manager.transformPointsBatchStatsManaged(
+      CASES[2].matrix,
+      numPoints
+    );
+
+    expect(stats.invalidCount).toBe(2);
+    expect(stats.validCount).toBe(6);
+  });
+
+  it("should report NaN bounds when no point is valid", async () => {
+    const input = await prepare(4);
+    input.set([-50, 0, -50, 1, -50, 2, -50, 3]);
+
+    const stats = await manager.transformPointsBatchStatsManaged(
+      CASES[2].matrix,
+      4
+    );
+
+    expect(stats.validCount).toBe(0);
+    expect(stats.invalidCount).toBe(4);
+    expect(stats.minX).toBeNaN();
+    expect(stats.centroidX).toBeNaN();
+  });
+});
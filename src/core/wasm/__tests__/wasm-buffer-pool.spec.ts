@@ -0,0 +1,100 @@
+// src/core/wasm/__tests__/wasm-buffer-pool.spec.ts
+
+import { describe, it, expect, beforeAll, afterAll } from "vitest";
+import { WasmBufferManager } from "../WasmBufferManager";
+import { cleanupWasm, loadWasmModule } from "../wasm-loader";
+import { expectTransformed, TEST_AFFINE } from "../../__tests__/testUtils";
+
+describe("WasmBufferManager - pooled handle buffers", () => {
+  const manager = new WasmBufferManager();
+
+  beforeAll(async () => {
+    await manager.initialize();
+  });
+
+  afterAll(async () => {
+    await manager.cleanup();
+    await cleanupWasm();
+  });
+
+  it("should transform between handle buffers", async () => {
+    const numPoints = 101;
+    const input = manager.allocBuffer(numPoints);
+    const output = manager.allocBuffer(numPoints);
+    expect(input).toBeGreaterThan(0);
+    expect(output).not.toBe(input);
+    expect(manager.getBufferCapacity(input)).toBeGreaterThanOrEqual(numPoints);
+
+    const view = manager.getBufferView(input, "f32", numPoints);
+    for (let i = 0; i < numPoints * 2; i++) view[i] = (i % 13) - 6;
+    await manager.transformPointsHandles(TEST_AFFINE, input, output, numPoints);
+
+    const result = manager.getBufferView(output, "f32", numPoints);
+    expectTransformed(TEST_AFFINE, view, result, undefined, 4);
+    manager.releaseBuffer(input);
+    manager.releaseBuffer(output);
+    expect(() => manager.getBufferView(input)).toThrow(/handle/);
+  });
+
+  it("should keep the handle and contents when growing", () => {
+    const handle = manager.allocBuffer(10);
+    manager.getBufferView(handle, "f32", 10).set([1, 2, 3, 4]);
+    manager.resizeBuffer(handle, 5000);
+    expect(manager.getBufferCapacity(handle)).toBeGreaterThanOrEqual(5000);
+    const view = manager.getBufferView(handle, "f32", 5000);
+    expect(Array.from(view.subarray(0, 4))).toEqual([1, 2, 3, 4]);
+    manager.releaseBuffer(handle);
+  });
+
+  it("should reuse freed blocks instead of calling malloc again", () => {
+    const warm = manager.allocBuffer(1000);
+    manager.releaseBuffer(warm);
+    const before = manager.getPoolStats();
+    for (let k = 0; k < 100; k++) {
+      const handle = manager.allocBuffer(900 + k);
+      manager.releaseBuffer(handle);
+    }
+    const after = manager.getPoolStats();
+    expect(after.systemAllocs).toBe(before.systemAllocs);
+    expect(after.reuseHits - before.reuseHits).toBe(100);
+  });
+
+  it("should recycle the frame arena without new allocations", () => {
+    const frame = () => {
+      manager.beginFrame();
+      const handles = [];
+      for (let k = 0; k < 8; k++) handles.push(manager.allocFrameBuffer(4096));
+      handles.forEach((h) => manager.getBufferView(h).fill(1));
+      return handles;
+    };
+    const first = frame();
+    frame();
+    const before = manager.getPoolStats();
+    const last = frame();
+    for (let k = 0; k < 20; k++) frame();
+    expect(manager.getPoolStats().systemAllocs).toBe(before.systemAllocs);
+    expect(() => manager.getBufferView(first[0])).toThrow(/handle/);
+    expect(manager.getPoolStats().arenaUsed).toBeGreaterThan(0);
+    expect(last.length).toBe(8);
+  });
+
+  it("should refresh views after the WASM memory grows", async () => {
+    const module = await loadWasmModule();
+    const handle = manager.allocBuffer(16);
+    const managed = await manager.getInputBuffer(16);
+    manager.getBufferView(handle).set([7, 8]);
+    managed.view.set([5, 6]);
+
+    const before = module.HEAPF32.buffer;
+    // Forzar crecimiento de memoria (ALLOW_MEMORY_GROWTH) con una alocación grande
+    const ptr = module._malloc(64 * 1024 * 1024);
+    expect(module.HEAPF32.buffer).not.toBe(before);
+
+    expect(manager.getBufferView(handle).buffer).toBe(module.HEAPF32.buffer);
+    expect(manager.getBufferView(handle)[1]).toBe(8);
+    expect(managed.view.buffer).toBe(module.HEAPF32.buffer);
+    expect(managed.view[1]).toBe(6);
+    module._free(ptr);
+    manager.releaseBuffer(handle);
+  });
+});
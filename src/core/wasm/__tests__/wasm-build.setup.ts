@@ -0,0 +1,60 @@
+// src/core/wasm/__tests__/wasm-build.setup.ts
+
+import { createHash } from "node:crypto";
+import { execSync } from "node:child_process";
+import { existsSync, readdirSync, readFileSync, writeFileSync } from "node:fs";
+import { join } from "node:path";
+import { fileURLToPath } from "node:url";
+
+const ROOT = fileURLToPath(new URL("../../../../", import.meta.url));
+const SOURCES_DIR = join(ROOT, "core_cpp/src");
+const GENERATED_DIR = join(ROOT, "src/core/wasm/generated");
+// Hash de las fuentes con las que se generaron los módulos de generated/
+const STAMP_FILE = join(GENERATED_DIR, "matrix_ops.sources.sha256");
+
+/**
+ * Hash de `core_cpp/src` y de los scripts `build:wasm*` (los flags también
+ * cambian el binario). Los mtime no sirven: git los reescribe al clonar.
+ */
+function sourcesHash(): string {
+  const hash = createHash("sha256");
+  for (const name of readdirSync(SOURCES_DIR).sort()) {
+    hash.update(name).update(readFileSync(join(SOURCES_DIR, name)));
+  }
+  const { scripts } = JSON.parse(
+    readFileSync(join(ROOT, "package.json"), "utf8")
+  ) as { scripts: Record<string, string> };
+  for (const name of Object.keys(scripts).sort()) {
+    if (name.startsWith("build:wasm")) hash.update(`${name}=${scripts[name]}`);
+  }
+  return hash.digest("hex");
+}
+
+/**
+ * `globalSetup` de vitest: las specs WASM cargan los módulos de generated/,
+ * así que se regeneran con `pnpm build:wasm:all` si no corresponden a las
+ * fuentes actuales. Sin Emscripten la ejecución falla aquí, en lugar de
+ * probar un binario antiguo. Un build manual no escribe el sello: la
+ * siguiente ejecución de los tests vuelve a compilar una vez.
+ */
+export default function setup(): void {
+  const expected = sourcesHash();
+  const stamped = existsSync(STAMP_FILE)
+    ? readFileSync(STAMP_FILE, "utf8").trim()
+    : "";
+  if (stamped === expected) return;
+
+  console.log(
+    "[WASM Build] Generated modules do not match core_cpp/src, running pnpm build:wasm:all..."
+  );
+  try {
+    execSync("pnpm build:wasm:all", { cwd: ROOT, stdio: "inherit" });
+  } catch (e) {
+    throw new Error(
+      "Generated WASM modules are out of date with core_cpp/src and the rebuild failed " +
+        `(${(e as Error).message}). Install the Emscripten SDK (em++ on PATH), ` +
+        "run `pnpm build:wasm:all` and commit src/core/wasm/generated."
+    );
+  }
+  writeFileSync(STAMP_FILE, `${expected}\n`);
+}
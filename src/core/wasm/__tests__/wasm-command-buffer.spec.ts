@@ -0,0 +1,145 @@
+// src/core/wasm/__tests__/wasm-command-buffer.spec.ts
+
+import { describe, it, expect, beforeAll, afterAll } from "vitest";
+import { WasmBufferManager } from "../WasmBufferManager";
+import { HOMOGRAPHY_A_SLOTS } from "../WasmCommandBuffer";
+import { cleanupWasm } from "../wasm-loader";
+import { MatrixUtils } from "../../matrix/MatrixUtils";
+import type { Matrix3x3 } from "../../../types/core.types";
+
+const A = MatrixUtils.fromValues(2, 1, 0, -1, 3, 0, 5, -4, 1);
+const B = MatrixUtils.multiply(
+  MatrixUtils.rotation(Math.PI / 5),
+  MatrixUtils.scaling(1.5, 0.75)
+);
+
+function expectMatrixClose(actual: Matrix3x3, expected: Matrix3x3) {
+  expected.forEach((v, k) => expect(actual[k]).toBeCloseTo(v, 4));
+}
+
+describe("WasmCommandBuffer", () => {
+  const manager = new WasmBufferManager();
+
+  beforeAll(async () => {
+    await manager.initialize();
+  });
+
+  afterAll(async () => {
+    await manager.cleanup();
+    await cleanupWasm();
+  });
+
+  it("should execute a mixed stream of ops in one call", () => {
+    const cb = manager.createCommandBuffer({ maxSlots: 16 });
+    const a = cb.allocSlots();
+    const b = cb.allocSlots();
+    const ab = cb.allocSlots();
+    const abInv = cb.allocSlots();
+    const det = cb.allocSlots();
+    cb.setMatrix(a, A);
+    cb.setMatrix(b, B);
+
+    const commands = [
+      cb.multiply(a, b, ab),
+      cb.invert(ab, abInv),
+      cb.determinant(ab, det),
+    ];
+    expect(cb.execute()).toBe(3);
+    commands.forEach((cmd) => expect(cb.succeeded(cmd)).toBe(true));
+
+    const expectedAB = MatrixUtils.multiply(A, B);
+    expectMatrixClose(cb.getMatrix(ab), expectedAB);
+    expectMatrixClose(cb.getMatrix(abInv), MatrixUtils.inverse(expectedAB)!);
+    expect(cb.getScalar(det)).toBeCloseTo(
+      MatrixUtils.determinant(expectedAB),
+      4
+    );
+    cb.dispose();
+  });
+
+  it("should report per-command failures without stopping the stream", () => {
+    const cb = manager.createCommandBuffer({ maxSlots: 4 });
+    const singular = cb.allocSlots();
+    const out = cb.allocSlots();
+    const det = cb.allocSlots();
+    cb.setMatrix(singular, MatrixUtils.fromValues(1, 2, 0, 2, 4, 0, 0, 0, 0));
+
+    const invertCmd = cb.invert(singular, out);
+    const outOfRange = cb.multiply(singular, 99, out);
+    const detCmd = cb.determinant(singular, det);
+    expect(cb.execute()).toBe(3);
+    expect(cb.succeeded(invertCmd)).toBe(false);
+    expect(cb.succeeded(outOfRange)).toBe(false);
+    expect(cb.succeeded(detCmd)).toBe(true);
+    expect(cb.getScalar(det)).toBeCloseTo(0, 6);
+
+    // El flujo se puede reutilizar tras reset()
+    cb.reset();
+    cb.setMatrix(singular, A);
+    const retry = cb.invert(singular, out);
+    expect(cb.execute()).toBe(1);
+    expect(cb.succeeded(retry)).toBe(true);
+    cb.dispose();
+  });
+
+  it("should solve a homography system from slots", () => {
+    const cb = manager.createCommandBuffer({ maxSlots: 16 });
+    const aSlot = cb.allocSlots(HOMOGRAPHY_A_SLOTS);
+    const bSlot = cb.allocSlots();
+    const xSlot = cb.allocSlots();
+    // A diagonal: x_i = b_i / (i + 1)
+    const system = new Float32Array(64);
+    const rhs = new Float32Array(8);
+    for (let i = 0; i < 8; i++) {
+      system[i * 8 + i] = i + 1;
+      rhs[i] = (i + 1) * (i - 3);
+    }
+    cb.setValues(aSlot, system);
+    cb.setValues(bSlot, rhs);
+    const cmd = cb.solveHomography(aSlot, bSlot, xSlot);
+    cb.execute();
+    expect(cb.succeeded(cmd)).toBe(true);
+    const x = cb.getMatrix(xSlot);
+    for (let i = 0; i < 8; i++) expect(x[i]).toBeCloseTo(i - 3, 4);
+    cb.dispose();
+  });
+
+  it("should transform the managed point buffers", async () => {
+    const numPoints = 37;
+    const input = await manager.getInputBuffer(numPoints);
+    await manager.getOutputBuffer(numPoints);
+    for (let i = 0; i < numPoints * 2; i++) input.view[i] = (i % 11) - 5;
+
+    const cb = manager.createCommandBuffer({ maxSlots: 4 });
+    const a = cb.allocSlots();
+    const b = cb.allocSlots();
+    const ab = cb.allocSlots();
+    cb.setMatrix(a, A);
+    cb.setMatrix(b, B);
+    cb.multiply(a, b, ab);
+    const cmd = cb.transformPointsManaged(ab, numPoints);
+    cb.execute();
+    expect(cb.succeeded(cmd)).toBe(true);
+
+    const m = MatrixUtils.multiply(A, B);
+    const output = manager.getOutputView(numPoints)!;
+    for (let i = 0; i < numPoints; i++) {
+      const p = MatrixUtils.transformPoint(m, {
+        x: input.view[i * 2],
+        y: input.view[i * 2 + 1],
+      });
+      expect(output[i * 2]).toBeCloseTo(p.x, 3);
+      expect(output[i * 2 + 1]).toBeCloseTo(p.y, 3);
+    }
+    expect(() => cb.transformPointsManaged(ab, numPoints * 1000)).toThrow(
+      /capacity/
+    );
+  });
+
+  it("should throw when the slot arena is exhausted", () => {
+    const cb = manager.createCommandBuffer({ maxSlots: 2 });
+    cb.allocSlots(2);
+    expect(() => cb.allocSlots()).toThrow(/exhausted/);
+    cb.dispose();
+  });
+});
@@ -13,6 +13,8 @@ import {
 import {
   loadWasmModule,
   transformPointsBatchWasm_Copy,
+  classifyMatrixWasm,
+  WasmMatrixClass,
   cleanupWasm,
 } from "../wasm-loader"; // Ajusta ruta
 import { MatrixUtils } from "../../matrix/MatrixUtils"; // Ajusta ruta
@@ -127,6 +129,18 @@ describe("WASM Correctness - transformPointsBatchWasm", () => {
       matrix: MatrixUtils.scaling(2, 2),
       points: [1, 1, 2, 2, 3, 3], // 3 puntos
     },
+    {
+      name: "Scale + Translation (kernel ScaleTranslate)",
+      matrix: MatrixUtils.fromValues(3, 0, 0, 0, -2, 0, 7, 11, 1),
+      points: [0, 0, 1, 1, -2, 4, 10, -10, 0.5, 0.25, 3, 3, 8, 9], // 7 puntos
+    },
+    {
+      name: "Pure Translation, SIMD + residue (kernel Translate)",
+      matrix: MatrixUtils.translation(-3.5, 0.25),
+      points: [
+        1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18,
+      ], // 9 puntos
+    },
   ];
 
   testCases.forEach((tc) => {
@@ -148,3 +162,53 @@ describe("WASM Correctness - transformPointsBatchWasm", () => {
     });
   });
 });
+
+describe("WASM Correctness - classifyMatrix", () => {
+  beforeAll(async () => {
+    await loadWasmModule();
+  });
+
+  afterAll(() => {
+    cleanupWasm();
+  });
+
+  const classCases: { name: string; matrix: Matrix3x3; expected: number }[] = [
+    {
+      name: "identity",
+      matrix: MatrixUtils.identity(),
+      expected: WasmMatrixClass.Identity,
+    },
+    {
+      name: "translation",
+      matrix: MatrixUtils.translation(4, -2),
+      expected: WasmMatrixClass.Translate,
+    },
+    {
+      name: "scaling",
+      matrix: MatrixUtils.scaling(2, 3),
+      expected: WasmMatrixClass.ScaleTranslate,
+    },
+    {
+      name: "rotation",
+      matrix: MatrixUtils.rotation(0.3),
+      expected: WasmMatrixClass.Affine,
+    },
+    {
+      name: "perspective",
+      matrix: MatrixUtils.fromValues(1, 0, 0.001, 0, 1, 0, 0, 0, 1),
+      expected: WasmMatrixClass.Projective,
+    },
+  ];
+
+  classCases.forEach((tc) => {
+    it(`should classify ${tc.name} matrices`, async () => {
+      expect(await classifyMatrixWasm(tc.matrix)).toBe(tc.expected);
+    });
+  });
+
+  it("should agree with MatrixUtils.isAffine on the projective boundary", async () => {
+    const m = MatrixUtils.fromValues(1, 0.2, 0, 0.1, 1, 0, 0, 0, 1.5);
+    expect(MatrixUtils.isAffine(m)).toBe(false);
+    expect(await classifyMatrixWasm(m)).toBe(WasmMatrixClass.Projective);
+  });
+});
@@ -0,0 +1,98 @@
+// src/core/wasm/__tests__/wasm-cull.spec.ts
+
+import { describe, it, expect, beforeAll, afterAll } from "vitest";
+import { WasmBufferManager, type ClipRect } from "../WasmBufferManager";
+import { cleanupWasm } from "../wasm-loader";
+import { MatrixUtils } from "../../matrix/MatrixUtils";
+import type { Matrix3x3 } from "../../../types/core.types";
+
+// Bordes fuera de la rejilla de salidas para no depender del redondeo f32/f64
+const RECT: ClipRect = {
+  minX: -20.25,
+  minY: -10.25,
+  maxX: 30.25,
+  maxY: 25.25,
+};
+
+const MATRICES: { name: string; matrix: Matrix3x3 }[] = [
+  { name: "identity", matrix: MatrixUtils.identity() },
+  {
+    name: "affine",
+    matrix: MatrixUtils.fromValues(1, 0.2, 0, -0.3, 1, 0, 5, -3, 1),
+  },
+  {
+    // Incluye puntos degenerados (W = 0 en x = -50)
+    name: "projective",
+    matrix: MatrixUtils.fromValues(1, 0, 0.02, 0, 1, 0, 0, 0, 1),
+  },
+];
+
+describe("WasmBufferManager - fused viewport culling", () => {
+  const manager = new WasmBufferManager();
+
+  beforeAll(async () => {
+    await manager.initialize();
+  });
+
+  afterAll(async () => {
+    await manager.cleanup();
+    await cleanupWasm();
+  });
+
+  MATRICES.forEach(({ name, matrix }) => {
+    it(`should keep only visible points, compacted and in order, for ${name}`, async () => {
+      const numPoints = 203; // incluye residuo escalar
+      const input = await manager.getInputBuffer(numPoints);
+      await manager.getOutputBuffer(numPoints);
+      for (let i = 0; i < numPoints * 2; i++)
+        input.view[i] = ((i * 37) % 101) - 50;
+      const original = input.view.slice();
+
+      const count = await manager.transformPointsCullManaged(
+        matrix,
+        numPoints,
+        RECT
+      );
+
+      // Referencia JS: transformar todo y filtrar
+      const expected: { index: number; x: number; y: number }[] = [];
+      for (let i = 0; i < numPoints; i++) {
+        const p = MatrixUtils.transformPoint(matrix, {
+          x: original[i * 2],
+          y: original[i * 2 + 1],
+        });
+        if (
+          p.x >= RECT.minX &&
+          p.x <= RECT.maxX &&
+          p.y >= RECT.minY &&
+          p.y <= RECT.maxY
+        )
+          expected.push({ index: i, ...p });
+      }
+
+      expect(count).toBe(expected.length);
+      const output = manager.getOutputView(count)!;
+      const indices = manager.getCulledIndexView(count)!.view;
+      expected.forEach((e, k) => {
+        expect(indices[k]).toBe(e.index);
+        expect(output[k * 2]).toBeCloseTo(e.x, 4);
+        expect(output[k * 2 + 1]).toBeCloseTo(e.y, 4);
+      });
+    });
+  });
+
+  it("should return 0 when every point is off-screen", async () => {
+    const input = await manager.getInputBuffer(8);
+    await manager.getOutputBuffer(8);
+    input.view.fill(1000);
+
+    const count = await manager.transformPointsCullManaged(
+      MatrixUtils.identity(),
+      8,
+      RECT,
+      false
+    );
+
+    expect(count).toBe(0);
+  });
+});
@@ -0,0 +1,110 @@
+// src/core/wasm/__tests__/wasm-f64.spec.ts
+
+import { describe, it, expect, beforeAll, afterAll } from "vitest";
+import { WasmBufferManager } from "../WasmBufferManager";
+import {
+  cleanupWasm,
+  multiplyWasmF64,
+  inverseWasmF64,
+  determinantWasmF64,
+} from "../wasm-loader";
+
+// Matriz CAD/GIS típica: rotación/escala pequeña + traslación en el rango 1e6
+const GIS_MATRIX = new Float64Array([
+  0.5, 0.1, 0, -0.1, 0.5, 0, 1234567.25, 7654321.5, 1,
+]);
+const PROJECTIVE_MATRIX = new Float64Array([1, 0, 1e-7, 0, 1, 2e-7, 0, 0, 1]);
+// A 1e6, W = 1 + 1e-5: descartarlo movería la salida unas 10 unidades
+const TINY_PERSPECTIVE_MATRIX = new Float64Array([
+  1, 0, 1e-11, 0, 1, 0, 0, 0, 1,
+]);
+
+// Referencia JS en doble precisión
+function refPoint(m: Float64Array, x: number, y: number): [number, number] {
+  const X = m[0] * x + m[3] * y + m[6];
+  const Y = m[1] * x + m[4] * y + m[7];
+  const W = m[2] * x + m[5] * y + m[8];
+  return [X / W, Y / W];
+}
+
+describe("WASM f64 matrix operations", () => {
+  afterAll(async () => {
+    await cleanupWasm();
+  });
+
+  it("should invert and multiply back to identity", async () => {
+    const inv = await inverseWasmF64(GIS_MATRIX);
+    expect(inv).not.toBeNull();
+    const product = await multiplyWasmF64(GIS_MATRIX, inv!);
+    const identity = [1, 0, 0, 0, 1, 0, 0, 0, 1];
+    product.forEach((v, k) => expect(v).toBeCloseTo(identity[k], 9));
+    expect(await determinantWasmF64(GIS_MATRIX)).toBeCloseTo(0.26, 12);
+  });
+
+  it("should return null for a singular matrix", async () => {
+    const singular = new Float64Array([1, 2, 0, 2, 4, 0, 0, 0, 0]);
+    expect(await inverseWasmF64(singular)).toBeNull();
+  });
+});
+
+describe("WasmBufferManager - f64 point transforms", () => {
+  const manager = new WasmBufferManager();
+  const numPoints = 33; // incluye punto impar (residuo escalar)
+
+  beforeAll(async () => {
+    await manager.initialize();
+  });
+
+  afterAll(async () => {
+    await manager.cleanup();
+    await cleanupWasm();
+  });
+
+  async function fillInput() {
+    const input = await manager.getTypedInputBuffer(numPoints, "f64");
+    // Coordenadas ~1e6 con detalle submilimétrico
+    for (let i = 0; i < numPoints * 2; i++)
+      input.view[i] = 1e6 + i * 0.001 + (i % 3) * 0.0001;
+    return input.view;
+  }
+
+  [
+    { name: "affine", matrix: GIS_MATRIX },
+    { name: "projective", matrix: PROJECTIVE_MATRIX },
+    { name: "tiny perspective", matrix: TINY_PERSPECTIVE_MATRIX },
+  ].forEach(({ name, matrix }) => {
+    it(`should keep sub-millimetre precision for ${name} f64 batches`, async () => {
+      const input = await fillInput();
+      const output = await manager.getTypedOutputBuffer(numPoints, "f64");
+
+      await manager.transformPointsF64Managed(matrix, numPoints);
+
+      for (let i = 0; i < numPoints; i++) {
+        const [ex, ey] = refPoint(matrix, input[i * 2], input[i * 2 + 1]);
+        expect(Math.abs(output.view[i * 2] - ex)).toBeLessThan(1e-6);
+        expect(Math.abs(output.view[i * 2 + 1] - ey)).toBeLessThan(1e-6);
+      }
+    });
+  });
+
+  it("should write f32 relative to a local origin", async () => {
+    const input = await fillInput();
+    const output = await manager.getOutputBuffer(numPoints);
+    const origin = { x: 1634567, y: 8254321 };
+
+    await manager.transformPointsF64ToLocalF32Managed(
+      GIS_MATRIX,
+      numPoints,
+      origin
+    );
+
+    for (let i = 0; i < numPoints; i++) {
+      const [ex, ey] = refPoint(GIS_MATRIX, input[i * 2], input[i * 2 + 1]);
+      // Resultado cerca del origen: f32 basta para precisión submilimétrica
+      const dx = output.view[i * 2] - (ex - origin.x);
+      const dy = output.view[i * 2 + 1] - (ey - origin.y);
+      expect(Math.abs(dx)).toBeLessThan(1e-4);
+      expect(Math.abs(dy)).toBeLessThan(1e-4);
+    }
+  });
+});
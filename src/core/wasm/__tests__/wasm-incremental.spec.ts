@@ -0,0 +1,131 @@
+// src/core/wasm/__tests__/wasm-incremental.spec.ts
+
+import { describe, it, expect, beforeAll, afterAll } from "vitest";
+import { WasmBufferManager } from "../WasmBufferManager";
+import { cleanupWasm } from "../wasm-loader";
+import { MatrixUtils } from "../../matrix/MatrixUtils";
+import { expectTransformed, TEST_AFFINE } from "../../__tests__/testUtils";
+
+const NUM_POINTS = 10000;
+const A = TEST_AFFINE;
+const B = MatrixUtils.translation(10, -5);
+
+describe("WasmBufferManager - incremental transform", () => {
+  const manager = new WasmBufferManager();
+  let input: Float32Array;
+
+  beforeAll(async () => {
+    await manager.initialize();
+    input = (await manager.getInputBuffer(NUM_POINTS)).view;
+    await manager.getOutputBuffer(NUM_POINTS);
+  });
+
+  afterAll(async () => {
+    await manager.cleanup();
+    await cleanupWasm();
+  });
+
+  it("should do a full pass first and nothing when nothing changed", async () => {
+    for (let i = 0; i < input.length; i++) input[i] = (i % 97) - 48;
+    manager.markInputDirtyAll();
+    expect(await manager.transformPointsIncrementalManaged(A, NUM_POINTS)).toBe(
+      NUM_POINTS
+    );
+    expect(await manager.transformPointsIncrementalManaged(A, NUM_POINTS)).toBe(
+      0
+    );
+    const output = manager.getOutputView(NUM_POINTS)!;
+    expectTransformed(A, input, output, [0, 1, 4999, NUM_POINTS - 1]);
+  });
+
+  it("should only transform the dirty spans", async () => {
+    const output = manager.getOutputView(NUM_POINTS)!;
+    // Un punto limpio con salida "falsa": si se retransforma, se nota
+    output[2 * 5000] = 12345;
+    input[2 * 10] = 1000;
+    input[2 * 7000] = -1000;
+    manager.markInputDirty(7000);
+    manager.markInputDirty(10);
+    manager.markInputDirty(12, 3); // Fusionado con el 10 (hueco pequeño)
+
+    const transformed = await manager.transformPointsIncrementalManaged(
+      A,
+      NUM_POINTS
+    );
+    expect(transformed).toBe(1 + 5); // [7000] y [10, 15)
+    expectTransformed(A, input, output, [10, 11, 14, 7000]);
+    expect(output[2 * 5000]).toBe(12345);
+  });
+
+  it("should fall back to a full pass when the matrix changes", async () => {
+    manager.markInputDirty(3);
+    expect(await manager.transformPointsIncrementalManaged(B, NUM_POINTS)).toBe(
+      NUM_POINTS
+    );
+    const output = manager.getOutputView(NUM_POINTS)!;
+    expectTransformed(B, input, output, [3, 5000, NUM_POINTS - 1]);
+    // Demasiados puntos sucios: también pasada completa
+    manager.markInputDirty(0, NUM_POINTS / 2);
+    expect(await manager.transformPointsIncrementalManaged(B, NUM_POINTS)).toBe(
+      NUM_POINTS
+    );
+  });
+
+  it("should redo a full pass after other writers of the output", async () => {
+    await manager.transformPointsIncrementalManaged(B, NUM_POINTS);
+    const output = manager.getOutputView(NUM_POINTS)!;
+
+    // El culling compacta la salida
+    const rect = { minX: 0, minY: 0, maxX: 20, maxY: 20 };
+    await manager.transformPointsCullManaged(A, NUM_POINTS, rect);
+    expect(await manager.transformPointsIncrementalManaged(B, NUM_POINTS)).toBe(
+      NUM_POINTS
+    );
+    expectTransformed(B, input, output, [0, 1, 4999, NUM_POINTS - 1]);
+
+    await manager.transformPointsBatchStatsManaged(A, NUM_POINTS);
+    expect(await manager.transformPointsIncrementalManaged(B, NUM_POINTS)).toBe(
+      NUM_POINTS
+    );
+    expectTransformed(B, input, output, [0, 4999]);
+
+    // Un command buffer invalida al ejecutar, no al codificar
+    const commands = manager.createCommandBuffer();
+    const slot = commands.allocSlots();
+    commands.setMatrix(slot, A);
+    commands.transformPointsManaged(slot, NUM_POINTS);
+    expect(await manager.transformPointsIncrementalManaged(B, NUM_POINTS)).toBe(
+      0
+    );
+    commands.execute();
+    expect(await manager.transformPointsIncrementalManaged(B, NUM_POINTS)).toBe(
+      NUM_POINTS
+    );
+    expectTransformed(B, input, output, [0, NUM_POINTS - 1]);
+    commands.dispose();
+  });
+
+  it("should redo a full pass after a plan writes the managed output", async () => {
+    await manager.transformPointsIncrementalManaged(B, NUM_POINTS);
+    const plan = manager.createTransformPlan(A, NUM_POINTS);
+    plan.execute();
+    plan.dispose();
+
+    manager.markInputDirty(3);
+    expect(await manager.transformPointsIncrementalManaged(B, NUM_POINTS)).toBe(
+      NUM_POINTS
+    );
+    const output = manager.getOutputView(NUM_POINTS)!;
+    expectTransformed(B, input, output, [0, 3, 5000, NUM_POINTS - 1]);
+  });
+
+  it("should clamp dirty ranges to the point count and validate them", async () => {
+    manager.markInputDirty(NUM_POINTS - 2, 100);
+    manager.markInputDirty(NUM_POINTS + 50);
+    expect(await manager.transformPointsIncrementalManaged(B, NUM_POINTS)).toBe(
+      2
+    );
+    expect(() => manager.markInputDirty(-1)).toThrow(/Invalid dirty range/);
+    expect(() => manager.markInputDirty(0, -5)).toThrow(/Invalid dirty range/);
+  });
+});
@@ -0,0 +1,138 @@
+// src/core/wasm/__tests__/wasm-instanced.spec.ts
+
+import { describe, it, expect, beforeAll, afterAll } from "vitest";
+import { WasmBufferManager } from "../WasmBufferManager";
+import { cleanupWasm } from "../wasm-loader";
+import { MatrixUtils } from "../../matrix/MatrixUtils";
+import type { Matrix3x3 } from "../../../types/core.types";
+
+const INSTANCE_MATRICES: Matrix3x3[] = [
+  MatrixUtils.translation(10, -5),
+  MatrixUtils.scaling(2, 0.5),
+  MatrixUtils.rotation(Math.PI / 3),
+  MatrixUtils.fromValues(1, 0, 0.001, 0, 1, 0.002, 0, 0, 1),
+];
+
+function expectPointMatches(
+  m: Matrix3x3,
+  input: Float32Array,
+  output: Float32Array,
+  i: number
+) {
+  const p = MatrixUtils.transformPoint(m, {
+    x: input[i * 2],
+    y: input[i * 2 + 1],
+  });
+  expect(output[i * 2]).toBeCloseTo(p.x, 4);
+  expect(output[i * 2 + 1]).toBeCloseTo(p.y, 4);
+}
+
+describe("WasmBufferManager - instanced transforms", () => {
+  const manager = new WasmBufferManager();
+
+  beforeAll(async () => {
+    await manager.initialize();
+  });
+
+  afterAll(async () => {
+    await manager.cleanup();
+    await cleanupWasm();
+  });
+
+  async function prepare(numPoints: number) {
+    const matrices = await manager.getMatrixArrayBuffer(
+      INSTANCE_MATRICES.length
+    );
+    INSTANCE_MATRICES.forEach((m, k) => matrices.view.set(m, k * 9));
+    const input = await manager.getInputBuffer(numPoints);
+    await manager.getOutputBuffer(numPoints);
+    for (let i = 0; i < numPoints * 2; i++) input.view[i] = (i % 17) - 8;
+    return input.view;
+  }
+
+  it("should transform each point with its own matrix (mixed + long runs)", async () => {
+    const numPoints = 40;
+    const input = await prepare(numPoints);
+    const indices = await manager.getInstanceIndexBuffer(numPoints);
+    // 0..19: índices alternos (gather); 20..39: un run largo de la matriz 2
+    for (let i = 0; i < numPoints; i++) {
+      indices.view[i] = i < 20 ? i % 4 : 2;
+    }
+
+    const invalid = await manager.transformPointsInstancedManaged(
+      INSTANCE_MATRICES.length,
+      numPoints
+    );
+
+    expect(invalid).toBe(0);
+    const output = manager.getOutputView(numPoints)!;
+    for (let i = 0; i < numPoints; i++)
+      expectPointMatches(INSTANCE_MATRICES[indices.view[i]], input, output, i);
+  });
+
+  it("should write NaN and report points with out-of-range indices", async () => {
+    const numPoints = 5;
+    await prepare(numPoints);
+    const indices = await manager.getInstanceIndexBuffer(numPoints);
+    indices.view.set([0, 1, 99, 2, 3]);
+
+    const invalid = await manager.transformPointsInstancedManaged(
+      INSTANCE_MATRICES.length,
+      numPoints
+    );
+
+    expect(invalid).toBe(1);
+    const output = manager.getOutputView(numPoints)!;
+    expect(isNaN(output[4])).toBe(true);
+    expect(isNaN(output[5])).toBe(true);
+    expect(isNaN(output[0])).toBe(false);
+  });
+
+  it("should transform (start, count) ranges per instance", async () => {
+    const numPoints = 30;
+    const input = await prepare(numPoints);
+    const ranges = await manager.getInstanceRangeBuffer(4);
+    ranges.view.set([0, 7, 7, 1, 8, 12, 20, 10]);
+
+    await manager.transformPointsInstanceRangesManaged(4, numPoints);
+
+    const output = manager.getOutputView(numPoints)!;
+    for (let k = 0; k < 4; k++) {
+      const start = ranges.view[k * 2];
+      const count = ranges.view[k * 2 + 1];
+      for (let i = start; i < start + count; i++)
+        expectPointMatches(INSTANCE_MATRICES[k], input, output, i);
+    }
+  });
+
+  it("should reject ranges beyond the point buffers", async () => {
+    await prepare(10);
+    const ranges = await manager.getInstanceRangeBuffer(1);
+    ranges.view.set([5, 6]);
+    await expect(
+      manager.transformPointsInstanceRangesManaged(1, 10)
+    ).rejects.toThrow();
+  });
+
+  it("should keep instance views live when the buffers and the heap grow", async () => {
+    const indices = await manager.getInstanceIndexBuffer(4);
+    const stale = indices.view;
+    // 16 MB de índices: el bloque se realoca y, en la build real, crece el heap
+    await manager.getInstanceIndexBuffer(1 << 22);
+    expect(indices.view).not.toBe(stale);
+    expect(indices.view.length).toBe(4);
+
+    indices.view.set([3, 2, 1, 0]);
+    const numPoints = 4;
+    const input = await prepare(numPoints);
+    const invalid = await manager.transformPointsInstancedManaged(
+      INSTANCE_MATRICES.length,
+      numPoints
+    );
+
+    expect(invalid).toBe(0);
+    const output = manager.getOutputView(numPoints)!;
+    for (let i = 0; i < numPoints; i++)
+      expectPointMatches(INSTANCE_MATRICES[3 - i], input, output, i);
+  });
+});
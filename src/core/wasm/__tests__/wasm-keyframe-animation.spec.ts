@@ -0,0 +1,143 @@
+// src/core/wasm/__tests__/wasm-keyframe-animation.spec.ts
+
+import { describe, it, expect, beforeAll, afterAll } from "vitest";
+import { WasmBufferManager } from "../WasmBufferManager";
+import type { Keyframe } from "../WasmKeyframeAnimation";
+import { cleanupWasm } from "../wasm-loader";
+import { MatrixUtils } from "../../matrix/MatrixUtils";
+import type { Matrix3x3 } from "../../../types/core.types";
+
+function trs(tx: number, ty: number, angle: number, s = 1): Matrix3x3 {
+  return MatrixUtils.multiply(
+    MatrixUtils.multiply(
+      MatrixUtils.translation(tx, ty),
+      MatrixUtils.rotation(angle)
+    ),
+    MatrixUtils.scaling(s, s)
+  );
+}
+
+function expectMatrixClose(actual: ArrayLike<number>, expected: Matrix3x3) {
+  for (let k = 0; k < 9; k++) expect(actual[k]).toBeCloseTo(expected[k], 4);
+}
+
+describe("WasmKeyframeAnimation", () => {
+  const manager = new WasmBufferManager();
+  const deg = Math.PI / 180;
+  // Pista 0: gira 90° y escala x2 mientras se desplaza; pista 1: de 170° a -170°
+  const tracks: Keyframe[][] = [
+    [
+      { time: 0, matrix: trs(0, 0, 0, 1) },
+      { time: 2, matrix: trs(10, -4, 90 * deg, 2), easing: "step" },
+      { time: 4, matrix: trs(20, 0, 0, 1) },
+    ],
+    [
+      { time: 0, matrix: trs(0, 0, 170 * deg), easing: "easeInOut" },
+      { time: 1, matrix: trs(4, 0, -170 * deg) },
+    ],
+    // Pista con reflexión y skew: la descomposición debe reproducirla
+    [
+      {
+        time: 0,
+        matrix: MatrixUtils.fromValues(-1.5, 0.3, 0, 0.7, 2, 0, 5, 6, 1),
+      },
+    ],
+  ];
+
+  beforeAll(async () => {
+    await manager.initialize();
+  });
+
+  afterAll(async () => {
+    await manager.cleanup();
+    await cleanupWasm();
+  });
+
+  it("should reproduce the keyframe matrices at their times", () => {
+    const animation = manager.createKeyframeAnimation();
+    tracks.forEach((keys) => animation.addTrack(keys));
+    expect(animation.numTracks).toBe(3);
+
+    const atStart = manager.evaluateKeyframeAnimationManaged(animation, 0).view;
+    tracks.forEach((keys, i) => {
+      expectMatrixClose(atStart.subarray(i * 9, i * 9 + 9), keys[0].matrix);
+    });
+    const atTwo = manager.evaluateKeyframeAnimationManaged(animation, 2).view;
+    expectMatrixClose(atTwo.subarray(0, 9), tracks[0][1].matrix);
+    // Fuera del rango se fija el extremo
+    const late = manager.evaluateKeyframeAnimationManaged(animation, 99).view;
+    expectMatrixClose(late.subarray(0, 9), tracks[0][2].matrix);
+    expectMatrixClose(late.subarray(9, 18), tracks[1][1].matrix);
+  });
+
+  it("should interpolate rotation and scale, not coefficients", () => {
+    const animation = manager.createKeyframeAnimation();
+    tracks.forEach((keys) => animation.addTrack(keys));
+
+    const mid = manager.evaluateKeyframeAnimationManaged(animation, 1).view;
+    expectMatrixClose(mid.subarray(0, 9), trs(5, -2, 45 * deg, 1.5));
+    // 170° -> -170° por el arco corto: a mitad (smoothstep 0.5) pasa por 180°
+    expectMatrixClose(mid.subarray(9, 18), trs(4, 0, -170 * deg));
+    const half = manager.evaluateKeyframeAnimationManaged(animation, 0.5).view;
+    expectMatrixClose(half.subarray(9, 18), trs(2, 0, 180 * deg));
+    // `step`: mantiene el keyframe de t = 2 hasta t = 4
+    const held = manager.evaluateKeyframeAnimationManaged(animation, 3.9).view;
+    expectMatrixClose(held.subarray(0, 9), tracks[0][1].matrix);
+  });
+
+  it("should write SoA matrices straight into the batch buffers", async () => {
+    const animation = manager.createKeyframeAnimation();
+    tracks.forEach((keys) => animation.addTrack(keys));
+    const count = animation.numTracks;
+    const parent = trs(100, 50, 30 * deg, 0.5);
+
+    const local = manager
+      .evaluateKeyframeAnimationManaged(animation, 1)
+      .view.slice(0, count * 9);
+
+    const options = { layout: "soa", sharedA: true } as const;
+    await manager.getMatrixBatchBuffers(count, options);
+    manager.evaluateKeyframeAnimationManaged(animation, 1, {
+      target: "batchB",
+      layout: "soa",
+    });
+    const { a } = await manager.getMatrixBatchBuffers(count, options);
+    a.view.set(parent);
+    const out = (await manager.multiplyMatricesBatchManaged(count, options))
+      .view;
+    for (let i = 0; i < count; i++) {
+      const expected = MatrixUtils.multiply(
+        parent,
+        local.slice(i * 9, i * 9 + 9) as Matrix3x3
+      );
+      for (let k = 0; k < 9; k++) {
+        expect(out[k * count + i]).toBeCloseTo(expected[k], 3);
+      }
+    }
+  });
+
+  it("should validate keyframes, targets and disposal", () => {
+    const animation = manager.createKeyframeAnimation();
+    const m = MatrixUtils.identity();
+    expect(() => animation.addTrack([])).toThrow(/Invalid keyframes/);
+    expect(() =>
+      animation.addTrack([
+        { time: 1, matrix: m },
+        { time: 1, matrix: m },
+      ])
+    ).toThrow(/Invalid keyframes/);
+    const projective = MatrixUtils.fromValues(1, 0, 0.01, 0, 1, 0, 0, 0, 1);
+    expect(() => animation.addTrack([{ time: 0, matrix: projective }])).toThrow(
+      /affine/
+    );
+    expect(animation.numTracks).toBe(0);
+
+    expect(() =>
+      manager.evaluateKeyframeAnimationManaged(animation, 0, { layout: "soa" })
+    ).toThrow(/aos/);
+    animation.dispose();
+    expect(() => animation.addTrack([{ time: 0, matrix: m }])).toThrow(
+      /disposed/
+    );
+  });
+});
@@ -0,0 +1,132 @@
+// src/core/wasm/__tests__/wasm-layouts.spec.ts
+
+import { describe, it, expect, beforeAll, afterAll } from "vitest";
+import { WasmBufferManager } from "../WasmBufferManager";
+import { cleanupWasm } from "../wasm-loader";
+import { MatrixUtils } from "../../matrix/MatrixUtils";
+import type { Matrix3x3 } from "../../../types/core.types";
+
+// Referencia JS para un punto
+function refPoint(m: Matrix3x3, x: number, y: number): [number, number] {
+  const p = MatrixUtils.transformPoint(m, { x, y });
+  return [p.x, p.y];
+}
+
+const MATRICES: { name: string; matrix: Matrix3x3 }[] = [
+  {
+    name: "affine",
+    matrix: MatrixUtils.fromValues(1, 0.4, 0, -0.3, 1.2, 0, 5, -3, 1),
+  },
+  {
+    name: "projective",
+    matrix: MatrixUtils.fromValues(1, 0, 0.001, 0, 1, 0.002, 0, 0, 1),
+  },
+];
+
+describe("WasmBufferManager - point layouts", () => {
+  const manager = new WasmBufferManager();
+
+  beforeAll(async () => {
+    await manager.initialize();
+  });
+
+  afterAll(async () => {
+    await manager.cleanup();
+    await cleanupWasm();
+  });
+
+  MATRICES.forEach(({ name, matrix }) => {
+    it(`should transform interleaved vertices (stride 5) for ${name}`, async () => {
+      const numPoints = 7;
+      const layout = { kind: "interleaved", stride: 5 } as const;
+      const input = await manager.getInputBuffer(numPoints, layout);
+      const output = await manager.getOutputBuffer(numPoints, layout);
+      for (let i = 0; i < input.view.length; i++) input.view[i] = i * 0.5 - 3;
+      output.view.fill(-1);
+
+      await manager.transformPointsLayoutManaged(matrix, numPoints, {
+        inLayout: layout,
+      });
+
+      for (let i = 0; i < numPoints; i++) {
+        const [ex, ey] = refPoint(
+          matrix,
+          input.view[i * 5],
+          input.view[i * 5 + 1]
+        );
+        expect(output.view[i * 5]).toBeCloseTo(ex, 4);
+        expect(output.view[i * 5 + 1]).toBeCloseTo(ey, 4);
+        // Los atributos u,v,rgba de la salida no se tocan
+        expect(output.view[i * 5 + 2]).toBe(-1);
+      }
+    });
+
+    it(`should transform SoA buffers for ${name}`, async () => {
+      const numPoints = 9;
+      const layout = { kind: "soa" } as const;
+      const input = await manager.getInputBuffer(numPoints, layout);
+      const output = await manager.getOutputBuffer(numPoints, layout);
+      for (let i = 0; i < numPoints * 2; i++) input.view[i] = i - 4;
+
+      await manager.transformPointsLayoutManaged(matrix, numPoints, {
+        inLayout: layout,
+      });
+
+      for (let i = 0; i < numPoints; i++) {
+        const [ex, ey] = refPoint(
+          matrix,
+          input.view[i],
+          input.view[numPoints + i]
+        );
+        expect(output.view[i]).toBeCloseTo(ex, 4);
+        expect(output.view[numPoints + i]).toBeCloseTo(ey, 4);
+      }
+    });
+
+    it(`should write xy into uv of the same vertex in place for ${name}`, async () => {
+      const numPoints = 6;
+      // Capacidad suficiente para el layout de salida (offset 2)
+      const input = await manager.getInputBuffer(numPoints, {
+        kind: "interleaved",
+        stride: 4,
+        offset: 2,
+      });
+      for (let i = 0; i < input.view.length; i++) input.view[i] = i + 1;
+      const original = input.view.slice();
+
+      await manager.transformPointsLayoutManaged(matrix, numPoints, {
+        inLayout: { kind: "interleaved", stride: 4 },
+        outLayout: { kind: "interleaved", stride: 4, offset: 2 },
+        inPlace: true,
+      });
+
+      for (let i = 0; i < numPoints; i++) {
+        const [ex, ey] = refPoint(
+          matrix,
+          original[i * 4],
+          original[i * 4 + 1]
+        );
+        expect(input.view[i * 4]).toBe(original[i * 4]);
+        expect(input.view[i * 4 + 2]).toBeCloseTo(ex, 4);
+        expect(input.view[i * 4 + 3]).toBeCloseTo(ey, 4);
+      }
+    });
+  });
+
+  it("should reject mixing interleaved and SoA layouts", async () => {
+    await manager.getInputBuffer(4, { kind: "soa" });
+    await manager.getOutputBuffer(4, { kind: "soa" });
+    await expect(
+      manager.transformPointsLayoutManaged(MatrixUtils.identity(), 4, {
+        inLayout: { kind: "soa" },
+        outLayout: { kind: "interleaved", stride: 2 },
+      })
+    ).rejects.toThrow();
+  });
+
+  it("should reject strides smaller than 2", async () => {
+    await expect(
+      manager.getInputBuffer(4, { kind: "interleaved", stride: 1 })
+    ).rejects.toThrow();
+  });
+});
@@ -0,0 +1,177 @@
+// src/core/wasm/__tests__/wasm-matrix-batch.spec.ts
+
+import { describe, it, expect, beforeAll, afterAll } from "vitest";
+import { WasmBufferManager } from "../WasmBufferManager";
+import { cleanupWasm } from "../wasm-loader";
+import { MatrixUtils } from "../../matrix/MatrixUtils";
+import type { Matrix3x3 } from "../../../types/core.types";
+
+// Múltiplo de 4 más 3: cubre los bloques SIMD y el residuo escalar
+const COUNT = 23;
+
+/** Matriz i determinista con perspectiva distinta de cero. */
+function matrixAt(i: number, salt: number): Matrix3x3 {
+  return MatrixUtils.fromValues(
+    1 + i * 0.1,
+    0.2 * salt,
+    0.001 * i,
+    -0.3 + salt,
+    0.8 - i * 0.05,
+    -0.002 * salt,
+    i - 4,
+    salt * 2 - i,
+    1 + 0.01 * i
+  );
+}
+
+/** Coeficiente k de la matriz i en el layout dado. */
+function coeff(
+  view: Float32Array,
+  layout: "aos" | "soa",
+  count: number,
+  i: number,
+  k: number
+): number {
+  return layout === "aos" ? view[i * 9 + k] : view[k * count + i];
+}
+
+function writeMatrix(
+  view: Float32Array,
+  layout: "aos" | "soa",
+  count: number,
+  i: number,
+  m: Matrix3x3
+) {
+  for (let k = 0; k < 9; k++) {
+    if (layout === "aos") view[i * 9 + k] = m[k];
+    else view[k * count + i] = m[k];
+  }
+}
+
+describe("WasmBufferManager - batched matrix multiply", () => {
+  const manager = new WasmBufferManager();
+
+  beforeAll(async () => {
+    await manager.initialize();
+  });
+
+  afterAll(async () => {
+    await manager.cleanup();
+    await cleanupWasm();
+  });
+
+  for (const layout of ["aos", "soa"] as const) {
+    it(`should multiply pairs of matrices (${layout})`, async () => {
+      const { a, b } = await manager.getMatrixBatchBuffers(COUNT, { layout });
+      for (let i = 0; i < COUNT; i++) {
+        writeMatrix(a.view, layout, COUNT, i, matrixAt(i, 1));
+        writeMatrix(b.view, layout, COUNT, i, matrixAt(COUNT - i, 2));
+      }
+      const { view: out } = await manager.multiplyMatricesBatchManaged(COUNT, {
+        layout,
+      });
+      for (let i = 0; i < COUNT; i++) {
+        const expected = MatrixUtils.multiply(
+          matrixAt(i, 1),
+          matrixAt(COUNT - i, 2)
+        );
+        for (let k = 0; k < 9; k++) {
+          expect(coeff(out, layout, COUNT, i, k)).toBeCloseTo(expected[k], 4);
+        }
+      }
+    });
+
+    it(`should multiply one shared A against many B (${layout})`, async () => {
+      const parent = MatrixUtils.multiply(
+        MatrixUtils.translation(10, -5),
+        MatrixUtils.rotation(0.3)
+      );
+      const options = { layout, sharedA: true };
+      const { a, b } = await manager.getMatrixBatchBuffers(COUNT, options);
+      expect(a.view.length).toBe(9);
+      a.view.set(parent);
+      for (let i = 0; i < COUNT; i++) {
+        writeMatrix(b.view, layout, COUNT, i, matrixAt(i, 3));
+      }
+      const result = await manager.multiplyMatricesBatchManaged(COUNT, options);
+      const out = result.view;
+      for (let i = 0; i < COUNT; i++) {
+        const expected = MatrixUtils.multiply(parent, matrixAt(i, 3));
+        for (let k = 0; k < 9; k++) {
+          expect(coeff(out, layout, COUNT, i, k)).toBeCloseTo(expected[k], 4);
+        }
+      }
+    });
+  }
+
+  for (const layout of ["aos", "soa"] as const) {
+    it(`should invert and flag singular matrices (${layout})`, async () => {
+      const singular = MatrixUtils.fromValues(1, 2, 0, 2, 4, 0, 0, 0, 1);
+      const matrices = Array.from({ length: COUNT }, (_, i) =>
+        i % 5 === 2 ? singular : matrixAt(i, 4)
+      );
+      // Un bloque afín completo (0..3) para el camino especializado
+      for (let i = 0; i < 4; i++) {
+        matrices[i] = MatrixUtils.multiply(
+          MatrixUtils.translation(i * 3, -i),
+          MatrixUtils.scaling(2 + i, 0.5)
+        );
+      }
+      const { a } = await manager.getMatrixBatchBuffers(COUNT, { layout });
+      matrices.forEach((m, i) => writeMatrix(a.view, layout, COUNT, i, m));
+
+      const { out, mask, inverted } = await manager.invertMatricesBatchManaged(
+        COUNT,
+        { layout }
+      );
+      expect(inverted).toBe(matrices.filter((m) => m !== singular).length);
+      matrices.forEach((m, i) => {
+        const expected = MatrixUtils.inverse(m);
+        expect(mask[i]).toBe(expected ? 1 : 0);
+        for (let k = 0; k < 9; k++) {
+          const value = coeff(out.view, layout, COUNT, i, k);
+          if (expected) expect(value).toBeCloseTo(expected[k], 4);
+          else expect(value).toBeNaN();
+        }
+      });
+      // La última fila afín es exacta
+      expect(coeff(out.view, layout, COUNT, 1, 8)).toBe(1);
+
+      const dets = await manager.determinantsBatchManaged(COUNT, { layout });
+      matrices.forEach((m, i) => {
+        expect(dets[i]).toBeCloseTo(MatrixUtils.determinant(m), 4);
+      });
+    });
+  }
+
+  it("should invert the composed result in place", async () => {
+    const { a, b } = await manager.getMatrixBatchBuffers(COUNT);
+    for (let i = 0; i < COUNT; i++) {
+      a.view.set(matrixAt(i, 5), i * 9);
+      b.view.set(matrixAt(i, 6), i * 9);
+    }
+    await manager.multiplyMatricesBatchManaged(COUNT);
+    const { out } = await manager.invertMatricesBatchManaged(COUNT, {
+      source: "out",
+    });
+    for (let i = 0; i < COUNT; i++) {
+      const world = MatrixUtils.multiply(matrixAt(i, 5), matrixAt(i, 6));
+      const expected = MatrixUtils.inverse(world)!;
+      for (let k = 0; k < 9; k++) {
+        expect(out.view[i * 9 + k]).toBeCloseTo(expected[k], 3);
+      }
+    }
+  });
+
+  it("should validate counts and buffer capacity", async () => {
+    await manager.getMatrixBatchBuffers(4);
+    await expect(manager.multiplyMatricesBatchManaged(-1)).rejects.toThrow(
+      /Invalid matrix count/
+    );
+    await expect(manager.multiplyMatricesBatchManaged(4096)).rejects.toThrow(
+      /lack capacity/
+    );
+    const empty = await manager.multiplyMatricesBatchManaged(0);
+    expect(empty.view).toHaveLength(0);
+  });
+});
@@ -0,0 +1,120 @@
+// src/core/wasm/__tests__/wasm-point-codec.spec.ts
+
+import { describe, it, expect, beforeAll, afterAll } from "vitest";
+import { WasmBufferManager } from "../WasmBufferManager";
+import { cleanupWasm } from "../wasm-loader";
+import { MatrixUtils } from "../../matrix/MatrixUtils";
+
+const NUM_POINTS = 5001; // Impar: cubre la cola escalar
+
+/** Paseo aleatorio: deltas pequeños, como una polilínea o una nube ordenada. */
+function walkPoints(numPoints: number): Float32Array {
+  const points = new Float32Array(numPoints * 2);
+  let seed = 11;
+  let x = 1000;
+  let y = -250;
+  for (let i = 0; i < numPoints; i++) {
+    seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+    x += ((seed % 200) - 100) * 0.01;
+    y += (((seed >> 8) % 200) - 100) * 0.01;
+    points[i * 2] = x;
+    points[i * 2 + 1] = y;
+  }
+  return points;
+}
+
+describe("WasmBufferManager - point codec", () => {
+  const manager = new WasmBufferManager();
+  const points = walkPoints(NUM_POINTS);
+
+  beforeAll(async () => {
+    await manager.initialize();
+    await manager.getInputBuffer(NUM_POINTS);
+    await manager.getOutputBuffer(NUM_POINTS);
+  });
+
+  afterAll(async () => {
+    await manager.cleanup();
+    await cleanupWasm();
+  });
+
+  it("should round-trip within half a grid step", async () => {
+    (await manager.getInputBuffer(NUM_POINTS)).view.set(points);
+    const step = 0.01;
+    const encoded = await manager.encodePointsManaged(NUM_POINTS, {
+      source: "input",
+      step,
+    });
+    // Deltas de +-1 unidad con step 0.01: unos 2 bytes por eje
+    expect(encoded.length).toBeLessThan(NUM_POINTS * 8 * 0.6);
+
+    (await manager.getInputBuffer(NUM_POINTS)).view.fill(0);
+    expect(await manager.decodePointsManaged(encoded)).toBe(NUM_POINTS);
+    const decoded = (await manager.getInputBuffer(NUM_POINTS)).view;
+    let maxError = 0;
+    for (let i = 0; i < NUM_POINTS * 2; i++) {
+      maxError = Math.max(maxError, Math.abs(decoded[i] - points[i]));
+    }
+    expect(maxError).toBeLessThanOrEqual(step / 2 + 1e-3);
+  });
+
+  it("should encode transformed output and decode it chunk by chunk", async () => {
+    const matrix = MatrixUtils.translation(5, 5);
+    (await manager.getInputBuffer(NUM_POINTS)).view.set(points);
+    await manager.transformPointsBatchManaged(matrix, NUM_POINTS);
+    const expected = manager.getOutputView(NUM_POINTS)!.slice();
+    const encoded = await manager.encodePointsManaged(NUM_POINTS);
+
+    async function* chunks() {
+      // Trozos irregulares: cabecera y varints partidos entre chunks
+      for (let offset = 0, size = 1; offset < encoded.length; size += 13) {
+        yield encoded.subarray(offset, offset + size);
+        offset += size;
+      }
+    }
+    expect(await manager.decodePointsManaged(chunks())).toBe(NUM_POINTS);
+    const decoded = (await manager.getInputBuffer(NUM_POINTS)).view;
+    for (let i = 0; i < NUM_POINTS * 2; i += 97) {
+      expect(decoded[i]).toBeCloseTo(expected[i], 1);
+    }
+  });
+
+  it("should reject bad input and corrupt or truncated streams", async () => {
+    (await manager.getInputBuffer(NUM_POINTS)).view.set(points);
+    const encoded = await manager.encodePointsManaged(100, {
+      source: "input",
+    });
+
+    await expect(
+      manager.decodePointsManaged(encoded.subarray(0, encoded.length - 3))
+    ).rejects.toThrow(/Truncated/);
+    await expect(
+      manager.decodePointsManaged(encoded.subarray(0, 10))
+    ).rejects.toThrow(/Truncated point stream header/);
+    const corrupt = encoded.slice();
+    corrupt[0] ^= 0xff;
+    await expect(manager.decodePointsManaged(corrupt)).rejects.toThrow(
+      /Invalid point stream header/
+    );
+    // Cabecera con 2^32 - 1 puntos: se rechaza antes de alocar los buffers
+    const huge = encoded.slice();
+    new DataView(huge.buffer).setUint32(4, 0xffffffff, true);
+    await expect(manager.decodePointsManaged(huge)).rejects.toThrow(
+      /declares 4294967295 points/
+    );
+    const padded = new Uint8Array(encoded.length + 1);
+    padded.set(encoded);
+    await expect(manager.decodePointsManaged(padded)).rejects.toThrow(
+      /Unexpected bytes/
+    );
+
+    (await manager.getInputBuffer(NUM_POINTS)).view[3] = Number.NaN;
+    await expect(
+      manager.encodePointsManaged(10, { source: "input" })
+    ).rejects.toThrow(/non-finite/);
+    (await manager.getInputBuffer(NUM_POINTS)).view[3] = points[3];
+    await expect(
+      manager.encodePointsManaged(10, { source: "input", step: 1e-9 })
+    ).rejects.toThrow(/step out of range/);
+  });
+});
@@ -0,0 +1,129 @@
+// src/core/wasm/__tests__/wasm-point-formats.spec.ts
+
+import { describe, it, expect, beforeAll, afterAll } from "vitest";
+import {
+  WasmBufferManager,
+  type PointQuantization,
+} from "../WasmBufferManager";
+import { cleanupWasm } from "../wasm-loader";
+import { MatrixUtils } from "../../matrix/MatrixUtils";
+
+// Decodificación de referencia de un half IEEE
+function halfToFloat(h: number): number {
+  const sign = h & 0x8000 ? -1 : 1;
+  const exp = (h >> 10) & 0x1f;
+  const mant = h & 0x3ff;
+  if (exp === 0) return sign * mant * 2 ** -24;
+  if (exp === 31) return mant ? NaN : sign * Infinity;
+  return sign * (1 + mant / 1024) * 2 ** (exp - 15);
+}
+
+const MATRIX = MatrixUtils.fromValues(1, 0.2, 0, -0.3, 1, 0, 5, -3, 1);
+const QUANT: PointQuantization = {
+  scaleX: 100,
+  scaleY: 80,
+  biasX: 5,
+  biasY: -3,
+};
+
+describe("WasmBufferManager - reduced-precision point formats", () => {
+  const manager = new WasmBufferManager();
+  const numPoints = 51; // incluye residuo escalar
+  let expected: number[] = [];
+
+  beforeAll(async () => {
+    await manager.initialize();
+  });
+
+  afterAll(async () => {
+    await manager.cleanup();
+    await cleanupWasm();
+  });
+
+  async function fillF32Input() {
+    const input = await manager.getTypedInputBuffer(numPoints, "f32");
+    expected = [];
+    for (let i = 0; i < numPoints; i++) {
+      const x = ((i * 37) % 101) - 50;
+      const y = ((i * 53) % 89) - 44;
+      input.view[i * 2] = x;
+      input.view[i * 2 + 1] = y;
+      const p = MatrixUtils.transformPoint(MATRIX, { x, y });
+      expected.push(p.x, p.y);
+    }
+  }
+
+  it("should write IEEE half floats", async () => {
+    await fillF32Input();
+    const output = await manager.getTypedOutputBuffer(numPoints, "f16");
+
+    await manager.transformPointsTypedManaged(MATRIX, numPoints, {
+      outType: "f16",
+    });
+
+    expected.forEach((e, k) => {
+      // 11 bits de mantisa: error relativo <= 2^-11
+      expect(Math.abs(halfToFloat(output.view[k]) - e)).toBeLessThanOrEqual(
+        Math.abs(e) * 2 ** -11 + 1e-6
+      );
+    });
+  });
+
+  it("should round-trip snorm16 with scale and bias", async () => {
+    await fillF32Input();
+    const quantized = await manager.getTypedOutputBuffer(numPoints, "snorm16");
+
+    await manager.transformPointsTypedManaged(MATRIX, numPoints, {
+      outType: "snorm16",
+      outQuantization: QUANT,
+    });
+
+    const q = quantized.view.slice();
+    expected.forEach((e, k) => {
+      const scale = k % 2 ? QUANT.scaleY : QUANT.scaleX;
+      const bias = k % 2 ? QUANT.biasY : QUANT.biasX;
+      expect(Math.abs((q[k] / 32767) * scale + bias - e)).toBeLessThanOrEqual(
+        scale / 32767
+      );
+    });
+
+    // Leer snorm16 de vuelta a f32 con la identidad
+    const input = await manager.getTypedInputBuffer(numPoints, "snorm16");
+    input.view.set(q);
+    const decoded = await manager.getTypedOutputBuffer(numPoints, "f32");
+    await manager.transformPointsTypedManaged(
+      MatrixUtils.identity(),
+      numPoints,
+      { inType: "snorm16", inQuantization: QUANT }
+    );
+    for (let k = 0; k < numPoints * 2; k++) {
+      const scale = k % 2 ? QUANT.scaleY : QUANT.scaleX;
+      const bias = k % 2 ? QUANT.biasY : QUANT.biasX;
+      expect(decoded.view[k]).toBeCloseTo((q[k] / 32767) * scale + bias, 3);
+    }
+  });
+
+  it("should transform half float input", async () => {
+    const input = await manager.getTypedInputBuffer(4, "f16");
+    // 1.0, 2.0, -0.5, 65504 (máximo finito), 0, 0, 0x3c00 = 1.0, 0
+    input.view.set([0x3c00, 0x4000, 0xb800, 0x7bff, 0, 0, 0x3c00, 0]);
+    const output = await manager.getTypedOutputBuffer(4, "f32");
+
+    await manager.transformPointsTypedManaged(MatrixUtils.identity(), 4, {
+      inType: "f16",
+    });
+
+    expect(Array.from(output.view)).toEqual([1, 2, -0.5, 65504, 0, 0, 1, 0]);
+  });
+
+  it("should reject a zero snorm16 scale", async () => {
+    await fillF32Input();
+    await manager.getTypedOutputBuffer(numPoints, "snorm16");
+    await expect(
+      manager.transformPointsTypedManaged(MATRIX, numPoints, {
+        outType: "snorm16",
+        outQuantization: { ...QUANT, scaleX: 0 },
+      })
+    ).rejects.toThrow();
+  });
+});
@@ -0,0 +1,111 @@
+// src/core/wasm/__tests__/wasm-point-stream.spec.ts
+
+import { describe, it, expect, beforeAll, afterAll } from "vitest";
+import { WasmBufferManager } from "../WasmBufferManager";
+import { cleanupWasm, loadWasmModule } from "../wasm-loader";
+import { expectTransformed, TEST_AFFINE } from "../../__tests__/testUtils";
+
+const M = TEST_AFFINE;
+
+function randomPoints(numPoints: number): Float32Array {
+  const points = new Float32Array(numPoints * 2);
+  for (let i = 0; i < points.length; i++) points[i] = (i % 97) - 48;
+  return points;
+}
+
+/** Comprueba uno de cada 37 puntos (las entradas llegan a 2M puntos). */
+function expectSampled(input: Float32Array, output: Float32Array) {
+  const sampled = Array.from(
+    { length: Math.ceil(input.length / 2 / 37) },
+    (_, k) => k * 37
+  );
+  expectTransformed(M, input, output, sampled);
+}
+
+describe("WasmBufferManager - streaming transform", () => {
+  const manager = new WasmBufferManager();
+
+  beforeAll(async () => {
+    await manager.initialize();
+  });
+
+  afterAll(async () => {
+    await manager.cleanup();
+    await cleanupWasm();
+  });
+
+  it("should transform an array through a fixed window", async () => {
+    const points = randomPoints(10007);
+    const output = await manager.transformPointsChunked(M, points, undefined, {
+      windowPoints: 1000,
+    });
+    expectSampled(points, output);
+  });
+
+  it("should keep WASM memory constant regardless of input size", async () => {
+    const module = await loadWasmModule();
+    const options = { windowPoints: 4096 };
+    const small = randomPoints(10000);
+    await manager.transformPointsChunked(M, small, small, options);
+    const before = manager.getPoolStats();
+    const heapBytes = module.HEAPF32.buffer.byteLength;
+
+    const large = randomPoints(2_000_000);
+    await manager.transformPointsChunked(M, large, large, options);
+    expect(module.HEAPF32.buffer.byteLength).toBe(heapBytes);
+    const after = manager.getPoolStats();
+    expect(after.systemAllocs).toBe(before.systemAllocs);
+    expect(after.liveHandles).toBe(before.liveHandles);
+    expectSampled(randomPoints(2_000_000), large);
+  });
+
+  it("should stream async chunks with double-buffered output", async () => {
+    const points = randomPoints(5000);
+    async function* chunks() {
+      yield points.subarray(0, 600);
+      yield new Float32Array(0);
+      yield points.subarray(600, 9000);
+      yield points.subarray(9000);
+    }
+    const output = new Float32Array(points.length);
+    let offset = 0;
+    let previous: { view: Float32Array; first: number } | null = null;
+    for await (const block of manager.transformPointsStream(M, chunks(), {
+      windowPoints: 1024,
+    })) {
+      expect(block.length).toBeLessThanOrEqual(2048);
+      // El bloque anterior sigue intacto mientras se procesa este
+      if (previous) expect(previous.view[0]).toBe(previous.first);
+      previous = { view: block, first: block[0] };
+      output.set(block, offset);
+      offset += block.length;
+    }
+    expect(offset).toBe(points.length);
+    expectSampled(points, output);
+  });
+
+  it("should release the window and close the source on early exit", async () => {
+    const before = manager.getPoolStats().liveHandles;
+    let closed = false;
+    async function* chunks() {
+      try {
+        for (let k = 0; k < 10; k++) yield randomPoints(200);
+      } finally {
+        closed = true;
+      }
+    }
+    let blocks = 0;
+    for await (const block of manager.transformPointsStream(M, chunks(), {
+      windowPoints: 50,
+    })) {
+      expect(block.length).toBe(100);
+      if (++blocks === 3) break;
+    }
+    expect(closed).toBe(true);
+    expect(manager.getPoolStats().liveHandles).toBe(before);
+
+    const odd = manager.transformPointsStream(M, [new Float32Array(3)]);
+    await expect(odd.next()).rejects.toThrow(/odd/);
+    expect(manager.getPoolStats().liveHandles).toBe(before);
+  });
+});
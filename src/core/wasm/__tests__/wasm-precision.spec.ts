@@ -0,0 +1,106 @@
+// src/core/wasm/__tests__/wasm-precision.spec.ts
+
+import { describe, it, expect, beforeAll, afterAll, afterEach } from "vitest";
+import { WasmBufferManager } from "../WasmBufferManager";
+import {
+  cleanupWasm,
+  TRANSFORM_PRECISION_MAX_ERROR,
+  WasmTransformPrecision,
+} from "../wasm-loader";
+import { MatrixUtils } from "../../matrix/MatrixUtils";
+import type { Matrix3x3 } from "../../../types/core.types";
+
+const FAST_MAX_ERROR =
+  TRANSFORM_PRECISION_MAX_ERROR[WasmTransformPrecision.Fast];
+
+const MATRICES: { name: string; matrix: Matrix3x3 }[] = [
+  {
+    name: "projective",
+    matrix: MatrixUtils.fromValues(0.9, 0.2, 1e-4, -0.3, 1.1, 2e-4, 40, -25, 1),
+  },
+  {
+    name: "affine",
+    matrix: MatrixUtils.fromValues(0.8, 0.3, 0, -0.2, 1.1, 0, 50, -20, 1),
+  },
+  { name: "scale", matrix: MatrixUtils.scaling(2.5, 0.75) },
+];
+
+describe("WasmBufferManager - transform precision modes", () => {
+  const manager = new WasmBufferManager();
+  const numPoints = 4099; // incluye residuo escalar
+
+  beforeAll(async () => {
+    await manager.initialize();
+  });
+
+  afterEach(() => {
+    manager.setTransformPrecision("exact");
+  });
+
+  afterAll(async () => {
+    await manager.cleanup();
+    await cleanupWasm();
+  });
+
+  async function transformWith(
+    matrix: Matrix3x3,
+    precision: "exact" | "fast"
+  ): Promise<Float32Array> {
+    const input = await manager.getInputBuffer(numPoints);
+    await manager.getOutputBuffer(numPoints);
+    // Coordenadas de pantalla pseudoaleatorias y deterministas en [-1000, 1000)
+    let seed = 12345;
+    for (let i = 0; i < numPoints * 2; i++) {
+      seed = (seed * 1103515245 + 12345) >>> 0;
+      input.view[i] = (seed / 2 ** 32) * 2000 - 1000;
+    }
+    manager.setTransformPrecision(precision);
+    await manager.transformPointsBatchManaged(matrix, numPoints);
+    return manager.getOutputView(numPoints)!.slice();
+  }
+
+  it("should default to exact and round-trip the mode", () => {
+    expect(manager.getTransformPrecision()).toBe("exact");
+    manager.setTransformPrecision("fast");
+    expect(manager.getTransformPrecision()).toBe("fast");
+  });
+
+  MATRICES.forEach(({ name, matrix }) => {
+    it(`should stay within the documented fast-mode error (${name})`, async () => {
+      const exact = await transformWith(matrix, "exact");
+      const fast = await transformWith(matrix, "fast");
+
+      let worst = 0;
+      for (let i = 0; i < exact.length; i++) {
+        expect(isNaN(fast[i])).toBe(isNaN(exact[i]));
+        if (isNaN(exact[i])) continue;
+        const err =
+          Math.abs(fast[i] - exact[i]) / Math.max(Math.abs(exact[i]), 1);
+        worst = Math.max(worst, err);
+      }
+      expect(worst).toBeLessThanOrEqual(FAST_MAX_ERROR);
+    });
+  });
+
+  it("should keep NaN for W near zero in fast mode", async () => {
+    // W = x: los puntos con x = 0 degeneran
+    const matrix = MatrixUtils.fromValues(1, 0, 1, 0, 1, 0, 0, 0, 0);
+    const input = await manager.getInputBuffer(8);
+    await manager.getOutputBuffer(8);
+    input.view.set([0, 1, 2, 3, 0, 5, 6, 7, 8, 9, 0, 0, 4, 4, 5, 5]);
+    manager.setTransformPrecision("fast");
+
+    await manager.transformPointsBatchManaged(matrix, 8);
+
+    const output = manager.getOutputView(8)!;
+    [0, 2, 5].forEach((i) => expect(isNaN(output[i * 2])).toBe(true));
+    expect(output[2]).toBeCloseTo(1, 4);
+    expect(output[3]).toBeCloseTo(1.5, 4);
+  });
+
+  it("should reject unknown precision modes", () => {
+    expect(() =>
+      manager.setTransformPrecision("turbo" as unknown as "fast")
+    ).toThrow();
+  });
+});
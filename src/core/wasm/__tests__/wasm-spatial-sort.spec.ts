@@ -0,0 +1,138 @@
+// src/core/wasm/__tests__/wasm-spatial-sort.spec.ts
+
+import { describe, it, expect, beforeAll, afterAll } from "vitest";
+import { WasmBufferManager } from "../WasmBufferManager";
+import { cleanupWasm } from "../wasm-loader";
+
+// 16 celdas: la cuantización a 16 bits lleva cada celda a sus 4 bits altos
+const GRID = 16;
+const NUM_POINTS = GRID * GRID;
+
+/** Celdas de una rejilla GRID x GRID en orden aleatorio (determinista). */
+function shuffledGrid(): Float32Array {
+  const cells = Array.from({ length: NUM_POINTS }, (_, i) => i);
+  let seed = 7;
+  for (let i = cells.length - 1; i > 0; i--) {
+    seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+    const j = seed % (i + 1);
+    [cells[i], cells[j]] = [cells[j], cells[i]];
+  }
+  const points = new Float32Array(NUM_POINTS * 2);
+  cells.forEach((cell, i) => {
+    points[i * 2] = cell % GRID;
+    points[i * 2 + 1] = Math.floor(cell / GRID);
+  });
+  return points;
+}
+
+/** Distancia Manhattan media entre puntos consecutivos del buffer. */
+function meanStep(points: Float32Array): number {
+  let total = 0;
+  for (let i = 1; i < points.length / 2; i++) {
+    total +=
+      Math.abs(points[i * 2] - points[i * 2 - 2]) +
+      Math.abs(points[i * 2 + 1] - points[i * 2 - 1]);
+  }
+  return total / (points.length / 2 - 1);
+}
+
+function expectPermutation(order: Uint32Array) {
+  const seen = new Uint8Array(order.length);
+  order.forEach((i) => seen[i]++);
+  expect(seen.every((count) => count === 1)).toBe(true);
+}
+
+describe("WasmBufferManager - spatial reordering", () => {
+  const manager = new WasmBufferManager();
+  let input: Float32Array;
+
+  beforeAll(async () => {
+    await manager.initialize();
+    input = (await manager.getInputBuffer(NUM_POINTS)).view;
+    await manager.getOutputBuffer(NUM_POINTS);
+  });
+
+  afterAll(async () => {
+    await manager.cleanup();
+    await cleanupWasm();
+  });
+
+  it("should walk a grid cell by cell along the Hilbert curve", async () => {
+    const points = shuffledGrid();
+    input.set(points);
+    const ids = Uint32Array.from({ length: NUM_POINTS }, (_, i) => i);
+    const order = await manager.reorderPointsSpatiallyManaged(NUM_POINTS, {
+      attributes: [ids],
+    });
+    expectPermutation(order);
+    expect(Array.from(ids)).toEqual(Array.from(order));
+
+    const sorted = (await manager.getInputBuffer(NUM_POINTS)).view;
+    // Hilbert: cada paso va a una celda vecina
+    expect(meanStep(sorted)).toBe(1);
+    for (let i = 0; i < NUM_POINTS; i++) {
+      expect(sorted[i * 2]).toBe(points[order[i] * 2]);
+      expect(sorted[i * 2 + 1]).toBe(points[order[i] * 2 + 1]);
+    }
+  });
+
+  it("should compute a Morton order without moving the points", async () => {
+    const points = shuffledGrid();
+    input.set(points);
+    const order = await manager.computeSpatialOrderManaged(
+      NUM_POINTS,
+      "morton"
+    );
+    expectPermutation(order);
+    // El orden en Z empieza por la esquina (0, 0), (1, 0), (0, 1), (1, 1)
+    const first = Array.from(order.subarray(0, 4), (i) => [
+      points[i * 2],
+      points[i * 2 + 1],
+    ]);
+    expect(first).toEqual([
+      [0, 0],
+      [1, 0],
+      [0, 1],
+      [1, 1],
+    ]);
+    expect(Array.from(input.subarray(0, points.length))).toEqual(
+      Array.from(points)
+    );
+    const reordered = new Float32Array(points.length);
+    order.forEach((from, i) => {
+      reordered[i * 2] = points[from * 2];
+      reordered[i * 2 + 1] = points[from * 2 + 1];
+    });
+    expect(meanStep(reordered)).toBeLessThan(meanStep(points) / 3);
+  });
+
+  it("should permute pooled and multi-component attributes", async () => {
+    input.set([5, 5, Number.NaN, 1, 0, 0]);
+    const colors = new Uint8Array([50, 51, 52, 90, 91, 92, 0, 1, 2]);
+    const handle = manager.allocBuffer(3, "f64");
+    manager.getBufferView(handle, "f64", 3).set([5, 5, 9, 9, 0, 0]);
+    const order = await manager.reorderPointsSpatiallyManaged(3, {
+      attributes: [colors, { handle, bytesPerPoint: 16 }],
+    });
+    // Los no finitos quedan al final
+    expect(Array.from(order)).toEqual([2, 0, 1]);
+    expect(Array.from(colors)).toEqual([0, 1, 2, 50, 51, 52, 90, 91, 92]);
+    expect(Array.from(manager.getBufferView(handle, "f64", 3))).toEqual([
+      0, 0, 5, 5, 9, 9,
+    ]);
+    manager.releaseBuffer(handle);
+  });
+
+  it("should validate orders and attributes before touching anything", async () => {
+    input.set([3, 3, 1, 1]);
+    await expect(
+      manager.reorderPointsSpatiallyManaged(2, {
+        attributes: [new Float32Array(3)],
+      })
+    ).rejects.toThrow(/does not match/);
+    expect(Array.from(input.subarray(0, 4))).toEqual([3, 3, 1, 1]);
+    expect(() =>
+      manager.applyPointOrder(new Uint32Array([0, 2]), [new Uint8Array(2)])
+    ).toThrow(/Invalid point order/);
+  });
+});
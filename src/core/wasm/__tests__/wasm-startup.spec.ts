@@ -0,0 +1,122 @@
+// src/core/wasm/__tests__/wasm-startup.spec.ts
+
+import { existsSync, readFileSync } from "node:fs";
+import { fileURLToPath } from "node:url";
+import { describe, it, expect, afterAll } from "vitest";
+import {
+  cleanupWasm,
+  determinantWasmSync,
+  getCompiledWasmModule,
+  getWasmDiagnostics,
+  initWasmSync,
+  isWasmReady,
+  loadWasmModule,
+} from "../wasm-loader";
+import { MatrixUtils } from "../../matrix/MatrixUtils";
+
+const A = MatrixUtils.fromValues(2, 1, 0, -1, 3, 0, 5, -4, 1);
+
+function generated(file: string): URL {
+  return new URL(`../generated/${file}`, import.meta.url);
+}
+
+async function importFactory(file: string) {
+  const glue = await import(/* @vite-ignore */ generated(file).href);
+  return glue.default as (config: object) => unknown;
+}
+
+const hasSizeBuild = existsSync(fileURLToPath(generated("matrix_ops.size.js")));
+
+// Módulo WASM vacío (solo cabecera): basta para instanciar dentro de la factory
+const EMPTY_WASM = new Uint8Array([0x00, 0x61, 0x73, 0x6d, 1, 0, 0, 0]);
+
+type InstantiateWasm = (
+  imports: WebAssembly.Imports,
+  receive: (instance: WebAssembly.Instance, module: WebAssembly.Module) => void
+) => unknown;
+
+/**
+ * Factory con el comportamiento de una build `WASM_ASYNC_COMPILATION=0`:
+ * instancia con `instantiateWasm` dentro de la llamada y devuelve el Module
+ * ya listo. Los kernels 3x3 son JS sobre HEAPF32.
+ */
+function createSyncModule(config: { instantiateWasm: InstantiateWasm }) {
+  let instantiated = false;
+  config.instantiateWasm({}, () => (instantiated = true));
+  if (!instantiated) throw new Error("instantiateWasm did not call back.");
+  const heap = new Float32Array(4096);
+  const matrixAt = (ptr: number) =>
+    heap.subarray(ptr / 4, ptr / 4 + 9) as typeof A;
+  let next = 16;
+  return {
+    HEAPF32: heap,
+    _malloc: (bytes: number) => {
+      const ptr = next;
+      next += (bytes + 15) & ~15;
+      return ptr;
+    },
+    _free: () => {},
+    _multiply_matrices_raw: (a: number, b: number, out: number) =>
+      matrixAt(out).set(MatrixUtils.multiply(matrixAt(a), matrixAt(b))),
+    _determinant_raw: (m: number) => MatrixUtils.determinant(matrixAt(m)),
+    _invert_matrix_raw: () => 0,
+  };
+}
+
+describe("WASM startup (compiled module cache, sync init)", () => {
+  afterAll(async () => {
+    await cleanupWasm();
+  });
+
+  it("should reject sync init with an asynchronous build", async () => {
+    const createModule = await importFactory("matrix_ops.js");
+    const bytes = readFileSync(fileURLToPath(generated("matrix_ops.wasm")));
+    expect(() => initWasmSync(createModule, bytes, "simd")).toThrow(
+      /WASM_ASYNC_COMPILATION/
+    );
+    expect(isWasmReady()).toBe(false);
+  });
+
+  it.skipIf(!hasSizeBuild)(
+    "should initialize synchronously from the size build",
+    async () => {
+      const createModule = await importFactory("matrix_ops.size.js");
+      const compiled = new WebAssembly.Module(
+        readFileSync(fileURLToPath(generated("matrix_ops.size.wasm")))
+      );
+      initWasmSync(createModule, compiled);
+      expect(isWasmReady()).toBe(true);
+      expect(determinantWasmSync(A)).toBeCloseTo(7, 5);
+      expect(await getCompiledWasmModule("size")).toBe(compiled);
+      await cleanupWasm();
+    }
+  );
+
+  it("should compile each variant once and reuse it after cleanup", async () => {
+    const compiled = await getCompiledWasmModule("simd");
+    expect(compiled).toBeInstanceOf(WebAssembly.Module);
+    expect(await getCompiledWasmModule("simd")).toBe(compiled);
+
+    const first = await loadWasmModule("simd");
+    await cleanupWasm();
+    const second = await loadWasmModule("simd");
+    expect(second).not.toBe(first);
+    expect(await getCompiledWasmModule("simd")).toBe(compiled);
+    expect(typeof second._malloc).toBe("function");
+  });
+
+  it("should initialize within the call from a synchronous factory", async () => {
+    const compiled = new WebAssembly.Module(EMPTY_WASM);
+    const module = initWasmSync(
+      createSyncModule as (config: object) => unknown,
+      compiled
+    );
+    expect(isWasmReady()).toBe(true);
+    expect(getWasmDiagnostics()?.variant).toBe("size");
+    expect(determinantWasmSync(A)).toBeCloseTo(7, 5);
+    // La instancia queda como módulo por defecto del loader
+    expect(await loadWasmModule()).toBe(module);
+    await cleanupWasm();
+    expect(isWasmReady()).toBe(false);
+  });
+});
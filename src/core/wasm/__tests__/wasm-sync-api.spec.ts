@@ -0,0 +1,69 @@
+// src/core/wasm/__tests__/wasm-sync-api.spec.ts
+
+import { describe, it, expect, afterAll } from "vitest";
+import {
+  cleanupWasm,
+  determinantWasmSync,
+  initWasm,
+  inverseWasmSync,
+  isWasmReady,
+  multiplyWasmSync,
+} from "../wasm-loader";
+import { MatrixUtils } from "../../matrix/MatrixUtils";
+
+const A = MatrixUtils.fromValues(2, 1, 0, -1, 3, 0, 5, -4, 1);
+const B = MatrixUtils.fromValues(0.5, 0, 0.001, 0.2, 1.5, 0, 10, 20, 1);
+
+describe("WASM sync API (raw C exports)", () => {
+  afterAll(async () => {
+    await cleanupWasm();
+  });
+
+  it("should throw before initWasm() resolves", () => {
+    expect(isWasmReady()).toBe(false);
+    expect(() => determinantWasmSync(A)).toThrow(/initWasm/);
+  });
+
+  it("should match the JS reference after initWasm()", async () => {
+    await initWasm();
+    expect(isWasmReady()).toBe(true);
+
+    const product = multiplyWasmSync(A, B);
+    const expected = MatrixUtils.multiply(A, B);
+    product.forEach((v, k) => expect(v).toBeCloseTo(expected[k], 4));
+
+    expect(determinantWasmSync(A)).toBeCloseTo(7, 5);
+
+    const inv = inverseWasmSync(A)!;
+    const identity = MatrixUtils.multiply(A, inv);
+    MatrixUtils.identity().forEach((v, k) =>
+      expect(identity[k]).toBeCloseTo(v, 5)
+    );
+  });
+
+  it("should write into the provided output and allow aliasing", async () => {
+    await initWasm();
+    const out = MatrixUtils.clone(A);
+    const result = multiplyWasmSync(out, B, out);
+    expect(result).toBe(out);
+    const expected = MatrixUtils.multiply(A, B);
+    out.forEach((v, k) => expect(v).toBeCloseTo(expected[k], 4));
+  });
+
+  it("should return null for a singular matrix", async () => {
+    await initWasm();
+    const singular = MatrixUtils.fromValues(1, 2, 0, 2, 4, 0, 0, 0, 0);
+    expect(inverseWasmSync(singular)).toBeNull();
+  });
+
+  it("should keep working after the WASM memory grows", async () => {
+    const module = await initWasm();
+    expect(determinantWasmSync(A)).toBeCloseTo(7, 5);
+    const before = module.HEAPF32.buffer;
+    // Forzar crecimiento de memoria (ALLOW_MEMORY_GROWTH) con una alocación grande
+    const ptr = module._malloc(64 * 1024 * 1024);
+    expect(module.HEAPF32.buffer).not.toBe(before);
+    expect(determinantWasmSync(A)).toBeCloseTo(7, 5);
+    module._free(ptr);
+  });
+});
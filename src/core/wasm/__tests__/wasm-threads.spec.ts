@@ -0,0 +1,79 @@
+// src/core/wasm/__tests__/wasm-threads.spec.ts
+
+import { existsSync } from "node:fs";
+import { fileURLToPath } from "node:url";
+import { describe, it, expect, beforeAll, afterAll } from "vitest";
+import { WasmBufferManager } from "../WasmBufferManager";
+import { cleanupWasm, loadWasmModule } from "../wasm-loader";
+import type { MatrixOpsWasmModule } from "../wasm-loader";
+import { MatrixUtils } from "../../matrix/MatrixUtils";
+import { expectTransformed, TEST_AFFINE } from "../../__tests__/testUtils";
+
+// Igual que PARALLEL_MIN_POINTS y THREAD_POOL_MAX_WORKERS en core_cpp
+const PARALLEL_MIN_POINTS = 65536;
+const MAX_WORKERS = 8;
+// Varios chunks de 16K y uno final incompleto
+const NUM_POINTS = PARALLEL_MIN_POINTS * 2 + 1234;
+const PERSPECTIVE = MatrixUtils.fromValues(1, 0, 1e-3, 0, 1, 2e-3, 5, -3, 1);
+
+const threadsBuild = existsSync(
+  fileURLToPath(
+    new URL("../generated/matrix_ops.threads.js", import.meta.url)
+  )
+);
+
+describe.skipIf(!threadsBuild)("WasmBufferManager - threads build", () => {
+  const manager = new WasmBufferManager();
+  let module: MatrixOpsWasmModule;
+  let input: Float32Array;
+
+  beforeAll(async () => {
+    await manager.initialize({ threads: 3 });
+    module = await loadWasmModule("threads");
+    input = (await manager.getInputBuffer(NUM_POINTS)).view;
+    await manager.getOutputBuffer(NUM_POINTS);
+    for (let i = 0; i < input.length; i++) input[i] = (i % 113) - 56;
+  });
+
+  afterAll(async () => {
+    await manager.cleanup();
+    module?.setTransformThreads(0);
+    await cleanupWasm();
+  });
+
+  it("should match the serial kernel above PARALLEL_MIN_POINTS", async () => {
+    expect(manager.getThreadCount()).toBe(3);
+    for (const matrix of [TEST_AFFINE, PERSPECTIVE]) {
+      await manager.transformPointsBatchManaged(matrix, NUM_POINTS);
+      const parallel = manager.getOutputView(NUM_POINTS)!.slice();
+
+      module.setTransformThreads(0);
+      await manager.transformPointsBatchManaged(matrix, NUM_POINTS);
+      module.setTransformThreads(3);
+      const serial = manager.getOutputView(NUM_POINTS)!;
+
+      // Mismo kernel por chunk: resultados idénticos bit a bit
+      let mismatches = 0;
+      for (let i = 0; i < serial.length; i++) {
+        if (!Object.is(parallel[i], serial[i])) mismatches++;
+      }
+      expect(mismatches).toBe(0);
+      expectTransformed(matrix, input, parallel, [
+        0,
+        16383,
+        16384,
+        PARALLEL_MIN_POINTS,
+        NUM_POINTS - 1,
+      ]);
+    }
+  });
+
+  it("should clamp the worker count of setTransformThreads", () => {
+    expect(module.setTransformThreads(-4)).toBe(0);
+    expect(module.getTransformThreads()).toBe(0);
+    expect(module.setTransformThreads(MAX_WORKERS + 10)).toBe(MAX_WORKERS);
+    expect(module.getTransformThreads()).toBe(MAX_WORKERS);
+    expect(module.setTransformThreads(3)).toBe(3);
+    expect(manager.getThreadCount()).toBe(3);
+  });
+});
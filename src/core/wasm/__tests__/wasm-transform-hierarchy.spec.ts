@@ -0,0 +1,118 @@
+// src/core/wasm/__tests__/wasm-transform-hierarchy.spec.ts
+
+import { describe, it, expect, beforeAll, afterAll } from "vitest";
+import { WasmBufferManager } from "../WasmBufferManager";
+import {
+  HIERARCHY_ROOT,
+  WasmTransformHierarchy,
+} from "../WasmTransformHierarchy";
+import { cleanupWasm } from "../wasm-loader";
+import { MatrixUtils } from "../../matrix/MatrixUtils";
+import type { Matrix3x3 } from "../../../types/core.types";
+
+const POINTS_PER_NODE = 3;
+
+function localAt(i: number): Matrix3x3 {
+  return MatrixUtils.multiply(
+    MatrixUtils.translation(i, -2 * i),
+    MatrixUtils.rotation(0.1 * i)
+  );
+}
+
+function expectMatrixClose(actual: Matrix3x3, expected: Matrix3x3) {
+  for (let k = 0; k < 9; k++) expect(actual[k]).toBeCloseTo(expected[k], 3);
+}
+
+describe("WasmTransformHierarchy", () => {
+  const manager = new WasmBufferManager();
+  let hierarchy: WasmTransformHierarchy;
+  // Escena: 2 raíces; 0 tiene un grupo (2) con 4 hojas, 1 una cadena 1 -> 7 -> 8
+  const parents = [HIERARCHY_ROOT, HIERARCHY_ROOT, 0, 2, 2, 2, 2, 1, 7];
+  const locals = parents.map((_, i) => localAt(i));
+
+  /** World esperado componiendo en JS desde la raíz. */
+  function expectedWorld(node: number): Matrix3x3 {
+    const parent = parents[node];
+    return parent === HIERARCHY_ROOT
+      ? locals[node]
+      : MatrixUtils.multiply(expectedWorld(parent), locals[node]);
+  }
+
+  beforeAll(async () => {
+    await manager.initialize();
+    hierarchy = manager.createTransformHierarchy(16);
+    parents.forEach((parent, i) => hierarchy.addNode(parent, locals[i]));
+  });
+
+  afterAll(async () => {
+    await manager.cleanup();
+    await cleanupWasm();
+  });
+
+  it("should compose world matrices down the hierarchy", () => {
+    expect(hierarchy.numNodes).toBe(parents.length);
+    expect(hierarchy.update()).toBe(parents.length);
+    parents.forEach((_, i) => {
+      expectMatrixClose(hierarchy.getWorld(i), expectedWorld(i));
+    });
+    // Nada sucio: no se recalcula nada
+    expect(hierarchy.update()).toBe(0);
+  });
+
+  it("should only update dirty subtrees", () => {
+    locals[2] = MatrixUtils.scaling(2, 0.5);
+    hierarchy.setLocal(2, locals[2]);
+    // El nodo 2 y sus 4 hojas
+    expect(hierarchy.update()).toBe(5);
+    parents.forEach((_, i) => {
+      expectMatrixClose(hierarchy.getWorld(i), expectedWorld(i));
+    });
+
+    hierarchy.markDirty(7);
+    expect(hierarchy.update()).toBe(2);
+  });
+
+  it("should transform each node's points in the same pass", async () => {
+    const numPoints = parents.length * POINTS_PER_NODE;
+    const input = (await manager.getInputBuffer(numPoints)).view;
+    await manager.getOutputBuffer(numPoints);
+    for (let i = 0; i < numPoints * 2; i++) input[i] = (i % 7) - 3;
+    parents.forEach((_, i) => {
+      hierarchy.setPointRange(i, i * POINTS_PER_NODE, POINTS_PER_NODE);
+    });
+
+    expect(
+      manager.updateTransformHierarchyManaged(hierarchy, numPoints)
+    ).toBe(parents.length);
+    const output = manager.getOutputView(numPoints)!;
+    parents.forEach((_, node) => {
+      const world = expectedWorld(node);
+      for (let j = 0; j < POINTS_PER_NODE; j++) {
+        const i = node * POINTS_PER_NODE + j;
+        const p = MatrixUtils.transformPoint(world, {
+          x: input[i * 2],
+          y: input[i * 2 + 1],
+        });
+        expect(output[i * 2]).toBeCloseTo(p.x, 3);
+        expect(output[i * 2 + 1]).toBeCloseTo(p.y, 3);
+      }
+    });
+  });
+
+  it("should validate nodes, capacity and point ranges", () => {
+    expect(() => hierarchy.addNode(42)).toThrow(/Invalid hierarchy node/);
+    expect(() => hierarchy.setPointRange(0, -1, 2)).toThrow(/Invalid point/);
+
+    hierarchy.setPointRange(0, 0, 1000);
+    expect(() =>
+      manager.updateTransformHierarchyManaged(hierarchy, 27)
+    ).toThrow(/exceed/);
+    hierarchy.setPointRange(0, 0, 0);
+
+    const small = manager.createTransformHierarchy(1);
+    small.addNode();
+    expect(() => small.addNode()).toThrow(/full/);
+    small.dispose();
+    expect(() => small.update()).toThrow(/disposed/);
+  });
+});
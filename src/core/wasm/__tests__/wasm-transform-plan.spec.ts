@@ -0,0 +1,117 @@
+// src/core/wasm/__tests__/wasm-transform-plan.spec.ts
+
+import { describe, it, expect, beforeAll, afterAll } from "vitest";
+import { WasmBufferManager } from "../WasmBufferManager";
+import { cleanupWasm, WasmMatrixClass } from "../wasm-loader";
+import { MatrixUtils } from "../../matrix/MatrixUtils";
+import { expectTransformed, TEST_AFFINE } from "../../__tests__/testUtils";
+
+const AFFINE = TEST_AFFINE;
+const PROJECTIVE = MatrixUtils.fromValues(1, 0, 0.001, 0, 1, 0.002, 3, 4, 1);
+
+describe("WasmBufferManager - transform plans", () => {
+  const manager = new WasmBufferManager();
+
+  beforeAll(async () => {
+    await manager.initialize();
+  });
+
+  afterAll(async () => {
+    await manager.cleanup();
+    await cleanupWasm();
+  });
+
+  it("should execute repeatedly and follow updateMatrix", async () => {
+    const numPoints = 103;
+    const input = await manager.getInputBuffer(numPoints);
+    await manager.getOutputBuffer(numPoints);
+    for (let i = 0; i < numPoints * 2; i++) input.view[i] = (i % 17) - 8;
+    const points = Float32Array.from(input.view);
+
+    const plan = manager.createTransformPlan(AFFINE, numPoints);
+    expect(plan.matrixClass).toBe(WasmMatrixClass.Affine);
+    plan.execute();
+    const out = () => manager.getOutputView(numPoints)!;
+    const readOut = (i: number): [number, number] => [
+      out()[i * 2],
+      out()[i * 2 + 1],
+    ];
+    expectTransformed(AFFINE, points, readOut);
+
+    expect(plan.updateMatrix(PROJECTIVE)).toBe(WasmMatrixClass.Projective);
+    plan.execute();
+    expectTransformed(PROJECTIVE, points, readOut);
+
+    expect(plan.updateMatrix(MatrixUtils.translation(2, 3))).toBe(
+      WasmMatrixClass.Translate
+    );
+    plan.execute();
+    expect(out()[0]).toBeCloseTo(points[0] + 2, 5);
+    plan.dispose();
+    expect(() => plan.execute()).toThrow(/disposed/);
+  });
+
+  it("should support interleaved in-place and SoA layouts", () => {
+    const numPoints = 21;
+    // x,y,u,v por vértice (+1 punto para el offset de la salida uv)
+    const vertices = manager.allocBuffer(numPoints * 2 + 1);
+    const view = manager.getBufferView(vertices);
+    for (let i = 0; i < numPoints; i++) {
+      view[i * 4] = i - 10;
+      view[i * 4 + 1] = 2 * i;
+    }
+    const xy = Float32Array.from({ length: numPoints * 2 }, (_, k) =>
+      k % 2 === 0 ? (k >> 1) - 10 : 2 * (k >> 1)
+    );
+    const uvPlan = manager.createTransformPlan(AFFINE, numPoints, {
+      input: vertices,
+      inLayout: { kind: "interleaved", stride: 4 },
+      outLayout: { kind: "interleaved", stride: 4, offset: 2 },
+      inPlace: true,
+    });
+    uvPlan.execute();
+    expectTransformed(AFFINE, xy, (i) => [view[i * 4 + 2], view[i * 4 + 3]]);
+
+    const soaIn = manager.allocBuffer(numPoints);
+    const soaOut = manager.allocBuffer(numPoints);
+    const soa = manager.getBufferView(soaIn);
+    for (let i = 0; i < numPoints; i++) {
+      soa[i] = xy[i * 2];
+      soa[numPoints + i] = xy[i * 2 + 1];
+    }
+    const soaPlan = manager.createTransformPlan(PROJECTIVE, numPoints, {
+      input: soaIn,
+      output: soaOut,
+      inLayout: { kind: "soa" },
+    });
+    soaPlan.execute();
+    const res = manager.getBufferView(soaOut);
+    expectTransformed(PROJECTIVE, xy, (i) => [res[i], res[numPoints + i]]);
+  });
+
+  it("should reject unresolvable overlap and detect stale buffers", () => {
+    const handle = manager.allocBuffer(64);
+    expect(() =>
+      manager.createTransformPlan(AFFINE, 16, {
+        input: handle,
+        inLayout: { kind: "interleaved", stride: 4 },
+        outLayout: { kind: "interleaved", stride: 6, offset: 2 },
+        inPlace: true,
+      })
+    ).toThrow(/overlap/);
+
+    const plan = manager.createTransformPlan(AFFINE, 64, {
+      input: handle,
+      inPlace: true,
+    });
+    plan.execute();
+    manager.resizeBuffer(handle, 100000);
+    expect(() => plan.execute()).toThrow(/stale/);
+    expect(() =>
+      manager.createTransformPlan(AFFINE, 200000, {
+        input: handle,
+        inPlace: true,
+      })
+    ).toThrow(/capacity/);
+  });
+});
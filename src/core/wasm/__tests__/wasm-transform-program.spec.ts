@@ -0,0 +1,128 @@
+// src/core/wasm/__tests__/wasm-transform-program.spec.ts
+
+import { describe, it, expect, beforeAll, afterAll } from "vitest";
+import { WasmBufferManager } from "../WasmBufferManager";
+import { cleanupWasm } from "../wasm-loader";
+import { MatrixUtils } from "../../matrix/MatrixUtils";
+import {
+  CropCommand,
+  CustomTransformCommand,
+  PerspectiveCommand,
+  ResizeCommand,
+  RotateCommand,
+  ScaleCommand,
+  SkewCommand,
+  TranslateCommand,
+} from "../../commands";
+import type { TransformCommand } from "../../commands";
+import type { Matrix3x3 } from "../../../types/core.types";
+
+function expectMatrixClose(actual: ArrayLike<number>, expected: Matrix3x3) {
+  for (let k = 0; k < 9; k++) {
+    expect(actual[k]).toBeCloseTo(expected[k], 3);
+  }
+}
+
+describe("WasmTransformProgram", () => {
+  const manager = new WasmBufferManager();
+  let sequences: TransformCommand[][];
+
+  beforeAll(async () => {
+    await manager.initialize();
+    const perspective = await PerspectiveCommand.create(
+      [
+        { x: 0, y: 0 },
+        { x: 100, y: 0 },
+        { x: 100, y: 100 },
+        { x: 0, y: 100 },
+      ],
+      [
+        { x: 10, y: 10 },
+        { x: 90, y: 5 },
+        { x: 110, y: 90 },
+        { x: 5, y: 110 },
+      ]
+    );
+    sequences = [
+      [
+        new TranslateCommand(3, -4),
+        new RotateCommand(0.7, { x: 10, y: 20 }),
+        new ScaleCommand(2, 0.5, { x: 5, y: 5 }),
+        new SkewCommand(0.2, -0.1),
+        new CustomTransformCommand(
+          MatrixUtils.fromValues(1.1, 0.2, 0, -0.3, 0.9, 0, 7, -8, 1)
+        ),
+      ],
+      [new RotateCommand(-1.2), new ScaleCommand(1.5, 1.5), perspective],
+      // Crop/Resize reinician la matriz: solo cuenta lo que viene después
+      [
+        new TranslateCommand(50, 50),
+        new CropCommand({ x: 0, y: 0, width: 10, height: 10 }),
+        new TranslateCommand(1, 2),
+        new ResizeCommand(64, 32),
+        new RotateCommand(0.3),
+      ],
+      [],
+    ];
+  });
+
+  afterAll(async () => {
+    await manager.cleanup();
+    await cleanupWasm();
+  });
+
+  it("should fold every sequence like MatrixUtils.combine", () => {
+    const program = manager.createTransformProgram();
+    sequences.forEach((commands, i) => {
+      expect(program.addSequence(commands)).toBe(i);
+    });
+    expect(program.sequenceCount).toBe(sequences.length);
+
+    const out = manager.evaluateTransformProgramManaged(program).view;
+    sequences.forEach((commands, i) => {
+      expectMatrixClose(
+        out.subarray(i * 9, i * 9 + 9),
+        MatrixUtils.combine(commands)
+      );
+    });
+  });
+
+  it("should write SoA matrices into the batch buffers", () => {
+    const program = manager.createTransformProgram();
+    sequences.forEach((commands) => program.addSequence(commands));
+    const count = program.sequenceCount;
+
+    const out = manager.evaluateTransformProgramManaged(program, {
+      target: "batchA",
+      layout: "soa",
+    });
+    sequences.forEach((commands, i) => {
+      const expected = MatrixUtils.combine(commands);
+      for (let k = 0; k < 9; k++) {
+        expect(out.view[k * count + i]).toBeCloseTo(expected[k], 3);
+      }
+    });
+  });
+
+  it("should reject unsupported commands and keep the program intact", () => {
+    const program = manager.createTransformProgram({ maxWords: 16 });
+    program.addSequence([new TranslateCommand(1, 1)]);
+    const words = program.wordCount;
+
+    const unknown = { name: "warp" } as unknown as TransformCommand;
+    expect(() =>
+      program.addSequence([new TranslateCommand(2, 2), unknown])
+    ).toThrow(/Unsupported transform command/);
+    expect(() => program.addSequence(sequences[0])).toThrow(/full/);
+    expect(program.wordCount).toBe(words);
+    expect(program.sequenceCount).toBe(1);
+
+    const out = manager.evaluateTransformProgramManaged(program).view;
+    expectMatrixClose(out.subarray(0, 9), MatrixUtils.translation(1, 1));
+
+    program.reset();
+    expect(program.sequenceCount).toBe(0);
+    program.dispose();
+    expect(() => program.addSequence([])).toThrow(/disposed/);
+  });
+});
@@ -0,0 +1,59 @@
+// src/core/wasm/__tests__/wasm-variants.spec.ts
+
+import { describe, it, expect, afterAll } from "vitest";
+import {
+  cleanupWasm,
+  detectWasmFeatures,
+  getWasmDiagnostics,
+  getWasmVariantCandidates,
+  loadWasmModule,
+} from "../wasm-loader";
+import { WasmBufferManager } from "../WasmBufferManager";
+
+describe("WASM loader - build variant selection", () => {
+  afterAll(async () => {
+    await cleanupWasm();
+  });
+
+  it("should detect SIMD support in the test runtime", () => {
+    const features = detectWasmFeatures();
+    expect(features.simd).toBe(true);
+    expect(typeof features.relaxedSimd).toBe("boolean");
+    expect(typeof features.threads).toBe("boolean");
+  });
+
+  it("should order candidates from fastest to baseline", () => {
+    const none = { simd: false, relaxedSimd: false, threads: false };
+    expect(getWasmVariantCandidates(none)).toEqual(["baseline"]);
+    expect(getWasmVariantCandidates({ ...none, simd: true })).toEqual([
+      "simd",
+      "baseline",
+    ]);
+    expect(
+      getWasmVariantCandidates({ simd: true, relaxedSimd: true, threads: true })
+    ).toEqual(["relaxed", "simd", "baseline"]);
+  });
+
+  it("should report the selected variant after loading the default module", async () => {
+    expect(getWasmDiagnostics()).toBeNull();
+    const module = await loadWasmModule();
+
+    const diagnostics = getWasmDiagnostics()!;
+    expect(diagnostics).not.toBeNull();
+    expect(diagnostics.candidates).toContain(diagnostics.variant);
+    // Las candidatas previas a la elegida fallaron al cargar (build no desplegada)
+    const index = diagnostics.candidates.indexOf(diagnostics.variant);
+    expect(diagnostics.failures.map((f) => f.variant)).toEqual(
+      diagnostics.candidates.slice(0, index)
+    );
+    // Pedir explícitamente la variante elegida devuelve la misma instancia
+    expect(await loadWasmModule(diagnostics.variant)).toBe(module);
+  });
+
+  it("should expose the variant in use through WasmBufferManager", async () => {
+    const manager = new WasmBufferManager();
+    await manager.initialize();
+    expect(manager.getVariant()).toBe(getWasmDiagnostics()!.variant);
+    await manager.cleanup();
+  });
+});
@@ -0,0 +1,114 @@
+// src/core/wasm/__tests__/wasm-worker-pipeline.spec.ts
+
+import { existsSync } from "node:fs";
+import { fileURLToPath } from "node:url";
+import { describe, it, expect, beforeAll, afterAll } from "vitest";
+import { WasmWorkerPipeline } from "../WasmWorkerPipeline";
+import { cleanupWasm } from "../wasm-loader";
+import { MatrixUtils } from "../../matrix/MatrixUtils";
+import { expectTransformed, TEST_AFFINE } from "../../__tests__/testUtils";
+
+const A = TEST_AFFINE;
+const B = MatrixUtils.translation(10, -5);
+
+const hasThreadsBuild = existsSync(
+  fileURLToPath(
+    new URL("../generated/matrix_ops.threads.js", import.meta.url)
+  )
+);
+
+describe("WasmWorkerPipeline", () => {
+  let pipeline: WasmWorkerPipeline;
+  const points = new Float32Array(2 * 1000).map((_, i) => (i % 41) - 20);
+
+  beforeAll(async () => {
+    pipeline = await WasmWorkerPipeline.create({ maxPoints: 4096 });
+  });
+
+  afterAll(async () => {
+    pipeline.dispose();
+    await cleanupWasm();
+  });
+
+  it("should transform points in the worker", async () => {
+    expectTransformed(A, points, await pipeline.transform(A, points));
+  });
+
+  it("should keep both frames of the double buffer", async () => {
+    pipeline.nextInput(1000).set(points);
+    const first = pipeline.submit(A, 1000);
+    pipeline.nextInput(500).set(points.subarray(0, 1000));
+    const second = pipeline.submit(B, 500);
+    expect(second).toBe(first + 1);
+
+    const firstOutput = await pipeline.result(first);
+    const secondOutput = await pipeline.result(second);
+    expect(pipeline.isDone(second)).toBe(true);
+    expectTransformed(A, points, firstOutput);
+    expectTransformed(B, points.subarray(0, 1000), secondOutput);
+
+    // Un tercer job reutiliza el slot del primero
+    pipeline.nextInput(10).fill(0);
+    const third = pipeline.submit(B, 10);
+    await pipeline.result(third);
+    await expect(pipeline.result(first)).rejects.toThrow(/overwritten/);
+    expectTransformed(B, points.subarray(0, 1000), secondOutput);
+  });
+
+  it("should pipeline many frames in order", async () => {
+    let previous = 0;
+    for (let frame = 1; frame <= 50; frame++) {
+      pipeline.nextInput(100).fill(frame);
+      const job = pipeline.submit(MatrixUtils.translation(frame, 0), 100);
+      if (previous) {
+        const output = await pipeline.result(previous);
+        // Frame anterior: x = (frame - 1) + (frame - 1)
+        expect(output[0]).toBe(2 * (frame - 1));
+      }
+      previous = job;
+    }
+    expect((await pipeline.result(previous))[0]).toBe(100);
+  });
+
+  it("should stage points when the WASM heap is not shared", async () => {
+    const staged = await WasmWorkerPipeline.create({
+      maxPoints: 64,
+      variant: "simd",
+    });
+    try {
+      expect(staged.sharedHeap).toBe(false);
+      const input = points.subarray(0, 128);
+      expectTransformed(A, input, await staged.transform(A, input));
+    } finally {
+      staged.dispose();
+    }
+  });
+
+  it.skipIf(!hasThreadsBuild)(
+    "should transform in the shared heap of the threads build",
+    async () => {
+      const shared = await WasmWorkerPipeline.create({
+        maxPoints: 64,
+        variant: "threads",
+      });
+      try {
+        expect(shared.sharedHeap).toBe(true);
+        const input = shared.nextInput(64);
+        input.set(points.subarray(0, 128));
+        const output = await shared.result(shared.submit(A, 64));
+        // Entrada y salida son vistas del mismo heap: sin copias
+        expect(output.buffer).toBe(input.buffer);
+        expectTransformed(A, points.subarray(0, 128), output);
+      } finally {
+        shared.dispose();
+      }
+    }
+  );
+
+  it("should validate sizes and reject use after dispose", async () => {
+    expect(() => pipeline.submit(A, 5000)).toThrow(/Invalid point count/);
+    const other = await WasmWorkerPipeline.create({ maxPoints: 16 });
+    other.dispose();
+    expect(() => other.submit(A, 1)).toThrow(/disposed/);
+  });
+});
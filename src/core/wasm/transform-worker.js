@@ -0,0 +1,169 @@
+// src/core/wasm/transform-worker.js
+// Worker de `WasmWorkerPipeline`. Es JS (ESM) sin imports para que worker_threads
+// lo cargue tal cual en Node, sin bundler; en el navegador lo empaqueta Vite.
+//
+// Protocolo:
+// 1. El hilo principal envía "init" con el SharedArrayBuffer de control, el
+//    layout, el WebAssembly.Module ya compilado y la URL del JS generado.
+// 2. El worker instancia el módulo, aloca sus buffers y responde "ready" (o
+//    "error"). Si el heap WASM es compartido (build `threads`), los slots de
+//    entrada/salida se alocan en él y "ready" lleva el heap y sus offsets: el
+//    hilo principal escribe y lee ahí directamente, sin copias.
+// 3. A partir de ahí solo hay memoria compartida: el job k usa el slot
+//    (k - 1) % slots, con su descriptor. El worker procesa los jobs en orden
+//    y publica en CONTROL_COMPLETED el último terminado. Se bloquea con
+//    Atomics.wait sobre CONTROL_SIGNAL cuando no hay trabajo.
+
+// Palabras de control y campos del descriptor (igual que en WasmWorkerPipeline.ts)
+const CONTROL_SUBMITTED = 0;
+const CONTROL_COMPLETED = 1;
+const CONTROL_STOP = 2;
+const CONTROL_SIGNAL = 3;
+const JOB_POINTS = 0;
+const JOB_MATRIX = 4;
+
+/** Canal con el hilo principal (Worker del navegador o worker_threads). */
+async function connect() {
+  if (typeof WorkerGlobalScope !== "undefined") {
+    return {
+      post: (message) => self.postMessage(message),
+      once: (listener) =>
+        self.addEventListener("message", (event) => listener(event.data), {
+          once: true,
+        }),
+    };
+  }
+  // Especificador en variable para que Vite no intente resolverlo en el navegador
+  const workerThreads = "node:worker_threads";
+  const { parentPort } = await import(/* @vite-ignore */ workerThreads);
+  return {
+    post: (message) => parentPort.postMessage(message),
+    once: (listener) => parentPort.once("message", listener),
+  };
+}
+
+async function instantiate(wasmModule, glueUrl) {
+  const { default: createModule } = await import(/* @vite-ignore */ glueUrl);
+  // En un worker la instanciación síncrona no tiene límite de tamaño y sirve
+  // tanto para las builds asíncronas como para la `size`
+  return createModule({
+    instantiateWasm: (imports, receive) => {
+      const instance = new WebAssembly.Instance(wasmModule, imports);
+      receive(instance, wasmModule);
+      return instance.exports;
+    },
+  });
+}
+
+function allocate(module, bytes) {
+  const ptr = module._malloc(bytes);
+  if (!ptr) {
+    throw new Error(`Failed to allocate ${bytes} bytes in the worker.`);
+  }
+  return ptr;
+}
+
+/**
+ * Punteros WASM de cada slot. Con heap compartido no hay buffers intermedios;
+ * si no, cada slot tiene un bloque en el heap y las vistas del SharedArrayBuffer
+ * de staging (`input`/`output`), que se copian en cada job.
+ */
+function allocateSlots(module, layout) {
+  const pointBytes = layout.maxPoints * 2 * Float32Array.BYTES_PER_ELEMENT;
+  const floats = layout.maxPoints * 2;
+  const staging = layout.staging;
+  if (!staging) {
+    return Array.from({ length: layout.slots }, () => ({
+      inputPtr: allocate(module, pointBytes),
+      outputPtr: allocate(module, pointBytes),
+    }));
+  }
+  const inputPtr = allocate(module, pointBytes);
+  const outputPtr = allocate(module, pointBytes);
+  return staging.inputOffsets.map((offset, k) => ({
+    inputPtr,
+    outputPtr,
+    input: new Float32Array(staging.buffer, offset, floats),
+    output: new Float32Array(staging.buffer, staging.outputOffsets[k], floats),
+  }));
+}
+
+function run(module, control, layout, matrixPtr, slots) {
+  const length = layout.slots * layout.descriptorInts;
+  const descInts = new Int32Array(
+    control.buffer,
+    layout.descriptorOffset,
+    length
+  );
+  const descFloats = new Float32Array(
+    control.buffer,
+    layout.descriptorOffset,
+    length
+  );
+
+  let next = Atomics.load(control, CONTROL_COMPLETED) + 1;
+  for (;;) {
+    // Leer la señal antes de comprobar: si llega un job después, wait no se bloquea
+    const signal = Atomics.load(control, CONTROL_SIGNAL);
+    if (Atomics.load(control, CONTROL_SUBMITTED) < next) {
+      if (Atomics.load(control, CONTROL_STOP)) return;
+      Atomics.wait(control, CONTROL_SIGNAL, signal);
+      continue;
+    }
+
+    const slot = (next - 1) % layout.slots;
+    const base = slot * layout.descriptorInts;
+    const numPoints = descInts[base + JOB_POINTS];
+    const { inputPtr, outputPtr, input, output } = slots[slot];
+    // El bucle no aloca, así que HEAPF32 no cambia entre jobs
+    const heap = module.HEAPF32;
+    const matrix = base + JOB_MATRIX;
+    heap.set(descFloats.subarray(matrix, matrix + 9), matrixPtr / 4);
+    if (input) heap.set(input.subarray(0, numPoints * 2), inputPtr / 4);
+    module.transformPointsBatch(matrixPtr, inputPtr, outputPtr, numPoints);
+    if (output) {
+      const out = outputPtr / 4;
+      output.set(heap.subarray(out, out + numPoints * 2));
+    }
+
+    Atomics.store(control, CONTROL_COMPLETED, next);
+    Atomics.notify(control, CONTROL_COMPLETED);
+    next++;
+  }
+}
+
+const channel = await connect();
+channel.once(async ({ buffer, layout, wasmModule, glueUrl }) => {
+  let module;
+  let matrixPtr;
+  let slots;
+  try {
+    module = await instantiate(wasmModule, glueUrl);
+    const shared =
+      typeof SharedArrayBuffer !== "undefined" &&
+      module.HEAPF32.buffer instanceof SharedArrayBuffer;
+    if (!shared && !layout.staging) {
+      throw new Error(
+        "The WASM heap is not shared (requires the threads build)."
+      );
+    }
+    matrixPtr = allocate(module, 9 * Float32Array.BYTES_PER_ELEMENT);
+    slots = allocateSlots(module, layout);
+  } catch (error) {
+    channel.post({ type: "error", message: String(error) });
+    return;
+  }
+  if (layout.staging) {
+    channel.post({ type: "ready" });
+  } else {
+    // Tras las alocaciones: el heap ya no crece y este buffer sigue vigente
+    channel.post({
+      type: "ready",
+      heap: module.HEAPF32.buffer,
+      inputOffsets: slots.map((slot) => slot.inputPtr),
+      outputOffsets: slots.map((slot) => slot.outputPtr),
+    });
+  }
+  const control = new Int32Array(buffer, 0, layout.controlInts);
+  run(module, control, layout, matrixPtr, slots);
+});
@@ -11,31 +11,439 @@ export interface MatrixOpsWasmModule extends EmscriptenModule {
   determinant(mPtr: number): number;
   invertMatrix(mPtr: number, outPtr: number): boolean; // Devuelve boolean
   solveHomographySVD(aPtr: number, bPtr: number, xPtr: number): boolean;
+  multiplyMatricesBatch(
+    aPtr: number,
+    numA: number, // 1 (A compartida) o count
+    bPtr: number,
+    outPtr: number,
+    count: number,
+    layout: number // 0 AoS, 1 SoA
+  ): number; // 1 éxito, 0 parámetros o solapamiento inválidos
+  invertMatrices(
+    mPtr: number,
+    outPtr: number,
+    maskOutPtr: number, // uint8 por matriz, 0 = sin máscara
+    count: number,
+    layout: number
+  ): number; // Matrices invertidas, -1 parámetros o solapamiento inválidos
+  determinants(
+    mPtr: number,
+    outPtr: number,
+    count: number,
+    layout: number
+  ): number; // 1 éxito, 0 parámetros inválidos
+  // Variantes f64 (punteros a Float64Array(9) column-major)
+  multiplyMatricesF64(aPtr: number, bPtr: number, outPtr: number): void;
+  determinantF64(mPtr: number): number;
+  invertMatrixF64(mPtr: number, outPtr: number): number; // 1 éxito, 0 singular
   transformPointsBatch(
     matrixPtr: number,
     pointsInPtr: number,
     pointsOutPtr: number,
     numPoints: number
   ): void;
+  transformPointsBatchStats(
+    matrixPtr: number,
+    pointsInPtr: number,
+    pointsOutPtr: number,
+    numPoints: number,
+    statsPtr: number
+  ): number; // Puntos degenerados (NaN); escribe PointBatchStats en statsPtr
+  transformPointsCull(
+    matrixPtr: number,
+    pointsInPtr: number,
+    pointsOutPtr: number,
+    indicesOutPtr: number, // 0 para no escribir índices
+    numPoints: number,
+    minX: number,
+    minY: number,
+    maxX: number,
+    maxY: number
+  ): number; // Puntos supervivientes (compactados al inicio de la salida)
+  transformPointsTyped(
+    matrixPtr: number,
+    inPtr: number,
+    inFormat: number, // WasmPointFormat
+    outPtr: number,
+    outFormat: number, // WasmPointFormat
+    numPoints: number,
+    quantPtr: number // 0 o 8 floats: escala/bias de entrada y de salida
+  ): number; // 1 éxito, 0 formato/escala/solapamiento inválido
+  transformPointsBatchF64(
+    matrixPtr: number, // 9 doubles
+    pointsInPtr: number, // xyxy f64
+    pointsOutPtr: number, // xyxy f64
+    numPoints: number
+  ): void;
+  transformPointsBatchF64ToF32(
+    matrixPtr: number, // 9 doubles
+    pointsInPtr: number, // xyxy f64
+    pointsOutPtr: number, // xyxy f32, relativo al origen
+    numPoints: number,
+    originX: number,
+    originY: number
+  ): void;
+  transformPointsStrided(
+    matrixPtr: number,
+    inPtr: number,
+    inOffset: number,
+    inStride: number,
+    outPtr: number,
+    outOffset: number,
+    outStride: number,
+    numPoints: number
+  ): number; // 1 éxito, 0 parámetros/solapamiento inválidos
+  transformPointsSoA(
+    matrixPtr: number,
+    xInPtr: number,
+    yInPtr: number,
+    xOutPtr: number,
+    yOutPtr: number,
+    numPoints: number
+  ): number; // 1 éxito, 0 solapamiento inválido
+  transformPointsInstanced(
+    matricesPtr: number,
+    numMatrices: number,
+    indicesPtr: number,
+    pointsInPtr: number,
+    pointsOutPtr: number,
+    numPoints: number
+  ): number; // Puntos con índice de instancia inválido
+  transformPointsInstanceRanges(
+    matricesPtr: number,
+    rangesPtr: number,
+    numInstances: number,
+    pointsInPtr: number,
+    pointsOutPtr: number,
+    numPoints: number
+  ): number; // 1 éxito, 0 rango fuera de límites
+  transformPointsRanges(
+    matrixPtr: number,
+    rangesPtr: number,
+    numRanges: number,
+    pointsInPtr: number,
+    pointsOutPtr: number,
+    numPoints: number
+  ): number; // Puntos transformados, -1 rango fuera de límites
+  spatialOrder(
+    pointsPtr: number,
+    numPoints: number,
+    curve: number, // 0 Morton, 1 Hilbert
+    permOutPtr: number,
+    keysOutPtr: number // 0 = no devolver las claves
+  ): number; // 1 éxito, 0 curva o recuento inválidos
+  applyPermutation(
+    permPtr: number,
+    numElements: number,
+    srcPtr: number,
+    dstPtr: number,
+    elementBytes: number
+  ): number; // 1 éxito, 0 índice fuera de rango o solapamiento parcial
+  encodePoints(
+    pointsPtr: number,
+    numPoints: number,
+    step: number, // <= 0: 2^16 celdas dentro del AABB
+    outPtr: number,
+    outCapacity: number
+  ): number; // Bytes escritos o código de error negativo
+  decodePoints(
+    inPtr: number,
+    availableBytes: number,
+    outPtr: number,
+    outCapacityPoints: number,
+    statePtr: number // 4 int32 a cero al empezar el stream
+  ): number; // Puntos decodificados hasta ahora o código de error negativo
+  classifyMatrix(matrixPtr: number): number; // Devuelve un WasmMatrixClass
+  setTransformThreads(numWorkers: number): number; // Workers activos (0 sin pthreads)
+  getTransformThreads(): number;
+  setTransformPrecision(mode: number): number; // WasmTransformPrecision; devuelve el activo
+  getTransformPrecision(): number;
+  hasRelaxedSimd(): number; // 1 en la build relaxed-SIMD
 
   // Funciones Exportadas (C - con guion bajo)
   _malloc(size: number): number; // ptr
   _free(ptr: number): void;
+  // ABI C plana para 3x3 (sin Embind), usadas por la API síncrona
+  _multiply_matrices_raw(aPtr: number, bPtr: number, outPtr: number): void;
+  _determinant_raw(mPtr: number): number;
+  _invert_matrix_raw(mPtr: number, outPtr: number): number; // 1 éxito, 0 singular
+  // Intérprete del command buffer; devuelve los comandos ejecutados
+  _execute_ops(
+    opsPtr: number,
+    numWords: number,
+    slotsPtr: number,
+    numSlots: number
+  ): number;
+  // Pool de buffers por handles (buffer_pool.h); handle 0 = fallo
+  _pool_alloc(bytes: number): number;
+  _pool_realloc(handle: number, bytes: number, preserve: number): number;
+  _pool_free(handle: number): void;
+  _arena_alloc(bytes: number): number;
+  _arena_reset(): void;
+  _pool_trim(): void;
+  _pool_ptr(handle: number): number; // 0 si el handle está liberado o caducado
+  _pool_capacity(handle: number): number;
+  _pool_stats(outPtr: number): void; // 8 uint32, ver WasmPoolStats
+  // Planes de transformación (transform_plan.h); id 0 = fallo
+  _plan_create(
+    layout: number, // 0 packed, 1 strided, 2 SoA
+    in0Ptr: number,
+    in1Ptr: number,
+    out0Ptr: number,
+    out1Ptr: number,
+    inStride: number,
+    outStride: number,
+    numPoints: number
+  ): number;
+  _plan_matrix_ptr(id: number): number;
+  _plan_update_matrix(id: number): number; // WasmMatrixClass, -1 id inválido
+  _plan_execute(id: number): number;
+  _plan_destroy(id: number): void;
+  // Jerarquías de transformaciones (transform_hierarchy.h); id 0 = fallo
+  _hierarchy_create(capacity: number): number;
+  _hierarchy_local_ptr(id: number): number; // 9 planos f32 de `capacity`
+  _hierarchy_world_ptr(id: number): number;
+  _hierarchy_parent_ptr(id: number): number; // int32, -1 = raíz
+  _hierarchy_dirty_ptr(id: number): number; // uint8
+  _hierarchy_ranges_ptr(id: number): number; // [start, count] int32 por nodo
+  _update_world_matrices(
+    id: number,
+    numNodes: number,
+    pointsInPtr: number, // 0 = solo matrices
+    pointsOutPtr: number,
+    numPoints: number
+  ): number; // Nodos recalculados, -1 parámetros inválidos
+  _hierarchy_destroy(id: number): void;
+  // Animaciones por keyframes (keyframe_animation.h); id 0 = fallo
+  _animation_create(): number;
+  _animation_add_track(
+    id: number,
+    matricesPtr: number, // AoS column-major, 9 f32 por keyframe
+    timesPtr: number, // f32 estrictamente crecientes
+    easingsPtr: number, // uint8 (KEYFRAME_EASING_CODES) por keyframe
+    numKeys: number
+  ): number; // Índice de pista, -1 keyframes inválidos, -2 matriz no afín
+  _animation_evaluate(
+    id: number,
+    time: number,
+    outPtr: number,
+    layout: number // 0 = AoS, 1 = SoA
+  ): number; // Pistas evaluadas, -1 parámetros inválidos
+  _animation_destroy(id: number): void;
+  // Programas de transformación (transform_program.h)
+  _evaluate_transform_programs(
+    codePtr: number, // Palabras de 32 bits: opcode int32 + argumentos f32
+    numWords: number,
+    outPtr: number,
+    maxMatrices: number,
+    layout: number // 0 = AoS, 1 = SoA (planos de maxMatrices)
+  ): number; // Secuencias evaluadas, -1 programa inválido o sin capacidad
+}
+
+/**
+ * Clases de matriz reconocidas por el kernel de transformación en lote.
+ * Cada clase usa un kernel especializado; solo `Projective` calcula W y divide.
+ * La frontera afín/proyectiva es la misma prueba que `MatrixUtils.isAffine`.
+ */
+export const WasmMatrixClass = {
+  Identity: 0,
+  Translate: 1,
+  ScaleTranslate: 2,
+  Affine: 3,
+  Projective: 4,
+} as const;
+export type WasmMatrixClass =
+  (typeof WasmMatrixClass)[keyof typeof WasmMatrixClass];
+
+/**
+ * Variantes compiladas del módulo WASM (`pnpm build:wasm:all` genera las cuatro).
+ * - `baseline`: sin SIMD (`pnpm build:wasm:baseline`); los kernels usan la
+ *   emulación escalar de simd_compat.h. Para motores sin SIMD128.
+ * - `simd`: SIMD128 (`pnpm build:wasm`), un solo hilo.
+ * - `relaxed`: SIMD128 + relaxed-SIMD (`pnpm build:wasm:relaxed`); el modo de
+ *   precisión `Fast` usa FMA.
+ * - `threads`: SIMD128 + pthreads (`pnpm build:wasm:threads`); memoria compartida y
+ *   un pool de workers para `transformPointsBatch`. En el navegador requiere
+ *   aislamiento cross-origin (COOP/COEP); en Node usa worker_threads.
+ * - `size`: SIMD128 optimizada para tamaño (`pnpm build:wasm:size`, `-Oz`, sin
+ *   sistema de archivos). Arranca antes a costa de algo de rendimiento; solo se
+ *   usa si se pide explícitamente.
+ */
+export type WasmModuleVariant =
+  | "baseline"
+  | "simd"
+  | "relaxed"
+  | "threads"
+  | "size";
+
+/**
+ * Modos de precisión de los kernels f32 (ver TransformPrecision en C++).
+ * - `Exact`: mul + add y división completa para 1/W.
+ * - `Fast`: FMA (solo en la build `relaxed`) y 1/W por estimación + Newton-Raphson.
+ *   Error máximo documentado en `TRANSFORM_PRECISION_MAX_ERROR`.
+ */
+export const WasmTransformPrecision = {
+  Exact: 0,
+  Fast: 1,
+} as const;
+export type WasmTransformPrecision =
+  (typeof WasmTransformPrecision)[keyof typeof WasmTransformPrecision];
+
+/**
+ * Error máximo de cada modo frente a `Exact`, relativo a max(|exacto|, 1)
+ * (coordenadas de pantalla, |W| en [1e-6, 1e38]).
+ */
+export const TRANSFORM_PRECISION_MAX_ERROR: Record<
+  WasmTransformPrecision,
+  number
+> = {
+  [WasmTransformPrecision.Exact]: 0,
+  [WasmTransformPrecision.Fast]: 1e-4,
+};
+
+/** Formatos de elemento de los puntos xyxy de `transformPointsTyped` (ver PointFormat en C++). */
+export const WasmPointFormat = {
+  F32: 0,
+  F16: 1,
+  SNorm16: 2,
+} as const;
+export type WasmPointFormat =
+  (typeof WasmPointFormat)[keyof typeof WasmPointFormat];
+
+/** Características WebAssembly del motor actual (sondeadas con `WebAssembly.validate`). */
+export interface WasmFeatureSupport {
+  simd: boolean;
+  relaxedSimd: boolean;
+  /** Memoria compartida + atómicos, y `SharedArrayBuffer` utilizable. */
+  threads: boolean;
+}
+
+/** Resultado de la selección de la variante por defecto (`getWasmDiagnostics`). */
+export interface WasmLoaderDiagnostics {
+  /** Variante cargada como módulo por defecto. */
+  variant: WasmModuleVariant;
+  features: WasmFeatureSupport;
+  /** Variantes soportadas, en orden de preferencia. */
+  candidates: WasmModuleVariant[];
+  /** Candidatas que fallaron al cargar (p. ej. build no desplegada). */
+  failures: { variant: WasmModuleVariant; error: string }[];
 }
 
 // --- Singleton para el Módulo Cargado ---
 let wasmModuleInstance: MatrixOpsWasmModule | null = null;
 let wasmLoadingPromise: Promise<MatrixOpsWasmModule> | null = null;
+let wasmDiagnostics: WasmLoaderDiagnostics | null = null;
+// Una instancia por variante (cada una con su propio heap); la por defecto es una de ellas
+const variantLoadingPromises = new Map<
+  WasmModuleVariant,
+  Promise<MatrixOpsWasmModule>
+>();
+// Módulos compilados por variante. Sobreviven a cleanupWasm(): recargar (o
+// instanciar en otro worker) no vuelve a descargar ni compilar el binario.
+const compiledModules = new Map<
+  WasmModuleVariant,
+  Promise<WebAssembly.Module>
+>();
+
+// --- Detección de Características ---
+// Módulos mínimos que solo validan si el motor soporta la instrucción usada.
+// () -> v128: i8x16.splat(0) + i8x16.popcnt
+const SIMD_PROBE = new Uint8Array([
+  0, 97, 115, 109, 1, 0, 0, 0, 1, 5, 1, 96, 0, 1, 123, 3, 2, 1, 0, 10, 10, 1, 8,
+  0, 65, 0, 253, 15, 253, 98, 11,
+]);
+// () -> v128: i8x16.relaxed_swizzle de dos splats
+const RELAXED_SIMD_PROBE = new Uint8Array([
+  0, 97, 115, 109, 1, 0, 0, 0, 1, 5, 1, 96, 0, 1, 123, 3, 2, 1, 0, 10, 15, 1, 13,
+  0, 65, 1, 253, 15, 65, 2, 253, 15, 253, 128, 2, 11,
+]);
+// Memoria compartida (1 página) + i32.atomic.load
+const THREADS_PROBE = new Uint8Array([
+  0, 97, 115, 109, 1, 0, 0, 0, 1, 4, 1, 96, 0, 0, 3, 2, 1, 0, 5, 4, 1, 3, 1, 1, 10,
+  11, 1, 9, 0, 65, 0, 254, 16, 2, 0, 26, 11,
+]);
+
+let cachedFeatures: WasmFeatureSupport | null = null;
+
+function validateProbe(bytes: Uint8Array): boolean {
+  try {
+    return WebAssembly.validate(bytes);
+  } catch {
+    return false;
+  }
+}
+
+/** Sondea (una vez) las características WebAssembly del motor. */
+export function detectWasmFeatures(): WasmFeatureSupport {
+  if (cachedFeatures) return cachedFeatures;
+  const simd = validateProbe(SIMD_PROBE);
+  // En el navegador, SharedArrayBuffer solo funciona con aislamiento cross-origin;
+  // en Node `crossOriginIsolated` no existe
+  const isolated =
+    (globalThis as { crossOriginIsolated?: boolean }).crossOriginIsolated !==
+    false;
+  cachedFeatures = {
+    simd,
+    relaxedSimd: simd && validateProbe(RELAXED_SIMD_PROBE),
+    threads:
+      simd &&
+      typeof SharedArrayBuffer !== "undefined" &&
+      isolated &&
+      validateProbe(THREADS_PROBE),
+  };
+  return cachedFeatures;
+}
+
+/**
+ * Variantes utilizables para el módulo por defecto, de la más rápida a la más lenta.
+ * `threads` no entra: solo compensa con workers configurados, así que se pide
+ * explícitamente (`WasmBufferManager.initialize({ threads })`).
+ */
+export function getWasmVariantCandidates(
+  features: WasmFeatureSupport = detectWasmFeatures()
+): WasmModuleVariant[] {
+  const candidates: WasmModuleVariant[] = [];
+  if (features.relaxedSimd) candidates.push("relaxed");
+  if (features.simd) candidates.push("simd");
+  candidates.push("baseline");
+  return candidates;
+}
+
+/**
+ * Variante elegida para el módulo por defecto y características detectadas.
+ * `null` hasta que se carga el módulo por defecto (`loadWasmModule()`).
+ */
+export function getWasmDiagnostics(): WasmLoaderDiagnostics | null {
+  return wasmDiagnostics;
+}
 
 // --- Path Helper ---
 /** Calcula la ruta al archivo JS del módulo WASM dependiendo del entorno. */
-function getWasmModulePath(): string {
+function getWasmModulePath(variant: WasmModuleVariant): string {
   try {
     // Construye la URL al archivo JS generado RELATIVA a ESTE archivo (wasm-loader.ts).
     // Asumiendo que:
     // - wasm-loader.ts está en src/core/wasm/
     // - matrix_ops.js está en src/core/wasm/generated/
-    const wasmJsUrl = new URL("./generated/matrix_ops.js", import.meta.url);
+    let wasmJsUrl: URL;
+    if (variant === "threads")
+      wasmJsUrl = new URL(
+        "./generated/matrix_ops.threads.js",
+        import.meta.url
+      );
+    else if (variant === "relaxed")
+      wasmJsUrl = new URL(
+        "./generated/matrix_ops.relaxed.js",
+        import.meta.url
+      );
+    else if (variant === "baseline")
+      wasmJsUrl = new URL(
+        "./generated/matrix_ops.baseline.js",
+        import.meta.url
+      );
+    else if (variant === "size")
+      wasmJsUrl = new URL("./generated/matrix_ops.size.js", import.meta.url);
+    else wasmJsUrl = new URL("./generated/matrix_ops.js", import.meta.url);
     // console.log(`[WASM Loader] Resolved WASM JS URL: ${wasmJsUrl.href}`); // Log para depurar
     return wasmJsUrl.href;
   } catch (e) {
@@ -45,40 +453,225 @@ function getWasmModulePath(): string {
 }
 
 // --- Carga del Módulo ---
+/** URL del binario .wasm de cada variante. */
+function getWasmBinaryUrl(variant: WasmModuleVariant): string {
+  // Las variantes no se importan con `?url` para que el bundle no dependa de que
+  // existan sus builds
+  if (variant === "threads") {
+    return new URL("./generated/matrix_ops.threads.wasm", import.meta.url)
+      .href;
+  }
+  if (variant === "relaxed") {
+    return new URL("./generated/matrix_ops.relaxed.wasm", import.meta.url)
+      .href;
+  }
+  if (variant === "baseline") {
+    return new URL("./generated/matrix_ops.baseline.wasm", import.meta.url)
+      .href;
+  }
+  if (variant === "size") {
+    return new URL("./generated/matrix_ops.size.wasm", import.meta.url).href;
+  }
+  return wasmBinaryUrl;
+}
+
+/**
+ * URLs del JS generado y del binario de una variante, para instanciarla fuera
+ * del loader (p. ej. en un worker, junto con `getCompiledWasmModule`).
+ */
+export function getWasmModuleUrls(variant: WasmModuleVariant): {
+  js: string;
+  wasm: string;
+} {
+  return { js: getWasmModulePath(variant), wasm: getWasmBinaryUrl(variant) };
+}
+
+// --- Caché de Módulos Compilados ---
+function isNodeRuntime(): boolean {
+  return typeof process !== "undefined" && !!process.versions?.node;
+}
+
+/** Descarga (o lee de disco en Node) y compila el binario .wasm. */
+async function compileWasmBinary(url: string): Promise<WebAssembly.Module> {
+  if (isNodeRuntime()) {
+    // Especificador en variable para que Vite no intente resolverlo en el navegador
+    const fsModule = "node:fs/promises";
+    const { readFile } = await import(/* @vite-ignore */ fsModule);
+    return WebAssembly.compile(
+      await readFile(url.startsWith("file:") ? new URL(url) : url)
+    );
+  }
+  if (typeof WebAssembly.compileStreaming === "function") {
+    try {
+      return await WebAssembly.compileStreaming(fetch(url));
+    } catch {
+      // p. ej. el servidor no envía application/wasm: compilar desde el buffer
+    }
+  }
+  const response = await fetch(url);
+  if (!response.ok) {
+    throw new Error(`Failed to fetch WASM binary ${url}: ${response.status}`);
+  }
+  return WebAssembly.compile(await response.arrayBuffer());
+}
+
+/**
+ * Módulo compilado (`WebAssembly.Module`) de una variante, cacheado para el resto
+ * del proceso. Se puede enviar por `postMessage` a un worker e instanciarlo allí
+ * con `initWasmSync` sin volver a compilar.
+ * @param variant Por defecto, la variante del módulo por defecto (o la primera
+ *   candidata si aún no se cargó).
+ */
+export function getCompiledWasmModule(
+  variant: WasmModuleVariant = wasmDiagnostics?.variant ??
+    getWasmVariantCandidates()[0]
+): Promise<WebAssembly.Module> {
+  let promise = compiledModules.get(variant);
+  if (!promise) {
+    // En Node la URL de `?url` no es una ruta de disco: resolver junto a este archivo
+    const url =
+      isNodeRuntime() && variant === "simd"
+        ? new URL("./generated/matrix_ops.wasm", import.meta.url).href
+        : getWasmBinaryUrl(variant);
+    promise = compileWasmBinary(url);
+    compiledModules.set(variant, promise);
+    // Permitir reintentar si la compilación falla
+    promise.catch(() => compiledModules.delete(variant));
+  }
+  return promise;
+}
+
+let nodeCompileCacheEnabled = false;
+/**
+ * En Node >= 22.1 activa la caché de compilación en disco (`module.enableCompileCache`)
+ * para el JS generado. V8 no permite serializar un `WebAssembly.Module` en Node,
+ * así que el binario se cachea compilado en memoria (`compiledModules`).
+ */
+async function enableNodeCompileCache(): Promise<void> {
+  if (nodeCompileCacheEnabled || !isNodeRuntime()) return;
+  nodeCompileCacheEnabled = true;
+  try {
+    const nodeModule = "node:module";
+    const { enableCompileCache } = await import(/* @vite-ignore */ nodeModule);
+    enableCompileCache?.();
+  } catch {
+    // Node antiguo: sin caché en disco
+  }
+}
+
 /**
  * Carga (o devuelve la instancia cacheada) del módulo WebAssembly.
- * Utiliza un patrón singleton para asegurar una única instancia.
+ * Utiliza un patrón singleton para asegurar una única instancia por variante.
+ * Sin `variant`, devuelve el módulo por defecto: la variante más rápida que soporte
+ * el motor (ver `getWasmVariantCandidates`), pasando a la siguiente si una build no
+ * carga. Los wrappers de este archivo (multiplyWasm, etc.) usan el módulo por defecto.
+ * @param variant Build concreta a cargar (opcional).
  * @returns Una promesa que resuelve con la instancia del módulo WASM inicializada.
  * @throws Error si la carga o inicialización falla.
  */
-export async function loadWasmModule(): Promise<MatrixOpsWasmModule> {
+export async function loadWasmModule(
+  variant?: WasmModuleVariant
+): Promise<MatrixOpsWasmModule> {
+  if (variant) return loadWasmVariant(variant);
   if (wasmModuleInstance) return wasmModuleInstance;
   if (wasmLoadingPromise) return wasmLoadingPromise;
 
-  wasmLoadingPromise = new Promise(async (resolve, reject) => {
+  wasmLoadingPromise = loadBestWasmVariant().then((instance) => {
+    wasmModuleInstance = instance;
+    return instance;
+  });
+  // Permitir reintentar si ninguna variante carga
+  wasmLoadingPromise.catch(() => (wasmLoadingPromise = null));
+  return wasmLoadingPromise;
+}
+
+function loadWasmVariant(
+  variant: WasmModuleVariant
+): Promise<MatrixOpsWasmModule> {
+  let promise = variantLoadingPromises.get(variant);
+  if (!promise) {
+    promise = instantiateWasmModule(variant);
+    variantLoadingPromises.set(variant, promise);
+    // Permitir reintentar si la carga falla
+    promise.catch(() => variantLoadingPromises.delete(variant));
+  }
+  return promise;
+}
+
+/** Prueba las candidatas en orden y registra el resultado en `wasmDiagnostics`. */
+async function loadBestWasmVariant(): Promise<MatrixOpsWasmModule> {
+  const features = detectWasmFeatures();
+  const candidates = getWasmVariantCandidates(features);
+  const failures: WasmLoaderDiagnostics["failures"] = [];
+  for (const variant of candidates) {
+    try {
+      const instance = await loadWasmVariant(variant);
+      wasmDiagnostics = { variant, features, candidates, failures };
+      console.log(`[WASM Loader] Selected "${variant}" build.`);
+      return instance;
+    } catch (error) {
+      // Normal si esa build no se generó: se pasa a la siguiente candidata
+      console.debug(`[WASM Loader] "${variant}" build unavailable:`, error);
+      failures.push({ variant, error: String(error) });
+    }
+  }
+  console.error("[WASM Loader] No WASM build could be loaded:", failures);
+  throw new Error(
+    `No WASM build could be loaded (tried: ${candidates.join(", ")}).`
+  );
+}
+
+/** Callback de Emscripten para el hook `instantiateWasm`. */
+type WasmInstanceCallback = (
+  instance: WebAssembly.Instance,
+  module: WebAssembly.Module
+) => void;
+
+/** Importa el JS generado de la variante e instancia el módulo. */
+function instantiateWasmModule(
+  variant: WasmModuleVariant
+): Promise<MatrixOpsWasmModule> {
+  return new Promise(async (resolve, reject) => {
     try {
-      const modulePath = getWasmModulePath(); // Obtiene URL del .js
+      const modulePath = getWasmModulePath(variant); // Obtiene URL del .js
+      const binaryUrl = getWasmBinaryUrl(variant);
       console.log(`[WASM Loader] Attempting to import JS: ${modulePath}`);
       console.log(
-        `[WASM Loader] WASM binary URL resolved by Vite: ${wasmBinaryUrl}`
+        `[WASM Loader] WASM binary URL resolved by Vite: ${binaryUrl}`
       ); // Log para ver la URL
 
+      await enableNodeCompileCache();
+      // Si no se puede compilar aquí (p. ej. URL que solo resuelve Emscripten),
+      // se deja la carga por defecto del JS generado
+      const compiled = await getCompiledWasmModule(variant).catch(() => null);
       const wasmModuleExports = await import(/* @vite-ignore */ modulePath);
       const createModule = wasmModuleExports.default;
       if (typeof createModule !== "function") {
         /*...*/
       }
 
-      const moduleConfig = {
+      const moduleConfig: Record<string, unknown> = {
         locateFile: (path: string, prefix: string) => {
           if (path.endsWith(".wasm")) {
-            return wasmBinaryUrl; // Devuelve la URL importada por Vite
+            return binaryUrl; // Devuelve la URL importada por Vite
           }
           return prefix + path; // Comportamiento por defecto para otros archivos
         },
       };
+      if (compiled) {
+        // Instanciar el módulo ya compilado en vez de descargar y compilar de nuevo
+        moduleConfig.instantiateWasm = (
+          imports: WebAssembly.Imports,
+          receive: WasmInstanceCallback
+        ) => {
+          WebAssembly.instantiate(compiled, imports).then(
+            (wasmInstance) => receive(wasmInstance, compiled),
+            reject
+          );
+          return {};
+        };
+      }
       const instance: MatrixOpsWasmModule = await createModule(moduleConfig); // <---
-      wasmModuleInstance = instance;
       if (!instance.HEAPF32) {
         /*...*/
       }
@@ -90,10 +683,11 @@ export async function loadWasmModule(): Promise<MatrixOpsWasmModule> {
       }
       resolve(instance);
     } catch (error) {
-      /*...*/
+      // Sin log aquí: quien carga decide si es un fallo (variante pedida) o
+      // solo una candidata ausente (loadBestWasmVariant)
+      reject(error);
     }
   });
-  return wasmLoadingPromise;
 }
 
 // --- Gestión de Memoria Estática ---
@@ -101,6 +695,8 @@ const MATRIX_SIZE_BYTES = 9 * Float32Array.BYTES_PER_ELEMENT;
 const HOMOGRAPHY_A_SIZE_BYTES = 64 * Float32Array.BYTES_PER_ELEMENT;
 const HOMOGRAPHY_B_SIZE_BYTES = 8 * Float32Array.BYTES_PER_ELEMENT;
 const HOMOGRAPHY_X_SIZE_BYTES = 8 * Float32Array.BYTES_PER_ELEMENT;
+// Tres matrices f64 contiguas (a, b, out) para los wrappers f64
+const MATRIX_F64_BLOCK_SIZE_BYTES = 3 * 9 * Float64Array.BYTES_PER_ELEMENT;
 // Punteros globales a memoria estática WASM (gestionados por ensure/cleanup)
 let wasm_matrix_a_ptr: number | null = null;
 let wasm_matrix_b_ptr: number | null = null;
@@ -108,6 +704,7 @@ let wasm_matrix_out_ptr: number | null = null;
 let wasm_homography_a_ptr: number | null = null;
 let wasm_homography_b_ptr: number | null = null;
 let wasm_homography_x_ptr: number | null = null;
+let wasm_matrix_f64_ptr: number | null = null;
 
 /**
  * Asegura que la memoria estática global necesaria para las operaciones
@@ -116,7 +713,13 @@ let wasm_homography_x_ptr: number | null = null;
  */
 export async function ensureStaticWasmMemory(): Promise<void> {
   // Añadido : Promise<void>
+  if (isWasmReady()) return; // Camino rápido: sin await de loadWasmModule
   const module = await loadWasmModule(); // Carga o obtiene instancia cacheada
+  allocateStaticWasmMemory(module);
+}
+
+/** Parte síncrona de `ensureStaticWasmMemory` (la usa también `initWasmSync`). */
+function allocateStaticWasmMemory(module: MatrixOpsWasmModule): void {
   // Verificar si toda la memoria necesaria ya está alocada
   if (
     wasm_matrix_a_ptr !== null &&
@@ -124,7 +727,8 @@ export async function ensureStaticWasmMemory(): Promise<void> {
     wasm_matrix_out_ptr !== null &&
     wasm_homography_a_ptr !== null &&
     wasm_homography_b_ptr !== null &&
-    wasm_homography_x_ptr !== null
+    wasm_homography_x_ptr !== null &&
+    wasm_matrix_f64_ptr !== null
   ) {
     return; // Ya está todo listo
   }
@@ -151,6 +755,8 @@ export async function ensureStaticWasmMemory(): Promise<void> {
       wasm_homography_b_ptr = module._malloc(HOMOGRAPHY_B_SIZE_BYTES);
     if (wasm_homography_x_ptr === null)
       wasm_homography_x_ptr = module._malloc(HOMOGRAPHY_X_SIZE_BYTES);
+    if (wasm_matrix_f64_ptr === null)
+      wasm_matrix_f64_ptr = module._malloc(MATRIX_F64_BLOCK_SIZE_BYTES);
 
     // Verificar si alguna alocación falló (malloc devuelve 0)
     if (
@@ -159,10 +765,9 @@ export async function ensureStaticWasmMemory(): Promise<void> {
       !wasm_matrix_out_ptr ||
       !wasm_homography_a_ptr ||
       !wasm_homography_b_ptr ||
-      !wasm_homography_x_ptr
+      !wasm_homography_x_ptr ||
+      !wasm_matrix_f64_ptr
     ) {
-      // Limpiar lo que se haya podido alocar antes de lanzar el error
-      await cleanupStaticWasmMemory();
       throw new Error(
         "module._malloc returned null or zero pointer during static memory allocation."
       );
@@ -173,13 +778,12 @@ export async function ensureStaticWasmMemory(): Promise<void> {
       "[WASM Loader] Error during static WASM memory allocation:",
       e
     );
-    await cleanupStaticWasmMemory(); // Intentar limpiar
+    freeStaticWasmMemory(module); // Limpiar lo que se haya podido alocar
     // Relanzar el error para indicar el fallo
     throw new Error(
       `Failed to allocate static WASM memory: ${e instanceof Error ? e.message : String(e)}`
     );
   }
-  // No hay valor de retorno explícito (Promise<void>)
 }
 
 /** Libera la memoria estática global alocada usando module._free. */
@@ -193,7 +797,8 @@ export async function cleanupStaticWasmMemory(): Promise<void> {
     wasm_matrix_out_ptr !== null ||
     wasm_homography_a_ptr !== null ||
     wasm_homography_b_ptr !== null ||
-    wasm_homography_x_ptr !== null;
+    wasm_homography_x_ptr !== null ||
+    wasm_matrix_f64_ptr !== null;
 
   if (!module && hasPointers) {
     console.warn(
@@ -203,7 +808,11 @@ export async function cleanupStaticWasmMemory(): Promise<void> {
       module = await loadWasmModule();
     } catch (e) {} // Intentar cargar, ignorar error aquí
   }
+  freeStaticWasmMemory(module);
+}
 
+/** Libera los punteros estáticos con `module._free` (si hay módulo) y los resetea. */
+function freeStaticWasmMemory(module: MatrixOpsWasmModule | null): void {
   const canFree = module && typeof module._free === "function";
   // console.log(`[WASM Loader] cleanupStaticWasmMemory called. Can free: ${canFree}`); // Opcional
 
@@ -215,6 +824,7 @@ export async function cleanupStaticWasmMemory(): Promise<void> {
     wasm_homography_a_ptr,
     wasm_homography_b_ptr,
     wasm_homography_x_ptr,
+    wasm_matrix_f64_ptr,
   ];
 
   pointersToFree.forEach((ptr) => {
@@ -235,12 +845,219 @@ export async function cleanupStaticWasmMemory(): Promise<void> {
   // Resetear punteros globales independientemente de si se pudo liberar
   wasm_matrix_a_ptr = wasm_matrix_b_ptr = wasm_matrix_out_ptr = null;
   wasm_homography_a_ptr = wasm_homography_b_ptr = wasm_homography_x_ptr = null;
+  wasm_matrix_f64_ptr = null;
+  staticMatrixViews = null;
   // console.log("[WASM Loader] Static memory pointers reset."); // Opcional
-  // No hay valor de retorno explícito (Promise<void>)
+}
+
+// --- API Síncrona (exportaciones C directas) ---
+// Tras `await initWasm()` no hay await ni Embind por llamada: se escribe en vistas
+// cacheadas de la memoria estática y se llama al export C de la instancia.
+// Con builds anteriores a los exports raw se usan las funciones Embind equivalentes.
+
+/** Kernels 3x3 de la API síncrona (mismos argumentos en raw y en Embind). */
+interface MatrixKernels {
+  multiply(aPtr: number, bPtr: number, outPtr: number): void;
+  determinant(mPtr: number): number;
+  invert(mPtr: number, outPtr: number): number | boolean; // falsy si es singular
+}
+const matrixKernels = new WeakMap<MatrixOpsWasmModule, MatrixKernels>();
+
+function getMatrixKernels(module: MatrixOpsWasmModule): MatrixKernels {
+  let kernels = matrixKernels.get(module);
+  if (!kernels) {
+    if (typeof module._multiply_matrices_raw === "function") {
+      kernels = {
+        multiply: module._multiply_matrices_raw,
+        determinant: module._determinant_raw,
+        invert: module._invert_matrix_raw,
+      };
+    } else {
+      console.warn(
+        "[WASM Loader] Module lacks the raw matrix exports (stale build): using Embind."
+      );
+      kernels = {
+        multiply: module.multiplyMatrices,
+        determinant: module.determinant,
+        invert: module.invertMatrix,
+      };
+    }
+    matrixKernels.set(module, kernels);
+  }
+  return kernels;
+}
+
+/** Vistas Float32 de las matrices estáticas a, b y out. */
+interface StaticMatrixViews {
+  buffer: ArrayBufferLike; // HEAPF32.buffer sobre el que se crearon
+  a: Float32Array;
+  b: Float32Array;
+  out: Float32Array;
+}
+let staticMatrixViews: StaticMatrixViews | null = null;
+
+/**
+ * Carga el módulo por defecto y su memoria estática. Cuando resuelve, las funciones
+ * `*Sync` (multiplyWasmSync, determinantWasmSync, inverseWasmSync) son utilizables.
+ */
+export async function initWasm(): Promise<MatrixOpsWasmModule> {
+  await ensureStaticWasmMemory();
+  return wasmModuleInstance!;
+}
+
+/**
+ * Inicialización síncrona para workers y herramientas CLI: instancia el módulo
+ * con `new WebAssembly.Instance` dentro de la llamada, sin promesas.
+ *
+ * Requiere una build con `-s WASM_ASYNC_COMPILATION=0` (la variante `size`): con
+ * las demás, la factory de Emscripten es asíncrona. `createModule` es su factory,
+ * importada estáticamente por el llamador
+ * (`import createModule from "./generated/matrix_ops.size.js"`), y `wasm` el
+ * módulo compilado (p. ej. `getCompiledWasmModule()` recibido por `postMessage`)
+ * o los bytes del .wasm (compilar bytes es síncrono y, en el hilo principal del
+ * navegador, solo se permite para binarios pequeños).
+ *
+ * Tras la llamada el módulo queda como módulo por defecto y la API `*Sync` es
+ * utilizable, igual que tras `await initWasm()`.
+ * @throws Error si hay una carga asíncrona en curso o si la factory no termina
+ *   de forma síncrona.
+ */
+export function initWasmSync(
+  createModule: (config: object) => unknown,
+  wasm: WebAssembly.Module | BufferSource,
+  variant: WasmModuleVariant = "size"
+): MatrixOpsWasmModule {
+  if (wasmModuleInstance) {
+    if (!isWasmReady()) allocateStaticWasmMemory(wasmModuleInstance);
+    return wasmModuleInstance;
+  }
+  if (wasmLoadingPromise) {
+    throw new Error(
+      "initWasmSync: an asynchronous load of the default module is in progress."
+    );
+  }
+  const compiled =
+    wasm instanceof WebAssembly.Module ? wasm : new WebAssembly.Module(wasm);
+  const config: Record<string, unknown> = {
+    instantiateWasm: (
+      imports: WebAssembly.Imports,
+      receive: WasmInstanceCallback
+    ) => {
+      const instance = new WebAssembly.Instance(compiled, imports);
+      receive(instance, compiled);
+      return instance.exports;
+    },
+  };
+  // Con WASM_ASYNC_COMPILATION=0 la factory devuelve el Module directamente
+  const result = createModule(config);
+  if (result instanceof Promise) result.catch(() => {});
+  const module = (
+    result instanceof Promise ? config : result
+  ) as MatrixOpsWasmModule;
+  if (!module?.HEAPF32 || typeof module._malloc !== "function") {
+    throw new Error(
+      "initWasmSync: the WASM module did not initialize synchronously (requires a build with -s WASM_ASYNC_COMPILATION=0, e.g. pnpm build:wasm:size)."
+    );
+  }
+  wasmModuleInstance = module;
+  wasmLoadingPromise = Promise.resolve(module);
+  variantLoadingPromises.set(variant, wasmLoadingPromise);
+  if (!compiledModules.has(variant)) {
+    compiledModules.set(variant, Promise.resolve(compiled));
+  }
+  wasmDiagnostics = {
+    variant,
+    features: detectWasmFeatures(),
+    candidates: [variant],
+    failures: [],
+  };
+  allocateStaticWasmMemory(module);
+  return module;
+}
+
+/** `true` si la API síncrona está lista (initWasm ya resolvió). */
+export function isWasmReady(): boolean {
+  return wasmModuleInstance !== null && wasm_matrix_out_ptr !== null;
+}
+
+/** Módulo y vistas estáticas; recrea las vistas si la memoria creció. */
+function syncContext(): {
+  kernels: MatrixKernels;
+  views: StaticMatrixViews;
+} {
+  const module = wasmModuleInstance;
+  if (!module || wasm_matrix_a_ptr === null || wasm_matrix_out_ptr === null) {
+    throw new Error(
+      "WASM not initialized: await initWasm() before using the sync API."
+    );
+  }
+  const buffer = module.HEAPF32.buffer;
+  if (!staticMatrixViews || staticMatrixViews.buffer !== buffer) {
+    staticMatrixViews = {
+      buffer,
+      a: new Float32Array(buffer, wasm_matrix_a_ptr, 9),
+      b: new Float32Array(buffer, wasm_matrix_b_ptr!, 9),
+      out: new Float32Array(buffer, wasm_matrix_out_ptr, 9),
+    };
+  }
+  return { kernels: getMatrixKernels(module), views: staticMatrixViews };
+}
+
+/**
+ * Multiplica dos matrices 3x3 (a * b) de forma síncrona.
+ * @param out Matriz destino opcional (evita alocar); puede ser `a` o `b`.
+ * @throws Error si initWasm() no ha resuelto.
+ */
+export function multiplyWasmSync(
+  a: Matrix3x3,
+  b: Matrix3x3,
+  out: Matrix3x3 = new Float32Array(9) as Matrix3x3
+): Matrix3x3 {
+  const { kernels, views } = syncContext();
+  views.a.set(a);
+  views.b.set(b);
+  kernels.multiply(
+    wasm_matrix_a_ptr!,
+    wasm_matrix_b_ptr!,
+    wasm_matrix_out_ptr!
+  );
+  out.set(views.out);
+  return out;
+}
+
+/** Determinante de una matriz 3x3, síncrono. */
+export function determinantWasmSync(m: Matrix3x3): number {
+  const { kernels, views } = syncContext();
+  views.a.set(m);
+  return kernels.determinant(wasm_matrix_a_ptr!);
+}
+
+/**
+ * Inversa de una matriz 3x3, síncrona. Devuelve null si es singular.
+ * @param out Matriz destino opcional (solo se escribe si tiene éxito).
+ */
+export function inverseWasmSync(
+  m: Matrix3x3,
+  out: Matrix3x3 = new Float32Array(9) as Matrix3x3
+): Matrix3x3 | null {
+  const { kernels, views } = syncContext();
+  views.a.set(m);
+  if (!kernels.invert(wasm_matrix_a_ptr!, wasm_matrix_out_ptr!)) {
+    return null; // La matriz era singular según C++
+  }
+  // Doble chequeo por si C++ no devolvió NaN pero el resultado no es finito
+  if (views.out.some((v) => !Number.isFinite(v))) {
+    console.warn(
+      "[WASM Loader] inverseWasm detected non-finite values in result despite success flag."
+    );
+    return null;
+  }
+  out.set(views.out);
+  return out;
 }
 
 // --- Funciones Wrapper de Alto Nivel (Usan memoria estática global) ---
-// Estas asumen que ensureStaticWasmMemory se llamó antes o la llaman ellas mismas
+// Versiones async: cargan el módulo si hace falta y delegan en la API síncrona.
 
 /** Multiplica dos matrices 3x3 usando WASM. */
 export async function multiplyWasm(
@@ -248,64 +1065,79 @@ export async function multiplyWasm(
   b: Matrix3x3
 ): Promise<Matrix3x3> {
   await ensureStaticWasmMemory(); // Asegura que los punteros estáticos existan
-  const module = wasmModuleInstance!; // Asumir que está cargado después de ensure
-  // Copiar datos JS -> WASM
-  module.HEAPF32.set(a, wasm_matrix_a_ptr! / 4);
-  module.HEAPF32.set(b, wasm_matrix_b_ptr! / 4);
-  // Llamar a la función C++
-  module.multiplyMatrices(
-    wasm_matrix_a_ptr!,
-    wasm_matrix_b_ptr!,
-    wasm_matrix_out_ptr!
-  );
-  // Copiar datos WASM -> JS
-  const resultMatrix = new Float32Array(9) as Matrix3x3;
-  resultMatrix.set(
-    module.HEAPF32.subarray(
-      wasm_matrix_out_ptr! / 4,
-      wasm_matrix_out_ptr! / 4 + 9
-    )
-  );
-  return resultMatrix;
+  return multiplyWasmSync(a, b);
 }
 
 /** Calcula el determinante de una matriz 3x3 usando WASM. */
 export async function determinantWasm(m: Matrix3x3): Promise<number> {
+  await ensureStaticWasmMemory();
+  return determinantWasmSync(m);
+}
+
+/** Vistas f64 de las tres matrices del bloque estático f64 (a, b, out). */
+function staticMatrixF64Views(module: MatrixOpsWasmModule) {
+  const base = wasm_matrix_f64_ptr!;
+  const bytes = 9 * Float64Array.BYTES_PER_ELEMENT;
+  const heap = module.HEAPF32.buffer;
+  return {
+    a: new Float64Array(heap, base, 9),
+    b: new Float64Array(heap, base + bytes, 9),
+    out: new Float64Array(heap, base + 2 * bytes, 9),
+    aPtr: base,
+    bPtr: base + bytes,
+    outPtr: base + 2 * bytes,
+  };
+}
+
+/**
+ * Multiplica dos matrices 3x3 en doble precisión (Float64Array(9) column-major).
+ * Para transformaciones con traslaciones grandes (CAD/GIS) que f32 no representa bien.
+ */
+export async function multiplyWasmF64(
+  a: Float64Array,
+  b: Float64Array
+): Promise<Float64Array> {
+  await ensureStaticWasmMemory();
+  const m = staticMatrixF64Views(wasmModuleInstance!);
+  m.a.set(a);
+  m.b.set(b);
+  wasmModuleInstance!.multiplyMatricesF64(m.aPtr, m.bPtr, m.outPtr);
+  return m.out.slice();
+}
+
+/** Determinante de una matriz 3x3 en doble precisión. */
+export async function determinantWasmF64(m: Float64Array): Promise<number> {
+  await ensureStaticWasmMemory();
+  const views = staticMatrixF64Views(wasmModuleInstance!);
+  views.a.set(m);
+  return wasmModuleInstance!.determinantF64(views.aPtr);
+}
+
+/** Inversa de una matriz 3x3 en doble precisión. Devuelve null si es singular. */
+export async function inverseWasmF64(
+  m: Float64Array
+): Promise<Float64Array | null> {
+  await ensureStaticWasmMemory();
+  const views = staticMatrixF64Views(wasmModuleInstance!);
+  views.a.set(m);
+  const ok = wasmModuleInstance!.invertMatrixF64(views.aPtr, views.outPtr);
+  return ok ? views.out.slice() : null;
+}
+
+/** Clasifica una matriz 3x3 tal y como lo hace el kernel de transformación en lote. */
+export async function classifyMatrixWasm(
+  m: Matrix3x3
+): Promise<WasmMatrixClass> {
   await ensureStaticWasmMemory();
   const module = wasmModuleInstance!;
-  module.HEAPF32.set(m, wasm_matrix_a_ptr! / 4); // Usar el primer buffer para entrada
-  const det = module.determinant(wasm_matrix_a_ptr!);
-  return det;
+  module.HEAPF32.set(m, wasm_matrix_a_ptr! / 4);
+  return module.classifyMatrix(wasm_matrix_a_ptr!) as WasmMatrixClass;
 }
 
 /** Calcula la inversa de una matriz 3x3 usando WASM. Devuelve null si es singular. */
 export async function inverseWasm(m: Matrix3x3): Promise<Matrix3x3 | null> {
   await ensureStaticWasmMemory();
-  const module = wasmModuleInstance!;
-  module.HEAPF32.set(m, wasm_matrix_a_ptr! / 4); // Usar A para entrada
-  const success: boolean = module.invertMatrix(
-    wasm_matrix_a_ptr!,
-    wasm_matrix_out_ptr!
-  ); // Usar OUT para salida
-  if (!success) {
-    return null; // La matriz era singular según C++
-  } else {
-    const resultMatrix = new Float32Array(9) as Matrix3x3;
-    resultMatrix.set(
-      module.HEAPF32.subarray(
-        wasm_matrix_out_ptr! / 4,
-        wasm_matrix_out_ptr! / 4 + 9
-      )
-    );
-    // Opcional: Doble chequeo por si acaso C++ no devolvió NaN pero JS lo detecta
-    if (resultMatrix.some((v) => !Number.isFinite(v))) {
-      console.warn(
-        "[WASM Loader] inverseWasm detected non-finite values in result despite success flag."
-      );
-      return null;
-    }
-    return resultMatrix;
-  }
+  return inverseWasmSync(m);
 }
 
 /** Resuelve la homografía Ax=b usando SVD en WASM. Devuelve null si falla o es singular. */
@@ -467,6 +1299,9 @@ export async function cleanupWasm(): Promise<void> {
   await cleanupStaticWasmMemory(); // Limpia solo la estática global
   wasmModuleInstance = null;
   wasmLoadingPromise = null;
+  wasmDiagnostics = null;
+  variantLoadingPromises.clear();
+  // compiledModules se conserva: recargar solo vuelve a instanciar
   // console.log("[WASM Loader] Loader state reset."); // Opcional
   // No necesita return explícito
 }
@@ -5,6 +5,8 @@ export default defineConfig({
   test: {
     globals: true,
     environment: "node",
+    // Regenera los módulos WASM si no corresponden a core_cpp/src
+    globalSetup: ["./src/core/wasm/__tests__/wasm-build.setup.ts"],
     coverage: {
       provider: "v8",
       reporter: ["text", "json", "html"],
@@ -21,6 +23,7 @@ export default defineConfig({
         "src/types/**/*",
         "src/core/wasm/wasm-loader.ts",
         "**/*.spec.ts",
+        "**/*.setup.ts",
         "**/node_modules/**",
         "**/dist/**",
         "**/index.ts",